@@ -24,6 +24,15 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':'reactor_state_capture_file',
+    'type':'string',
+    'shortDesc' : "Binary trace of the inputs of every solve for replay with zerork_cfd_plugin_tester.x (empty to disable, one file per MPI rank with a .<rank> suffix and per plugin handle with a .h<index> suffix after the first handle)",
+    'defaultValue' : ""
+}
+)
+
 spify_parser_params.append(
 {
     'name':'n_reactors_max',
@@ -129,9 +138,9 @@ spify_parser_params.append(
 {
     'name':"integrator",
     'type':'int',
-    'shortDesc' : "Integrator",
+    'shortDesc' : "Integrator (0: CVODE, 1: SEULEX, 2: RODAS4 Rosenbrock, 3: exprb32 exponential Rosenbrock, CPU only)",
     'defaultValue' : 0,
-    'discreteValues': [0,1]
+    'discreteValues': [0,1,2,3]
 }
 )
 
@@ -189,9 +198,19 @@ spify_parser_params.append(
 {
     'name':"load_balance",
     'type':'int',
-    'shortDesc' : "Which load balance method.",
+    'shortDesc' : "Which load balance method. (0 = none, 1 = step count, 2 = solve time, 3 = dynamic batch stealing, CPU solves only)",
     'defaultValue' : 1,
-    'discreteValues': [0,1,2]
+    'discreteValues': [0,1,2,3]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"load_balance_batch_size",
+    'type':'int',
+    'shortDesc' : "Number of reactors claimed at a time with dynamic load balancing (load_balance = 3)",
+    'defaultValue' : 16,
+    'boundMin': 1
 }
 )
 
@@ -284,6 +303,267 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':"share_mechanism",
+    'type':'int',
+    'shortDesc' : "Share one read-only CPU mechanism between the plugin handles of this process that load the same files with the same rate constant table options",
+    'defaultValue' : 1,
+    'discreteValues': [0,1]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"rate_const_table",
+    'type':'int',
+    'shortDesc' : "Interpolate the temperature dependent terms of the CPU rate constants from a table",
+    'defaultValue' : 0,
+    'discreteValues': [0,1]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"rate_const_table_tolerance",
+    'type':'double',
+    'shortDesc' : "Target relative error of the tabulated terms, the table spacing is refined until it is met",
+    'defaultValue' : 1.0e-6,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"rate_const_table_min_temperature",
+    'type':'double',
+    'shortDesc' : "Lowest temperature [K] of the rate constant table",
+    'defaultValue' : 250.0,
+    'boundMin': 1.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"rate_const_table_max_temperature",
+    'type':'double',
+    'shortDesc' : "Highest temperature [K] of the rate constant table",
+    'defaultValue' : 3500.0,
+    'boundMin': 1.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"frozen_chemistry_bypass",
+    'type':'int',
+    'shortDesc' : "Skip the implicit solve of CPU reactors whose predicted change over the step is below the frozen chemistry tolerances",
+    'defaultValue' : 0,
+    'discreteValues': [0,1]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"frozen_chemistry_tolerance",
+    'type':'double',
+    'shortDesc' : "Largest predicted mass fraction change of a reactor that bypasses the implicit solve",
+    'defaultValue' : 1.0e-6,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"frozen_chemistry_temperature_tolerance",
+    'type':'double',
+    'shortDesc' : "Largest predicted temperature change [K] of a reactor that bypasses the implicit solve",
+    'defaultValue' : 0.1,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"cpu_batch_size",
+    'type':'int',
+    'shortDesc' : "Number of CPU reactors integrated together as one system. Not used with isat, adaptive_chemistry, frozen_chemistry_bypass or the CVODE dense direct solver.",
+    'defaultValue' : 1,
+    'boundMin': 1
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"seulex_parallel_columns",
+    'type':'int',
+    'shortDesc' : "Number of threads computing the SEULEX extrapolation columns of a CPU reactor concurrently (integrator: 1). Needs ENABLE_OPENMP. Not used with cpu_batch_size > 1 or adaptive_chemistry.",
+    'defaultValue' : 1,
+    'boundMin': 1
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"seulex_warm_start",
+    'type':'int',
+    'shortDesc' : "Start each SEULEX integration (integrator: 1) of a reactor id from the step size and order at the end of its previous integration. Not used with cpu_batch_size > 1.",
+    'defaultValue' : 0,
+    'boundMin': 0,
+    'boundMax': 1
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"cluster_reactors",
+    'type':'int',
+    'shortDesc' : "Solve one mean state per bin of (T, log P, progress variable, equivalence ratio) and apply its increments to the bin members. Not used with species or energy sources.",
+    'defaultValue' : 0,
+    'discreteValues': [0,1]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"cluster_temperature_tolerance",
+    'type':'double',
+    'shortDesc' : "Temperature bin width [K] for reactor clustering",
+    'defaultValue' : 5.0,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"cluster_pressure_tolerance",
+    'type':'double',
+    'shortDesc' : "log(P) bin width for reactor clustering",
+    'defaultValue' : 0.01,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"cluster_progress_tolerance",
+    'type':'double',
+    'shortDesc' : "Progress variable (Y_CO2+Y_CO+Y_H2O) bin width for reactor clustering",
+    'defaultValue' : 0.01,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"cluster_equivalence_ratio_tolerance",
+    'type':'double',
+    'shortDesc' : "Equivalence ratio bin width for reactor clustering",
+    'defaultValue' : 0.01,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"adaptive_chemistry",
+    'type':'int',
+    'shortDesc' : "Freeze the species found unimportant by DRGEP at the start of each CPU reactor step",
+    'defaultValue' : 0,
+    'discreteValues': [0,1]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"adaptive_chemistry_threshold",
+    'type':'double',
+    'shortDesc' : "DRGEP importance below which a species is frozen",
+    'defaultValue' : 1.0e-3,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"adaptive_chemistry_target_mass_fraction",
+    'type':'double',
+    'shortDesc' : "Species with at least this mass fraction are DRGEP targets",
+    'defaultValue' : 1.0e-4,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"adaptive_chemistry_tolerance",
+    'type':'double',
+    'shortDesc' : "Maximum estimated mass fraction change of a frozen species over the step before the step is repeated with all species",
+    'defaultValue' : 1.0e-6,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"isat",
+    'type':'int',
+    'shortDesc' : "Use in-situ adaptive tabulation for CPU reactors without source terms or ignition roots",
+    'defaultValue' : 0,
+    'discreteValues': [0,1]
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"isat_tolerance",
+    'type':'double',
+    'shortDesc' : "ISAT error tolerance on the scaled reactor state",
+    'defaultValue' : 1.0e-4,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"isat_max_radius",
+    'type':'double',
+    'shortDesc' : "Maximum semi-axis of an ISAT ellipsoid of accuracy in scaled units",
+    'defaultValue' : 0.05,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"isat_max_memory_mb",
+    'type':'double',
+    'shortDesc' : "Maximum memory of the ISAT table per rank in MB. Least recently used records are evicted beyond this.",
+    'defaultValue' : 256.0,
+    'boundMin': 0.0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"isat_max_search",
+    'type':'int',
+    'shortDesc' : "Maximum number of ISAT records checked per query, in most recently used order",
+    'defaultValue' : 64,
+    'boundMin': 1
+}
+)
+
+spify_parser_params.append(
+{
+    'name':"isat_temperature_scale",
+    'type':'double',
+    'shortDesc' : "Temperature scale [K] of the ISAT error and distance measures",
+    'defaultValue' : 1000.0,
+    'boundMin': 0.0
+}
+)
+
 spify_parser_params.append(
 {
     'name':"always_solve_temperature",
@@ -335,6 +615,17 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':"exprb_krylov_max_dim",
+    'type':'int',
+    'shortDesc' : "Maximum Krylov subspace dimension of the exponential Rosenbrock integrator (integrator: 3). Steps that need more vectors are retried with a smaller step size.",
+    'defaultValue' : 40,
+    'boundMin':  2,
+    'boundMax':  500
+}
+)
+
 spify_parser_params.append(
 {
     'name':"cvode_retry_absolute_tolerance_adjustment",
@@ -183,6 +183,15 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':"replay_files",
+    'type':'v_string',
+    'shortDesc' : "Reactor state traces (reactor_state_capture_file of the plugin) to replay instead of the initial states. The replay reports reactors/s, steps per reactor, a histogram of the steps per reactor and the load imbalance.",
+    'defaultValue' : []   #empty
+}
+)
+
 spify_parser_params.append(
 {
     'name':"reactor_history_file_prefix",
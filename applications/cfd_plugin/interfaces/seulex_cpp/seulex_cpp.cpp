@@ -25,6 +25,8 @@ seulex::seulex(int _n, N_Vector _y0)
       nsol(0),
       nmax(100000),
       km(12),
+      kinit(0),
+      klast(0),
       nsequ(2),
       lambda(0),
       nrdens(0),
@@ -51,6 +53,9 @@ seulex::seulex(int _n, N_Vector _y0)
       err(0.0),
       errold(0.0),
       x(0.0),
+      work_vectors_allocated(false),
+      parallel(false),
+      num_columns_ready(0),
       deriv_fcn(NULL),
       jac_fcn(NULL),
       jac_decomp_fcn(NULL),
@@ -73,8 +78,20 @@ seulex::~seulex()
   output_fcn = NULL;
   output_fcn_data = NULL;
   user_data = NULL;
+  destroy_work_vectors();
+  N_VDestroy(rtol);
+  N_VDestroy(atol);
+}
+
+void seulex::resize(int _n, N_Vector _y0)
+{
+  if(_n == n) return;
+  n = _n;
+  destroy_work_vectors();
   N_VDestroy(rtol);
   N_VDestroy(atol);
+  rtol = N_VClone(_y0);
+  atol = N_VClone(_y0);
 }
 
 void seulex::set_nmax(int _nmax)
@@ -119,6 +136,12 @@ void seulex::set_hinit(double _hinit)
   h=_hinit;
 }
 
+void seulex::set_kinit(int _kinit)
+{
+  assert(_kinit >= 0);
+  kinit=_kinit;
+}
+
 void seulex::set_hmax(double _hmax)
 {
   assert(_hmax != 0.);
@@ -213,6 +236,16 @@ void seulex::set_user_data(void* _user_data)
   user_data = _user_data;
 }
 
+void seulex::set_parallel_user_data(const std::vector<void*>& _worker_user_data)
+{
+  if(_worker_user_data.size() != worker_user_data.size())
+  {
+    destroy_work_vectors();
+  }
+  worker_user_data = _worker_user_data;
+  parallel = worker_user_data.size() > 0;
+}
+
 void seulex::get_integrator_stats(int* _nfcn,int* _njac,int* _nstep,
                             int* _naccept,int* _nreject,int* _ndec,int* _nsol)
 {
@@ -225,6 +258,12 @@ void seulex::get_integrator_stats(int* _nfcn,int* _njac,int* _nstep,
   *_nsol = nsol;
 }
 
+void seulex::get_last_step(double* _h, int* _k)
+{
+  *_h = h;
+  *_k = klast;
+}
+
 int seulex::solve(double* x_in, double xend, N_Vector y)
 {
   //reset counters
@@ -245,10 +284,10 @@ int seulex::solve(double* x_in, double xend, N_Vector y)
   double hopt;
 
   create_work_vectors(y);
-  std::vector<double> hh(km+1,0);
-  std::vector<double> w(km+1,0);
-  std::vector<double> a(km+1,0);
-  std::vector<int> nj(km+1,0);
+  std::fill(hh.begin(), hh.end(), 0.0);
+  std::fill(w.begin(), w.end(), 0.0);
+  std::fill(a.begin(), a.end(), 0.0);
+  std::fill(nj.begin(), nj.end(), 0);
 
   setup_step_sequence(nj, a);
   x = *x_in;
@@ -259,11 +298,26 @@ int seulex::solve(double* x_in, double xend, N_Vector y)
   double posneg = xend-xstart > 0 ? 1.0 : -1.0;
   double min_rtol = N_VMin(rtol);
   double min_atol = N_VMin(atol);
-  k = std::max(1,std::min(km-2,int(-log10(min_rtol+min_atol)*0.6+0.5)));
+  if(kinit > 0)
+  {
+    // warm start, the order and step size of a previous solve
+    k = std::max(1,std::min(km-1,kinit));
+    h = fabs(h);
+  }
+  else
+  {
+    k = std::max(1,std::min(km-2,int(-log10(min_rtol+min_atol)*0.6+0.5)));
+    h = std::max(fabs(h),1.0e-6);
+  }
   hmax = std::min(fabs(hmax),fabs(xend-x));
-  h = std::max(fabs(h),1.0e-6);
   h = posneg*std::min(h,hmax);
   theta = 2*fabs(thet);
+  err = 0.0;
+  errold = 0.0;
+  for(size_t iw = 0; iw < worker_work.size(); ++iw)
+  {
+    worker_work[iw].jac_current = false;
+  }
   deriv_fcn(x,y,dy,user_data);
   //if(output_fcn != NULL)
   //{
@@ -295,8 +349,19 @@ g10:
   if(theta > thet && !caljac)
   {
     njac += 1;
-    deriv_fcn(x,y,dy,user_data);
-    jac_fcn(x, y, dy, user_data);
+    if(parallel)
+    {
+      // each worker evaluates its Jacobian at (x,y) before its columns
+      for(size_t iw = 0; iw < worker_work.size(); ++iw)
+      {
+        worker_work[iw].jac_current = false;
+      }
+    }
+    else
+    {
+      deriv_fcn(x,y,dy,user_data);
+      jac_fcn(x, y, dy, user_data);
+    }
     caljac = true;
   }
 
@@ -305,6 +370,7 @@ g10:
   {
     nstep += 1;
     if (nstep > nmax) goto g120;
+    if(parallel) compute_columns(x, y, k+1, nj);
     for(int j = 0; j <= k; ++j)
     {
       kc = j;
@@ -319,6 +385,7 @@ g10:
 g30:
   nstep += 1;
   if (nstep > nmax) goto g120;
+  if(parallel) compute_columns(x, y, k+1, nj);
   kc = k - 1;
   for(int j = 0; j <= kc; ++j)
   {
@@ -434,7 +501,7 @@ g100:
 //C --- SOLUTION EXIT
 g110:
   h=hopt;
-  destroy_work_vectors();
+  klast = k;
   hmax = hmax_save;
   *x_in = x;
   return 0;
@@ -442,7 +509,7 @@ g110:
 //C --- FAIL EXIT
 g120:
   printf("  EXIT OF SEULEX AT X=%g   H=%g  nstep=%d\n",x,h,nstep);
-  destroy_work_vectors();
+  klast = k;
   hmax = hmax_save;
   *x_in = x;
   return 1;
@@ -459,39 +526,111 @@ int seulex::seul(double x,
              std::vector<int>& nj,
              std::vector<double>& a)
 {
-  int m;
   double fac,facmin,expo;
 //C --- THIS SUBROUTINE COMPUTES THE J-TH LINE OF THE
 //C --- EXTRAPOLATION TABLE AND PROVIDES AN ESTIMATE
 //C --- OF THE OPTIMAL STEP SIZE
+  if(parallel)
+  {
+    // N.B. the column was computed in t[jj] by compute_columns, the
+    // statistics were counted there
+    assert(jj < num_columns_ready);
+    const column_stats& cs = parallel_stats[jj];
+    if(cs.stability_check) theta = cs.theta;
+    if(cs.flag != 0) goto g79;
+  }
+  else
+  {
+    column_stats cs;
+    int flag = seul_column(x, y, jj, nj, user_data, serial_work, cs, t[jj]);
+    nfcn += cs.nfcn;
+    ndec += cs.ndec;
+    nsol += cs.nsol;
+    if(cs.stability_check) theta = cs.theta;
+    if(flag != 0) goto g79;
+  }
+  //DEBUG N_VPrint_Serial(t[jj]);
+//C *** *** *** *** *** *** ***
+//C --- POLYNOMIAL EXTRAPOLATION
+//C *** *** *** *** *** *** ***
+  if(jj==0) return 0;
+  for(int l = jj; l > 0; --l)
+  {
+     //N.B. OpenFOAM implementation uses a table
+     double fac=((double) nj[jj])/((double)nj[l-1])-1.0;
+     fac = 1.0/fac;
+     N_VLinearSum(1.0,t[l],-1.0,t[l-1],t[l-1]);
+     N_VLinearSum(1.0,t[l],fac,t[l-1],t[l-1]);
+  }
+  err = 0.0;
+  N_VLinearSum(1.0, t[0], -1.0, t[1], wh); //USING wh for temp storage here
+  N_VAbs(wh,wh);
+  err = N_VWrmsNorm(scal,wh);
+  if(isnan(err)) goto g79;
+  if(err < 0.0) goto g79;
+  if (err > 1.0e15) goto g79;
+  if (jj > 1 && err >= errold) goto g79;
+  errold = std::max(4*err,1.0);
+//C --- COMPUTE OPTIMAL STEP SIZES
+  expo=1.0/(jj+1);
+  facmin=pow(fac1,expo);
+  fac=std::min(fac2/facmin,std::max(facmin,pow((err/safe1),expo)/safe2));
+  fac=1.0/fac;
+  hh[jj]=std::min(fabs(h)*fac,hmax);
+  w[jj]=a[jj]/hh[jj];
+  return 0;
+g79:
+  atov=true;
+  h=h*0.5;
+  reject=true;
+  return 1;
+};
+
+// Computes the linearly implicit Euler sequence of column jj in tj with the
+// user data and work vectors of one worker. The step size is the member h,
+// which is not changed. Returns non-zero if the sequence failed.
+int seulex::seul_column(double x,
+                        N_Vector y,
+                        int jj,
+                        const std::vector<int>& nj,
+                        void* data,
+                        column_work& cw,
+                        column_stats& cs,
+                        N_Vector tj)
+{
+  int m;
+  cs.flag = 1;
+  cs.nfcn = 0;
+  cs.ndec = 0;
+  cs.nsol = 0;
+  cs.stability_check = false;
+  cs.theta = 0.0;
   double hj=h/nj[jj];
   double hji=1.0/hj;
 //C *** *** *** *** *** *** ***
 //C  COMPUTE THE MATRIX E AND ITS DECOMPOSITION
 //C *** *** *** *** *** *** ***
-  int ier = jac_decomp_fcn(hj,user_data);
-  ndec += 1;
+  int ier = jac_decomp_fcn(hj,data);
+  cs.ndec += 1;
   if(ier != 0)
   {
 //    printf("jac_decomp_fcn ier=%d\n",ier);
-    goto g79;
+    return 1;
   }
 //C *** *** *** *** *** *** ***
 //C --- STARTING PROCEDURE
 //C *** *** *** *** *** *** ***
-  ier = deriv_fcn(x+hj,y,dy,user_data);
-  nfcn += 1;
-  if(ier != 0) goto g79;
-  N_VScale(1.0,y,yh);
-  N_VScale(1.0,dy,del);
-  //printf("nstep, nreject, njac, ndec, nsol, jj, hji, thet, theta = %d, %d, %d, %d, %d, %d, %g, %g, %g\n",
-  //       nstep,nreject,njac,ndec,nsol,jj,hji,thet,theta);
+  ier = deriv_fcn(x+hj,y,cw.dy,data);
+  cs.nfcn += 1;
+  if(ier != 0) return 1;
+  N_VScale(1.0,y,cw.yh);
+  N_VScale(1.0,cw.dy,cw.del);
   //DEBUG N_VPrint_Serial(del);
-  jac_solve_fcn(x, y, dy, del, tmp1, user_data);
-  N_VScale(1.0, tmp1, del);
-  N_VScale(hj,del,del);
+  jac_solve_fcn(x, y, cw.dy, cw.del, cw.tmp1, data);
+  N_VScale(1.0, cw.tmp1, cw.del);
+  N_VScale(hj,cw.del,cw.del);
 
-  nsol += 1;
+  cs.nsol += 1;
   m=nj[jj];
 
 
@@ -502,40 +641,41 @@ int seulex::seul(double x,
   {
     for(int mm = 1; mm < m; ++mm)
     {
-      N_VLinearSum(1.0,yh,1.0,del,yh);
+      N_VLinearSum(1.0,cw.yh,1.0,cw.del,cw.yh);
 
-      ier = deriv_fcn(x+hj*(mm+1),yh,dyh,user_data);
-      nfcn+=1;
-      if(ier != 0) goto g79;
+      ier = deriv_fcn(x+hj*(mm+1),cw.yh,cw.dyh,data);
+      cs.nfcn+=1;
+      if(ier != 0) return 1;
       if (mm == 1 && jj <= 1) //mm 1-based; jj 0-based
       {
 //C --- STABILITY CHECK
-         double del1 = N_VWL2Norm(del,scal);
-         if(isnan(del1)) goto g79;
-         ier = deriv_fcn(x+hj,yh,wh,user_data);
-         nfcn+=1;
-         if(ier != 0) goto g79;
-         N_VLinearSum(1.0,wh,-hji,del,del);
-         jac_solve_fcn(x+hj, yh, wh, del, tmp1, user_data);
-         N_VScale(1.0, tmp1, del);
-         N_VScale(hj,del,del);
-         nsol+=1;
-
-         double max_del = N_VMaxNorm(del);
-         if(max_del > 1e15) goto g79;
-
-         double del2 = N_VWL2Norm(del,scal);
-         if(isnan(del2)) goto g79;
-         theta=del2/std::max(1.0,del1);
+         double del1 = N_VWL2Norm(cw.del,scal);
+         if(isnan(del1)) return 1;
+         ier = deriv_fcn(x+hj,cw.yh,cw.wh,data);
+         cs.nfcn+=1;
+         if(ier != 0) return 1;
+         N_VLinearSum(1.0,cw.wh,-hji,cw.del,cw.del);
+         jac_solve_fcn(x+hj, cw.yh, cw.wh, cw.del, cw.tmp1, data);
+         N_VScale(1.0, cw.tmp1, cw.del);
+         N_VScale(hj,cw.del,cw.del);
+         cs.nsol+=1;
+
+         double max_del = N_VMaxNorm(cw.del);
+         if(max_del > 1e15) return 1;
+
+         double del2 = N_VWL2Norm(cw.del,scal);
+         if(isnan(del2)) return 1;
+         cs.stability_check = true;
+         cs.theta=del2/std::max(1.0,del1);
          //theta=del2/std::min(1.0,del1+1.0e-30);
-         if (theta > 1.0) goto g79;
+         if (cs.theta > 1.0) return 1;
       }
       //N_VScale(hj,dyh,dyh);
-      jac_solve_fcn(x+hj*(mm+1), yh, dyh, dyh, tmp1, user_data);
-      N_VScale(1.0, tmp1, dyh);
-      N_VScale(hj,dyh,dyh);
-      nsol+=1;
-      N_VScale(1.0,dyh,del);
+      jac_solve_fcn(x+hj*(mm+1), cw.yh, cw.dyh, cw.dyh, cw.tmp1, data);
+      N_VScale(1.0, cw.tmp1, cw.dyh);
+      N_VScale(hj,cw.dyh,cw.dyh);
+      cs.nsol+=1;
+      N_VScale(1.0,cw.dyh,cw.del);
 //      IF (IOUT.EQ.2.AND.MM.GE.M-JJ) THEN
 //        IPT=IPT+1
 //        DO I=1,NRD
@@ -544,43 +684,90 @@ int seulex::seul(double x,
 //      END IF
     }
   }
-  N_VLinearSum(1.0,yh,1.0,del,t[jj]);
-  //DEBUG N_VPrint_Serial(t[jj]);
-//C *** *** *** *** *** *** ***
-//C --- POLYNOMIAL EXTRAPOLATION
-//C *** *** *** *** *** *** ***
-  if(jj==0) return 0;
-  for(int l = jj; l > 0; --l)
+  N_VLinearSum(1.0,cw.yh,1.0,cw.del,tj);
+  cs.flag = 0;
+  return 0;
+}
+
+// Computes the columns 0 to kmax of the step from (x,y) with step size h in
+// t[0] to t[kmax], the raw linearly implicit Euler results that seul()
+// extrapolates in order. The columns the step control does not use are
+// discarded.
+void seulex::compute_columns(double x,
+                             N_Vector y,
+                             int kmax,
+                             const std::vector<int>& nj)
+{
+  const int num_columns = kmax+1;
+  const int num_workers = worker_user_data.size();
+  schedule_columns(num_columns, nj, &worker_columns);
+  parallel_stats.resize(km+1);
+
+#ifdef USE_OMP
+#pragma omp parallel for num_threads(num_workers) schedule(static,1)
+#endif
+  for(int iw = 0; iw < num_workers; ++iw)
   {
-     //N.B. OpenFOAM implementation uses a table
-     double fac=((double) nj[jj])/((double)nj[l-1])-1.0;
-     fac = 1.0/fac;
-     N_VLinearSum(1.0,t[l],-1.0,t[l-1],t[l-1]);
-     N_VLinearSum(1.0,t[l],fac,t[l-1],t[l-1]);
+    column_work& cw = worker_work[iw];
+    void* data = worker_user_data[iw];
+    N_VScale(1.0,y,cw.y);
+    if(!cw.jac_current)
+    {
+      deriv_fcn(x,cw.y,cw.dy,data);
+      jac_fcn(x,cw.y,cw.dy,data);
+      cw.jac_current = true;
+    }
+    for(size_t c = 0; c < worker_columns[iw].size(); ++c)
+    {
+      const int jj = worker_columns[iw][c];
+      seul_column(x, cw.y, jj, nj, data, cw, parallel_stats[jj], t[jj]);
+    }
   }
-  err = 0.0;
-  N_VLinearSum(1.0, t[0], -1.0, t[1], wh); //USING wh for temp storage here
-  N_VAbs(wh,wh);
-  err = N_VWrmsNorm(scal,wh);
-  if(isnan(err)) goto g79;
-  if(err < 0.0) goto g79;
-  if (err > 1.0e15) goto g79;
-  if (jj > 1 && err >= errold) goto g79;
-  errold = std::max(4*err,1.0);
-//C --- COMPUTE OPTIMAL STEP SIZES
-  expo=1.0/(jj+1);
-  facmin=pow(fac1,expo);
-  fac=std::min(fac2/facmin,std::max(facmin,pow((err/safe1),expo)/safe2));
-  fac=1.0/fac;
-  hh[jj]=std::min(fabs(h)*fac,hmax);
-  w[jj]=a[jj]/hh[jj];
-  return 0;
-g79:
-  atov=true;
-  h=h*0.5;
-  reject=true;
-  return 1;
-};
+  for(int jj = 0; jj < num_columns; ++jj)
+  {
+    nfcn += parallel_stats[jj].nfcn;
+    ndec += parallel_stats[jj].ndec;
+    nsol += parallel_stats[jj].nsol;
+  }
+  num_columns_ready = num_columns;
+}
+
+// Assigns the columns 0 to num_columns-1 to the workers, longest column
+// first to the least loaded worker, and returns the largest worker cost.
+double seulex::schedule_columns(int num_columns,
+                                const std::vector<int>& nj,
+                                std::vector<std::vector<int> >* columns)
+{
+  // The scratch arrays are sized in create_work_vectors, the column lists
+  // keep their capacity between steps
+  const int num_workers = std::max((int)worker_user_data.size(),1);
+  std::vector<int>::iterator order_end = schedule_order.begin()+num_columns;
+  std::vector<double>::iterator load_end = schedule_load.begin()+num_workers;
+  for(int j = 0; j < num_columns; ++j)
+  {
+    schedule_order[j] = j;
+  }
+  std::stable_sort(schedule_order.begin(), order_end,
+                   [&nj](int j1, int j2) { return nj[j1] > nj[j2]; });
+  std::fill(schedule_load.begin(), load_end, 0.0);
+  columns->resize(num_workers);
+  for(int iw = 0; iw < num_workers; ++iw)
+  {
+    (*columns)[iw].clear();
+  }
+  for(int j = 0; j < num_columns; ++j)
+  {
+    int iw = std::min_element(schedule_load.begin(),load_end) -
+             schedule_load.begin();
+    schedule_load[iw] += nj[schedule_order[j]]*wkrow+wkdec;
+    (*columns)[iw].push_back(schedule_order[j]);
+  }
+  for(int iw = 0; iw < num_workers; ++iw)
+  {
+    std::sort((*columns)[iw].begin(), (*columns)[iw].end());
+  }
+  return *std::max_element(schedule_load.begin(),load_end);
+}
 
 void seulex::setup_step_sequence(std::vector<int>& nj, std::vector<double>& a)
 {
@@ -623,10 +810,21 @@ void seulex::setup_step_sequence(std::vector<int>& nj, std::vector<double>& a)
   {
     a[i]=a[i-1]+(nj[i]-1)*wkrow+wkdec;
   }
+  if(parallel)
+  {
+    // the columns 0 to i+1 of a step of order i are computed concurrently,
+    // so the work is the largest worker cost
+    for(int i = 0; i <= km; ++i)
+    {
+      a[i]=wkjac+schedule_columns(std::min(i+2,km+1), nj, &worker_columns);
+    }
+  }
 }
 
 void seulex::create_work_vectors(N_Vector y)
 {
+  if(work_vectors_allocated && (int)t.size() == km+1) return;
+  destroy_work_vectors();
   yh = N_VClone(y);
   dy = N_VClone(y);
   dyh = N_VClone(y);
@@ -639,10 +837,43 @@ void seulex::create_work_vectors(N_Vector y)
   {
     t[i] = N_VClone(y);
   }
+  hh.assign(km+1,0.0);
+  w.assign(km+1,0.0);
+  a.assign(km+1,0.0);
+  nj.assign(km+1,0);
+  schedule_order.assign(km+1,0);
+  schedule_load.assign(std::max((int)worker_user_data.size(),1),0.0);
+  worker_columns.assign(schedule_load.size(),std::vector<int>());
+  serial_work.yh = yh;
+  serial_work.dy = dy;
+  serial_work.dyh = dyh;
+  serial_work.del = del;
+  serial_work.wh = wh;
+  serial_work.tmp1 = tmp1;
+  serial_work.y = NULL;
+  serial_work.jac_current = false;
+  if(parallel)
+  {
+    worker_work.resize(worker_user_data.size());
+    for(size_t iw = 0; iw < worker_work.size(); ++iw)
+    {
+      worker_work[iw].yh = N_VClone(y);
+      worker_work[iw].dy = N_VClone(y);
+      worker_work[iw].dyh = N_VClone(y);
+      worker_work[iw].del = N_VClone(y);
+      worker_work[iw].wh = N_VClone(y);
+      worker_work[iw].tmp1 = N_VClone(y);
+      worker_work[iw].y = N_VClone(y);
+      worker_work[iw].jac_current = false;
+    }
+  }
+  num_columns_ready = 0;
+  work_vectors_allocated = true;
 }
 
 void seulex::destroy_work_vectors()
 {
+  if(!work_vectors_allocated) return;
   N_VDestroy(yh);
   N_VDestroy(dy);
   N_VDestroy(dyh);
@@ -650,10 +881,23 @@ void seulex::destroy_work_vectors()
   N_VDestroy(wh);
   N_VDestroy(scal);
   N_VDestroy(tmp1);
-  for(int i = 0; i <= km; ++i)
+  for(size_t i = 0; i < t.size(); ++i)
   {
     N_VDestroy(t[i]);
   }
+  t.clear();
+  for(size_t iw = 0; iw < worker_work.size(); ++iw)
+  {
+    N_VDestroy(worker_work[iw].yh);
+    N_VDestroy(worker_work[iw].dy);
+    N_VDestroy(worker_work[iw].dyh);
+    N_VDestroy(worker_work[iw].del);
+    N_VDestroy(worker_work[iw].wh);
+    N_VDestroy(worker_work[iw].tmp1);
+    N_VDestroy(worker_work[iw].y);
+  }
+  worker_work.clear();
+  work_vectors_allocated = false;
 }
 
 } //end namespace seulex_cpp
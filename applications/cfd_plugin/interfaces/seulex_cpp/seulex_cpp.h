@@ -18,6 +18,11 @@ class seulex {
   seulex(int, N_Vector);
   virtual ~seulex();
 
+  // Sets the system size for the next solve. The work vectors are kept
+  // between solves and are only allocated again when the size changes, so
+  // one solver can be reused for many problems.
+  void resize(int, N_Vector);
+
   void set_nmax(int);
   void set_km(int);
   void set_nsequ(int);
@@ -25,6 +30,9 @@ class seulex {
   void set_nrdens(int);
   void set_uround(double);
   void set_hinit(double);
+  // Initial order (column) of the next solve, e.g. the last order of a
+  // previous solve. With 0 the order is chosen from the tolerances.
+  void set_kinit(int);
   void set_hmax(double);
   void set_thet(double);
   void set_step_size_params(double,double);
@@ -42,9 +50,23 @@ class seulex {
   void set_jac_solve_fcn(seul_jac_solve_fcn);
   void set_output_fcn(seul_output_fcn, void*);
   void set_user_data(void*);
+  // Parallel extrapolation. The columns of the extrapolation tableau are
+  // linearly implicit Euler sequences from the same state and Jacobian, so
+  // they are computed concurrently, one worker per entry of
+  // worker_user_data. A worker's user data is passed to the deriv, jac,
+  // jac_decomp and jac_solve functions of its columns, and must have its
+  // own derivative, Jacobian and factorization workspace. The columns are
+  // assigned to the workers by their cost. The columns 0 to k+1 of a step
+  // of order k are computed at once and extrapolated in order by the serial
+  // step control, so a step gives the same result as the serial solve. The
+  // order selection uses the parallel (longest worker) work of a step.
+  void set_parallel_user_data(const std::vector<void*>& worker_user_data);
   int solve(double* x_in, double xend, N_Vector y);
   void get_integrator_stats(int* nfcn,int* njac,int* nstep,
                             int* naccpt,int* nrejct,int* ndec,int* nsol);
+  // Predicted step size and order after the last accepted step of a solve,
+  // for a warm start of a following solve with set_hinit and set_kinit
+  void get_last_step(double* h, int* k);
  private:
   int n;
   int nfcn;
@@ -58,6 +80,9 @@ class seulex {
   int nmax;
 // -------- KM     MAXIMUM NUMBER OF COLUMNS IN THE EXTRAPOLATION
   int km;
+// -------- KINIT  INITIAL ORDER, KLAST LAST ORDER OF A SOLVE
+  int kinit;
+  int klast;
 // -------- NSEQU     CHOICE OF STEP SIZE SEQUENCE
   int nsequ;
 // -------- LAMBDA   PARAMETER FOR DENSE OUTPUT
@@ -108,6 +133,33 @@ class seulex {
            std::vector<double>& hh, std::vector<double>& w,
            std::vector<int>& nj, std::vector<double>& a);
 
+// Work vectors and statistics of the linearly implicit Euler sequence of
+// one tableau column
+  struct column_work {
+    N_Vector yh;
+    N_Vector dy;
+    N_Vector dyh;
+    N_Vector del;
+    N_Vector wh;
+    N_Vector tmp1;
+    N_Vector y;    // copy of the step start (parallel workers only)
+    bool jac_current;
+  };
+  struct column_stats {
+    int flag;
+    int nfcn;
+    int ndec;
+    int nsol;
+    bool stability_check;
+    double theta;
+  };
+  int seul_column(double x, N_Vector y, int jj, const std::vector<int>& nj,
+                  void* data, column_work& cw, column_stats& cs, N_Vector tj);
+  void compute_columns(double x, N_Vector y, int kmax,
+                       const std::vector<int>& nj);
+  double schedule_columns(int num_columns, const std::vector<int>& nj,
+                          std::vector<std::vector<int> >* worker_columns);
+
 // Work arrays
   N_Vector yh;
   N_Vector dy;
@@ -117,6 +169,22 @@ class seulex {
   N_Vector scal;
   N_Vector tmp1;
   std::vector<N_Vector> t;
+  column_work serial_work;
+  std::vector<double> hh;  // step size of each order
+  std::vector<double> w;   // work per unit step of each order
+  std::vector<double> a;   // work of a step of each order
+  std::vector<int> nj;     // step sequence
+  bool work_vectors_allocated;
+
+// Parallel extrapolation
+  bool parallel;
+  std::vector<void*> worker_user_data;
+  std::vector<column_work> worker_work;
+  std::vector<std::vector<int> > worker_columns;
+  std::vector<int> schedule_order;
+  std::vector<double> schedule_load;
+  std::vector<column_stats> parallel_stats;
+  int num_columns_ready;
 
   seul_deriv_fcn deriv_fcn;
   seul_jac_fcn jac_fcn;
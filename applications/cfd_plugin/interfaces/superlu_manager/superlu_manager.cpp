@@ -87,7 +87,11 @@ int superlu_manager::factor(int n,
 
   m_B.ncol=0;
   m_options.Fact=DOFACT;
-  get_perm_c(MMD_AT_PLUS_A, &m_M, &m_colPermutation[0]);
+  if(static_cast<int>(m_userColPermutation.size()) == n) {
+    m_colPermutation = m_userColPermutation;
+  } else {
+    get_perm_c(MMD_AT_PLUS_A, &m_M, &m_colPermutation[0]);
+  }
 
   int lwork=0;      // SuperLU allocates its own memeory
   void *work=NULL;  // ''
@@ -376,6 +380,11 @@ void superlu_manager::SetTranspose(const bool transpose)
   }
 }
 
+void superlu_manager::SetColumnPermutation(const std::vector<int>& perm_c)
+{
+  m_userColPermutation = perm_c;
+}
+
 void superlu_manager::reset()
 {
   m_last_factor_nnz = -1;
@@ -26,6 +26,11 @@ class superlu_manager
 
   void SetTranspose(const bool transpose);
 
+  // Column permutation (SuperLU perm_c) used by the following full
+  // factorizations of n x n matrices. Other sizes and an empty permutation
+  // fall back to the MMD_AT_PLUS_A ordering of the matrix being factored.
+  void SetColumnPermutation(const std::vector<int>& perm_c);
+
   int GetLU(int* L_nnz,
             std::vector<int>* L_sums,
             std::vector<int>* L_indexes,
@@ -58,6 +63,7 @@ class superlu_manager
   std::vector<int> m_rowPermutation;
   std::vector<int> m_colPermutation;
   std::vector<int> m_colElimTree; // etree
+  std::vector<int> m_userColPermutation;
 
   bool m_factored;
   int m_last_factor_n;
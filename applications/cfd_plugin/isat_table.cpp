@@ -0,0 +1,182 @@
+#include <math.h>
+
+#include "isat_table.h"
+
+IsatTable::IsatTable(const int num_key,
+                     const int num_output,
+                     const std::vector<double>& scale,
+                     const double tolerance,
+                     const double max_radius,
+                     const size_t max_bytes,
+                     const int max_search)
+  :
+    num_key_(num_key),
+    num_output_(num_output),
+    scale_(scale),
+    tolerance_(tolerance),
+    max_radius_(max_radius),
+    max_search_(max_search)
+{
+  // The outputs are the leading key variables and share their scales
+  bytes_per_record_ = sizeof(IsatRecord) +
+    sizeof(double)*(num_key_ + num_output_ +
+                    num_output_*num_key_ + num_key_*num_key_);
+  max_records_ = (int)(max_bytes/bytes_per_record_);
+  ds_.assign(num_key_, 0.0);
+  mds_.assign(num_key_, 0.0);
+  Clear();
+}
+
+void IsatTable::Clear()
+{
+  records_.clear();
+  have_nearest_ = false;
+  num_queries_ = 0;
+  num_retrieves_ = 0;
+  num_grows_ = 0;
+  num_adds_ = 0;
+  num_evictions_ = 0;
+}
+
+double IsatTable::EoaDistance(const IsatRecord& record, const double* x)
+{
+  for(int j = 0; j < num_key_; ++j) {
+    ds_[j] = (x[j] - record.x[j])/scale_[j];
+  }
+  double distance = 0.0;
+  for(int j = 0; j < num_key_; ++j) {
+    double sum = 0.0;
+    const double* eoa_row = &record.eoa[j*num_key_];
+    for(int k = 0; k < num_key_; ++k) {
+      sum += eoa_row[k]*ds_[k];
+    }
+    mds_[j] = sum;
+    distance += ds_[j]*sum;
+  }
+  return distance;
+}
+
+void IsatTable::LinearApproximation(const IsatRecord& record,
+                                    const double* x,
+                                    double* output)
+{
+  for(int i = 0; i < num_output_; ++i) {
+    double sum = record.output[i];
+    const double* gradient_row = &record.gradient[i*num_key_];
+    for(int j = 0; j < num_key_; ++j) {
+      sum += gradient_row[j]*(x[j] - record.x[j]);
+    }
+    output[i] = sum;
+  }
+}
+
+bool IsatTable::Retrieve(const double dt, const double* x, double* output)
+{
+  ++num_queries_;
+  have_nearest_ = false;
+  double min_distance = 1.0e300;
+  int num_searched = 0;
+  std::list<IsatRecord>::iterator it = records_.begin();
+  for(; it != records_.end() && num_searched < max_search_; ++it) {
+    if(fabs(it->dt - dt) > 1.0e-12*dt) {
+      continue;
+    }
+    ++num_searched;
+    const double distance = EoaDistance(*it, x);
+    if(distance <= 1.0) {
+      LinearApproximation(*it, x, output);
+      records_.splice(records_.begin(), records_, it);
+      ++num_retrieves_;
+      return true;
+    }
+    if(distance < min_distance) {
+      min_distance = distance;
+      nearest_ = it;
+      have_nearest_ = true;
+    }
+  }
+  return false;
+}
+
+bool IsatTable::Grow(const double dt, const double* x, const double* output)
+{
+  if(!have_nearest_ || fabs(nearest_->dt - dt) > 1.0e-12*dt) {
+    return false;
+  }
+  std::vector<double> approximation(num_output_);
+  LinearApproximation(*nearest_, x, &approximation[0]);
+  double error = 0.0;
+  for(int i = 0; i < num_output_; ++i) {
+    const double scaled_error = (approximation[i] - output[i])/scale_[i];
+    error += scaled_error*scaled_error;
+  }
+  if(sqrt(error) > tolerance_) {
+    return false;
+  }
+
+  // Minimal rank one update of M so that x lies on the new EOA boundary.
+  // In the coordinates where the old EOA is the unit ball the EOA is only
+  // stretched in the direction of x, so it still contains the old one.
+  const double distance = EoaDistance(*nearest_, x);
+  if(distance > 1.0) {
+    const double factor = (1.0 - distance)/(distance*distance);
+    for(int j = 0; j < num_key_; ++j) {
+      double* eoa_row = &nearest_->eoa[j*num_key_];
+      for(int k = 0; k < num_key_; ++k) {
+        eoa_row[k] += factor*mds_[j]*mds_[k];
+      }
+    }
+  }
+  records_.splice(records_.begin(), records_, nearest_);
+  have_nearest_ = false;
+  ++num_grows_;
+  return true;
+}
+
+void IsatTable::Add(const double dt,
+                    const double* x,
+                    const double* output,
+                    const std::vector<double>& gradient)
+{
+  have_nearest_ = false;
+  if(max_records_ <= 0) {
+    return;
+  }
+  if((int)records_.size() >= max_records_) {
+    records_.pop_back();
+    ++num_evictions_;
+  }
+
+  IsatRecord record;
+  record.dt = dt;
+  record.x.assign(x, x+num_key_);
+  record.output.assign(output, output+num_output_);
+  record.gradient = gradient;
+
+  // Initial EOA from the scaled gradient, |A_hat ds| <= tolerance, with the
+  // semi-axes limited to max_radius in directions the mapping does not
+  // depend on
+  const double inv_tol2 = 1.0/(tolerance_*tolerance_);
+  std::vector<double> scaled_gradient(num_output_*num_key_);
+  for(int i = 0; i < num_output_; ++i) {
+    for(int j = 0; j < num_key_; ++j) {
+      scaled_gradient[i*num_key_+j] =
+        gradient[i*num_key_+j]*scale_[j]/scale_[i];
+    }
+  }
+  record.eoa.assign(num_key_*num_key_, 0.0);
+  for(int j = 0; j < num_key_; ++j) {
+    for(int k = j; k < num_key_; ++k) {
+      double sum = 0.0;
+      for(int i = 0; i < num_output_; ++i) {
+        sum += scaled_gradient[i*num_key_+j]*scaled_gradient[i*num_key_+k];
+      }
+      record.eoa[j*num_key_+k] = sum*inv_tol2;
+      record.eoa[k*num_key_+j] = sum*inv_tol2;
+    }
+    record.eoa[j*num_key_+j] += 1.0/(max_radius_*max_radius_);
+  }
+
+  records_.push_front(record);
+  ++num_adds_;
+}
@@ -0,0 +1,95 @@
+#ifndef ISAT_TABLE_H_
+#define ISAT_TABLE_H_
+
+#include <list>
+#include <vector>
+
+// In-situ adaptive tabulation (ISAT) of reactor mappings.
+//
+// Each record stores a query point x0 (the reactor state at the start of the
+// step plus any extra key variables), the mapping R(x0) (the state at the
+// end of the step), the mapping gradient A = dR/dx and an ellipsoid of
+// accuracy (EOA) {x : (x-x0)^T M (x-x0) <= 1} in scaled coordinates. Queries
+// inside an EOA are answered by the linear approximation R(x0) + A (x-x0).
+// Queries outside all EOAs are integrated by the caller. If the linear
+// approximation from the nearest record is still within tolerance, that
+// record's EOA is grown to include the query. Otherwise a new record is
+// added. Records are kept in most recently used order, and the least
+// recently used record is evicted once the memory limit is reached.
+class IsatTable
+{
+ public:
+  IsatTable(const int num_key,
+            const int num_output,
+            const std::vector<double>& scale,
+            const double tolerance,
+            const double max_radius,
+            const size_t max_bytes,
+            const int max_search);
+
+  // Returns true and sets output if x lies inside the EOA of a record made
+  // with the same step size. On a miss the nearest record that was checked
+  // is remembered for Grow().
+  bool Retrieve(const double dt, const double* x, double* output);
+
+  // Try to grow the EOA of the nearest record of the last Retrieve() to
+  // include x, given the integrated output at x. Returns false when the
+  // linear approximation is not accurate enough and a record must be added.
+  bool Grow(const double dt, const double* x, const double* output);
+
+  // Add a record. gradient is the num_output x num_key mapping gradient,
+  // stored row major.
+  void Add(const double dt,
+           const double* x,
+           const double* output,
+           const std::vector<double>& gradient);
+
+  void Clear();
+
+  int num_records() const {return (int)records_.size();}
+  int max_records() const {return max_records_;}
+  size_t bytes_per_record() const {return bytes_per_record_;}
+  long int num_queries() const {return num_queries_;}
+  long int num_retrieves() const {return num_retrieves_;}
+  long int num_grows() const {return num_grows_;}
+  long int num_adds() const {return num_adds_;}
+  long int num_evictions() const {return num_evictions_;}
+
+ private:
+  struct IsatRecord {
+    double dt;
+    std::vector<double> x;
+    std::vector<double> output;
+    std::vector<double> gradient;
+    std::vector<double> eoa;
+  };
+
+  double EoaDistance(const IsatRecord& record, const double* x);
+  void LinearApproximation(const IsatRecord& record,
+                           const double* x,
+                           double* output);
+
+  int num_key_;
+  int num_output_;
+  std::vector<double> scale_;
+  double tolerance_;
+  double max_radius_;
+  size_t bytes_per_record_;
+  int max_records_;
+  int max_search_;
+
+  std::list<IsatRecord> records_;
+  std::list<IsatRecord>::iterator nearest_;
+  bool have_nearest_;
+
+  std::vector<double> ds_;  // scaled query displacement
+  std::vector<double> mds_; // M*ds
+
+  long int num_queries_;
+  long int num_retrieves_;
+  long int num_grows_;
+  long int num_adds_;
+  long int num_evictions_;
+};
+
+#endif
@@ -66,6 +66,10 @@ class ReactorBase : public Optionable {
   virtual int JacobianSolve(double t, N_Vector y, N_Vector fy,
                             N_Vector r, N_Vector z) = 0;
 
+  // Jv = J*v with the Jacobian of the last JacobianSetup, for the Krylov
+  // integrators. Returns non-zero if the reactor does not support it.
+  virtual int JacobianVectorProduct(N_Vector v, N_Vector Jv) { return 1; };
+
   virtual int RootFunction(double t, N_Vector y, double *root_function) = 0;
 
   virtual int SetRootTime(double t) = 0;
@@ -81,6 +85,12 @@ class ReactorBase : public Optionable {
 
   virtual void SetSolveTemperature(bool value) = 0;
 
+  // Dynamic adaptive chemistry. Reactors that integrate a reduced set of
+  // active species return false if the frozen species would have changed
+  // by more than the consistency tolerance over the step.
+  virtual bool CheckActiveSpecies(const double reactor_time) { return true; };
+  virtual int GetNumActiveSpecies() { return num_species_; };
+
   virtual void Reset() {};
 
  protected:
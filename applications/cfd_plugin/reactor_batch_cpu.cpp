@@ -0,0 +1,394 @@
+#include <algorithm> //std::min
+
+#include "reactor_batch_cpu.h"
+#include "reactor_constant_pressure_cpu.h"
+#include "reactor_constant_volume_cpu.h"
+
+#include "nvector/nvector_serial.h"
+
+ReactorBatchCPU::ReactorBatchCPU(std::shared_ptr<zerork::mechanism> mech_ptr,
+                                 bool constant_volume,
+                                 int max_num_reactors)
+  :
+    ReactorBase(),
+    mech_ptr_(mech_ptr),
+    max_num_reactors_(max_num_reactors)
+{
+  num_species_ = mech_ptr_->getNumSpecies();
+  num_variables_ = num_species_ + 1;
+  num_steps_ = mech_ptr_->getNumSteps();
+  num_reactors_ = max_num_reactors_;
+  mech_ptr_->getJacobianOrdering(&jacobian_ordering_);
+  block_ordering_reactors_ = 0;
+  block_ordering_variables_ = 0;
+
+  for(int k = 0; k < max_num_reactors_; ++k) {
+    if(constant_volume) {
+      reactors_.push_back(std::make_unique<ReactorConstantVolumeCPU>(mech_ptr_));
+    } else {
+      reactors_.push_back(std::make_unique<ReactorConstantPressureCPU>(mech_ptr_));
+    }
+  }
+
+  state_data_.assign(num_variables_*max_num_reactors_, 0.0);
+  state_ = N_VMake_Serial(num_variables_*num_reactors_, &state_data_[0]);
+  weights_.assign(max_num_reactors_, 1.0);
+  mass_fractions_.assign(num_species_, 0.0);
+  root_found_.assign(max_num_reactors_, 0);
+  root_times_.assign(max_num_reactors_, 0.0);
+  CreateReactorVectors();
+}
+
+ReactorBatchCPU::~ReactorBatchCPU()
+{
+  N_VDestroy(state_);
+  DestroyReactorVectors();
+}
+
+void ReactorBatchCPU::CreateReactorVectors()
+{
+  reactor_state_ = N_VNew_Serial(num_variables_);
+  reactor_derivative_ = N_VNew_Serial(num_variables_);
+  reactor_rhs_ = N_VNew_Serial(num_variables_);
+  reactor_solution_ = N_VNew_Serial(num_variables_);
+}
+
+void ReactorBatchCPU::DestroyReactorVectors()
+{
+  N_VDestroy(reactor_state_);
+  N_VDestroy(reactor_derivative_);
+  N_VDestroy(reactor_rhs_);
+  N_VDestroy(reactor_solution_);
+}
+
+void ReactorBatchCPU::GatherReactor(int reactor_idx, N_Vector batch, N_Vector reactor)
+{
+  const double* batch_ptr = NV_DATA_S(batch);
+  double* reactor_ptr = NV_DATA_S(reactor);
+  for(int j = 0; j < num_variables_; ++j) {
+    reactor_ptr[j] = batch_ptr[j*num_reactors_ + reactor_idx];
+  }
+}
+
+void ReactorBatchCPU::ScatterReactor(int reactor_idx, N_Vector reactor, N_Vector batch)
+{
+  const double* reactor_ptr = NV_DATA_S(reactor);
+  double* batch_ptr = NV_DATA_S(batch);
+  for(int j = 0; j < num_variables_; ++j) {
+    batch_ptr[j*num_reactors_ + reactor_idx] = reactor_ptr[j];
+  }
+}
+
+void ReactorBatchCPU::InitializeState(
+    const double reactor_time,
+    const int n_reactors,
+    const double *T,
+    const double *P,
+    const double *mf,
+    const double *dpdt,
+    const double *e_src,
+    const double *y_src)
+{
+  assert(n_reactors <= max_num_reactors_);
+  Reset();
+  if(n_reactors != num_reactors_) {
+    num_reactors_ = n_reactors;
+    N_VDestroy(state_);
+    state_ = N_VMake_Serial(num_variables_*num_reactors_, &state_data_[0]);
+  }
+  if(y_src != nullptr) {
+    y_src_.assign(num_species_*num_reactors_, 0.0);
+  }
+
+  for(int k = 0; k < num_reactors_; ++k) {
+    ReactorNVectorSerial* reactor = reactors_[k].get();
+    // Options are not virtual, so the reactors take the batch options here
+    reactor->SetIntOptions(int_options_);
+    reactor->SetDoubleOptions(double_options_);
+    reactor->SetID(id_);
+
+    for(int j = 0; j < num_species_; ++j) {
+      mass_fractions_[j] = mf[j*num_reactors_ + k];
+    }
+    const double* y_src_reactor = nullptr;
+    if(y_src != nullptr) {
+      for(int j = 0; j < num_species_; ++j) {
+        y_src_[k*num_species_ + j] = y_src[j*num_reactors_ + k];
+      }
+      y_src_reactor = &y_src_[k*num_species_];
+    }
+    double dpdt_reactor = dpdt == nullptr ? 0.0 : dpdt[k];
+    double e_src_reactor = e_src == nullptr ? 0.0 : e_src[k];
+    reactor->InitializeState(reactor_time, 1, &T[k], &P[k], &mass_fractions_[0],
+                             &dpdt_reactor, &e_src_reactor, y_src_reactor);
+    ScatterReactor(k, reactor->GetStateNVectorRef(), state_);
+
+    root_found_[k] = 0;
+    root_times_[k] = 0.0;
+  }
+}
+
+void ReactorBatchCPU::GetState(
+    const double reactor_time,
+    double *T,
+    double *P,
+    double *mf)
+{
+  for(int k = 0; k < num_reactors_; ++k) {
+    ReactorNVectorSerial* reactor = reactors_[k].get();
+    GatherReactor(k, state_, reactor->GetStateNVectorRef());
+    reactor->GetState(reactor_time, &T[k], &P[k], &mass_fractions_[0]);
+    for(int j = 0; j < num_species_; ++j) {
+      mf[j*num_reactors_ + k] = mass_fractions_[j];
+    }
+  }
+}
+
+void ReactorBatchCPU::SetBatchMaskNVector(int reactor_idx, N_Vector batch_mask)
+{
+  N_VConst(0.0, batch_mask);
+  double* batch_mask_ptr = NV_DATA_S(batch_mask);
+  for(int j = 0; j < num_variables_; ++j) {
+    batch_mask_ptr[j*num_reactors_ + reactor_idx] = 1.0;
+  }
+}
+
+void ReactorBatchCPU::GetAbsoluteToleranceCorrection(N_Vector correction)
+{
+  for(int k = 0; k < num_reactors_; ++k) {
+    reactors_[k]->GetAbsoluteToleranceCorrection(reactor_solution_);
+    ScatterReactor(k, reactor_solution_, correction);
+  }
+}
+
+int ReactorBatchCPU::GetTimeDerivative(const double reactor_time,
+                                       N_Vector state,
+                                       N_Vector derivative)
+{
+  int flag = 0;
+  for(int k = 0; k < num_reactors_; ++k) {
+    GatherReactor(k, state, reactor_state_);
+    int reactor_flag = reactors_[k]->GetTimeDerivative(reactor_time, reactor_state_,
+                                                       reactor_derivative_);
+    if(reactor_flag != 0) {
+      flag = reactor_flag;
+    }
+    ScatterReactor(k, reactor_derivative_, derivative);
+  }
+  return flag;
+}
+
+void ReactorBatchCPU::SetStepLimiter(double value)
+{
+  for(int k = 0; k < max_num_reactors_; ++k) {
+    reactors_[k]->SetStepLimiter(value);
+  }
+}
+
+void ReactorBatchCPU::SetSolveTemperature(bool value)
+{
+  for(int k = 0; k < max_num_reactors_; ++k) {
+    reactors_[k]->SetSolveTemperature(value);
+  }
+  const int num_variables = reactors_[0]->GetNumStateVariables();
+  if(num_variables != num_variables_) {
+    num_variables_ = num_variables;
+    N_VDestroy(state_);
+    state_ = N_VMake_Serial(num_variables_*num_reactors_, &state_data_[0]);
+    DestroyReactorVectors();
+    CreateReactorVectors();
+    Reset();
+  }
+}
+
+int ReactorBatchCPU::JacobianSetup(double t, N_Vector y, N_Vector fy)
+{
+  int flag = 0;
+  for(int k = 0; k < num_reactors_; ++k) {
+    GatherReactor(k, y, reactor_state_);
+    GatherReactor(k, fy, reactor_derivative_);
+    int reactor_flag = reactors_[k]->JacobianSetup(t, reactor_state_,
+                                                   reactor_derivative_);
+    if(reactor_flag != 0) {
+      flag = reactor_flag;
+    }
+  }
+  return flag;
+}
+
+int ReactorBatchCPU::JacobianFactor(double gamma)
+{
+  int flag = 0;
+  if(int_options_["dense"] == 1) {
+    for(int k = 0; k < num_reactors_; ++k) {
+      int reactor_flag = reactors_[k]->JacobianFactor(gamma);
+      if(reactor_flag != 0) {
+        flag = reactor_flag;
+      }
+    }
+    return flag;
+  }
+
+  const int num_rows = num_variables_*num_reactors_;
+  block_column_sums_.assign(num_rows+1, 0);
+  block_row_indexes_.clear();
+  block_values_.clear();
+  for(int k = 0; k < num_reactors_; ++k) {
+    const std::vector<int>* column_sums;
+    const std::vector<int>* row_indexes;
+    const std::vector<double>* values;
+    reactors_[k]->GetSparsePreconditioner(gamma, &column_sums, &row_indexes, &values);
+    const int offset = k*num_variables_;
+    for(int j = 0; j < num_variables_; ++j) {
+      for(int m = (*column_sums)[j]; m < (*column_sums)[j+1]; ++m) {
+        block_row_indexes_.push_back((*row_indexes)[m] + offset);
+        block_values_.push_back((*values)[m]);
+      }
+      block_column_sums_[offset+j+1] = block_row_indexes_.size();
+    }
+  }
+
+  // Keep the symbolic factorization while the pattern of every block is
+  // unchanged
+  flag = 1;
+  if(slum_.factored() &&
+     block_column_sums_ == last_block_column_sums_ &&
+     block_row_indexes_ == last_block_row_indexes_) {
+    flag = slum_.refactor(block_values_);
+  }
+  if(flag != 0) {
+    if(block_ordering_reactors_ != num_reactors_ ||
+       block_ordering_variables_ != num_variables_) {
+      // Without temperature the last (temperature) column is dropped from
+      // the mechanism ordering
+      block_ordering_.clear();
+      for(int k = 0; k < num_reactors_; ++k) {
+        const int offset = k*num_variables_;
+        for(size_t j = 0; j < jacobian_ordering_.size(); ++j) {
+          if(jacobian_ordering_[j] < num_variables_) {
+            block_ordering_.push_back(jacobian_ordering_[j] + offset);
+          }
+        }
+      }
+      block_ordering_reactors_ = num_reactors_;
+      block_ordering_variables_ = num_variables_;
+      slum_.SetColumnPermutation(block_ordering_);
+    }
+    flag = slum_.factor(block_row_indexes_,
+                        block_column_sums_,
+                        block_values_,
+                        superlu_manager::CSC);
+    last_block_column_sums_ = block_column_sums_;
+    last_block_row_indexes_ = block_row_indexes_;
+  }
+  return flag;
+}
+
+int ReactorBatchCPU::JacobianSolve(double t, N_Vector y, N_Vector fy,
+                                   N_Vector r, N_Vector z)
+{
+  int flag = 0;
+  if(int_options_["dense"] == 1) {
+    for(int k = 0; k < num_reactors_; ++k) {
+      GatherReactor(k, r, reactor_rhs_);
+      int reactor_flag = reactors_[k]->JacobianSolve(t, reactor_state_, reactor_derivative_,
+                                                     reactor_rhs_, reactor_solution_);
+      if(reactor_flag != 0) {
+        flag = reactor_flag;
+      }
+      ScatterReactor(k, reactor_solution_, z);
+    }
+    return flag;
+  }
+
+  const int num_rows = num_variables_*num_reactors_;
+  const double* r_ptr = NV_DATA_S(r);
+  double* z_ptr = NV_DATA_S(z);
+  block_rhs_.resize(num_rows);
+  block_solution_.resize(num_rows);
+  for(int k = 0; k < num_reactors_; ++k) {
+    for(int j = 0; j < num_variables_; ++j) {
+      block_rhs_[k*num_variables_ + j] = r_ptr[j*num_reactors_ + k];
+    }
+  }
+  flag = slum_.solve(num_rows, &block_rhs_[0], &block_solution_[0]);
+  for(int k = 0; k < num_reactors_; ++k) {
+    for(int j = 0; j < num_variables_; ++j) {
+      z_ptr[j*num_reactors_ + k] = block_solution_[k*num_variables_ + j];
+    }
+  }
+  return flag;
+}
+
+int ReactorBatchCPU::JacobianVectorProduct(N_Vector v, N_Vector Jv)
+{
+  int flag = 0;
+  for(int k = 0; k < num_reactors_; ++k) {
+    GatherReactor(k, v, reactor_rhs_);
+    int reactor_flag = reactors_[k]->JacobianVectorProduct(reactor_rhs_,
+                                                           reactor_solution_);
+    if(reactor_flag != 0) {
+      flag = reactor_flag;
+    }
+    ScatterReactor(k, reactor_solution_, Jv);
+  }
+  return flag;
+}
+
+int ReactorBatchCPU::GetNumRootFunctions()
+{
+  if(double_options_["delta_temperature_ignition"] > 0) {
+    return num_reactors_;
+  } else {
+    return 0;
+  }
+}
+
+int ReactorBatchCPU::RootFunction(double t, N_Vector y, double *root_function)
+{
+  for(int k = 0; k < num_reactors_; ++k) {
+    if(root_found_[k]) {
+      root_function[k] = -1.0;
+    } else {
+      GatherReactor(k, y, reactor_state_);
+      reactors_[k]->RootFunction(t, reactor_state_, &root_function[k]);
+    }
+  }
+  return 0;
+}
+
+int ReactorBatchCPU::SetRootTime(double t)
+{
+  // Called at a root of the batch with the state at t. Every reactor that
+  // has passed its ignition temperature by t is assigned the root time.
+  double root_function = 0.0;
+  for(int k = 0; k < num_reactors_; ++k) {
+    if(root_found_[k]) continue;
+    GatherReactor(k, state_, reactor_state_);
+    reactors_[k]->RootFunction(t, reactor_state_, &root_function);
+    if(root_function <= 0.0) {
+      root_found_[k] = 1;
+      root_times_[k] = t;
+      reactors_[k]->SetRootTime(t);
+    }
+  }
+  return 0;
+}
+
+double ReactorBatchCPU::GetRootTime()
+{
+  double root_time = 0.0;
+  for(int k = 0; k < num_reactors_; ++k) {
+    if(root_found_[k] && (root_time == 0.0 || root_times_[k] < root_time)) {
+      root_time = root_times_[k];
+    }
+  }
+  return root_time;
+}
+
+void ReactorBatchCPU::Reset()
+{
+  slum_.reset();
+  last_block_column_sums_.clear();
+  last_block_row_indexes_.clear();
+}
@@ -0,0 +1,139 @@
+#ifndef REACTOR_BATCH_CPU_H
+#define REACTOR_BATCH_CPU_H
+
+#include <memory>
+#include "reactor_nvector_serial.h"
+
+// Batch of CPU reactors integrated as one system (cpu_batch_size > 1). The
+// state is interleaved like the GPU reactors, state[j*num_reactors_+k] for
+// variable j of reactor k, and the inputs to InitializeState and outputs of
+// GetState use the same transposed layout for the mass fractions and the
+// species sources. Each reactor of the batch is evaluated by its own
+// ReactorConstantPressureCPU or ReactorConstantVolumeCPU. The sparse
+// preconditioners of the reactors are assembled into one block diagonal
+// matrix that is factored with a single SuperLU factorization, so the
+// symbolic factorization is shared by the whole batch and reused while the
+// sparsity pattern is unchanged. With dense == 1 each block is factored by
+// its own reactor.
+class ReactorBatchCPU : public ReactorBase
+{
+ public:
+  ReactorBatchCPU(std::shared_ptr<zerork::mechanism> mech_ptr,
+                  bool constant_volume,
+                  int max_num_reactors);
+  ~ReactorBatchCPU();
+
+  void InitializeState(const double reactor_time,
+                       const int n_reactors,
+                       const double *T,
+                       const double *P,
+                       const double *mf,
+                       const double *dpdt,
+                       const double *e_src,
+                       const double *y_src);
+
+  N_Vector& GetStateNVectorRef() { return state_; };
+  void SetBatchMaskNVector(int reactor_idx, N_Vector batch_mask);
+
+  void GetState(const double reactor_time,
+                double *T,
+                double *P,
+                double *mf);
+
+  std::vector<double>& GetReactorWeightsRef() { return weights_; };
+
+  void GetAbsoluteToleranceCorrection(N_Vector correction);
+
+  int GetTimeDerivative(const double reactor_time,
+                        N_Vector state,
+                        N_Vector derivative);
+
+  void SetStepLimiter(double value);
+
+  // The batch only supports the solvers that use JacobianSetup,
+  // JacobianFactor and JacobianSolve or JacobianVectorProduct
+#ifdef SUNDIALS2
+  int GetJacobianDense(long int N, double t, N_Vector y, N_Vector fy,
+                       DlsMat Jac) { return 1; };
+#elif defined SUNDIALS3 || defined SUNDIALS4
+  int GetJacobianDense(double t, N_Vector y, N_Vector fy,
+                       SUNMatrix Jac) { return 1; };
+#else
+#error "Unsupported SUNDIALS version"
+#endif
+  int GetJacobianDenseRaw(long int N, double t, N_Vector y, N_Vector fy,
+                          double* Jac) { return 1; };
+
+  int JacobianSetup(double t, N_Vector y, N_Vector fy);
+
+  int JacobianFactor(double gamma);
+
+  int JacobianSolve(double t, N_Vector y, N_Vector fy,
+                    N_Vector r, N_Vector z);
+
+  int JacobianVectorProduct(N_Vector v, N_Vector Jv);
+
+  // One root function per reactor. Reactors that have ignited are masked
+  // with a constant negative value so they do not stop the integration
+  // again.
+  int RootFunction(double t, N_Vector y, double *root_function);
+
+  int SetRootTime(double t);
+  double GetRootTime();
+  double GetBatchRootTime(int reactor_idx) { return root_times_[reactor_idx]; };
+
+  int GetNumStateVariables() { return num_variables_; };
+
+  int GetNumRootFunctions();
+
+  int GetNumBatchReactors() { return num_reactors_; };
+  int GetMinBatchReactors() { return 2; };
+  int GetMaxBatchReactors() { return max_num_reactors_; };
+
+  void SetSolveTemperature(bool value);
+
+  void Reset();
+
+ private:
+  std::shared_ptr<zerork::mechanism> mech_ptr_;
+  std::vector<std::unique_ptr<ReactorNVectorSerial> > reactors_;
+  int max_num_reactors_;
+
+  N_Vector state_;
+  std::vector<double> state_data_;
+  std::vector<double> weights_;
+
+  // per reactor views used to call the reactors of the batch
+  N_Vector reactor_state_;
+  N_Vector reactor_derivative_;
+  N_Vector reactor_rhs_;
+  N_Vector reactor_solution_;
+  void CreateReactorVectors();
+  void DestroyReactorVectors();
+  void GatherReactor(int reactor_idx, N_Vector batch, N_Vector reactor);
+  void ScatterReactor(int reactor_idx, N_Vector reactor, N_Vector batch);
+
+  std::vector<double> mass_fractions_;
+  std::vector<double> y_src_;
+
+  std::vector<int> root_found_;
+  std::vector<double> root_times_;
+
+  // block diagonal preconditioner in reactor major order
+  superlu_manager slum_;
+  std::vector<int> block_column_sums_;
+  std::vector<int> block_row_indexes_;
+  std::vector<double> block_values_;
+  std::vector<int> last_block_column_sums_;
+  std::vector<int> last_block_row_indexes_;
+  std::vector<double> block_rhs_;
+  std::vector<double> block_solution_;
+  // the mechanism's Jacobian ordering repeated for each reactor block,
+  // built for block_ordering_reactors_ blocks of block_ordering_variables_
+  std::vector<int> jacobian_ordering_;
+  std::vector<int> block_ordering_;
+  int block_ordering_reactors_;
+  int block_ordering_variables_;
+};
+
+#endif
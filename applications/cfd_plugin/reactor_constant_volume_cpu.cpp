@@ -39,6 +39,7 @@ void ReactorConstantVolumeCPU::InitializeState(
   dpdt_ = *dpdt;
   e_src_ = *e_src;
   y_src_ = y_src;
+  SelectActiveSpecies();
 }
 
 void ReactorConstantVolumeCPU::GetState(
@@ -102,7 +103,12 @@ int ReactorConstantVolumeCPU::GetTimeDerivative(const double reactor_time,
   // compute the molar production rates at the current state_ (aka wdot)
   mech_ptr_->getReactionRatesLimiter(temperature, &concentrations_[0], &step_limiter_[0],
                                      net_production_rates_ptr, creation_rates_ptr, destruction_rates_ptr,
-                                     forward_rates_of_production_ptr);
+                                     forward_rates_of_production_ptr,
+                                     &rate_coefficients_[0],
+                                     rate_const_work_.get());
+  if(adaptive_chemistry_reduced_) {
+    FreezeInactiveSpecies(net_production_rates_ptr);
+  }
 
   double energy_sum=0.0;
   // ydot = [kmol/m^3/s] * [kg/kmol] * [m^3/kg] = [(kg spec j)/(kg mix)/s]
@@ -127,4 +133,10 @@ int ReactorConstantVolumeCPU::GetTimeDerivative(const double reactor_time,
   return 0;
 }
 
-
+bool ReactorConstantVolumeCPU::GetVolumeTemperatureExponent(double* exponent) const
+{
+  // temperature from the internal energy, density from the pressure
+  if(e_src_ != 0 || dpdt_ != 0) return false;
+  *exponent = 0.0;
+  return true;
+}
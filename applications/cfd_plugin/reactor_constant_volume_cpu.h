@@ -27,6 +27,8 @@ class ReactorConstantVolumeCPU : public ReactorNVectorSerial
                         N_Vector state,
                         N_Vector derivative);
 
+ protected:
+  bool GetVolumeTemperatureExponent(double* exponent) const;
 };
 
 #endif
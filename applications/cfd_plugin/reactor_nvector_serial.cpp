@@ -1,6 +1,7 @@
 
 #include <cmath> //sqrt
 #include <algorithm> //max
+#include <queue>
 
 #include "utility_funcs.h"
 #include "reactor_nvector_serial.h"
@@ -20,6 +21,7 @@ ReactorNVectorSerial::ReactorNVectorSerial(std::shared_ptr<zerork::mechanism> me
   num_species_ = mech_ptr_->getNumSpecies();
   num_variables_ = num_species_ + 1;
   num_steps_ = mech_ptr_->getNumSteps();
+  rate_const_work_ = mech_ptr_->createRateConstWorkspace();
 
   sqrt_unit_round_ = sqrt(UNIT_ROUNDOFF);
   root_time_ = 0.0;
@@ -40,10 +42,22 @@ ReactorNVectorSerial::ReactorNVectorSerial(std::shared_ptr<zerork::mechanism> me
   energy_.assign(num_species_,0.0);
   cx_mass_.assign(num_species_,0.0);
   forward_rates_of_production_.assign(num_steps_,0.0);
+  rate_coefficients_.assign(num_steps_,0.0);
+  mass_action_terms_.assign(
+    mech_ptr_->getMassActionJacobian()->getNumTerms()+1,0.0);
   creation_rates_.assign(num_species_,0.0);
   destruction_rates_.assign(num_species_,0.0);
   concentrations_.assign(num_species_,0.0);
 
+  step_temperature_derivatives_.assign(num_steps_,0.0);
+  step_csum_derivatives_.assign(num_steps_,0.0);
+  step_concentration_derivatives_.assign(
+    mech_ptr_->getNumRateConstConcentrationTerms()+1,0.0);
+  net_temperature_derivatives_.assign(num_species_,0.0);
+  creation_temperature_derivatives_.assign(num_species_,0.0);
+  destruction_temperature_derivatives_.assign(num_species_,0.0);
+  cx_mass_derivatives_.assign(num_species_,0.0);
+
   // set constant parameters
   mech_ptr_->getMolWtSpc(&mol_wt_[0]);
   for(int j=0; j < num_species_; ++j) {
@@ -51,9 +65,15 @@ ReactorNVectorSerial::ReactorNVectorSerial(std::shared_ptr<zerork::mechanism> me
   }
 
   SetupSparseJacobianArrays();
+  mech_ptr_->getJacobianOrdering(&jacobian_ordering_);
+  SetPreconditionerOrdering();
 
   weights_.assign(1,1.0);
   step_limiter_.assign(num_steps_, 1.0e22);
+
+  adaptive_chemistry_reduced_ = false;
+  num_active_species_ = num_species_;
+  active_species_.assign(num_species_, 1);
 }
 
 ReactorNVectorSerial::~ReactorNVectorSerial()
@@ -96,9 +116,18 @@ void ReactorNVectorSerial::SetSolveTemperature(bool value) {
     tmp1_ = N_VMake_Serial(num_variables_, &tmp1_data_[0]);
     tmp2_ = N_VMake_Serial(num_variables_, &tmp2_data_[0]);
     tmp3_ = N_VMake_Serial(num_variables_, &tmp3_data_[0]);
+    SetPreconditionerOrdering();
   }
 }
 
+void ReactorNVectorSerial::SetPreconditionerOrdering() {
+  // temperature is ordered last so the species entries alone are the
+  // ordering of the species-only Jacobian
+  slum_.SetColumnPermutation(
+      std::vector<int>(jacobian_ordering_.begin(),
+                       jacobian_ordering_.begin() + num_variables_));
+}
+
 void ReactorNVectorSerial::SetBatchMaskNVector(int reactor_idx, N_Vector batch_mask) {
   assert(reactor_idx == 0);
   N_VConst(1.0, batch_mask);
@@ -134,27 +163,36 @@ void ReactorNVectorSerial::SetupSparseJacobianArrays() {
   }
 
   destruction_terms_.concentration_indexes.clear();
+  destruction_terms_.row_species_indexes.clear();
   destruction_terms_.reaction_indexes.clear();
+  destruction_terms_.term_indexes.clear();
   destruction_terms_.sparse_indexes_temperature.clear();
   destruction_terms_.sparse_indexes_no_temperature.clear();
   creation_terms_.concentration_indexes.clear();
+  creation_terms_.row_species_indexes.clear();
   creation_terms_.reaction_indexes.clear();
+  creation_terms_.term_indexes.clear();
   creation_terms_.sparse_indexes_temperature.clear();
   creation_terms_.sparse_indexes_no_temperature.clear();
   // parse the system, filling in the Jacobian term data
   // Jacobian = d ydot(k)/ dy(j)
+  const zerork::mass_action_jacobian *mass_action =
+    mech_ptr_->getMassActionJacobian();
   for(int j=0; j<num_steps_; ++j) {
     int num_reactants=mech_ptr_->getOrderOfStep(j);
     int num_products=mech_ptr_->getNumProductsOfStep(j);
     for(int k=0; k<num_reactants; ++k) {
       int column_idx=mech_ptr_->getSpecIdxOfStepReactant(j,k); // species being perturbed
+      int term_idx=mass_action->getTermIdx(j,k); // d(step j)/d(column species)
       // forward destruction
       for(int m=0; m < num_reactants; ++m) {
         int row_idx=mech_ptr_->getSpecIdxOfStepReactant(j,m); // species being destroyed
         isNonZero[column_idx*num_variables_+row_idx]=1; // mark location in dense
 
         destruction_terms_.concentration_indexes.push_back(column_idx);
+        destruction_terms_.row_species_indexes.push_back(row_idx);
         destruction_terms_.reaction_indexes.push_back(j);
+        destruction_terms_.term_indexes.push_back(term_idx);
         destruction_terms_.sparse_indexes_temperature.push_back(row_idx);
         destruction_terms_.sparse_indexes_no_temperature.push_back(row_idx);
       }
@@ -164,18 +202,55 @@ void ReactorNVectorSerial::SetupSparseJacobianArrays() {
         isNonZero[column_idx*num_variables_+row_idx]=1; // mark location in dense
 
         creation_terms_.concentration_indexes.push_back(column_idx);
+        creation_terms_.row_species_indexes.push_back(row_idx);
         creation_terms_.reaction_indexes.push_back(j);
+        creation_terms_.term_indexes.push_back(term_idx);
         creation_terms_.sparse_indexes_temperature.push_back(row_idx);
         creation_terms_.sparse_indexes_no_temperature.push_back(row_idx);
       }
     }
   }
 
+  // enhanced third body species of the third body and falloff steps
+  third_body_destruction_terms_ = reaction_indexes();
+  third_body_creation_terms_ = reaction_indexes();
+  const int num_third_body_terms = mech_ptr_->getNumRateConstConcentrationTerms();
+  std::vector<int> term_steps(num_third_body_terms);
+  std::vector<int> term_species(num_third_body_terms);
+  mech_ptr_->getRateConstConcentrationTerms(term_steps.data(), term_species.data());
+  for(int j=0; j<num_third_body_terms; ++j) {
+    int step_idx = term_steps[j];
+    int column_idx = term_species[j]; // enhanced species being perturbed
+    int num_reactants=mech_ptr_->getOrderOfStep(step_idx);
+    int num_products=mech_ptr_->getNumProductsOfStep(step_idx);
+    for(int m=0; m < num_reactants; ++m) {
+      int row_idx=mech_ptr_->getSpecIdxOfStepReactant(step_idx,m);
+      isNonZero[column_idx*num_variables_+row_idx]=1;
+
+      third_body_destruction_terms_.concentration_indexes.push_back(column_idx);
+      third_body_destruction_terms_.row_species_indexes.push_back(row_idx);
+      third_body_destruction_terms_.reaction_indexes.push_back(j);
+      third_body_destruction_terms_.sparse_indexes_temperature.push_back(row_idx);
+      third_body_destruction_terms_.sparse_indexes_no_temperature.push_back(row_idx);
+    }
+    for(int m=0; m < num_products; ++m) {
+      int row_idx=mech_ptr_->getSpecIdxOfStepProduct(step_idx,m);
+      isNonZero[column_idx*num_variables_+row_idx]=1;
+
+      third_body_creation_terms_.concentration_indexes.push_back(column_idx);
+      third_body_creation_terms_.row_species_indexes.push_back(row_idx);
+      third_body_creation_terms_.reaction_indexes.push_back(j);
+      third_body_creation_terms_.sparse_indexes_temperature.push_back(row_idx);
+      third_body_creation_terms_.sparse_indexes_no_temperature.push_back(row_idx);
+    }
+  }
+
   num_noninteger_jacobian_nonzeros_ =
     mech_ptr_->getNonIntegerReactionNetwork()->GetNumJacobianNonzeros();
 
   std::vector<int> noninteger_row_id;
   std::vector<int> noninteger_column_id;
+  noninteger_species_.assign(num_species_, 0);
 
   // non-integer reaction network
   if(num_noninteger_jacobian_nonzeros_ > 0) {
@@ -193,6 +268,8 @@ void ReactorNVectorSerial::SetupSparseJacobianArrays() {
 
       int dense_id = noninteger_row_id[j]+noninteger_column_id[j]*num_variables_;
       isNonZero[dense_id]=1;
+      noninteger_species_[noninteger_row_id[j]] = 1;
+      noninteger_species_[noninteger_column_id[j]] = 1;
 
     }
   } // end if(num_noninteger_jacobian_nonzeros_ > 0)
@@ -263,12 +340,53 @@ void ReactorNVectorSerial::SetupSparseJacobianArrays() {
     creation_terms_.sparse_indexes_no_temperature[j]=sparse_idx-column_idx; // reset to sparse addr
   }
 
+  reaction_indexes* third_body_terms[] = {&third_body_destruction_terms_,
+                                          &third_body_creation_terms_};
+  for(int m=0; m<2; ++m) {
+    reaction_indexes* terms = third_body_terms[m];
+    for(int j=0; j<terms->concentration_indexes.size(); ++j) {
+      int row_idx=terms->sparse_indexes_temperature[j];
+      int column_idx=terms->concentration_indexes[j];
+      int nzAddr=isNonZero[column_idx*num_variables_+row_idx];
+      int sparse_idx = nzAddr-1;
+      terms->sparse_indexes_temperature[j]=sparse_idx; // reset to sparse addr
+      terms->sparse_indexes_no_temperature[j]=sparse_idx-column_idx; // reset to sparse addr
+    }
+  }
+
   for(int j=0; j<num_noninteger_jacobian_nonzeros_; ++j) {
     int dense_id = noninteger_row_id[j]+noninteger_column_id[j]*num_variables_;
     int nzAddr=isNonZero[dense_id];
     noninteger_sparse_id_temperature_[j] = nzAddr-1;
     noninteger_sparse_id_no_temperature_[j] = nzAddr-1 - noninteger_column_id[j];
   }
+
+  // transpose the off-diagonal species block for the DRGEP search
+  drg_row_sums_.assign(num_species_+1,0);
+  for(int j=0; j<num_species_; ++j) {
+    for(int k=jacobian_column_sums_temperature_[j]; k<jacobian_column_sums_temperature_[j+1]; ++k) {
+      int row = jacobian_row_indexes_temperature_[k];
+      if(row < num_species_ && row != j) {
+        drg_row_sums_[row+1] += 1;
+      }
+    }
+  }
+  for(int j=0; j<num_species_; ++j) {
+    drg_row_sums_[j+1] += drg_row_sums_[j];
+  }
+  drg_column_indexes_.assign(drg_row_sums_[num_species_],0);
+  drg_sparse_indexes_.assign(drg_row_sums_[num_species_],0);
+  std::vector<int> row_fill(drg_row_sums_.begin(), drg_row_sums_.end()-1);
+  for(int j=0; j<num_species_; ++j) {
+    for(int k=jacobian_column_sums_temperature_[j]; k<jacobian_column_sums_temperature_[j+1]; ++k) {
+      int row = jacobian_row_indexes_temperature_[k];
+      if(row < num_species_ && row != j) {
+        drg_column_indexes_[row_fill[row]] = j;
+        drg_sparse_indexes_[row_fill[row]] = k;
+        row_fill[row] += 1;
+      }
+    }
+  }
 }
 
 
@@ -472,6 +590,17 @@ int ReactorNVectorSerial::FormPreconditioner(double gamma)
   return 0;
 }
 
+void ReactorNVectorSerial::GetSparsePreconditioner(double gamma,
+                                                   const std::vector<int>** column_sums,
+                                                   const std::vector<int>** row_indexes,
+                                                   const std::vector<double>** values)
+{
+  FormPreconditioner(gamma);
+  *column_sums = &preconditioner_column_sums_;
+  *row_indexes = &preconditioner_row_indexes_;
+  *values = &preconditioner_data_;
+}
+
 int ReactorNVectorSerial::JacobianSolve(double t, N_Vector y, N_Vector fy,
                                             N_Vector r, N_Vector z)
 {
@@ -486,6 +615,31 @@ int ReactorNVectorSerial::JacobianSolve(double t, N_Vector y, N_Vector fy,
   return flag;
 }
 
+int ReactorNVectorSerial::JacobianVectorProduct(N_Vector v, N_Vector Jv)
+{
+  const double * v_ptr = NV_DATA_S(v);
+  double * Jv_ptr = NV_DATA_S(Jv);
+  const int num_vars = num_variables_;
+  for(int j=0; j<num_vars; ++j) {
+    Jv_ptr[j] = 0.0;
+  }
+  if(int_options_["analytic"] == 1) {
+    for(int j=0; j<num_vars; ++j) {
+      const double v_j = v_ptr[j];
+      for(int k=(*jacobian_column_sums_ptr_)[j]; k<(*jacobian_column_sums_ptr_)[j+1]; ++k) {
+        Jv_ptr[(*jacobian_row_indexes_ptr_)[k]] += jacobian_data_[k]*v_j;
+      }
+    }
+  } else {
+    for(int j=0; j<num_vars; ++j) {
+      const double v_j = v_ptr[j];
+      for(int row=0; row<num_vars; ++row) {
+        Jv_ptr[row] += dense_jacobian_[j*num_vars + row]*v_j;
+      }
+    }
+  }
+  return 0;
+}
 
 int ReactorNVectorSerial::SetupJacobianSparse(realtype t, N_Vector y,N_Vector fy)
 {
@@ -501,49 +655,62 @@ int ReactorNVectorSerial::SetupJacobianSparse(realtype t, N_Vector y,N_Vector fy
   const int num_spec = num_species_;
   const int num_destruction_terms = destruction_terms_.concentration_indexes.size();
   const int num_creation_terms = creation_terms_.concentration_indexes.size();
-  const double min_mass_frac = double_options_["min_mass_fraction"];
 
-  // set tmp1_ to the strictly positive mass fraction array
-  // set tmp2_ to 1/C where C is the concentration for the strictly positive
-  // mass fraction array
+  // the mass action Jacobian terms are products of the other reactant
+  // concentrations, so the state is used as is without a minimum mass
+  // fraction
   for(int j=0; j < num_spec; j++) {
     tmp1_ptr[j]=y_ptr[j];
-    if(fabs(tmp1_ptr[j]) < min_mass_frac) {
-      if(tmp1_ptr[j] < 0.0) {
-        tmp1_ptr[j]= -min_mass_frac;
-      } else {
-        tmp1_ptr[j]=  min_mass_frac;
-      }
-    }
-    tmp2_ptr[j]=mol_wt_[j]/tmp1_ptr[j]*inverse_density_;
   }
 
   if(solve_temperature_) {
     tmp1_ptr[num_spec]=y_ptr[num_spec];
   }
 
-  // calculate the reaction info for the strictly positive case
+  // calculate the reaction info and the rate coefficients at the state
   //double start_time_deriv = getHighResolutionTime();
   GetTimeDerivative(t,tmp1_,tmp3_);
   //double deriv_time = getHighResolutionTime() - start_time_deriv;
+  mech_ptr_->getMassActionJacobian()->getTermValues(&rate_coefficients_[0],
+                                                    &concentrations_[0],
+                                                    &mass_action_terms_[0]);
 
   // set the full sparse array
   jacobian_data_.assign(nnz_,0.0);
 
-  // process the forward destruction terms
-  for(int j=0; j < num_destruction_terms; ++j) {
-      int conc_idx = destruction_terms_.concentration_indexes[j];
-      int rxn_idx    = destruction_terms_.reaction_indexes[j];
-      int sparse_idx = (*destruction_sparse_indexes_ptr_)[j];
-      jacobian_data_[sparse_idx]-=forward_rates_of_production_[rxn_idx]*tmp2_ptr[conc_idx];
-  }
+  if(adaptive_chemistry_reduced_) {
+    // only the couplings between active species, the frozen species are
+    // decoupled from the active system
+    for(int j=0; j < num_destruction_terms; ++j) {
+        int conc_idx = destruction_terms_.concentration_indexes[j];
+        if(active_species_[conc_idx] == 0 ||
+           active_species_[destruction_terms_.row_species_indexes[j]] == 0) continue;
+        int term_idx   = destruction_terms_.term_indexes[j];
+        int sparse_idx = (*destruction_sparse_indexes_ptr_)[j];
+        jacobian_data_[sparse_idx]-=mass_action_terms_[term_idx];
+    }
+    for(int j=0; j < num_creation_terms; ++j) {
+        int conc_idx = creation_terms_.concentration_indexes[j];
+        if(active_species_[conc_idx] == 0 ||
+           active_species_[creation_terms_.row_species_indexes[j]] == 0) continue;
+        int term_idx   = creation_terms_.term_indexes[j];
+        int sparse_idx = (*creation_sparse_indexes_ptr_)[j];
+        jacobian_data_[sparse_idx]+=mass_action_terms_[term_idx];
+    }
+  } else {
+    // process the forward destruction terms
+    for(int j=0; j < num_destruction_terms; ++j) {
+        int term_idx   = destruction_terms_.term_indexes[j];
+        int sparse_idx = (*destruction_sparse_indexes_ptr_)[j];
+        jacobian_data_[sparse_idx]-=mass_action_terms_[term_idx];
+    }
 
-  // process the forward creation terms
-  for(int j=0; j < num_creation_terms; ++j) {
-      int conc_idx = creation_terms_.concentration_indexes[j];
-      int rxn_idx    = creation_terms_.reaction_indexes[j];
-      int sparse_idx = (*creation_sparse_indexes_ptr_)[j];
-      jacobian_data_[sparse_idx]+=forward_rates_of_production_[rxn_idx]*tmp2_ptr[conc_idx];
+    // process the forward creation terms
+    for(int j=0; j < num_creation_terms; ++j) {
+        int term_idx   = creation_terms_.term_indexes[j];
+        int sparse_idx = (*creation_sparse_indexes_ptr_)[j];
+        jacobian_data_[sparse_idx]+=mass_action_terms_[term_idx];
+    }
   }
 
   // process the non-integer Jacobian information
@@ -555,6 +722,17 @@ int ReactorNVectorSerial::SetupJacobianSparse(realtype t, N_Vector y,N_Vector fy
       noninteger_jacobian_[j] = 0.0;
     }
 
+    // the non-integer reaction network computes its terms from the step
+    // rates and 1/C, set tmp2_ to 1/C with a minimum mass fraction
+    const double min_mass_frac = double_options_["min_mass_fraction"];
+    for(int j=0; j < num_spec; j++) {
+      double mass_fraction = y_ptr[j];
+      if(fabs(mass_fraction) < min_mass_frac) {
+        mass_fraction = (mass_fraction < 0.0) ? -min_mass_frac : min_mass_frac;
+      }
+      tmp2_ptr[j]=mol_wt_[j]/mass_fraction*inverse_density_;
+    }
+
     mech_ptr_->getNonIntegerReactionNetwork()->GetSpeciesJacobian(
       tmp2_ptr,
       &forward_rates_of_production_[0],
@@ -565,8 +743,58 @@ int ReactorNVectorSerial::SetupJacobianSparse(realtype t, N_Vector y,N_Vector fy
     }
   }
 
+  // evaluate the analytic temperature derivatives of the rates of progress
+  // and the derivatives of the third body and falloff rate constants with
+  // respect to the enhanced species
+  const double reference_temperature = double_options_["reference_temperature"];
+  double temperature = initial_temperature_;
+  if(solve_temperature_) {
+    temperature = tmp1_ptr[num_spec]*reference_temperature;
+  }
+  double volume_exponent = 0.0;
+  const bool analytic_rates = GetVolumeTemperatureExponent(&volume_exponent);
+  // GetTimeDerivative limits the rate temperature to 1.0e4 K (TLIMIT)
+  const double max_rate_temperature = 1.0e4;
+  if(analytic_rates) {
+    mech_ptr_->getReactionRateDerivativesLimiter(
+        std::min(temperature, max_rate_temperature),
+        &concentrations_[0], &step_limiter_[0],
+        &net_production_rates_[0], &creation_rates_[0], &destruction_rates_[0],
+        &forward_rates_of_production_[0],
+        &step_temperature_derivatives_[0], &step_csum_derivatives_[0],
+        &step_concentration_derivatives_[0], rate_const_work_.get());
+    if(adaptive_chemistry_reduced_) {
+      FreezeInactiveSpecies(&net_production_rates_[0]);
+    }
+
+    // The dependence on the sum of all concentrations (step_csum_derivatives_)
+    // would fill the reactant and product rows of every third body and
+    // falloff step, so only the enhanced species terms are kept.
+    const std::vector<int>& destruction_sparse_indexes = solve_temperature_ ?
+      third_body_destruction_terms_.sparse_indexes_temperature :
+      third_body_destruction_terms_.sparse_indexes_no_temperature;
+    const std::vector<int>& creation_sparse_indexes = solve_temperature_ ?
+      third_body_creation_terms_.sparse_indexes_temperature :
+      third_body_creation_terms_.sparse_indexes_no_temperature;
+    for(int j=0; j < destruction_sparse_indexes.size(); ++j) {
+      if(adaptive_chemistry_reduced_ &&
+         (active_species_[third_body_destruction_terms_.concentration_indexes[j]] == 0 ||
+          active_species_[third_body_destruction_terms_.row_species_indexes[j]] == 0)) continue;
+      int term_idx = third_body_destruction_terms_.reaction_indexes[j];
+      jacobian_data_[destruction_sparse_indexes[j]] -= step_concentration_derivatives_[term_idx];
+    }
+    for(int j=0; j < creation_sparse_indexes.size(); ++j) {
+      if(adaptive_chemistry_reduced_ &&
+         (active_species_[third_body_creation_terms_.concentration_indexes[j]] == 0 ||
+          active_species_[third_body_creation_terms_.row_species_indexes[j]] == 0)) continue;
+      int term_idx = third_body_creation_terms_.reaction_indexes[j];
+      jacobian_data_[creation_sparse_indexes[j]] += step_concentration_derivatives_[term_idx];
+    }
+  }
+
   // At this point sMptr stores d(wdot[k])/dC[j] ignoring the contribution
-  // of perturbations in the third body species
+  // of perturbations in the sum of the third body concentrations, and of the
+  // enhanced third body species unless analytic_rates is set
 
   if(solve_temperature_) {
     // ---------------------------------------------------------------------
@@ -599,33 +827,110 @@ int ReactorNVectorSerial::SetupJacobianSparse(realtype t, N_Vector y,N_Vector fy
       int last_row_idx = last_row_indexes_[j];
       jacobian_data_[last_row_idx] *= inv_mol_wt_[j]*multFact;
     }
+    if(adaptive_chemistry_reduced_) {
+      for(int j=0; j<num_spec; j++) {
+        if(active_species_[j] == 0) {
+          jacobian_data_[last_row_indexes_[j]] = 0.0;
+        }
+      }
+    }
 
-    // At this point Mtx stores d(Tdot[k])/dy[j] ignoring the contribution
-    // of perturbations in the third body species
+    // At this point Mtx stores d(Tdot[k])/dy[j] with the same third body
+    // terms as d(wdot[k])/dC[j]
 
     // --------------------------------------------------------------------- 
     // calculate d(ydot[k])/dT
+    if(analytic_rates && temperature < max_rate_temperature) {
+      const double Ru = mech_ptr_->getGasConstant();
+      const double inv_temperature = 1.0/temperature;
+      const double relative_volume = inverse_density_;
+
+      // step 1: d(wdot[k])/dT at constant concentration, plus the change of
+      // the concentrations dC[j]/dT = -a*C[j]/T with the volume v ~ T^a
+      if(volume_exponent != 0.0) {
+        double concentration_sum = 0.0;
+        for(int j=0; j<num_spec; ++j) {
+          concentration_sum += concentrations_[j];
+        }
+        const double dCsum_dT = -volume_exponent*concentration_sum*inv_temperature;
+        for(int j=0; j<num_steps_; ++j) {
+          step_temperature_derivatives_[j] += step_csum_derivatives_[j]*dCsum_dT;
+        }
+      }
+      mech_ptr_->getNetRatesFromStepRates(&step_temperature_derivatives_[0],
+                                          &net_temperature_derivatives_[0],
+                                          &creation_temperature_derivatives_[0],
+                                          &destruction_temperature_derivatives_[0]);
+      if(volume_exponent != 0.0) {
+        for(int j=0; j<num_spec; j++) { // column number
+          const double dC_dT = -volume_exponent*concentrations_[j]*inv_temperature;
+          for(int k=(*jacobian_column_sums_ptr_)[j]; k<(*jacobian_column_sums_ptr_)[j+1]; k++) {
+            int row=(*jacobian_row_indexes_ptr_)[k];
+            if(row < num_spec) {
+              net_temperature_derivatives_[row] += jacobian_data_[k]*dC_dT;
+            }
+          }
+        }
+      }
+      if(adaptive_chemistry_reduced_) {
+        FreezeInactiveSpecies(&net_temperature_derivatives_[0]);
+      }
 
-    // step 1: perturb the temperature
-    double delta_temp=y_ptr[num_spec]*sqrt_unit_round_;
-    tmp1_ptr[num_spec]+=delta_temp;
-    delta_temp=tmp1_ptr[num_spec]-y_ptr[num_spec];
-    double multiplier = 1.0/delta_temp;
+      // step 2: d(ydot[k])/dT and the sums for d(Tdot)/dT, with the molar
+      // source q[k] = v*wdot[k] + y_src[k]/mw[k] and E = sum(e[k]*q[k])
+      const int temperature_column = (*jacobian_column_sums_ptr_)[num_spec];
+      double energy_sum = 0.0;
+      double energy_derivative_sum = 0.0;
+      for(int k=0; k<num_spec; ++k) {
+        double molar_source = relative_volume*net_production_rates_[k];
+        if(y_src_ != nullptr) {
+          molar_source += y_src_[k]*inv_mol_wt_[k];
+        }
+        const double molar_source_derivative = relative_volume*
+          (volume_exponent*net_production_rates_[k]*inv_temperature +
+           net_temperature_derivatives_[k]);
+        // d(e/RT)/dT = (c/R - e/RT)/T
+        const double energy_derivative =
+          (cx_mass_[k]*mol_wt_[k]/Ru - energy_[k])*inv_temperature;
+        jacobian_data_[temperature_column+k] =
+          reference_temperature*mol_wt_[k]*molar_source_derivative;
+        energy_sum += energy_[k]*molar_source;
+        energy_derivative_sum += energy_derivative*molar_source +
+                                 energy_[k]*molar_source_derivative;
+      }
 
-    for(int j=0; j<num_spec; ++j) {
-      tmp1_ptr[j]=y_ptr[j];
-    }
+      // step 3: d(Tdot)/dT with Tdot*cx = -Ru*y[T]*E + (e_src + dpdt*v)/Tref
+      const double cx_mass_derivative =
+        mech_ptr_->getMassdCpdTFromTY(temperature, tmp1_ptr,
+                                      &cx_mass_derivatives_[0]);
+      const double source_derivative =
+        -Ru*energy_sum/reference_temperature
+        -Ru*tmp1_ptr[num_spec]*energy_derivative_sum
+        +dpdt_*volume_exponent*relative_volume*inv_temperature/reference_temperature;
+      jacobian_data_[temperature_column+num_spec] = reference_temperature*
+        (source_derivative - tmp3_ptr[num_spec]*cx_mass_derivative)/mean_cx_mass_;
+    } else {
+      // step 1: perturb the temperature
+      double delta_temp=y_ptr[num_spec]*sqrt_unit_round_;
+      tmp1_ptr[num_spec]+=delta_temp;
+      delta_temp=tmp1_ptr[num_spec]-y_ptr[num_spec];
+      double multiplier = 1.0/delta_temp;
+
+      for(int j=0; j<num_spec; ++j) {
+        tmp1_ptr[j]=y_ptr[j];
+      }
 
-    // step 2: calculate ydot at Temp+dTemp
-    //start_time_deriv = getHighResolutionTime();
-    GetTimeDerivative(t,tmp1_,tmp3_);
-    //deriv_time += getHighResolutionTime() - start_time_deriv;
+      // step 2: calculate ydot at Temp+dTemp
+      //start_time_deriv = getHighResolutionTime();
+      GetTimeDerivative(t,tmp1_,tmp3_);
+      //deriv_time += getHighResolutionTime() - start_time_deriv;
 
-    // step 3: approximate d(ydot[k])/dT with finite difference
-    for(int k=(*jacobian_column_sums_ptr_)[num_spec]; k<(*jacobian_column_sums_ptr_)[num_vars]; ++k) {
-      int row=(*jacobian_row_indexes_ptr_)[k];
-      jacobian_data_[k]=(tmp3_ptr[row]-fy_ptr[row])*multiplier;
-    }
+      // step 3: approximate d(ydot[k])/dT with finite difference
+      for(int k=(*jacobian_column_sums_ptr_)[num_spec]; k<(*jacobian_column_sums_ptr_)[num_vars]; ++k) {
+        int row=(*jacobian_row_indexes_ptr_)[k];
+        jacobian_data_[k]=(tmp3_ptr[row]-fy_ptr[row])*multiplier;
+      }
+    } // if(analytic_rates)
   } //if(solve_temperature_)
 
   //Convert concentration to mass fraction
@@ -719,3 +1024,111 @@ void ReactorNVectorSerial::Reset() {
   slum_.reset();
 }
 
+void ReactorNVectorSerial::SelectActiveSpecies() {
+  adaptive_chemistry_reduced_ = false;
+  num_active_species_ = num_species_;
+  active_species_.assign(num_species_, 1);
+  if(int_options_["adaptive_chemistry"] != 1) {
+    return;
+  }
+  const double threshold = double_options_["adaptive_chemistry_threshold"];
+  const double target_mass_fraction =
+    double_options_["adaptive_chemistry_target_mass_fraction"];
+
+  // rates of progress of each step at the initial state
+  GetTimeDerivative(initial_time_, state_, tmp1_);
+
+  // DRGEP direct interaction coefficients
+  //   r_AB = |sum_i nu_A,i w_i delta_B,i| / max(P_A, C_A)
+  // where delta_B,i marks the steps with B as a reactant, so that the
+  // couplings are the off-diagonal terms of the species Jacobian
+  const int num_destruction_terms = destruction_terms_.concentration_indexes.size();
+  const int num_creation_terms = creation_terms_.concentration_indexes.size();
+  drg_coefficients_.assign(nnz_temperature_, 0.0);
+  for(int j=0; j < num_destruction_terms; ++j) {
+    drg_coefficients_[destruction_terms_.sparse_indexes_temperature[j]] -=
+      forward_rates_of_production_[destruction_terms_.reaction_indexes[j]];
+  }
+  for(int j=0; j < num_creation_terms; ++j) {
+    drg_coefficients_[creation_terms_.sparse_indexes_temperature[j]] +=
+      forward_rates_of_production_[creation_terms_.reaction_indexes[j]];
+  }
+
+  // largest path product from any target species (graph search with the
+  // best path first, paths below the threshold are not extended)
+  const double *y_ptr = NV_DATA_S(state_);
+  std::priority_queue<std::pair<double, int> > search_queue;
+  drg_importance_.assign(num_species_, 0.0);
+  for(int j=0; j<num_species_; ++j) {
+    if(y_ptr[j] >= target_mass_fraction) {
+      drg_importance_[j] = 1.0;
+      search_queue.push(std::make_pair(1.0, j));
+    }
+  }
+  while(!search_queue.empty()) {
+    const double importance = search_queue.top().first;
+    const int species_a = search_queue.top().second;
+    search_queue.pop();
+    if(importance < drg_importance_[species_a]) {
+      continue;
+    }
+    const double rate_scale = std::max(creation_rates_[species_a],
+                                       destruction_rates_[species_a]);
+    if(rate_scale <= 0.0) {
+      continue;
+    }
+    for(int k=drg_row_sums_[species_a]; k<drg_row_sums_[species_a+1]; ++k) {
+      const int species_b = drg_column_indexes_[k];
+      const double r_ab =
+        std::min(1.0, fabs(drg_coefficients_[drg_sparse_indexes_[k]])/rate_scale);
+      const double path_importance = importance*r_ab;
+      if(path_importance >= threshold &&
+         path_importance > drg_importance_[species_b]) {
+        drg_importance_[species_b] = path_importance;
+        search_queue.push(std::make_pair(path_importance, species_b));
+      }
+    }
+  }
+
+  // species in non-integer reactions are not in the step graph and are
+  // always kept
+  num_active_species_ = 0;
+  for(int j=0; j<num_species_; ++j) {
+    if(drg_importance_[j] < threshold && noninteger_species_[j] == 0) {
+      active_species_[j] = 0;
+    } else {
+      num_active_species_ += 1;
+    }
+  }
+  adaptive_chemistry_reduced_ = num_active_species_ < num_species_;
+}
+
+void ReactorNVectorSerial::FreezeInactiveSpecies(double* net_production_rates) {
+  for(int j=0; j<num_species_; ++j) {
+    if(active_species_[j] == 0) {
+      net_production_rates[j] = 0.0;
+    }
+  }
+}
+
+bool ReactorNVectorSerial::CheckActiveSpecies(const double reactor_time) {
+  if(!adaptive_chemistry_reduced_) {
+    return true;
+  }
+  // Estimate the change of the frozen species over the step from their
+  // full production rates at the end of the step
+  adaptive_chemistry_reduced_ = false;
+  GetTimeDerivative(reactor_time, state_, tmp1_);
+  adaptive_chemistry_reduced_ = true;
+
+  const double dt = reactor_time - initial_time_;
+  const double tolerance = double_options_["adaptive_chemistry_tolerance"];
+  for(int j=0; j<num_species_; ++j) {
+    if(active_species_[j] == 0 &&
+       fabs(net_production_rates_[j]*mol_wt_[j]*inverse_density_)*dt > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
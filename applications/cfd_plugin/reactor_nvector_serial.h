@@ -41,6 +41,8 @@ class ReactorNVectorSerial : public ReactorBase
   int JacobianSolve(double t, N_Vector y, N_Vector fy,
                     N_Vector r, N_Vector z);
 
+  int JacobianVectorProduct(N_Vector v, N_Vector Jv);
+
   int RootFunction(double t, N_Vector y, double *root_function);
 
   int SetRootTime(double t);
@@ -57,12 +59,26 @@ class ReactorNVectorSerial : public ReactorBase
   void SetSolveTemperature(bool value);
   void SetStepLimiter(double value);
 
+  bool CheckActiveSpecies(const double reactor_time);
+  int GetNumActiveSpecies() { return num_active_species_; };
+
   void Reset();
 
+  // Sparse I - gamma*J of the last JacobianSetup in compressed column form,
+  // formed without factoring it. Used by ReactorBatchCPU to assemble one
+  // block diagonal system for a batch of reactors.
+  void GetSparsePreconditioner(double gamma,
+                               const std::vector<int>** column_sums,
+                               const std::vector<int>** row_indexes,
+                               const std::vector<double>** values);
+
  protected:
   bool solve_temperature_; 
 
   std::shared_ptr<zerork::mechanism> mech_ptr_;
+  // rate constant work arrays of this reactor, so that reactors on
+  // different threads can share mech_ptr_
+  std::unique_ptr<zerork::rate_const_workspace> rate_const_work_;
   N_Vector state_;
   N_Vector tmp1_;
   N_Vector tmp2_;
@@ -84,14 +100,38 @@ class ReactorNVectorSerial : public ReactorBase
   std::vector<double> energy_;
   std::vector<double> cx_mass_;
   std::vector<double> forward_rates_of_production_;
+  // limited rate coefficient of each step from GetTimeDerivative, for the
+  // mass action Jacobian terms (see zerork::mass_action_jacobian)
+  std::vector<double> rate_coefficients_;
   std::vector<double> creation_rates_;
   std::vector<double> destruction_rates_;
   std::vector<double> concentrations_;
   std::vector<double> step_limiter_;
 
+  // Dynamic adaptive chemistry (adaptive_chemistry == 1). At the start of
+  // each step the species are ranked with DRGEP from the target species
+  // and the species below the threshold are frozen for the step.
+  bool adaptive_chemistry_reduced_;
+  int num_active_species_;
+  std::vector<int> active_species_;
+  void SelectActiveSpecies();
+  void FreezeInactiveSpecies(double* net_production_rates);
+
+  // The rates are evaluated at the state temperature and a volume that
+  // varies as T^exponent at constant mass fractions. Returns false when the
+  // reactor source terms make the rates depend on temperature otherwise,
+  // in which case the Jacobian temperature column is found by a finite
+  // difference and the third body terms are left out.
+  virtual bool GetVolumeTemperatureExponent(double* exponent) const
+  { return false; }
+
  private:
   superlu_manager slum_;
   lapack_manager lpm_;
+  // fill-reducing ordering of the species + temperature Jacobian stored
+  // with the mechanism, temperature is last
+  std::vector<int> jacobian_ordering_;
+  void SetPreconditionerOrdering();
   std::vector<double> weights_;
 
   double sqrt_unit_round_;
@@ -131,7 +171,9 @@ class ReactorNVectorSerial : public ReactorBase
 
   struct reaction_indexes {
     std::vector<int> concentration_indexes;
+    std::vector<int> row_species_indexes;
     std::vector<int> reaction_indexes;
+    std::vector<int> term_indexes; // mass action Jacobian term
     std::vector<int> sparse_indexes_temperature;
     std::vector<int> sparse_indexes_no_temperature;
   };
@@ -140,6 +182,30 @@ class ReactorNVectorSerial : public ReactorBase
 
   reaction_indexes destruction_terms_;
   reaction_indexes creation_terms_;
+  // d(wdot)/dC of the enhanced third body species of the third body and
+  // falloff steps, reaction_indexes holds the rate constant concentration
+  // term (see zerork::mechanism::getReactionRateDerivativesLimiter)
+  reaction_indexes third_body_destruction_terms_;
+  reaction_indexes third_body_creation_terms_;
+
+  // analytic rate derivatives for the Jacobian
+  std::vector<double> mass_action_terms_;
+  std::vector<double> step_temperature_derivatives_;
+  std::vector<double> step_csum_derivatives_;
+  std::vector<double> step_concentration_derivatives_;
+  std::vector<double> net_temperature_derivatives_;
+  std::vector<double> creation_temperature_derivatives_;
+  std::vector<double> destruction_temperature_derivatives_;
+  std::vector<double> cx_mass_derivatives_;
+
+  // species-species couplings in compressed row form for the DRGEP search,
+  // with the addresses of the couplings in the temperature Jacobian
+  std::vector<int> drg_row_sums_;
+  std::vector<int> drg_column_indexes_;
+  std::vector<int> drg_sparse_indexes_;
+  std::vector<double> drg_coefficients_;
+  std::vector<double> drg_importance_;
+  std::vector<int> noninteger_species_;
 
   void SetupSparseJacobianArrays();
   int SetupJacobianSparse(realtype t, N_Vector y,N_Vector fy);
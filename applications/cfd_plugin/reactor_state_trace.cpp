@@ -0,0 +1,169 @@
+#include <string.h>
+
+#include "reactor_state_trace.h"
+
+static const char TRACE_MAGIC[8] = {'Z','R','K','T','R','A','C','E'};
+static const int TRACE_VERSION = 1;
+static const int TRACE_FIELD_DPDT  = 1;
+static const int TRACE_FIELD_E_SRC = 2;
+static const int TRACE_FIELD_Y_SRC = 4;
+
+ReactorStateTraceWriter::ReactorStateTraceWriter()
+  :
+    fptr_(NULL),
+    num_species_(0)
+{}
+
+ReactorStateTraceWriter::~ReactorStateTraceWriter()
+{
+  Close();
+}
+
+bool ReactorStateTraceWriter::Open(const std::string& filename,
+                                   const int num_species)
+{
+  Close();
+  fptr_ = fopen(filename.c_str(), "wb");
+  if(fptr_ == NULL) {
+    return false;
+  }
+  num_species_ = num_species;
+  fwrite(TRACE_MAGIC, sizeof(char), 8, fptr_);
+  fwrite(&TRACE_VERSION, sizeof(int), 1, fptr_);
+  fwrite(&num_species_, sizeof(int), 1, fptr_);
+  return true;
+}
+
+void ReactorStateTraceWriter::Close()
+{
+  if(fptr_ != NULL) {
+    fclose(fptr_);
+    fptr_ = NULL;
+  }
+}
+
+bool ReactorStateTraceWriter::Write(const int n_cycle,
+                                    const double time,
+                                    const double dt,
+                                    const int n_reactors,
+                                    const double* T,
+                                    const double* P,
+                                    const double* mf,
+                                    const double* dpdt,
+                                    const double* e_src,
+                                    const double* y_src,
+                                    const int species_stride)
+{
+  if(fptr_ == NULL) {
+    return false;
+  }
+  int fields = 0;
+  if(dpdt != NULL) fields |= TRACE_FIELD_DPDT;
+  if(e_src != NULL) fields |= TRACE_FIELD_E_SRC;
+  if(y_src != NULL) fields |= TRACE_FIELD_Y_SRC;
+
+  fwrite(&n_cycle, sizeof(int), 1, fptr_);
+  fwrite(&time, sizeof(double), 1, fptr_);
+  fwrite(&dt, sizeof(double), 1, fptr_);
+  fwrite(&n_reactors, sizeof(int), 1, fptr_);
+  fwrite(&fields, sizeof(int), 1, fptr_);
+  if(n_reactors > 0) {
+    fwrite(T, sizeof(double), n_reactors, fptr_);
+    fwrite(P, sizeof(double), n_reactors, fptr_);
+    for(int k = 0; k < n_reactors; ++k) {
+      fwrite(&mf[k*species_stride], sizeof(double), num_species_, fptr_);
+    }
+    if(dpdt != NULL) {
+      fwrite(dpdt, sizeof(double), n_reactors, fptr_);
+    }
+    if(e_src != NULL) {
+      fwrite(e_src, sizeof(double), n_reactors, fptr_);
+    }
+    if(y_src != NULL) {
+      for(int k = 0; k < n_reactors; ++k) {
+        fwrite(&y_src[k*species_stride], sizeof(double), num_species_, fptr_);
+      }
+    }
+  }
+  fflush(fptr_);
+  return ferror(fptr_) == 0;
+}
+
+ReactorStateTraceReader::ReactorStateTraceReader()
+  :
+    fptr_(NULL),
+    num_species_(0)
+{}
+
+ReactorStateTraceReader::~ReactorStateTraceReader()
+{
+  Close();
+}
+
+bool ReactorStateTraceReader::Open(const std::string& filename)
+{
+  Close();
+  fptr_ = fopen(filename.c_str(), "rb");
+  if(fptr_ == NULL) {
+    return false;
+  }
+  char magic[8];
+  int version = 0;
+  if(fread(magic, sizeof(char), 8, fptr_) != 8 ||
+     memcmp(magic, TRACE_MAGIC, 8) != 0 ||
+     fread(&version, sizeof(int), 1, fptr_) != 1 ||
+     version != TRACE_VERSION ||
+     fread(&num_species_, sizeof(int), 1, fptr_) != 1) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void ReactorStateTraceReader::Close()
+{
+  if(fptr_ != NULL) {
+    fclose(fptr_);
+    fptr_ = NULL;
+  }
+}
+
+static bool ReadDoubles(FILE* fptr, const size_t count,
+                        std::vector<double>* values)
+{
+  values->resize(count);
+  if(count == 0) {
+    return true;
+  }
+  return fread(&(*values)[0], sizeof(double), count, fptr) == count;
+}
+
+bool ReactorStateTraceReader::Read(ReactorStateTraceRecord* record)
+{
+  if(fptr_ == NULL) {
+    return false;
+  }
+  int fields = 0;
+  if(fread(&record->n_cycle, sizeof(int), 1, fptr_) != 1 ||
+     fread(&record->time, sizeof(double), 1, fptr_) != 1 ||
+     fread(&record->dt, sizeof(double), 1, fptr_) != 1 ||
+     fread(&record->n_reactors, sizeof(int), 1, fptr_) != 1 ||
+     fread(&fields, sizeof(int), 1, fptr_) != 1 ||
+     record->n_reactors < 0) {
+    return false;
+  }
+  const size_t n_reactors = record->n_reactors;
+  const size_t n_species_values = n_reactors*num_species_;
+  if(!ReadDoubles(fptr_, n_reactors, &record->T) ||
+     !ReadDoubles(fptr_, n_reactors, &record->P) ||
+     !ReadDoubles(fptr_, n_species_values, &record->mf) ||
+     !ReadDoubles(fptr_, (fields & TRACE_FIELD_DPDT) ? n_reactors : 0,
+                  &record->dpdt) ||
+     !ReadDoubles(fptr_, (fields & TRACE_FIELD_E_SRC) ? n_reactors : 0,
+                  &record->e_src) ||
+     !ReadDoubles(fptr_, (fields & TRACE_FIELD_Y_SRC) ? n_species_values : 0,
+                  &record->y_src)) {
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,86 @@
+#ifndef REACTOR_STATE_TRACE_H_
+#define REACTOR_STATE_TRACE_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Binary trace of the inputs of zerork_reactor_solve calls, written by the
+// plugin when reactor_state_capture_file is set and replayed by
+// zerork_cfd_plugin_tester.x (replay_files). The file starts with
+//
+//   char[8] "ZRKTRACE", int version, int num_species
+//
+// followed by one record per call:
+//
+//   int n_cycle, double time, double dt, int n_reactors, int fields,
+//   double T[n_reactors], double P[n_reactors],
+//   double mf[n_reactors*num_species],
+//   double dpdt[n_reactors]                  (fields & TRACE_FIELD_DPDT)
+//   double e_src[n_reactors]                 (fields & TRACE_FIELD_E_SRC)
+//   double y_src[n_reactors*num_species]     (fields & TRACE_FIELD_Y_SRC)
+//
+// in native byte order. Species arrays are written without the stride of
+// the caller.
+struct ReactorStateTraceRecord
+{
+  int n_cycle;
+  double time;
+  double dt;
+  int n_reactors;
+  std::vector<double> T;
+  std::vector<double> P;
+  std::vector<double> mf;
+  std::vector<double> dpdt;  // empty if not set by the caller
+  std::vector<double> e_src; // empty if not set by the caller
+  std::vector<double> y_src; // empty if not set by the caller
+};
+
+class ReactorStateTraceWriter
+{
+ public:
+  ReactorStateTraceWriter();
+  ~ReactorStateTraceWriter();
+
+  bool Open(const std::string& filename, const int num_species);
+  bool IsOpen() const { return fptr_ != NULL; };
+  void Close();
+
+  // dpdt, e_src and y_src may be NULL
+  bool Write(const int n_cycle,
+             const double time,
+             const double dt,
+             const int n_reactors,
+             const double* T,
+             const double* P,
+             const double* mf,
+             const double* dpdt,
+             const double* e_src,
+             const double* y_src,
+             const int species_stride);
+
+ private:
+  FILE* fptr_;
+  int num_species_;
+};
+
+class ReactorStateTraceReader
+{
+ public:
+  ReactorStateTraceReader();
+  ~ReactorStateTraceReader();
+
+  bool Open(const std::string& filename);
+  bool IsOpen() const { return fptr_ != NULL; };
+  void Close();
+  int num_species() const { return num_species_; };
+
+  // Returns false at the end of the trace or on a truncated record
+  bool Read(ReactorStateTraceRecord* record);
+
+ private:
+  FILE* fptr_;
+  int num_species_;
+};
+
+#endif
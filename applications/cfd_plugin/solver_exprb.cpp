@@ -0,0 +1,470 @@
+
+#include <math.h>
+#include <algorithm> //std::min,max
+#include <vector>
+
+#include "solver_exprb.h"
+#include "utility_funcs.h"
+
+#include "nvector/nvector_serial.h"
+
+// exprb32 (Hochbruck, Ostermann and Schweitzer, SIAM J. Numer. Anal. 47,
+// 2009). With the Jacobian J at the start of the step and the remainder
+// g(y) = f(y) - J*y a step is
+//
+//   U     = y + h*phi_1(hJ) f(y)
+//   y_new = U + 2*h*phi_3(hJ) (g(U) - g(y))
+//
+// U is the order 2 exponential Rosenbrock-Euler solution, so the second
+// term is the error estimate.
+
+// step size controller
+static const double EXPRB_SAFETY = 0.9;
+static const double EXPRB_MIN_FACTOR = 0.2;
+static const double EXPRB_MAX_FACTOR = 6.0;
+static const double EXPRB_MIN_STEP_FRACTION = 1.0e-14;
+// Krylov error of h*phi_p(hJ)b in the weighted norm of the step error
+static const double EXPRB_KRYLOV_TOLERANCE = 0.05;
+static const double EXPRB_HAPPY_BREAKDOWN = 1.0e-12;
+// The dense phi-functions of the Hessenberg matrix cost O(m^3), so the
+// Krylov error is only checked at the dimensions 2, 3, 5, 8, 12, ... (and
+// at exprb_krylov_max_dim), each about EXPRB_KRYLOV_CHECK_GROWTH times
+// the previous one
+static const int EXPRB_KRYLOV_FIRST_CHECK = 2;
+static const double EXPRB_KRYLOV_CHECK_GROWTH = 1.5;
+
+// exp(a) of a small dense n x n row major matrix by scaling and squaring
+// of the Taylor series
+static void DenseExponential(const int n, std::vector<double>* a)
+{
+  double norm = 0.0;
+  for(int j = 0; j < n; ++j) {
+    double column_sum = 0.0;
+    for(int i = 0; i < n; ++i) {
+      column_sum += fabs((*a)[i*n + j]);
+    }
+    norm = std::max(norm, column_sum);
+  }
+  int num_squarings = 0;
+  if(norm > 0.5) {
+    num_squarings = (int)ceil(log2(norm/0.5));
+  }
+  const double scale = ldexp(1.0, -num_squarings);
+  for(int k = 0; k < n*n; ++k) {
+    (*a)[k] *= scale;
+  }
+
+  std::vector<double> result(n*n, 0.0);
+  std::vector<double> term(*a);
+  std::vector<double> product(n*n);
+  for(int i = 0; i < n; ++i) {
+    result[i*n + i] = 1.0;
+  }
+  for(int order = 1; order <= 20; ++order) {
+    double term_norm = 0.0;
+    for(int k = 0; k < n*n; ++k) {
+      result[k] += term[k];
+      term_norm = std::max(term_norm, fabs(term[k]));
+    }
+    if(term_norm < 1.0e-17) break;
+    // term = term*a/(order+1)
+    for(int i = 0; i < n; ++i) {
+      for(int j = 0; j < n; ++j) {
+        double sum = 0.0;
+        for(int l = 0; l < n; ++l) {
+          sum += term[i*n + l]*(*a)[l*n + j];
+        }
+        product[i*n + j] = sum/(order+1);
+      }
+    }
+    term.swap(product);
+  }
+  for(int s = 0; s < num_squarings; ++s) {
+    for(int i = 0; i < n; ++i) {
+      for(int j = 0; j < n; ++j) {
+        double sum = 0.0;
+        for(int l = 0; l < n; ++l) {
+          sum += result[i*n + l]*result[l*n + j];
+        }
+        product[i*n + j] = sum;
+      }
+    }
+    result.swap(product);
+  }
+  a->swap(result);
+}
+
+// phi_k(h*H)e_1 for k = 1..p of the m x m upper Hessenberg H (row major,
+// ld columns), returned in phi[(k-1)*m + i]. The exponential of the
+// augmented matrix [[h*H, e_1, 0], [0, 0, I_(p-1)], [0, 0, 0]] has the
+// phi_k(h*H)e_1 as its last p columns (Sidje, ACM TOMS 24, 1998).
+static void HessenbergPhi(const int m, const int ld, const double* H,
+                          const double h, const int p,
+                          std::vector<double>* phi)
+{
+  const int n = m + p;
+  std::vector<double> a(n*n, 0.0);
+  for(int i = 0; i < m; ++i) {
+    for(int j = 0; j < m; ++j) {
+      a[i*n + j] = h*H[i*ld + j];
+    }
+  }
+  a[m] = 1.0;
+  for(int k = 0; k < p-1; ++k) {
+    a[(m+k)*n + m+k+1] = 1.0;
+  }
+  DenseExponential(n, &a);
+  phi->resize(p*m);
+  for(int k = 0; k < p; ++k) {
+    for(int i = 0; i < m; ++i) {
+      (*phi)[k*m + i] = a[i*n + m+k];
+    }
+  }
+}
+
+ExpRosenbrockContext::ExpRosenbrockContext()
+  :
+      n_(0),
+      max_krylov_dim_(0),
+      abs_tol_(nullptr),
+      abs_tol_corrections_(nullptr)
+{}
+
+ExpRosenbrockContext::~ExpRosenbrockContext() {
+  Free();
+}
+
+void ExpRosenbrockContext::Free() {
+  if(n_ > 0) {
+    N_VDestroy(abs_tol_);
+    N_VDestroy(abs_tol_corrections_);
+    for(size_t j = 0; j < work_.size(); ++j) {
+      N_VDestroy(work_[j]);
+    }
+    for(size_t j = 0; j < basis_.size(); ++j) {
+      N_VDestroy(basis_[j]);
+    }
+  }
+  work_.clear();
+  basis_.clear();
+  n_ = 0;
+  max_krylov_dim_ = 0;
+}
+
+void ExpRosenbrockContext::Resize(int n, int max_krylov_dim, N_Vector y0) {
+  if(n == n_ && max_krylov_dim == max_krylov_dim_) {
+    return;
+  }
+  Free();
+  abs_tol_ = N_VClone(y0);
+  abs_tol_corrections_ = N_VClone(y0);
+  work_.resize(NUM_WORK_VECTORS);
+  for(int j = 0; j < NUM_WORK_VECTORS; ++j) {
+    work_[j] = N_VClone(y0);
+  }
+  basis_.resize(max_krylov_dim+1);
+  for(int j = 0; j <= max_krylov_dim; ++j) {
+    basis_[j] = N_VClone(y0);
+  }
+  hessenberg_.assign((max_krylov_dim+1)*max_krylov_dim, 0.0);
+  n_ = n;
+  max_krylov_dim_ = max_krylov_dim;
+}
+
+ExpRosenbrockSolver::ExpRosenbrockSolver(ReactorBase& reactor)
+  :
+      SolverBase(reactor),
+      reactor_ref_(reactor),
+      context_(nullptr),
+      cb_fn_(nullptr),
+      cb_fn_data_(nullptr),
+      max_krylov_dim_(0)
+{}
+
+void ExpRosenbrockSolver::SetContext(ExpRosenbrockContext* context) {
+  context_ = context;
+}
+
+int ExpRosenbrockSolver::Integrate(const double end_time) {
+  N_Vector& state = reactor_ref_.GetStateNVectorRef();
+  int reactor_id = reactor_ref_.GetID();
+  int num_variables = reactor_ref_.GetNumStateVariables();
+  int num_batches = reactor_ref_.GetNumBatchReactors();
+  reactor_ref_.GetReactorWeightsRef().assign(num_batches,1.0);
+
+  if(context_ == nullptr) {
+    own_context_.reset(new ExpRosenbrockContext());
+    context_ = own_context_.get();
+  }
+  max_krylov_dim_ = std::max(2, int_options_["exprb_krylov_max_dim"]);
+  context_->Resize(num_variables*num_batches, max_krylov_dim_, state);
+
+  N_Vector abs_tol_vector = context_->AbsTol();
+  N_Vector abs_tol_corrections = context_->AbsTolCorrections();
+  reactor_ref_.GetAbsoluteToleranceCorrection(abs_tol_corrections);
+  N_VConst(double_options_["abs_tol"],abs_tol_vector);
+  N_VProd(abs_tol_vector, abs_tol_corrections, abs_tol_vector);
+  const double rel_tol = double_options_["rel_tol"];
+  const double max_dt = std::min(end_time, double_options_["max_dt"]);
+  const double min_dt = EXPRB_MIN_STEP_FRACTION*end_time;
+  const int max_steps = int_options_["max_steps"];
+
+  N_Vector derivative = context_->Work(0);
+  N_Vector stage_state = context_->Work(1);
+  N_Vector stage_derivative = context_->Work(2);
+  N_Vector stage_increment = context_->Work(3);
+  N_Vector jacobian_product = context_->Work(4);
+  N_Vector remainder = context_->Work(5);
+  N_Vector error = context_->Work(6);
+  N_Vector scale = context_->Work(7);
+
+  std::vector<double> root_fn_values(reactor_ref_.GetNumRootFunctions());
+  if(root_fn_values.size() > 0) {
+    reactor_ref_.RootFunction(0.0, state, &root_fn_values[0]);
+  }
+
+  // scale = 1/(abs_tol + rel_tol*|y|) at the start of each step
+  N_VAbs(state, scale);
+  N_VScale(rel_tol, scale, scale);
+  N_VLinearSum(1.0, abs_tol_vector, 1.0, scale, scale);
+  N_VInv(scale, scale);
+
+  double tcurr = 0.0;
+  double h = 0.0;
+  int nsteps = 0;
+  int flag = reactor_ref_.GetTimeDerivative(tcurr, state, derivative);
+  if(flag == 0) {
+    h = InitialStepSize(max_dt, state, derivative, scale);
+  }
+  bool jacobian_current = false;
+  bool last_rejected = false;
+  while(flag == 0 && tcurr < end_time) {
+    if(nsteps >= max_steps) {
+      flag = -1;
+      break;
+    }
+    if(h < min_dt) {
+      flag = -2;
+      break;
+    }
+    bool last_step = false;
+    if(tcurr + 1.01*h >= end_time) {
+      h = end_time - tcurr;
+      last_step = true;
+    }
+
+    if(!jacobian_current) {
+      flag = reactor_ref_.JacobianSetup(tcurr, state, derivative);
+      if(flag != 0) break;
+      jacobian_current = true;
+    }
+
+    // U = y + h*phi_1(hJ) f(y)
+    int step_flag = PhiKrylov(h, 1, derivative, scale, stage_increment);
+    if(step_flag == 0) {
+      N_VLinearSum(1.0, state, 1.0, stage_increment, stage_state);
+      step_flag = reactor_ref_.GetTimeDerivative(tcurr + h, stage_state,
+                                                 stage_derivative);
+    }
+    // g(U) - g(y) = f(U) - f(y) - J*(U - y)
+    if(step_flag == 0) {
+      step_flag = reactor_ref_.JacobianVectorProduct(stage_increment,
+                                                     jacobian_product);
+    }
+    if(step_flag == 0) {
+      N_VLinearSum(1.0, stage_derivative, -1.0, derivative, remainder);
+      N_VLinearSum(1.0, remainder, -1.0, jacobian_product, remainder);
+      step_flag = PhiKrylov(h, 3, remainder, scale, error);
+    }
+
+    double err = 1.0e10;
+    if(step_flag == 0) {
+      N_VScale(2.0, error, error);
+      err = N_VWrmsNorm(error, scale);
+    }
+    if(step_flag != 0 || isnan(err)) {
+      // Krylov space too small for the step, or failed right hand side
+      // evaluation
+      h *= 0.25;
+      last_rejected = true;
+      continue;
+    }
+
+    double factor = EXPRB_SAFETY*pow(std::max(err,1.0e-10),-1.0/3.0);
+    factor = std::max(EXPRB_MIN_FACTOR, std::min(EXPRB_MAX_FACTOR, factor));
+    if(err > 1.0) {
+      h *= factor;
+      last_rejected = true;
+      continue;
+    }
+
+    // accept the order 3 solution U + 2*h*phi_3(hJ)(g(U) - g(y))
+    double tprev = tcurr;
+    tcurr = last_step ? end_time : tcurr + h;
+    N_VLinearSum(1.0, stage_state, 1.0, error, state);
+    nsteps += 1;
+    jacobian_current = false;
+    flag = reactor_ref_.GetTimeDerivative(tcurr, state, derivative);
+    if(flag != 0) break;
+
+    if(cb_fn_ != nullptr) {
+      if(N_VGetVectorID(state) == SUNDIALS_NVEC_SERIAL) {
+        int cb_flag = cb_fn_(reactor_id, nsteps, tcurr, tcurr-tprev, NV_DATA_S(state),
+                             NV_DATA_S(derivative), cb_fn_data_);
+        if(cb_flag != 0) {
+          break;
+        }
+      }
+    }
+    if(CheckRoots(tprev, tcurr, state, &root_fn_values)) {
+      if(int_options_["stop_after_ignition"]) {
+        break;
+      }
+    }
+
+    if(last_rejected) {
+      factor = std::min(factor, 1.0);
+    }
+    last_rejected = false;
+    h = std::min(h*factor, max_dt);
+
+    N_VAbs(state, scale);
+    N_VScale(rel_tol, scale, scale);
+    N_VLinearSum(1.0, abs_tol_vector, 1.0, scale, scale);
+    N_VInv(scale, scale);
+  }
+
+  if(flag != 0) {
+    printf("WARNING: Failed to complete integration.\n");
+    if(nsteps <= 0) {
+      nsteps = -1;
+    } else {
+      nsteps = -nsteps;
+    }
+  }
+
+  return nsteps;
+}
+
+// result = h*phi_p(hJ) b with the Arnoldi approximation
+// beta*V_m phi_p(h*H_m) e_1. The error of the m dimensional approximation is
+// estimated by the next term of the series, beta*h*h_(m+1,m)*
+// [phi_(p+1)(h*H_m) e_1]_m v_(m+1) (Saad, SIAM J. Numer. Anal. 29, 1992).
+// Returns non-zero if the estimate is not below EXPRB_KRYLOV_TOLERANCE with
+// max_krylov_dim_ vectors. The estimate is only evaluated at the check
+// dimensions, so up to a factor EXPRB_KRYLOV_CHECK_GROWTH more vectors than
+// needed may be used.
+int ExpRosenbrockSolver::PhiKrylov(const double h, const int p, N_Vector b,
+                                   N_Vector scale, N_Vector result)
+{
+  const double beta = sqrt(N_VDotProd(b, b));
+  if(beta == 0.0) {
+    N_VConst(0.0, result);
+    return 0;
+  }
+  std::vector<N_Vector>& basis = context_->Basis();
+  std::vector<double>& hessenberg = context_->Hessenberg();
+  std::vector<double>& phi = context_->Phi();
+  const int ld = max_krylov_dim_;
+  std::fill(hessenberg.begin(), hessenberg.end(), 0.0);
+  N_VScale(1.0/beta, b, basis[0]);
+
+  int m = 0;
+  int next_check = EXPRB_KRYLOV_FIRST_CHECK;
+  bool converged = false;
+  for(int j = 0; j < max_krylov_dim_ && !converged; ++j) {
+    int flag = reactor_ref_.JacobianVectorProduct(basis[j], basis[j+1]);
+    if(flag != 0) {
+      return flag;
+    }
+    // modified Gram-Schmidt
+    double column_norm = 0.0;
+    for(int i = 0; i <= j; ++i) {
+      const double hij = N_VDotProd(basis[j+1], basis[i]);
+      hessenberg[i*ld + j] = hij;
+      column_norm += hij*hij;
+      N_VLinearSum(1.0, basis[j+1], -hij, basis[i], basis[j+1]);
+    }
+    const double h_next = sqrt(N_VDotProd(basis[j+1], basis[j+1]));
+    column_norm = sqrt(column_norm + h_next*h_next);
+    m = j+1;
+
+    const bool breakdown = h_next <= EXPRB_HAPPY_BREAKDOWN*column_norm;
+    if(breakdown) {
+      // the Krylov space is invariant and the approximation is exact
+      HessenbergPhi(m, ld, &hessenberg[0], h, p+1, &phi);
+      converged = true;
+      break;
+    }
+    hessenberg[(j+1)*ld + j] = h_next;
+    N_VScale(1.0/h_next, basis[j+1], basis[j+1]);
+    if(m < next_check && m < max_krylov_dim_) {
+      continue;
+    }
+    next_check = std::max(m+1, (int)ceil(EXPRB_KRYLOV_CHECK_GROWTH*m));
+
+    HessenbergPhi(m, ld, &hessenberg[0], h, p+1, &phi);
+    const double next_term = beta*h*h*h_next*phi[p*m + m-1];
+    const double krylov_error = fabs(next_term)*N_VWrmsNorm(basis[j+1], scale);
+    converged = krylov_error <= EXPRB_KRYLOV_TOLERANCE;
+  }
+  if(!converged) {
+    return -1;
+  }
+
+  N_VConst(0.0, result);
+  for(int i = 0; i < m; ++i) {
+    N_VLinearSum(beta*h*phi[(p-1)*m + i], basis[i], 1.0, result, result);
+  }
+  return 0;
+}
+
+double ExpRosenbrockSolver::InitialStepSize(const double max_dt, N_Vector y,
+                                            N_Vector f, N_Vector scale)
+{
+  // h = 0.01*|y|/|f| in the weighted norm (Hairer, Norsett and Wanner)
+  const double y_norm = N_VWrmsNorm(y, scale);
+  const double f_norm = N_VWrmsNorm(f, scale);
+  double h = 1.0e-6;
+  if(y_norm > 1.0e-5 && f_norm > 1.0e-5) {
+    h = 0.01*y_norm/f_norm;
+  }
+  return std::min(h, max_dt);
+}
+
+bool ExpRosenbrockSolver::CheckRoots(const double t_prev, const double t,
+                                     N_Vector y,
+                                     std::vector<double>* root_fn_values)
+{
+  const int num_root_fns = root_fn_values->size();
+  if(num_root_fns == 0) {
+    return false;
+  }
+  std::vector<double> current_root_fn_values(num_root_fns);
+  reactor_ref_.RootFunction(t, y, &current_root_fn_values[0]);
+  bool found = false;
+  double t_root = t;
+  for(int i = 0; i < num_root_fns; ++i) {
+    const double last_value = (*root_fn_values)[i];
+    const double current_value = current_root_fn_values[i];
+    if((last_value > 0.0 && current_value <= 0.0) ||
+       (last_value < 0.0 && current_value >= 0.0)) {
+      // linear interpolation of the crossing over the step
+      double t_cross = t_prev + (t - t_prev)*last_value/(last_value - current_value);
+      if(!found || t_cross < t_root) {
+        t_root = t_cross;
+      }
+      found = true;
+    }
+  }
+  root_fn_values->swap(current_root_fn_values);
+  if(found) {
+    reactor_ref_.SetRootTime(t_root);
+  }
+  return found;
+}
+
+void ExpRosenbrockSolver::SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data) {
+  cb_fn_ = fn;
+  cb_fn_data_ = cb_fn_data;
+}
@@ -0,0 +1,88 @@
+#ifndef SOLVER_EXPRB_H_
+#define SOLVER_EXPRB_H_
+
+#include <memory>
+#include <vector>
+
+#include "solver_base.h"
+#include "reactor_base.h"
+
+#include "sundials/sundials_nvector.h"
+
+// Exponential Rosenbrock integrator exprb32 of Hochbruck, Ostermann and
+// Schweitzer (order 3 with an embedded exponential Rosenbrock-Euler error
+// estimate). The actions of the phi-functions of h*J are computed in Krylov
+// subspaces built with JacobianVectorProduct, so each step uses one
+// JacobianSetup, two right hand side evaluations and one product per Krylov
+// vector, and no matrix is factored. The Krylov dimension is limited by
+// exprb_krylov_max_dim, steps that need more vectors are retried with a
+// smaller step size. As with RODAS4 the explicit time dependence of the
+// reactor right hand side is not included in the stages.
+
+// Work vectors, Arnoldi basis and upper Hessenberg matrix of the exprb32
+// integrator, kept across integrations by the reactor manager like the
+// SeulexContext.
+class ExpRosenbrockContext
+{
+ public:
+  ExpRosenbrockContext();
+  ~ExpRosenbrockContext();
+
+  // (Re-)allocates only when n or max_krylov_dim changes
+  void Resize(int n, int max_krylov_dim, N_Vector y0);
+  N_Vector AbsTol() { return abs_tol_; };
+  N_Vector AbsTolCorrections() { return abs_tol_corrections_; };
+  N_Vector Work(int j) { return work_[j]; };
+  // max_krylov_dim+1 vectors
+  std::vector<N_Vector>& Basis() { return basis_; };
+  // row major with max_krylov_dim columns
+  std::vector<double>& Hessenberg() { return hessenberg_; };
+  std::vector<double>& Phi() { return phi_; };
+
+  static const int NUM_WORK_VECTORS = 8;
+
+ private:
+  int n_;
+  int max_krylov_dim_;
+  N_Vector abs_tol_;
+  N_Vector abs_tol_corrections_;
+  std::vector<N_Vector> work_;
+  std::vector<N_Vector> basis_;
+  std::vector<double> hessenberg_;
+  std::vector<double> phi_;
+  void Free();
+};
+
+class ExpRosenbrockSolver : public SolverBase
+{
+ public:
+  ExpRosenbrockSolver(ReactorBase& reactor);
+  ~ExpRosenbrockSolver() {};
+
+  int Integrate(const double end_time);
+  int Iterative() { return 0; };
+
+  void SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data);
+
+  // Integrate with a shared workspace instead of one owned by the solver
+  void SetContext(ExpRosenbrockContext* context);
+
+ private:
+  ReactorBase& reactor_ref_;
+  ExpRosenbrockContext* context_;
+  std::unique_ptr<ExpRosenbrockContext> own_context_;
+
+  zerork_callback_fn cb_fn_;
+  void* cb_fn_data_;
+
+  int max_krylov_dim_;
+
+  int PhiKrylov(const double h, const int p, N_Vector b, N_Vector scale,
+                N_Vector result);
+  double InitialStepSize(const double max_dt, N_Vector y, N_Vector f,
+                         N_Vector scale);
+  bool CheckRoots(const double t_prev, const double t, N_Vector y,
+                  std::vector<double>* root_fn_values);
+};
+
+#endif
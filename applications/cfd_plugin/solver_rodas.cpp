@@ -0,0 +1,273 @@
+
+#include <math.h>
+#include <algorithm> //std::min,max
+#include <vector>
+
+#include "solver_rodas.h"
+#include "utility_funcs.h"
+
+#include "nvector/nvector_serial.h"
+
+// RODAS4 coefficients from Hairer and Wanner, Solving Ordinary Differential
+// Equations II. The stages solve
+//
+//   (I - h*gamma*J) k_i = h*gamma*f(t + c_i*h, y + sum_j a_ij k_j)
+//                         + gamma*sum_j c_ij k_j
+//
+// and the last two stages are evaluated at t+h so that the solution
+// y + sum_j a_6j k_j + k_6 is stiffly accurate. k_6 is the error estimate.
+static const int RODAS_NUM_STAGES = 6;
+static const double RODAS_GAMMA = 0.25;
+static const double RODAS_C[RODAS_NUM_STAGES] =
+  {0.0, 0.386, 0.21, 0.63, 1.0, 1.0};
+static const double RODAS_A[RODAS_NUM_STAGES][RODAS_NUM_STAGES-1] = {
+  {0.0, 0.0, 0.0, 0.0, 0.0},
+  {1.544, 0.0, 0.0, 0.0, 0.0},
+  {0.9466785280815826, 0.2557011698983284, 0.0, 0.0, 0.0},
+  {3.314825187068521, 2.896124015972201, 0.9986419139977817, 0.0, 0.0},
+  {1.221224509226641, 6.019134481288629, 12.53708332932087,
+   -0.6878860361058950, 0.0},
+  {1.221224509226641, 6.019134481288629, 12.53708332932087,
+   -0.6878860361058950, 1.0}
+};
+static const double RODAS_CK[RODAS_NUM_STAGES][RODAS_NUM_STAGES-1] = {
+  {0.0, 0.0, 0.0, 0.0, 0.0},
+  {-5.6688, 0.0, 0.0, 0.0, 0.0},
+  {-2.430093356833875, -0.2063599157091915, 0.0, 0.0, 0.0},
+  {-0.1073529058151375, -9.594562251023355, -20.47028614809616, 0.0, 0.0},
+  {7.496443313967647, -10.24680431464352, -33.99990352819905,
+   11.70890893206160, 0.0},
+  {8.083246795921522, -7.981132988064893, -31.52159432874371,
+   16.31930543123136, -6.058818238834054}
+};
+
+// step size controller
+static const double RODAS_SAFETY = 0.9;
+static const double RODAS_MIN_FACTOR = 0.2;
+static const double RODAS_MAX_FACTOR = 6.0;
+static const double RODAS_MIN_STEP_FRACTION = 1.0e-14;
+
+RodasSolver::RodasSolver(ReactorBase& reactor)
+  :
+      SolverBase(reactor),
+      reactor_ref_(reactor),
+      cb_fn_(nullptr),
+      cb_fn_data_(nullptr)
+{}
+
+int RodasSolver::Integrate(const double end_time) {
+  N_Vector& state = reactor_ref_.GetStateNVectorRef();
+  int reactor_id = reactor_ref_.GetID();
+  int num_batches = reactor_ref_.GetNumBatchReactors();
+  reactor_ref_.GetReactorWeightsRef().assign(num_batches,1.0);
+
+  N_Vector abs_tol_vector = N_VClone(state);
+  N_Vector abs_tol_corrections = N_VClone(state);
+  reactor_ref_.GetAbsoluteToleranceCorrection(abs_tol_corrections);
+  N_VConst(double_options_["abs_tol"],abs_tol_vector);
+  N_VProd(abs_tol_vector, abs_tol_corrections, abs_tol_vector);
+  N_VDestroy(abs_tol_corrections);
+  const double rel_tol = double_options_["rel_tol"];
+  const double max_dt = std::min(end_time, double_options_["max_dt"]);
+  const double min_dt = RODAS_MIN_STEP_FRACTION*end_time;
+  const int max_steps = int_options_["max_steps"];
+
+  N_Vector derivative = N_VClone(state);
+  N_Vector stage_state = N_VClone(state);
+  N_Vector stage_derivative = N_VClone(state);
+  N_Vector rhs = N_VClone(state);
+  N_Vector scale = N_VClone(state);
+  std::vector<N_Vector> k(RODAS_NUM_STAGES);
+  for(int i = 0; i < RODAS_NUM_STAGES; ++i) {
+    k[i] = N_VClone(state);
+  }
+
+  std::vector<double> root_fn_values(reactor_ref_.GetNumRootFunctions());
+  if(root_fn_values.size() > 0) {
+    reactor_ref_.RootFunction(0.0, state, &root_fn_values[0]);
+  }
+
+  // scale = 1/(abs_tol + rel_tol*|y|) at the start of each step
+  N_VAbs(state, scale);
+  N_VScale(rel_tol, scale, scale);
+  N_VLinearSum(1.0, abs_tol_vector, 1.0, scale, scale);
+  N_VInv(scale, scale);
+
+  double tcurr = 0.0;
+  double h = 0.0;
+  int nsteps = 0;
+  int flag = reactor_ref_.GetTimeDerivative(tcurr, state, derivative);
+  if(flag == 0) {
+    h = InitialStepSize(max_dt, state, derivative, scale);
+  }
+  bool jacobian_current = false;
+  bool last_rejected = false;
+  while(flag == 0 && tcurr < end_time) {
+    if(nsteps >= max_steps) {
+      flag = -1;
+      break;
+    }
+    if(h < min_dt) {
+      flag = -2;
+      break;
+    }
+    bool last_step = false;
+    if(tcurr + 1.01*h >= end_time) {
+      h = end_time - tcurr;
+      last_step = true;
+    }
+
+    if(!jacobian_current) {
+      flag = reactor_ref_.JacobianSetup(tcurr, state, derivative);
+      if(flag != 0) break;
+      jacobian_current = true;
+    }
+    const double hgamma = h*RODAS_GAMMA;
+    int step_flag = reactor_ref_.JacobianFactor(hgamma);
+
+    for(int i = 0; i < RODAS_NUM_STAGES && step_flag == 0; ++i) {
+      N_Vector f = derivative;
+      if(i > 0) {
+        N_VScale(1.0, state, stage_state);
+        for(int j = 0; j < i; ++j) {
+          if(RODAS_A[i][j] != 0.0) {
+            N_VLinearSum(RODAS_A[i][j], k[j], 1.0, stage_state, stage_state);
+          }
+        }
+        step_flag = reactor_ref_.GetTimeDerivative(tcurr + RODAS_C[i]*h,
+                                                   stage_state, stage_derivative);
+        if(step_flag != 0) break;
+        f = stage_derivative;
+      }
+      N_VScale(hgamma, f, rhs);
+      for(int j = 0; j < i; ++j) {
+        N_VLinearSum(RODAS_GAMMA*RODAS_CK[i][j], k[j], 1.0, rhs, rhs);
+      }
+      step_flag = reactor_ref_.JacobianSolve(tcurr, state, derivative, rhs, k[i]);
+    }
+
+    double err = 1.0e10;
+    if(step_flag == 0) {
+      err = N_VWrmsNorm(k[RODAS_NUM_STAGES-1], scale);
+    }
+    if(step_flag != 0 || isnan(err)) {
+      // failed linear solve or right hand side evaluation
+      h *= 0.25;
+      last_rejected = true;
+      continue;
+    }
+
+    double factor = RODAS_SAFETY*pow(std::max(err,1.0e-10),-0.25);
+    factor = std::max(RODAS_MIN_FACTOR, std::min(RODAS_MAX_FACTOR, factor));
+    if(err > 1.0) {
+      h *= factor;
+      last_rejected = true;
+      continue;
+    }
+
+    // accept y + sum_j a_6j k_j + k_6
+    double tprev = tcurr;
+    tcurr = last_step ? end_time : tcurr + h;
+    N_VLinearSum(1.0, stage_state, 1.0, k[RODAS_NUM_STAGES-1], state);
+    nsteps += 1;
+    jacobian_current = false;
+    flag = reactor_ref_.GetTimeDerivative(tcurr, state, derivative);
+    if(flag != 0) break;
+
+    if(cb_fn_ != nullptr) {
+      if(N_VGetVectorID(state) == SUNDIALS_NVEC_SERIAL) {
+        int cb_flag = cb_fn_(reactor_id, nsteps, tcurr, tcurr-tprev, NV_DATA_S(state),
+                             NV_DATA_S(derivative), cb_fn_data_);
+        if(cb_flag != 0) {
+          break;
+        }
+      }
+    }
+    if(CheckRoots(tprev, tcurr, state, &root_fn_values)) {
+      if(int_options_["stop_after_ignition"]) {
+        break;
+      }
+    }
+
+    if(last_rejected) {
+      factor = std::min(factor, 1.0);
+    }
+    last_rejected = false;
+    h = std::min(h*factor, max_dt);
+
+    N_VAbs(state, scale);
+    N_VScale(rel_tol, scale, scale);
+    N_VLinearSum(1.0, abs_tol_vector, 1.0, scale, scale);
+    N_VInv(scale, scale);
+  }
+
+  if(flag != 0) {
+    printf("WARNING: Failed to complete integration.\n");
+    if(nsteps <= 0) {
+      nsteps = -1;
+    } else {
+      nsteps = -nsteps;
+    }
+  }
+
+  for(int i = 0; i < RODAS_NUM_STAGES; ++i) {
+    N_VDestroy(k[i]);
+  }
+  N_VDestroy(derivative);
+  N_VDestroy(stage_state);
+  N_VDestroy(stage_derivative);
+  N_VDestroy(rhs);
+  N_VDestroy(scale);
+  N_VDestroy(abs_tol_vector);
+
+  return nsteps;
+}
+
+double RodasSolver::InitialStepSize(const double max_dt, N_Vector y, N_Vector f,
+                                    N_Vector scale)
+{
+  // h = 0.01*|y|/|f| in the weighted norm (Hairer, Norsett and Wanner)
+  const double y_norm = N_VWrmsNorm(y, scale);
+  const double f_norm = N_VWrmsNorm(f, scale);
+  double h = 1.0e-6;
+  if(y_norm > 1.0e-5 && f_norm > 1.0e-5) {
+    h = 0.01*y_norm/f_norm;
+  }
+  return std::min(h, max_dt);
+}
+
+bool RodasSolver::CheckRoots(const double t_prev, const double t, N_Vector y,
+                             std::vector<double>* root_fn_values)
+{
+  const int num_root_fns = root_fn_values->size();
+  if(num_root_fns == 0) {
+    return false;
+  }
+  std::vector<double> current_root_fn_values(num_root_fns);
+  reactor_ref_.RootFunction(t, y, &current_root_fn_values[0]);
+  bool found = false;
+  double t_root = t;
+  for(int i = 0; i < num_root_fns; ++i) {
+    const double last_value = (*root_fn_values)[i];
+    const double current_value = current_root_fn_values[i];
+    if((last_value > 0.0 && current_value <= 0.0) ||
+       (last_value < 0.0 && current_value >= 0.0)) {
+      // linear interpolation of the crossing over the step
+      double t_cross = t_prev + (t - t_prev)*last_value/(last_value - current_value);
+      if(!found || t_cross < t_root) {
+        t_root = t_cross;
+      }
+      found = true;
+    }
+  }
+  root_fn_values->swap(current_root_fn_values);
+  if(found) {
+    reactor_ref_.SetRootTime(t_root);
+  }
+  return found;
+}
+
+void RodasSolver::SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data) {
+  cb_fn_ = fn;
+  cb_fn_data_ = cb_fn_data;
+}
@@ -0,0 +1,43 @@
+#ifndef SOLVER_RODAS_H_
+#define SOLVER_RODAS_H_
+
+#include <string>
+#include <vector>
+
+#include "solver_base.h"
+#include "reactor_base.h"
+
+#include "sundials/sundials_nvector.h"
+
+// Linearly implicit one step Rosenbrock integrator using the L-stable,
+// stiffly accurate RODAS4 method of Hairer and Wanner (order 4 with an
+// embedded order 3 error estimate). Each step uses one JacobianSetup, one
+// JacobianFactor with gamma = h*0.25 and six JacobianSolve calls, and needs
+// no nonlinear iteration. No history is kept between steps, so every
+// integration starts at full order. The explicit time dependence of the
+// reactor right hand side (pressure and energy sources) is not included in
+// the stage equations.
+class RodasSolver : public SolverBase
+{
+ public:
+  RodasSolver(ReactorBase& reactor);
+  ~RodasSolver() {};
+
+  int Integrate(const double end_time);
+  int Iterative() { return 0; };
+
+  void SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data);
+
+ private:
+  ReactorBase& reactor_ref_;
+
+  zerork_callback_fn cb_fn_;
+  void* cb_fn_data_;
+
+  double InitialStepSize(const double max_dt, N_Vector y, N_Vector f,
+                         N_Vector scale);
+  bool CheckRoots(const double t_prev, const double t, N_Vector y,
+                  std::vector<double>* root_fn_values);
+};
+
+#endif
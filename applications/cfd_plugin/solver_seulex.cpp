@@ -13,10 +13,64 @@ static int SeulexSolverMonitorFn(int nsteps, double x, double h, N_Vector y, N_V
   return solver->MonitorFn(nsteps, x, h, y, ydot);
 }
 
+SeulexContext::SeulexContext()
+  :
+      n_(0),
+      abs_tol_(nullptr),
+      rel_tol_(nullptr),
+      abs_tol_corrections_(nullptr)
+{}
+
+SeulexContext::~SeulexContext() {
+  solver_.reset();
+  if(n_ > 0) {
+    N_VDestroy(abs_tol_);
+    N_VDestroy(rel_tol_);
+    N_VDestroy(abs_tol_corrections_);
+  }
+}
+
+seulex_cpp::seulex& SeulexContext::GetSolver(int n, N_Vector y0) {
+  if(n != n_) {
+    if(n_ > 0) {
+      N_VDestroy(abs_tol_);
+      N_VDestroy(rel_tol_);
+      N_VDestroy(abs_tol_corrections_);
+    }
+    abs_tol_ = N_VClone(y0);
+    rel_tol_ = N_VClone(y0);
+    abs_tol_corrections_ = N_VClone(y0);
+    if(solver_) {
+      solver_->resize(n, y0);
+    } else {
+      solver_.reset(new seulex_cpp::seulex(n, y0));
+    }
+    n_ = n;
+  }
+  return *solver_;
+}
+
+bool SeulexContext::GetWarmStart(int reactor_id, double* h, int* k) const {
+  std::unordered_map<int, warm_start>::const_iterator it = warm_starts_.find(reactor_id);
+  if(it == warm_starts_.end()) {
+    return false;
+  }
+  *h = it->second.h;
+  *k = it->second.k;
+  return true;
+}
+
+void SeulexContext::SetWarmStart(int reactor_id, double h, int k) {
+  warm_start& ws = warm_starts_[reactor_id];
+  ws.h = h;
+  ws.k = k;
+}
+
 SeulexSolver::SeulexSolver(ReactorBase& reactor)
   :
       SolverBase(reactor),
       reactor_ref_(reactor),
+      context_(nullptr),
       cb_fn_(nullptr),
       cb_fn_data_(nullptr)
 {}
@@ -25,28 +79,53 @@ int SeulexSolver::Integrate(const double end_time) {
   N_Vector& state = reactor_ref_.GetStateNVectorRef();
   int num_variables = reactor_ref_.GetNumStateVariables();
   int num_batches = reactor_ref_.GetNumBatchReactors();
-  seulex_cpp::seulex s(num_variables*num_batches, state);
+  if(context_ == nullptr) {
+    own_context_.reset(new SeulexContext());
+    context_ = own_context_.get();
+  }
+  seulex_cpp::seulex& s = context_->GetSolver(num_variables*num_batches, state);
 
-  N_Vector abs_tol_vector = N_VClone(state);
-  N_Vector rel_tol_vector = N_VClone(state);
+  N_Vector abs_tol_vector = context_->AbsTol();
+  N_Vector rel_tol_vector = context_->RelTol();
   N_VConst(double_options_["abs_tol"],abs_tol_vector);
   N_VConst(double_options_["rel_tol"],rel_tol_vector);
 
-  N_Vector abs_tol_corrections = N_VClone(state);
+  N_Vector abs_tol_corrections = context_->AbsTolCorrections();
   reactor_ref_.GetAbsoluteToleranceCorrection(abs_tol_corrections);
   N_VProd(abs_tol_vector, abs_tol_corrections, abs_tol_vector);
 
   s.set_tolerances(rel_tol_vector,abs_tol_vector);
-  N_VDestroy(abs_tol_vector);
-  N_VDestroy(rel_tol_vector);
-  N_VDestroy(abs_tol_corrections);
 
-  s.set_hinit(end_time);
+  // Warm start from the last accepted step of the same reactor. Only for
+  // single reactors, the step of a batch depends on its members.
+  bool warm_start = int_options_["seulex_warm_start"] == 1 && num_batches == 1;
+  int reactor_id = reactor_ref_.GetID();
+  double h_warm = 0.0;
+  int k_warm = 0;
+  if(warm_start && context_->GetWarmStart(reactor_id, &h_warm, &k_warm)) {
+    s.set_hinit(std::min(h_warm,end_time));
+    s.set_kinit(k_warm);
+  } else {
+    s.set_hinit(end_time);
+    s.set_kinit(0);
+  }
   s.set_nmax(int_options_["max_steps"]);
   s.set_hmax(std::min(end_time,double_options_["max_dt"]));
   s.set_user_data((void*) &(reactor_ref_));
   s.set_work_params(1.0, 3.0, 8.0, 1.5); //fcn, jac, decomp, solve
-  s.set_nsequ(2);
+  if(column_reactors_.size() > 0) {
+    std::vector<void*> worker_data(1, (void*) &(reactor_ref_));
+    for(size_t j = 0; j < column_reactors_.size(); ++j) {
+      worker_data.push_back((void*) column_reactors_[j]);
+    }
+    s.set_parallel_user_data(worker_data);
+    // step numbers 2,3,4,5,... balance the concurrent columns better than
+    // the doubling sequence, whose last column dominates the step
+    s.set_nsequ(4);
+  } else {
+    s.set_parallel_user_data(std::vector<void*>());
+    s.set_nsequ(2);
+  }
 
   s.set_deriv_fcn(ReactorGetTimeDerivative);
   s.set_jac_fcn(ReactorJacobianSetup);
@@ -82,6 +161,11 @@ int SeulexSolver::Integrate(const double end_time) {
   int nfcn, njac, nsteps, naccpt, nrejct, ndec, nsol;
   s.get_integrator_stats(&nfcn,&njac,&nsteps,&naccpt,&nrejct,&ndec,&nsol);
 
+  if(warm_start && flag == 0) {
+    s.get_last_step(&h_warm, &k_warm);
+    context_->SetWarmStart(reactor_id, h_warm, k_warm);
+  }
+
   if(flag != 0) {
     printf("WARNING: Failed to complete integration.\n");
     if(nsteps <= 0) {
@@ -105,6 +189,14 @@ void SeulexSolver::AdjustWeights() {
   return;
 }
 
+void SeulexSolver::SetColumnReactors(const std::vector<ReactorBase*>& column_reactors) {
+  column_reactors_ = column_reactors;
+}
+
+void SeulexSolver::SetContext(SeulexContext* context) {
+  context_ = context;
+}
+
 void SeulexSolver::SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data) {
   cb_fn_ = fn;
   cb_fn_data_ = cb_fn_data;
@@ -115,7 +207,10 @@ int SeulexSolver::MonitorFn(int nsteps, double x, double h, N_Vector y, N_Vector
   int reactor_id = reactor_ref_.GetID();
   int num_root_fns = ReactorGetNumRootFunctions(&reactor_ref_);
   if(num_root_fns > 0) {
-    static std::vector<double> last_root_fn_values(num_root_fns,0.0);
+    static std::vector<double> last_root_fn_values;
+    if((int)last_root_fn_values.size() != num_root_fns) {
+      last_root_fn_values.assign(num_root_fns,0.0);
+    }
     std::vector<double> current_root_fn_values(num_root_fns);
     int flag = ReactorRootFunction(x, y, &current_root_fn_values[0], &reactor_ref_);
     if(nsteps > 0) {
@@ -1,13 +1,51 @@
 #ifndef SOLVER_SEULEX_H_
 #define SOLVER_SEULEX_H_
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "solver_base.h"
 #include "reactor_base.h"
 
 #include "sundials/sundials_nvector.h"
 
+namespace seulex_cpp { class seulex; }
+
+// Persistent SEULEX workspace. The integrator and its work and tolerance
+// vectors are allocated once and re-initialized for every reactor that is
+// solved with it, and the last accepted step size and order of each reactor
+// id are kept for a warm start of its next integration. A context must only
+// be used by one thread at a time.
+class SeulexContext
+{
+ public:
+  SeulexContext();
+  ~SeulexContext();
+
+  // Integrator for n variables, (re-)allocated only when n changes
+  seulex_cpp::seulex& GetSolver(int n, N_Vector y0);
+  N_Vector AbsTol() { return abs_tol_; };
+  N_Vector RelTol() { return rel_tol_; };
+  N_Vector AbsTolCorrections() { return abs_tol_corrections_; };
+
+  bool GetWarmStart(int reactor_id, double* h, int* k) const;
+  void SetWarmStart(int reactor_id, double h, int k);
+
+ private:
+  int n_;
+  std::unique_ptr<seulex_cpp::seulex> solver_;
+  N_Vector abs_tol_;
+  N_Vector rel_tol_;
+  N_Vector abs_tol_corrections_;
+  struct warm_start {
+    double h;
+    int k;
+  };
+  std::unordered_map<int, warm_start> warm_starts_;
+};
+
 class SeulexSolver : public SolverBase
 {
  public:
@@ -20,8 +58,19 @@ class SeulexSolver : public SolverBase
   void SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data);
   int MonitorFn(int nsteps, double x, double h, N_Vector y, N_Vector ydot);
 
+  // Parallel extrapolation. The columns of the extrapolation tableau are
+  // computed concurrently by the reactor and the column reactors, which must
+  // be initialized to the same state as the reactor before Integrate.
+  void SetColumnReactors(const std::vector<ReactorBase*>& column_reactors);
+
+  // Integrate with a shared workspace instead of one owned by the solver
+  void SetContext(SeulexContext* context);
+
  private:
   ReactorBase& reactor_ref_;
+  std::vector<ReactorBase*> column_reactors_;
+  SeulexContext* context_;
+  std::unique_ptr<SeulexContext> own_context_;
   void AdjustWeights();
 
   zerork_callback_fn cb_fn_;
@@ -203,6 +203,96 @@ zerork_status_t zerork_reactor_set_reactor_ids(int * reactor_ids,
   return zrm->SetReactorIDs(reactor_ids);
 }
 
+extern "C"
+zerork_status_t zerork_reactor_get_num_species(int* num_species,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->GetNumSpecies(num_species);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_get_species_index(const char* species_name,
+                                   int* species_index,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  if(species_name == nullptr) return ZERORK_STATUS_INVALID_POINTER;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  std::string species_name_str(species_name);
+  return zrm->GetSpeciesIndex(species_name_str, species_index);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_get_premixed_mass_fractions(const double* fuel_mole_fracs,
+                                   const double* oxid_mole_fracs,
+                                   double phi,
+                                   double egr,
+                                   double* mass_fracs,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->GetPremixedMassFractions(fuel_mole_fracs, oxid_mole_fracs,
+                                       phi, egr, mass_fracs);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_get_arrhenius_parameters(int reaction_id,
+                                   int direction,
+                                   double* A,
+                                   double* Tpow,
+                                   double* Ea,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->GetArrheniusParameters(reaction_id, direction, A, Tpow, Ea);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_set_arrhenius_parameters(int reaction_id,
+                                   int direction,
+                                   double A,
+                                   double Tpow,
+                                   double Ea,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->SetArrheniusParameters(reaction_id, direction, A, Tpow, Ea);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_get_num_plog_lines(int reaction_id,
+                                   int* num_lines,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->GetNumPLogLines(reaction_id, num_lines);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_get_plog_parameters(int reaction_id,
+                                   int line_id,
+                                   double* pressure,
+                                   double* A,
+                                   double* Tpow,
+                                   double* Ea,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->GetPLogParameters(reaction_id, line_id, pressure, A, Tpow, Ea);
+}
+
+extern "C"
+zerork_status_t zerork_reactor_set_plog_parameters(int reaction_id,
+                                   int line_id,
+                                   double A,
+                                   double Tpow,
+                                   double Ea,
+                                   zerork_handle handle) {
+  if(handle == nullptr) return ZERORK_STATUS_INVALID_HANDLE;
+  ZeroRKReactorManagerBase* zrm = handle->r.get();
+  return zrm->SetPLogParameters(reaction_id, line_id, A, Tpow, Ea);
+}
+
 extern "C"
 zerork_status_t zerork_reactor_free(zerork_handle handle) {
   if(handle == nullptr) {
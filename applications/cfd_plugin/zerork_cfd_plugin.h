@@ -28,6 +28,7 @@ typedef enum _zerork_status_t {
   ZERORK_STATUS_FAILED_OPTIONS_PARSE,
   ZERORK_STATUS_FAILED_SOLVE,
   ZERORK_STATUS_OPTION_NOT_DEFINED,
+  ZERORK_STATUS_INVALID_PARAMETER,
   ZERORK_STATUS_UNKNOWN_ERROR = 99,
 } zerork_status_t;
 
@@ -84,6 +85,63 @@ zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_set_callback_fn(zerork_
 
 zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_set_reactor_ids(int* reactor_ids, zerork_handle handle);
 
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_get_num_species(int* num_species,
+                                   zerork_handle handle);
+
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_get_species_index(const char* species_name,
+                                   int* species_index,
+                                   zerork_handle handle);
+
+// Mass fractions of a premixed fuel/oxidizer blend at equivalence ratio phi,
+// diluted by the mass fraction egr of its ideal exhaust. The mole fraction
+// arrays are num_species long and are normalized.
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_get_premixed_mass_fractions(const double* fuel_mole_fracs,
+                                   const double* oxid_mole_fracs,
+                                   double phi,
+                                   double egr,
+                                   double* mass_fracs,
+                                   zerork_handle handle);
+
+// Runtime changes of the kinetic parameters of the loaded mechanism. The
+// units are those of the mechanism file (cm, mol, s, and the activation
+// energy units of the REACTIONS line) and direction is 1 for the forward and
+// -1 for the reverse rate of reaction_id. Reverse rates computed from the
+// equilibrium constant follow the forward rate and cannot be set. The
+// mechanism is loaded if needed; the parameters must be set on every rank
+// before zerork_reactor_solve.
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_get_arrhenius_parameters(int reaction_id,
+                                   int direction,
+                                   double* A,
+                                   double* Tpow,
+                                   double* Ea,
+                                   zerork_handle handle);
+
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_set_arrhenius_parameters(int reaction_id,
+                                   int direction,
+                                   double A,
+                                   double Tpow,
+                                   double Ea,
+                                   zerork_handle handle);
+
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_get_num_plog_lines(int reaction_id,
+                                   int* num_lines,
+                                   zerork_handle handle);
+
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_get_plog_parameters(int reaction_id,
+                                   int line_id,
+                                   double* pressure,
+                                   double* A,
+                                   double* Tpow,
+                                   double* Ea,
+                                   zerork_handle handle);
+
+zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_set_plog_parameters(int reaction_id,
+                                   int line_id,
+                                   double A,
+                                   double Tpow,
+                                   double Ea,
+                                   zerork_handle handle);
+
 zerork_status_t ZERORK_CFD_PLUGIN_EXPORTS zerork_reactor_free(zerork_handle handle);
 
 
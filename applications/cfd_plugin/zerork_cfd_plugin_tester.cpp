@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "utility_funcs.h"
+#include "reactor_state_trace.h"
 #include "ZeroRKCFDPluginTesterIFP.h"
 
 #include "zerork/mechanism.h"
@@ -17,6 +18,10 @@
 #include "mpi.h"
 #endif
 
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
 using zerork::getHighResolutionTime;
 
 template <typename T>
@@ -37,6 +42,9 @@ static void log_output(int step, double time, int n_print_reactors,
                        std::vector<int> log_species_indexes, std::vector<std::string> log_species_names,
                        int nsp, std::vector<std::shared_ptr<std::ofstream>> reactor_log_files);
 
+static void replay_reactor_states(const ZeroRKCFDPluginTesterIFP& inputFileDB,
+                                  int nSpc);
+
 
 typedef struct UserData {
   int nsteps;
@@ -119,6 +127,18 @@ void zerork_reactor(int inp_argc, char **inp_argv)
 
 
   int nSpc=mech.getNumSpecies();
+  if(inputFileDB.replay_files().size() != 0) {
+    replay_reactor_states(inputFileDB, nSpc);
+#ifdef USE_OMP
+#pragma omp parallel
+    {
+#endif
+    zerork_reactor_free(zrm_handle);
+#ifdef USE_OMP
+    }
+#endif
+    return;
+  }
   int nState=nSpc+1;
   int nStep=mech.getNumSteps();
   int nSpcStride = nSpc;
@@ -569,4 +589,236 @@ static void log_output(int step, double time, int n_print_reactors,
       }
 }
 
+// Re-solves the zerork_reactor_solve calls recorded by the plugin with
+// reactor_state_capture_file. Record i of every replay file is solved in one
+// call, so the traces captured on several ranks are replayed together and
+// distributed by the plugin over the ranks of the replay. The plugin options
+// (integrator, dense, thresholds, ...) come from zerork_cfd_plugin_input.
+static void replay_reactor_states(const ZeroRKCFDPluginTesterIFP& inputFileDB,
+                                  int nSpc)
+{
+  int rank = 0;
+  int nranks = 1;
+#ifdef USE_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&nranks);
+#endif
+  int nthreads = 1;
+#ifdef USE_OMP
+  nthreads = omp_get_max_threads();
+#endif
+  const bool batched = inputFileDB.batched() || nranks > 1;
+
+  const std::vector<std::string>& replay_files = inputFileDB.replay_files();
+  std::vector<std::unique_ptr<ReactorStateTraceReader> > readers;
+  if(rank == 0) {
+    for(size_t j = 0; j < replay_files.size(); ++j) {
+      readers.push_back(std::make_unique<ReactorStateTraceReader>());
+      if(!readers[j]->Open(replay_files[j])) {
+        printf("ERROR: could not read reactor state trace %s\n",
+               replay_files[j].c_str());
+        fflush(stdout); exit(-1);
+      }
+      if(readers[j]->num_species() != nSpc) {
+        printf("ERROR: reactor state trace %s has %d species,"
+               " the mechanism has %d\n",
+               replay_files[j].c_str(), readers[j]->num_species(), nSpc);
+        fflush(stdout); exit(-1);
+      }
+    }
+  }
 
+  std::vector<double> reactorT, reactorP, reactorMassFrac;
+  std::vector<double> reactorDPDT, reactorESRC, reactorYsrc;
+  std::vector<double> reactorCost, reactorGpu;
+  std::vector<double> thread_time(nthreads, 0.0);
+  // histogram of the steps per reactor in powers of two
+  const int n_histogram_bins = 24;
+  std::vector<long> steps_histogram(n_histogram_bins, 0);
+  long n_reactor_solves = 0;
+  double n_steps_total = 0.0;
+  int n_solve_calls = 0;
+  int num_solution_failures = 0;
+  double solve_time = 0.0;
+  ReactorStateTraceRecord record;
+
+  while(true) {
+    int header[5] = {1, 0, 0, 0, 0}; // more, n_cycle, has dpdt, e_src, y_src
+    double times[2] = {0.0, 0.0};
+    int nReactors = 0;
+    if(rank == 0) {
+      reactorT.clear();
+      reactorP.clear();
+      reactorMassFrac.clear();
+      reactorDPDT.clear();
+      reactorESRC.clear();
+      reactorYsrc.clear();
+      for(size_t j = 0; j < readers.size(); ++j) {
+        if(!readers[j]->Read(&record)) {
+          header[0] = 0;
+          break;
+        }
+        if(j == 0) {
+          header[1] = record.n_cycle;
+          times[0] = record.time;
+          times[1] = record.dt;
+        }
+        const int n = record.n_reactors;
+        reactorT.insert(reactorT.end(), record.T.begin(), record.T.end());
+        reactorP.insert(reactorP.end(), record.P.begin(), record.P.end());
+        reactorMassFrac.insert(reactorMassFrac.end(),
+                               record.mf.begin(), record.mf.end());
+        if(record.dpdt.size() > 0) header[2] = 1;
+        if(record.e_src.size() > 0) header[3] = 1;
+        if(record.y_src.size() > 0) header[4] = 1;
+        record.dpdt.resize(n, 0.0);
+        record.e_src.resize(n, 0.0);
+        record.y_src.resize(n*nSpc, 0.0);
+        reactorDPDT.insert(reactorDPDT.end(),
+                           record.dpdt.begin(), record.dpdt.end());
+        reactorESRC.insert(reactorESRC.end(),
+                           record.e_src.begin(), record.e_src.end());
+        reactorYsrc.insert(reactorYsrc.end(),
+                           record.y_src.begin(), record.y_src.end());
+      }
+      nReactors = reactorT.size();
+    }
+#ifdef USE_MPI
+    MPI_Bcast(header,5,MPI_INT,0,MPI_COMM_WORLD);
+    MPI_Bcast(times,2,MPI_DOUBLE,0,MPI_COMM_WORLD);
+#endif
+    if(header[0] == 0) break;
+    const int n_cycle = header[1];
+    const double time = times[0];
+    const double dt = times[1];
+
+    // the costs are kept between calls as in a CFD code
+    reactorCost.resize(nReactors, 1.0);
+    reactorGpu.resize(nReactors, 0.0);
+
+    double start_time = getHighResolutionTime();
+    if(!batched) {
+#ifdef USE_OMP
+      #pragma omp parallel for reduction(+:num_solution_failures)
+#endif
+      for(int k = 0; k < nReactors; ++k) {
+        int thread_id = 0;
+#ifdef USE_OMP
+        thread_id = omp_get_thread_num();
+#endif
+        double reactor_start_time = getHighResolutionTime();
+        zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_COST, &reactorCost[k], zrm_handle);
+        zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_GPU, &reactorGpu[k], zrm_handle);
+        if(header[2]) {
+          zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_DPDT, &reactorDPDT[k], zrm_handle);
+        }
+        if(header[3]) {
+          zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_E_SRC, &reactorESRC[k], zrm_handle);
+        }
+        if(header[4]) {
+          zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_Y_SRC, &reactorYsrc[k*nSpc], zrm_handle);
+        }
+        zerork_status_t flag = zerork_reactor_solve(n_cycle, time, dt, 1,
+                                                    &reactorT[k], &reactorP[k],
+                                                    &reactorMassFrac[k*nSpc],
+                                                    zrm_handle);
+        if(flag != ZERORK_STATUS_SUCCESS) num_solution_failures += 1;
+        thread_time[thread_id] += getHighResolutionTime() - reactor_start_time;
+      }
+    } else {
+      // the plugin does not accept null aux field pointers, so ranks
+      // without reactors pass a pointer to a dummy value
+      double dummy = 0.0;
+      zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_COST, nReactors > 0 ? &reactorCost[0] : &dummy, zrm_handle);
+      zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_GPU, nReactors > 0 ? &reactorGpu[0] : &dummy, zrm_handle);
+      if(header[2]) {
+        zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_DPDT, nReactors > 0 ? &reactorDPDT[0] : &dummy, zrm_handle);
+      }
+      if(header[3]) {
+        zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_E_SRC, nReactors > 0 ? &reactorESRC[0] : &dummy, zrm_handle);
+      }
+      if(header[4]) {
+        zerork_reactor_set_aux_field_pointer(ZERORK_FIELD_Y_SRC, nReactors > 0 ? &reactorYsrc[0] : &dummy, zrm_handle);
+      }
+      zerork_status_t flag = zerork_reactor_solve(n_cycle, time, dt, nReactors,
+                                                  reactorT.data(), reactorP.data(),
+                                                  reactorMassFrac.data(), zrm_handle);
+      if(flag != ZERORK_STATUS_SUCCESS) num_solution_failures += 1;
+    }
+    solve_time += getHighResolutionTime() - start_time;
+    n_solve_calls += 1;
+
+    for(int k = 0; k < nReactors; ++k) {
+      // the plugin stores the number of integrator steps in the cost
+      const double steps = reactorCost[k];
+      int bin = 0;
+      while(bin < n_histogram_bins-1 && steps >= (double)(2L << bin)) {
+        ++bin;
+      }
+      steps_histogram[bin] += 1;
+      n_steps_total += steps;
+    }
+    n_reactor_solves += nReactors;
+  }
+
+  if(rank != 0) return;
+
+  printf("Replayed %d solve calls with %ld reactors from %d file(s)\n",
+         n_solve_calls, n_reactor_solves, (int)replay_files.size());
+  printf("  solution failures        : %d\n", num_solution_failures);
+  printf("  solve time               : %g s\n", solve_time);
+  printf("  reactors/s               : %g\n",
+         solve_time > 0.0 ? n_reactor_solves/solve_time : 0.0);
+  printf("  steps per reactor        : %g\n",
+         n_reactor_solves > 0 ? n_steps_total/n_reactor_solves : 0.0);
+
+  // Load imbalance (max/avg busy time) of the threads, or of the ranks from
+  // the avg_time_total and max_time_total columns of the plugin timing log.
+  double imbalance = -1.0;
+  if(!batched) {
+    double max_time = 0.0;
+    double sum_time = 0.0;
+    for(int j = 0; j < nthreads; ++j) {
+      max_time = std::max(max_time, thread_time[j]);
+      sum_time += thread_time[j];
+    }
+    if(sum_time > 0.0) imbalance = max_time*nthreads/sum_time;
+    printf("  load imbalance (threads) : ");
+  } else {
+    std::vector<char> log_name(1024, '\0');
+    char* log_name_ptr = &log_name[0];
+    zerork_reactor_get_string_option("reactor_timing_log_filename",
+                                     &log_name_ptr, log_name.size()-1,
+                                     zrm_handle);
+    double sum_avg_time = 0.0;
+    double sum_max_time = 0.0;
+    std::ifstream log_file(log_name_ptr);
+    std::string line;
+    while(std::getline(log_file, line)) {
+      if(line.size() == 0 || line[0] == '#') continue;
+      std::istringstream columns(line);
+      std::vector<double> values;
+      double value;
+      while(columns >> value) values.push_back(value);
+      if(values.size() >= 16) {
+        sum_avg_time += values[14];
+        sum_max_time += values[15];
+      }
+    }
+    if(sum_avg_time > 0.0) imbalance = sum_max_time/sum_avg_time;
+    printf("  load imbalance (ranks)   : ");
+  }
+  if(imbalance > 0.0) {
+    printf("%g (max/avg)\n", imbalance);
+  } else {
+    printf("n/a (set reactor_timing_log in the plugin options)\n");
+  }
+
+  printf("  steps per reactor histogram:\n");
+  for(int j = 0; j < n_histogram_bins; ++j) {
+    if(steps_histogram[j] == 0) continue;
+    const long bin_min = (j == 0) ? 0 : (1L << j);
+    printf("    [%8ld, %8ld) %12ld\n", bin_min, 2L << j, steps_histogram[j]);
+  }
+  fflush(stdout);
+}
@@ -3,7 +3,14 @@
 #include "mpi.h"
 #endif
 
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
 #include <iomanip>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 
 #include "zerork_reactor_manager.h"
@@ -11,8 +18,11 @@
 
 #include "solver_cvode.h"
 #include "solver_seulex.h"
+#include "solver_rodas.h"
+#include "solver_exprb.h"
 #include "reactor_constant_volume_cpu.h"
 #include "reactor_constant_pressure_cpu.h"
+#include "nvector/nvector_serial.h"
 
 #ifdef ZERORK_GPU
 #include "reactor_constant_volume_gpu.h"
@@ -28,7 +38,8 @@ using zerork::getHighResolutionTime;
 ZeroRKReactorManager::ZeroRKReactorManager()
   :
       ZeroRKReactorManagerBase(),
-      mech_ptr_(nullptr)
+      mech_ptr_(nullptr),
+      mech_shared_(false)
 {
   n_calls_ = 0;
   n_cycle_ = 0;
@@ -57,6 +68,7 @@ ZeroRKReactorManager::ZeroRKReactorManager()
   }
   int_options_["load_balance_noise"] = 0;
   int_options_["load_balance_mem"] = 1;
+  int_options_["load_balance_batch_size"] = 16;
   int_options_["reactor_weight_mult"] = 1;
   int_options_["dump_reactors"] = 0;
   int_options_["dump_failed_reactors"] = 0;
@@ -69,6 +81,7 @@ ZeroRKReactorManager::ZeroRKReactorManager()
   int_options_["integrator"] = 0;
   int_options_["abstol_dens"] = 0;
   int_options_["cvode_num_retries"] = 5;
+  int_options_["exprb_krylov_max_dim"] = 40;
   double_options_["rel_tol"] = 1.0e-8;
   double_options_["abs_tol"] = 1.0e-20;
   double_options_["eps_lin"] = 1.0e-3;
@@ -87,6 +100,58 @@ ZeroRKReactorManager::ZeroRKReactorManager()
   double_options_["solve_temperature_threshold"] = 2.0;
   double_options_["step_limiter"] = 1.0e22;
 
+  //ISAT Options
+  int_options_["isat"] = 0;
+  int_options_["isat_max_search"] = 64;
+  double_options_["isat_tolerance"] = 1.0e-4;
+  double_options_["isat_max_radius"] = 0.05;
+  double_options_["isat_max_memory_mb"] = 256.0;
+  double_options_["isat_temperature_scale"] = 1000.0;
+  n_isat_retrieves_ = 0;
+
+  //Adaptive Chemistry Options
+  int_options_["adaptive_chemistry"] = 0;
+  double_options_["adaptive_chemistry_threshold"] = 1.0e-3;
+  double_options_["adaptive_chemistry_target_mass_fraction"] = 1.0e-4;
+  double_options_["adaptive_chemistry_tolerance"] = 1.0e-6;
+  n_dac_fallbacks_ = 0;
+  sum_dac_active_species_ = 0.0;
+
+  //Frozen Chemistry Options
+  int_options_["frozen_chemistry_bypass"] = 0;
+  double_options_["frozen_chemistry_tolerance"] = 1.0e-6;
+  double_options_["frozen_chemistry_temperature_tolerance"] = 0.1;
+  n_frozen_bypass_ = 0;
+  frozen_max_error_ = 0.0;
+
+  //CPU Batch Options
+  int_options_["cpu_batch_size"] = 1;
+
+  //SEULEX Options
+  int_options_["seulex_parallel_columns"] = 1;
+  int_options_["seulex_warm_start"] = 0;
+
+  //Mechanism Options
+  int_options_["share_mechanism"] = 1;
+
+  //Rate Constant Table Options
+  int_options_["rate_const_table"] = 0;
+  double_options_["rate_const_table_tolerance"] = 1.0e-6;
+  double_options_["rate_const_table_min_temperature"] = 250.0;
+  double_options_["rate_const_table_max_temperature"] = 3500.0;
+
+  //Clustering Options
+  int_options_["cluster_reactors"] = 0;
+  double_options_["cluster_temperature_tolerance"] = 5.0;
+  double_options_["cluster_pressure_tolerance"] = 0.01;
+  double_options_["cluster_progress_tolerance"] = 0.01;
+  double_options_["cluster_equivalence_ratio_tolerance"] = 0.01;
+  clustered_ = false;
+  n_reactors_input_ = 0;
+  n_clusters_ = 0;
+  cluster_max_dT_ = 0.0;
+  cluster_max_dY_ = 0.0;
+
   //GPU Options
   int_options_["gpu"] = 0;
   int_options_["initial_gpu_multiplier"] = 8;
@@ -96,6 +161,7 @@ ZeroRKReactorManager::ZeroRKReactorManager()
   //File-output Options
   string_options_["reactor_timing_log_filename"] = std::string(zerork::utilities::null_filename);
   string_options_["mechanism_parsing_log_filename"] = std::string(zerork::utilities::null_filename);
+  string_options_["reactor_state_capture_filename"] = std::string("");
   int_options_["output_performance_log"] = 1;
 
   T_other_.clear();
@@ -128,6 +194,17 @@ ZeroRKReactorManager::ZeroRKReactorManager()
 
   cb_fn_ = nullptr;
   cb_fn_data_ = nullptr;
+
+#ifdef USE_MPI
+  batch_size_ = 1;
+  batch_counter_ = 0;
+  n_batches_self_ = 0;
+  n_reactors_stolen_ = 0;
+  batch_counter_win_ = MPI_WIN_NULL;
+  batch_input_win_ = MPI_WIN_NULL;
+  batch_output_win_ = MPI_WIN_NULL;
+  batch_ids_win_ = MPI_WIN_NULL;
+#endif
 }
 
 zerork_status_t ZeroRKReactorManager::ReadOptionsFile(const std::string& options_filename) {
@@ -155,6 +232,7 @@ zerork_status_t ZeroRKReactorManager::ReadOptionsFile(const std::string& options
   int_options_["integrator"] = inputFileDB.integrator();
   int_options_["abstol_dens"] = inputFileDB.abstol_dens();
   int_options_["cvode_num_retries"] = inputFileDB.cvode_num_retries();
+  int_options_["exprb_krylov_max_dim"] = inputFileDB.exprb_krylov_max_dim();
   double_options_["abs_tol"] = inputFileDB.absolute_tolerance();
   double_options_["rel_tol"] = inputFileDB.relative_tolerance();
   double_options_["eps_lin"] = inputFileDB.eps_lin();
@@ -170,6 +248,38 @@ zerork_status_t ZeroRKReactorManager::ReadOptionsFile(const std::string& options
   double_options_["min_mass_fraction"] = inputFileDB.min_mass_fraction();
   double_options_["step_limiter"] = inputFileDB.step_limiter();
 
+  int_options_["isat"] = inputFileDB.isat();
+  int_options_["isat_max_search"] = inputFileDB.isat_max_search();
+  double_options_["isat_tolerance"] = inputFileDB.isat_tolerance();
+  double_options_["isat_max_radius"] = inputFileDB.isat_max_radius();
+  double_options_["isat_max_memory_mb"] = inputFileDB.isat_max_memory_mb();
+  double_options_["isat_temperature_scale"] = inputFileDB.isat_temperature_scale();
+
+  int_options_["adaptive_chemistry"] = inputFileDB.adaptive_chemistry();
+  double_options_["adaptive_chemistry_threshold"] = inputFileDB.adaptive_chemistry_threshold();
+  double_options_["adaptive_chemistry_target_mass_fraction"] = inputFileDB.adaptive_chemistry_target_mass_fraction();
+  double_options_["adaptive_chemistry_tolerance"] = inputFileDB.adaptive_chemistry_tolerance();
+
+  int_options_["frozen_chemistry_bypass"] = inputFileDB.frozen_chemistry_bypass();
+  double_options_["frozen_chemistry_tolerance"] = inputFileDB.frozen_chemistry_tolerance();
+  double_options_["frozen_chemistry_temperature_tolerance"] = inputFileDB.frozen_chemistry_temperature_tolerance();
+
+  int_options_["cpu_batch_size"] = inputFileDB.cpu_batch_size();
+  int_options_["seulex_parallel_columns"] = inputFileDB.seulex_parallel_columns();
+  int_options_["seulex_warm_start"] = inputFileDB.seulex_warm_start();
+
+  int_options_["share_mechanism"] = inputFileDB.share_mechanism();
+  int_options_["rate_const_table"] = inputFileDB.rate_const_table();
+  double_options_["rate_const_table_tolerance"] = inputFileDB.rate_const_table_tolerance();
+  double_options_["rate_const_table_min_temperature"] = inputFileDB.rate_const_table_min_temperature();
+  double_options_["rate_const_table_max_temperature"] = inputFileDB.rate_const_table_max_temperature();
+
+  int_options_["cluster_reactors"] = inputFileDB.cluster_reactors();
+  double_options_["cluster_temperature_tolerance"] = inputFileDB.cluster_temperature_tolerance();
+  double_options_["cluster_pressure_tolerance"] = inputFileDB.cluster_pressure_tolerance();
+  double_options_["cluster_progress_tolerance"] = inputFileDB.cluster_progress_tolerance();
+  double_options_["cluster_equivalence_ratio_tolerance"] = inputFileDB.cluster_equivalence_ratio_tolerance();
+
   int_options_["gpu"] = inputFileDB.gpu();
   int_options_["initial_gpu_multiplier"] = inputFileDB.initial_gpu_multiplier();
   n_reactors_max_ = inputFileDB.n_reactors_max();
@@ -178,29 +288,167 @@ zerork_status_t ZeroRKReactorManager::ReadOptionsFile(const std::string& options
   int_options_["load_balance"] = inputFileDB.load_balance();
   int_options_["load_balance_noise"] = inputFileDB.load_balance_noise();
   int_options_["reactor_weight_mult"] = inputFileDB.reactor_weight_mult();
+  int_options_["load_balance_batch_size"] = inputFileDB.load_balance_batch_size();
 #endif
   int_options_["dump_reactors"] = inputFileDB.dump_reactors();
   int_options_["dump_failed_reactors"] = inputFileDB.dump_failed_reactors();
 
   string_options_["reactor_timing_log_filename"] = inputFileDB.reactor_timing_log();
   string_options_["mechanism_parsing_log_filename"] = inputFileDB.mechanism_parsing_log();
+  string_options_["reactor_state_capture_filename"] = inputFileDB.reactor_state_capture_file();
   return ZERORK_STATUS_SUCCESS;
 }
 
-zerork_status_t ZeroRKReactorManager::LoadMechanism() {
-  std::string cklog_filename(string_options_["mechanism_parsing_log_filename"]);
-  if(rank_ != root_rank_) {
-     cklog_filename = std::string(zerork::utilities::null_filename);
+// FNV-1a hash of the contents of a file. Returns false if the file can not
+// be read.
+static bool HashFileContents(const std::string& filename, uint64_t* hash)
+{
+  FILE* fptr = fopen(filename.c_str(), "rb");
+  if(fptr == NULL) {
+    return false;
+  }
+  uint64_t h = 14695981039346656037ULL;
+  unsigned char buffer[65536];
+  size_t num_read;
+  while((num_read = fread(buffer, 1, sizeof(buffer), fptr)) > 0) {
+    for(size_t j = 0; j < num_read; ++j) {
+      h ^= buffer[j];
+      h *= 1099511628211ULL;
+    }
+  }
+  const bool ok = (ferror(fptr) == 0);
+  fclose(fptr);
+  *hash = h;
+  return ok;
+}
+
+static std::string CanonicalFilename(const std::string& filename)
+{
+  char* path = realpath(filename.c_str(), NULL);
+  if(path == NULL) {
+    return filename;
+  }
+  std::string canonical(path);
+  free(path);
+  return canonical;
+}
+
+// Process wide registry of the mechanisms loaded by the plugin. Handles
+// loading the same mechanism and thermodynamics files (by path and
+// contents) with the same rate constant table options share one
+// zerork::mechanism, which is not changed after it is created here. The
+// reactors of each handle evaluate the rates with their own rate constant
+// workspace. A mechanism is freed with the last handle using it.
+static std::shared_ptr<zerork::mechanism>
+  AcquireSharedMechanism(const std::string& mech_filename,
+                         const std::string& therm_filename,
+                         const std::string& cklog_filename,
+                         const bool use_rate_const_table,
+                         const double table_min_temperature,
+                         const double table_max_temperature,
+                         const double table_tolerance)
+{
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::weak_ptr<zerork::mechanism> > registry;
+
+  uint64_t mech_hash, therm_hash;
+  if(!HashFileContents(mech_filename, &mech_hash) ||
+     !HashFileContents(therm_filename, &therm_hash)) {
+    // let the parser report the error
+    return std::make_shared<zerork::mechanism>(mech_filename.c_str(),
+                                               therm_filename.c_str(),
+                                               cklog_filename.c_str());
   }
+  char settings[256];
+  snprintf(settings, sizeof(settings), "|%016llx|%016llx|%d|%.17g|%.17g|%.17g",
+           (unsigned long long)mech_hash,
+           (unsigned long long)therm_hash,
+           use_rate_const_table ? 1 : 0,
+           use_rate_const_table ? table_min_temperature : 0.0,
+           use_rate_const_table ? table_max_temperature : 0.0,
+           use_rate_const_table ? table_tolerance : 0.0);
+  const std::string key = CanonicalFilename(mech_filename) + "|" +
+                          CanonicalFilename(therm_filename) + settings;
+
+  // Held while parsing so concurrent handles wait for the first one
+  // instead of parsing the same files
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::shared_ptr<zerork::mechanism> mech = registry[key].lock();
+  if(mech == nullptr) {
+    mech = std::make_shared<zerork::mechanism>(mech_filename.c_str(),
+                                               therm_filename.c_str(),
+                                               cklog_filename.c_str());
+    if(use_rate_const_table) {
+      mech->setRateConstTable(table_min_temperature,
+                              table_max_temperature,
+                              table_tolerance);
+    }
+    // The non-integer Jacobian data is built on first use, build it before
+    // the mechanism is shared
+    mech->getNonIntegerReactionNetwork()->GetNumJacobianNonzeros();
+    registry[key] = mech;
+  }
+  return mech;
+}
 
+// Reactor state capture file of a handle. Each handle created in the process
+// writes its own file, handles created on several threads (e.g. the OpenMP
+// threadprivate handles of the tester) would otherwise truncate and
+// interleave a single trace. The first handle keeps the configured name,
+// later handles get a ".h<index>" suffix.
+static std::string CaptureFilename(const std::string& filename,
+                                   const int rank,
+                                   const int nranks)
+{
+  static std::mutex capture_mutex;
+  static int num_capture_handles = 0;
+
+  std::string capture_filename = filename;
+  if(nranks > 1) {
+    capture_filename += "." + std::to_string(rank);
+  }
+  std::lock_guard<std::mutex> lock(capture_mutex);
+  if(num_capture_handles > 0) {
+    capture_filename += ".h" + std::to_string(num_capture_handles);
+  }
+  ++num_capture_handles;
+  return capture_filename;
+}
+
+zerork_status_t ZeroRKReactorManager::LoadCpuMechanism(bool shared,
+                                                       const std::string& cklog_filename) {
   try {
-    mech_ptr_ = std::make_shared<zerork::mechanism>(string_options_["mech_filename"].c_str(),
-                    string_options_["therm_filename"].c_str(),
-                    cklog_filename.c_str());
+    if(shared) {
+      mech_ptr_ = AcquireSharedMechanism(string_options_["mech_filename"],
+                    string_options_["therm_filename"],
+                    cklog_filename,
+                    int_options_["rate_const_table"] == 1,
+                    double_options_["rate_const_table_min_temperature"],
+                    double_options_["rate_const_table_max_temperature"],
+                    double_options_["rate_const_table_tolerance"]);
+    } else {
+      mech_ptr_ = std::make_shared<zerork::mechanism>(string_options_["mech_filename"].c_str(),
+                      string_options_["therm_filename"].c_str(),
+                      cklog_filename.c_str());
+    }
   } catch (const std::runtime_error& e) {
     mech_ptr_ = nullptr;
+    mech_shared_ = false;
     return ZERORK_STATUS_FAILED_MECHANISM_PARSE;
   }
+  mech_shared_ = shared;
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::LoadMechanism() {
+  std::string cklog_filename(string_options_["mechanism_parsing_log_filename"]);
+  if(rank_ != root_rank_) {
+     cklog_filename = std::string(zerork::utilities::null_filename);
+  }
+
+  zerork_status_t flag = LoadCpuMechanism(int_options_["share_mechanism"] == 1,
+                                          cklog_filename);
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
 #ifdef ZERORK_GPU
   rank_has_gpu_.assign(nranks_,0);
   gpu_id_ = -1;
@@ -319,41 +567,147 @@ void ZeroRKReactorManager::AssignGpuId() {
 #endif
 
 #ifdef USE_MPI
-int ZeroRKReactorManager::RecvReactors(size_t send_rank) {
-  MPI_Status status;
-  int n_recv_reactors;
-  MPI_Recv(&n_recv_reactors,1, MPI_INT, send_rank, EXCHANGE_SEND_TAG_, MPI_COMM_WORLD,
-           &status);
-  if(n_recv_reactors == 0) return n_recv_reactors;
+int ZeroRKReactorManager::ExchangeCountPerReactor() {
+  int tx_count = tx_count_per_reactor_;
+  if(dpdt_defined_) tx_count += 1;
+  if(e_src_defined_) tx_count += 1;
+  if(y_src_defined_) tx_count += num_species_;
+  return tx_count;
+}
 
-  size_t recv_idx = n_reactors_other_;
-  size_t extra_tx_count = 0;
-  n_reactors_other_ += n_recv_reactors;
+int ZeroRKReactorManager::ResultCountPerReactor() {
+  return 6+num_species_;
+}
+
+void ZeroRKReactorManager::PackReactor(size_t self_idx, double* buf) {
+  size_t buf_idx = 0;
+  memcpy(&buf[buf_idx], &mf_self_[self_idx*num_species_stride_],
+         sizeof(double)*num_species_);
+  buf_idx += num_species_;
+  buf[buf_idx] = T_self_[self_idx];
+  buf_idx += 1;
+  buf[buf_idx] = P_self_[self_idx];
+  buf_idx += 1;
+  if(dpdt_defined_) {
+    buf[buf_idx] = dpdt_self_[self_idx];
+    buf_idx += 1;
+  }
+  if(e_src_defined_) {
+    buf[buf_idx] = e_src_self_[self_idx];
+    buf_idx += 1;
+  }
+  if(y_src_defined_) {
+    memcpy(&buf[buf_idx], &y_src_self_[self_idx*num_species_stride_],
+           sizeof(double)*num_species_);
+    buf_idx += num_species_;
+  }
+  buf[buf_idx] = rg_self_[self_idx];
+  buf_idx += 1;
+  buf[buf_idx] = rc_self_[self_idx];
+  buf_idx += 1;
+  buf[buf_idx] = temp_delta_self_[self_idx];
+}
+
+void ZeroRKReactorManager::UnpackReactor(const double* buf, size_t other_idx) {
+  size_t buf_idx = 0;
+  memcpy(&mf_other_[other_idx*num_species_], &buf[buf_idx],
+         sizeof(double)*num_species_);
+  buf_idx += num_species_;
+  T_other_[other_idx] = buf[buf_idx];
+  buf_idx += 1;
+  P_other_[other_idx] = buf[buf_idx];
+  buf_idx += 1;
+  if(dpdt_defined_) {
+    dpdt_other_[other_idx] = buf[buf_idx];
+    buf_idx += 1;
+  }
+  if(e_src_defined_) {
+    e_src_other_[other_idx] = buf[buf_idx];
+    buf_idx += 1;
+  }
+  if(y_src_defined_) {
+    memcpy(&y_src_other_[other_idx*num_species_], &buf[buf_idx],
+           sizeof(double)*num_species_);
+    buf_idx += num_species_;
+  }
+  rg_other_[other_idx] = buf[buf_idx];
+  buf_idx += 1;
+  rc_other_[other_idx] = buf[buf_idx];
+  buf_idx += 1;
+  temp_delta_other_[other_idx] = buf[buf_idx];
+}
+
+void ZeroRKReactorManager::PackResult(size_t other_idx, double* buf) {
+  size_t buf_idx = 0;
+  buf[buf_idx] = rg_other_[other_idx];
+  buf_idx += 1;
+  buf[buf_idx] = rc_other_[other_idx];
+  buf_idx += 1;
+  buf[buf_idx] = T_other_[other_idx];
+  buf_idx += 1;
+  buf[buf_idx] = P_other_[other_idx];
+  buf_idx += 1;
+  buf[buf_idx] = root_times_other_[other_idx];
+  buf_idx += 1;
+  buf[buf_idx] = temp_delta_other_[other_idx];
+  buf_idx += 1;
+  memcpy(&buf[buf_idx], &mf_other_[other_idx*num_species_],
+         sizeof(double)*num_species_);
+}
 
+void ZeroRKReactorManager::UnpackResult(const double* buf, size_t self_idx) {
+  size_t buf_idx = 0;
+  rg_self_[self_idx] = buf[buf_idx];
+  buf_idx += 1;
+  rc_self_[self_idx] = buf[buf_idx];
+  buf_idx += 1;
+  T_self_[self_idx] = buf[buf_idx];
+  buf_idx += 1;
+  P_self_[self_idx] = buf[buf_idx];
+  buf_idx += 1;
+  root_times_self_[self_idx] = buf[buf_idx];
+  buf_idx += 1;
+  temp_delta_self_[self_idx] = buf[buf_idx];
+  buf_idx += 1;
+  memcpy(&mf_self_[self_idx*num_species_stride_], &buf[buf_idx],
+         sizeof(double)*num_species_);
+}
+
+void ZeroRKReactorManager::ResizeOtherReactors() {
   T_other_.resize(n_reactors_other_);
   P_other_.resize(n_reactors_other_);
   if(dpdt_defined_) {
     dpdt_other_.resize(n_reactors_other_);
-    extra_tx_count += 1;
   }
   if(e_src_defined_) {
     e_src_other_.resize(n_reactors_other_);
-    extra_tx_count += 1;
   }
   if(y_src_defined_) {
     y_src_other_.resize(n_reactors_other_*num_species_);
-    extra_tx_count += num_species_;
   }
   rg_other_.resize(n_reactors_other_);
   rc_other_.resize(n_reactors_other_);
   root_times_other_.assign(n_reactors_other_, -1.0); //N.B. at start negative one by definition so we don't communicate it
   temp_delta_other_.resize(n_reactors_other_);
   mf_other_.resize(n_reactors_other_*num_species_);
+}
 
-  std::vector<double> recv_buf(tx_count_per_reactor_+extra_tx_count);
+int ZeroRKReactorManager::RecvReactors(size_t send_rank) {
+  MPI_Status status;
+  int n_recv_reactors;
+  MPI_Recv(&n_recv_reactors,1, MPI_INT, send_rank, EXCHANGE_SEND_TAG_, MPI_COMM_WORLD,
+           &status);
+  if(n_recv_reactors == 0) return n_recv_reactors;
+
+  size_t recv_idx = n_reactors_other_;
+  n_reactors_other_ += n_recv_reactors;
+  ResizeOtherReactors();
+
+  const int tx_count = ExchangeCountPerReactor();
+  std::vector<double> recv_buf(tx_count);
   if(int_options_["load_balance_mem"] != 0) {
-    recv_buf.resize((tx_count_per_reactor_+extra_tx_count)*n_recv_reactors);
-    MPI_Recv(&recv_buf[0],(tx_count_per_reactor_+extra_tx_count)*n_recv_reactors,
+    recv_buf.resize(tx_count*n_recv_reactors);
+    MPI_Recv(&recv_buf[0],tx_count*n_recv_reactors,
              MPI_DOUBLE, send_rank, EXCHANGE_SEND_TAG_,
              MPI_COMM_WORLD, &status);
   }
@@ -361,38 +715,14 @@ int ZeroRKReactorManager::RecvReactors(size_t send_rank) {
   for(size_t i = 0; i < n_recv_reactors; ++i, ++recv_idx) {
      //Bring 'em in
      if(int_options_["load_balance_mem"] == 0) {
-       MPI_Recv(&recv_buf[0],tx_count_per_reactor_+extra_tx_count,
+       MPI_Recv(&recv_buf[0],tx_count,
                 MPI_DOUBLE, send_rank, EXCHANGE_SEND_TAG_,
                 MPI_COMM_WORLD, &status);
        buf_idx = 0;
      }
      //Unpack 'em
-     memcpy(&mf_other_[recv_idx*num_species_], &recv_buf[buf_idx],
-            sizeof(double)*num_species_);
-     buf_idx += num_species_;
-     memcpy(&T_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-     buf_idx += 1;
-     memcpy(&P_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-     buf_idx += 1;
-     if(dpdt_defined_) {
-       memcpy(&dpdt_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-       buf_idx += 1;
-     }
-     if(e_src_defined_) {
-       memcpy(&e_src_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-       buf_idx += 1;
-     }
-     if(y_src_defined_) {
-       memcpy(&y_src_other_[recv_idx*num_species_], &recv_buf[buf_idx],
-              sizeof(double)*num_species_);
-       buf_idx += num_species_;
-     }
-     memcpy(&rg_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-     buf_idx += 1;
-     memcpy(&rc_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-     buf_idx += 1;
-     memcpy(&temp_delta_other_[recv_idx], &recv_buf[buf_idx], sizeof(double));
-     buf_idx += 1;
+     UnpackReactor(&recv_buf[buf_idx], recv_idx);
+     buf_idx += tx_count;
   }
   if(reactor_ids_defined_) {
      reactor_ids_other_.resize(n_reactors_other_);
@@ -415,15 +745,12 @@ void ZeroRKReactorManager::SendReactors(std::vector<size_t> send_reactor_idxs, s
     return;
   }
 
-  size_t extra_tx_count = 0;
-  if(dpdt_defined_) extra_tx_count+=1;
-  if(e_src_defined_) extra_tx_count+=1;
-  if(y_src_defined_) extra_tx_count+=num_species_;
+  const int tx_count = ExchangeCountPerReactor();
   std::vector<double> send_buf;
   if(int_options_["load_balance_mem"] == 0) {
-    send_buf.resize(tx_count_per_reactor_+extra_tx_count);
+    send_buf.resize(tx_count);
   } else {
-    send_buf.resize((tx_count_per_reactor_+extra_tx_count)*send_nreactors);
+    send_buf.resize(tx_count*send_nreactors);
   }
   int buf_idx = 0;
   for(int i = 0; i < send_nreactors; ++i) {
@@ -431,40 +758,16 @@ void ZeroRKReactorManager::SendReactors(std::vector<size_t> send_reactor_idxs, s
       buf_idx = 0;
     }
     int send_idx = send_reactor_idxs[i];
-    memcpy(&send_buf[buf_idx], &mf_self_[send_idx*num_species_stride_],
-           sizeof(double)*num_species_);
-    buf_idx += num_species_;
-    memcpy(&send_buf[buf_idx], &T_self_[send_idx], sizeof(double));
-    buf_idx += 1;
-    memcpy(&send_buf[buf_idx], &P_self_[send_idx], sizeof(double));
-    buf_idx += 1;
-    if(dpdt_defined_) {
-      memcpy(&send_buf[buf_idx], &dpdt_self_[send_idx], sizeof(double));
-      buf_idx += 1;
-    }
-    if(e_src_defined_) {
-      memcpy(&send_buf[buf_idx], &e_src_self_[send_idx], sizeof(double));
-      buf_idx += 1;
-    }
-    if(y_src_defined_) {
-      memcpy(&send_buf[buf_idx], &y_src_self_[send_idx*num_species_stride_],
-             sizeof(double)*num_species_);
-      buf_idx += num_species_;
-    }
-    memcpy(&send_buf[buf_idx], &rg_self_[send_idx], sizeof(double));
-    buf_idx += 1;
-    memcpy(&send_buf[buf_idx], &rc_self_[send_idx], sizeof(double));
-    buf_idx += 1;
-    memcpy(&send_buf[buf_idx], &temp_delta_self_[send_idx], sizeof(double));
-    buf_idx += 1;
+    PackReactor(send_idx, &send_buf[buf_idx]);
+    buf_idx += tx_count;
 
     if(int_options_["load_balance_mem"] == 0) {
-      MPI_Send(&send_buf[0], tx_count_per_reactor_+extra_tx_count,
+      MPI_Send(&send_buf[0], tx_count,
                MPI_DOUBLE, (int) recv_rank, EXCHANGE_SEND_TAG_, MPI_COMM_WORLD);
     }
   }
   if(int_options_["load_balance_mem"] != 0) {
-    MPI_Send(&send_buf[0], send_nreactors*(tx_count_per_reactor_+extra_tx_count),
+    MPI_Send(&send_buf[0], send_nreactors*tx_count,
              MPI_DOUBLE, (int) recv_rank, EXCHANGE_SEND_TAG_, MPI_COMM_WORLD);
   }
   if(reactor_ids_defined_) {
@@ -496,6 +799,14 @@ zerork_status_t ZeroRKReactorManager::SetInputVariables(int n_cycle,
   P_self_ = P;
   mf_self_ = mf;
 
+  if(trace_writer_) {
+    trace_writer_->Write(n_cycle, time, dt, n_reactors, T, P, mf,
+                         dpdt_defined_ ? dpdt_self_ : nullptr,
+                         e_src_defined_ ? e_src_self_ : nullptr,
+                         y_src_defined_ ? y_src_self_ : nullptr,
+                         num_species_stride_);
+  }
+
   if(n_reactors_self_ > 0) {
     if(rg_owned_) {
       rg_default_.resize(n_reactors, 0.0);
@@ -520,9 +831,200 @@ zerork_status_t ZeroRKReactorManager::SetInputVariables(int n_cycle,
         sorted_reactor_idxs_ = sort_indexes_pointer(n_reactors_self_, rc_self_);
     }
   }
+
+  n_reactors_input_ = n_reactors_self_;
+  n_clusters_ = n_reactors_self_;
+  cluster_max_dT_ = 0.0;
+  cluster_max_dY_ = 0.0;
+  // Per reactor sources are not part of the cluster key
+  if(int_options_["cluster_reactors"] == 1 && n_reactors_self_ > 0 &&
+     !y_src_defined_ && !e_src_defined_) {
+    ClusterReactors();
+  }
   return ZERORK_STATUS_SUCCESS;
 }
 
+void ZeroRKReactorManager::ClusterReactors()
+{
+  if(cluster_carbon_count_.size() != (size_t)num_species_) {
+    cluster_carbon_count_.assign(num_species_,0);
+    cluster_hydrogen_count_.assign(num_species_,0);
+    cluster_oxygen_count_.assign(num_species_,0);
+    mech_ptr_->getSpeciesCarbonCount(&cluster_carbon_count_[0]);
+    mech_ptr_->getSpeciesHydrogenCount(&cluster_hydrogen_count_[0]);
+    mech_ptr_->getSpeciesOxygenCount(&cluster_oxygen_count_[0]);
+    cluster_progress_species_.clear();
+    const char* progress_species[] = {"CO2", "CO", "H2O"};
+    for(int j = 0; j < 3; ++j) {
+      int idx = mech_ptr_->getIdxFromName(progress_species[j]);
+      if(idx >= 0) cluster_progress_species_.push_back(idx);
+    }
+  }
+  std::vector<double> mol_wt(num_species_);
+  mech_ptr_->getMolWtSpc(&mol_wt[0]);
+
+  const double dT = double_options_["cluster_temperature_tolerance"];
+  const double dlnP = double_options_["cluster_pressure_tolerance"];
+  const double dc = double_options_["cluster_progress_tolerance"];
+  const double dphi = double_options_["cluster_equivalence_ratio_tolerance"];
+
+  // Bin each reactor. Reactors solved with and without temperature are
+  // kept in separate clusters.
+  std::map<std::vector<long int>, int> cluster_of_key;
+  std::vector<long int> key(5);
+  std::vector<int> cluster_size;
+  cluster_of_reactor_.assign(n_reactors_self_,0);
+  for(int k = 0; k < n_reactors_self_; ++k) {
+    const double* mf = &mf_self_[k*num_species_stride_];
+    double progress = 0.0;
+    for(size_t j = 0; j < cluster_progress_species_.size(); ++j) {
+      progress += mf[cluster_progress_species_[j]];
+    }
+    double moles_C = 0.0;
+    double moles_H = 0.0;
+    double moles_O = 0.0;
+    for(int j = 0; j < num_species_; ++j) {
+      const double moles = mf[j]/mol_wt[j];
+      moles_C += cluster_carbon_count_[j]*moles;
+      moles_H += cluster_hydrogen_count_[j]*moles;
+      moles_O += cluster_oxygen_count_[j]*moles;
+    }
+    const double phi = moles_O > 0.0 ? (2.0*moles_C + 0.5*moles_H)/moles_O : 0.0;
+
+    key[0] = (long int) floor(T_self_[k]/dT);
+    key[1] = (long int) floor(log(P_self_[k])/dlnP);
+    key[2] = (long int) floor(progress/dc);
+    key[3] = (long int) floor(phi/dphi);
+    key[4] = temp_delta_self_[k] > 0.0 ? 1 : 0;
+    std::map<std::vector<long int>, int>::iterator it = cluster_of_key.find(key);
+    if(it == cluster_of_key.end()) {
+      int cluster_id = cluster_size.size();
+      cluster_of_key[key] = cluster_id;
+      cluster_size.push_back(0);
+      cluster_of_reactor_[k] = cluster_id;
+    } else {
+      cluster_of_reactor_[k] = it->second;
+    }
+    cluster_size[cluster_of_reactor_[k]] += 1;
+  }
+  n_clusters_ = cluster_size.size();
+
+  // Representatives are the mean states of the clusters. The cost of a
+  // representative is the largest cost of its members.
+  T_cluster_.assign(n_clusters_, 0.0);
+  P_cluster_.assign(n_clusters_, 0.0);
+  mf_cluster_.assign(n_clusters_*num_species_, 0.0);
+  dpdt_cluster_.assign(n_clusters_, 0.0);
+  rc_cluster_.assign(n_clusters_, 0.0);
+  rg_cluster_.assign(n_clusters_, 0.0);
+  root_times_cluster_.assign(n_clusters_, -1.0);
+  temp_delta_cluster_.assign(n_clusters_, 0.0);
+  for(int k = 0; k < n_reactors_self_; ++k) {
+    const int c = cluster_of_reactor_[k];
+    const double weight = 1.0/cluster_size[c];
+    T_cluster_[c] += T_self_[k]*weight;
+    P_cluster_[c] += P_self_[k]*weight;
+    for(int j = 0; j < num_species_; ++j) {
+      mf_cluster_[c*num_species_+j] += mf_self_[k*num_species_stride_+j]*weight;
+    }
+    if(dpdt_defined_) {
+      dpdt_cluster_[c] += dpdt_self_[k]*weight;
+    }
+    rc_cluster_[c] = std::max(rc_cluster_[c], rc_self_[k]);
+    rg_cluster_[c] = std::max(rg_cluster_[c], rg_self_[k]);
+    temp_delta_cluster_[c] = std::max(temp_delta_cluster_[c], temp_delta_self_[k]);
+  }
+  T_cluster_init_ = T_cluster_;
+  P_cluster_init_ = P_cluster_;
+  mf_cluster_init_ = mf_cluster_;
+
+  for(int k = 0; k < n_reactors_self_; ++k) {
+    const int c = cluster_of_reactor_[k];
+    cluster_max_dT_ = std::max(cluster_max_dT_, fabs(T_self_[k] - T_cluster_[c]));
+    for(int j = 0; j < num_species_; ++j) {
+      cluster_max_dY_ = std::max(cluster_max_dY_,
+        fabs(mf_self_[k*num_species_stride_+j] - mf_cluster_[c*num_species_+j]));
+    }
+  }
+
+  // Swap in the representatives
+  T_input_ = T_self_;
+  P_input_ = P_self_;
+  mf_input_ = mf_self_;
+  dpdt_input_ = dpdt_self_;
+  rc_input_ = rc_self_;
+  rg_input_ = rg_self_;
+  root_times_input_ = root_times_self_;
+  temp_delta_input_ = temp_delta_self_;
+  num_species_stride_input_ = num_species_stride_;
+  reactor_ids_defined_input_ = reactor_ids_defined_;
+
+  T_self_ = &T_cluster_[0];
+  P_self_ = &P_cluster_[0];
+  mf_self_ = &mf_cluster_[0];
+  if(dpdt_defined_) {
+    dpdt_self_ = &dpdt_cluster_[0];
+  }
+  rc_self_ = &rc_cluster_[0];
+  rg_self_ = &rg_cluster_[0];
+  root_times_self_ = &root_times_cluster_[0];
+  temp_delta_self_ = &temp_delta_cluster_[0];
+  num_species_stride_ = num_species_;
+  reactor_ids_defined_ = false;
+  n_reactors_self_ = n_clusters_;
+  clustered_ = true;
+
+  sorted_reactor_idxs_.assign(n_reactors_self_,0);
+  std::iota(sorted_reactor_idxs_.begin(), sorted_reactor_idxs_.end(), 0);
+  if(int_options_["sort_reactors"]) {
+      sorted_reactor_idxs_ = sort_indexes_pointer(n_reactors_self_, rc_self_);
+  }
+}
+
+void ZeroRKReactorManager::UnclusterReactors()
+{
+  T_self_ = T_input_;
+  P_self_ = P_input_;
+  mf_self_ = mf_input_;
+  dpdt_self_ = dpdt_input_;
+  rc_self_ = rc_input_;
+  rg_self_ = rg_input_;
+  root_times_self_ = root_times_input_;
+  temp_delta_self_ = temp_delta_input_;
+  num_species_stride_ = num_species_stride_input_;
+  reactor_ids_defined_ = reactor_ids_defined_input_;
+  n_reactors_self_ = n_reactors_input_;
+  clustered_ = false;
+
+  // Apply the increments of each representative to its members. Mass
+  // fractions that would become negative are clipped and the members are
+  // renormalized to their initial mass fraction sum.
+  for(int k = 0; k < n_reactors_self_; ++k) {
+    const int c = cluster_of_reactor_[k];
+    T_self_[k] += T_cluster_[c] - T_cluster_init_[c];
+    P_self_[k] *= P_cluster_[c]/P_cluster_init_[c];
+    double* mf = &mf_self_[k*num_species_stride_];
+    double sum_initial = 0.0;
+    double sum_final = 0.0;
+    for(int j = 0; j < num_species_; ++j) {
+      sum_initial += mf[j];
+      mf[j] = std::max(0.0, mf[j] + mf_cluster_[c*num_species_+j] -
+                                    mf_cluster_init_[c*num_species_+j]);
+      sum_final += mf[j];
+    }
+    if(sum_final > 0.0) {
+      const double scale = sum_initial/sum_final;
+      for(int j = 0; j < num_species_; ++j) {
+        mf[j] *= scale;
+      }
+    }
+    rc_self_[k] = rc_cluster_[c];
+    rg_self_[k] = rg_cluster_[c];
+    root_times_self_[k] = root_times_cluster_[c];
+    temp_delta_self_[k] = temp_delta_cluster_[c];
+  }
+}
+
 zerork_status_t ZeroRKReactorManager::SetAuxFieldPointer(zerork_field_t ft, double* field_pointer) {
   if(ft == ZERORK_FIELD_DPDT) {
       dpdt_self_ = field_pointer;
@@ -567,6 +1069,196 @@ zerork_status_t ZeroRKReactorManager::SetCallbackFunction(zerork_callback_fn fn,
   return ZERORK_STATUS_SUCCESS;
 }
 
+zerork_status_t ZeroRKReactorManager::RequireMechanism() {
+  if(mech_ptr_ == nullptr) {
+    return this->LoadMechanism();
+  }
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::GetNumSpecies(int* num_species) {
+  if(num_species == nullptr) return ZERORK_STATUS_INVALID_POINTER;
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  *num_species = mech_ptr_->getNumSpecies();
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::GetSpeciesIndex(const std::string& species_name,
+                                                      int* species_index) {
+  if(species_index == nullptr) return ZERORK_STATUS_INVALID_POINTER;
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  *species_index = mech_ptr_->getIdxFromName(species_name.c_str());
+  if(*species_index < 0) return ZERORK_STATUS_INVALID_PARAMETER;
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::GetPremixedMassFractions(const double* fuel_mole_fracs,
+                                                               const double* oxid_mole_fracs,
+                                                               double phi,
+                                                               double egr,
+                                                               double* mass_fracs) {
+  if(fuel_mole_fracs == nullptr || oxid_mole_fracs == nullptr ||
+     mass_fracs == nullptr) {
+    return ZERORK_STATUS_INVALID_POINTER;
+  }
+  if(phi < 0.0 || egr < 0.0 || egr > 1.0) return ZERORK_STATUS_INVALID_PARAMETER;
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+
+  const int num_species = mech_ptr_->getNumSpecies();
+  std::vector<double> fuel_mole(fuel_mole_fracs, fuel_mole_fracs+num_species);
+  std::vector<double> oxid_mole(oxid_mole_fracs, oxid_mole_fracs+num_species);
+  std::vector<double> fresh_mole(num_species);
+  std::vector<double> fresh_mass(num_species);
+  std::vector<double> exhaust_mole(num_species);
+  std::vector<double> exhaust_mass(num_species, 0.0);
+  double fuel_sum = 0.0;
+  double oxid_sum = 0.0;
+  for(int j = 0; j < num_species; ++j) {
+    fuel_sum += fuel_mole[j];
+    oxid_sum += oxid_mole[j];
+  }
+  if(fuel_sum <= 0.0 || oxid_sum <= 0.0) return ZERORK_STATUS_INVALID_PARAMETER;
+  for(int j = 0; j < num_species; ++j) {
+    fuel_mole[j] /= fuel_sum;
+    oxid_mole[j] /= oxid_sum;
+  }
+
+  // moles of oxidizer for stoichiometry per mole of fuel, as in the
+  // zerork_cfd_plugin_tester
+  const double fuel_oxygen_bal = mech_ptr_->getMolarAtomicOxygenRemainder(&fuel_mole[0]);
+  const double oxid_oxygen_bal = mech_ptr_->getMolarAtomicOxygenRemainder(&oxid_mole[0]);
+  if(oxid_oxygen_bal <= 0.0) return ZERORK_STATUS_INVALID_PARAMETER;
+  const double mole_oxid_stoic_per_fuel = fabs(fuel_oxygen_bal)/oxid_oxygen_bal;
+
+  double fresh_sum = 0.0;
+  for(int j = 0; j < num_species; ++j) {
+    fresh_mole[j] = phi*fuel_mole[j] + mole_oxid_stoic_per_fuel*oxid_mole[j];
+    fresh_sum += fresh_mole[j];
+  }
+  for(int j = 0; j < num_species; ++j) {
+    fresh_mole[j] /= fresh_sum;
+  }
+  mech_ptr_->getYfromX(&fresh_mole[0], &fresh_mass[0]);
+  if(egr > 0.0) {
+    mech_ptr_->getMolarIdealExhaust(&fresh_mole[0], &exhaust_mole[0]);
+    mech_ptr_->getYfromX(&exhaust_mole[0], &exhaust_mass[0]);
+  }
+  for(int j = 0; j < num_species; ++j) {
+    mass_fracs[j] = (1.0-egr)*fresh_mass[j] + egr*exhaust_mass[j];
+  }
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::RequirePrivateMechanism() {
+  if(!mech_shared_) return ZERORK_STATUS_SUCCESS;
+
+  zerork_status_t flag = LoadCpuMechanism(false,
+                          std::string(zerork::utilities::null_filename));
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  if(tried_init_ && int_options_["rate_const_table"] == 1) {
+    mech_ptr_->setRateConstTable(double_options_["rate_const_table_min_temperature"],
+                                 double_options_["rate_const_table_max_temperature"],
+                                 double_options_["rate_const_table_tolerance"]);
+  }
+  // the reactors are created again with the new mechanism
+  reactor_ptr_.reset(nullptr);
+  reactor_batch_ptr_.reset(nullptr);
+  seulex_column_reactors_.clear();
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::KineticsChanged() {
+  // The mechanism rebuilds its rate constant table if one is in use. ISAT
+  // records were tabulated with the old rates.
+  isat_table_.reset();
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::GetArrheniusParameters(int reaction_id,
+                                                             int direction,
+                                                             double* A,
+                                                             double* Tpow,
+                                                             double* Ea) {
+  if(A == nullptr || Tpow == nullptr || Ea == nullptr) {
+    return ZERORK_STATUS_INVALID_POINTER;
+  }
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  if(mech_ptr_->getArrheniusParameters(reaction_id, direction, A, Tpow, Ea) != 0) {
+    return ZERORK_STATUS_INVALID_PARAMETER;
+  }
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::SetArrheniusParameters(int reaction_id,
+                                                             int direction,
+                                                             double A,
+                                                             double Tpow,
+                                                             double Ea) {
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+#ifdef ZERORK_GPU
+  // mechanism_cuda keeps its own copy of the rate parameters on the device
+  if(mech_cuda_ptr_ != nullptr) return ZERORK_STATUS_UNKNOWN_ERROR;
+#endif
+  flag = RequirePrivateMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  if(mech_ptr_->setArrheniusParameters(reaction_id, direction, A, Tpow, Ea) != 0) {
+    return ZERORK_STATUS_INVALID_PARAMETER;
+  }
+  return KineticsChanged();
+}
+
+zerork_status_t ZeroRKReactorManager::GetNumPLogLines(int reaction_id,
+                                                      int* num_lines) {
+  if(num_lines == nullptr) return ZERORK_STATUS_INVALID_POINTER;
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  if(reaction_id < 0 || reaction_id >= mech_ptr_->getNumReactions()) {
+    return ZERORK_STATUS_INVALID_PARAMETER;
+  }
+  *num_lines = std::max(mech_ptr_->getNumPLogLines(reaction_id), 0);
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::GetPLogParameters(int reaction_id,
+                                                        int line_id,
+                                                        double* pressure,
+                                                        double* A,
+                                                        double* Tpow,
+                                                        double* Ea) {
+  if(pressure == nullptr || A == nullptr || Tpow == nullptr || Ea == nullptr) {
+    return ZERORK_STATUS_INVALID_POINTER;
+  }
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  if(mech_ptr_->getPLogParameters(reaction_id, line_id, pressure, A, Tpow, Ea) != 0) {
+    return ZERORK_STATUS_INVALID_PARAMETER;
+  }
+  return ZERORK_STATUS_SUCCESS;
+}
+
+zerork_status_t ZeroRKReactorManager::SetPLogParameters(int reaction_id,
+                                                        int line_id,
+                                                        double A,
+                                                        double Tpow,
+                                                        double Ea) {
+  zerork_status_t flag = RequireMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+#ifdef ZERORK_GPU
+  if(mech_cuda_ptr_ != nullptr) return ZERORK_STATUS_UNKNOWN_ERROR;
+#endif
+  flag = RequirePrivateMechanism();
+  if(flag != ZERORK_STATUS_SUCCESS) return flag;
+  if(mech_ptr_->setPLogParameters(reaction_id, line_id, A, Tpow, Ea) != 0) {
+    return ZERORK_STATUS_INVALID_PARAMETER;
+  }
+  return KineticsChanged();
+}
+
 zerork_status_t ZeroRKReactorManager::FinishInit() {
   if(!tried_init_) {
     tried_init_ = true;
@@ -574,6 +1266,12 @@ zerork_status_t ZeroRKReactorManager::FinishInit() {
     if(mech_ptr_ == nullptr) {
       zerork_status_t flag = this->LoadMechanism();
       if(flag) return flag;
+    } else if(mech_shared_) {
+      // The sharing and rate constant table options may have changed since
+      // the mechanism was loaded
+      zerork_status_t flag = LoadCpuMechanism(int_options_["share_mechanism"] == 1,
+                               std::string(zerork::utilities::null_filename));
+      if(flag) return flag;
     }
 
     num_species_ = mech_ptr_->getNumSpecies();
@@ -581,6 +1279,26 @@ zerork_status_t ZeroRKReactorManager::FinishInit() {
 
     tx_count_per_reactor_ = 5 + num_species_;
 
+    if(int_options_["rate_const_table"] == 1) {
+      // A shared mechanism is loaded with its table. Table memory is shared
+      // by all mechanisms loaded from the same files in this process.
+      double table_error = mech_ptr_->getRateConstTableError();
+      if(!mech_shared_) {
+        table_error = mech_ptr_->setRateConstTable(
+                        double_options_["rate_const_table_min_temperature"],
+                        double_options_["rate_const_table_max_temperature"],
+                        double_options_["rate_const_table_tolerance"]);
+      }
+      if(rank_ == root_rank_ && int_options_["verbosity"] > 0) {
+        if(table_error < 0.0) {
+          printf("WARNING: could not use the rate constant table.\n");
+        } else {
+          printf("Rate constant table max relative error = %.6e\n",
+                 table_error);
+        }
+      }
+    }
+
 #ifdef USE_MPI
     rank_weights_.assign(nranks_,1);
 #ifdef ZERORK_GPU
@@ -629,6 +1347,25 @@ zerork_status_t ZeroRKReactorManager::FinishInit() {
       reactor_log_file_ << std::setw(17) << "step_time_gpu";
       reactor_log_file_ << std::setw(17) << "avg_time_total";
       reactor_log_file_ << std::setw(17) << "max_time_total";
+      if(int_options_["isat"] == 1) {
+        reactor_log_file_ << std::setw(17) << "n_isat_retrieve";
+        reactor_log_file_ << std::setw(17) << "isat_records";
+        reactor_log_file_ << std::setw(17) << "isat_memory_mb";
+      }
+      if(int_options_["adaptive_chemistry"] == 1) {
+        reactor_log_file_ << std::setw(17) << "n_dac_fallback";
+        reactor_log_file_ << std::setw(17) << "dac_active_avg";
+      }
+      if(int_options_["frozen_chemistry_bypass"] == 1) {
+        reactor_log_file_ << std::setw(17) << "n_frozen_bypass";
+        reactor_log_file_ << std::setw(17) << "frozen_err_max";
+      }
+      if(int_options_["cluster_reactors"] == 1) {
+        reactor_log_file_ << std::setw(17) << "n_reactors_input";
+        reactor_log_file_ << std::setw(17) << "n_clusters";
+        reactor_log_file_ << std::setw(17) << "cluster_dT_max";
+        reactor_log_file_ << std::setw(17) << "cluster_dY_max";
+      }
       reactor_log_file_ << std::endl;
       reactor_log_file_.flush();
     }
@@ -637,6 +1374,17 @@ zerork_status_t ZeroRKReactorManager::FinishInit() {
     if(int_options_.find("num_species_stride") != int_options_.end()) {
       num_species_stride_ = int_options_["num_species_stride"];
     }
+
+    std::string capture_filename = string_options_["reactor_state_capture_filename"];
+    if(capture_filename.size() > 0) {
+      capture_filename = CaptureFilename(capture_filename, rank_, nranks_);
+      trace_writer_ = std::make_unique<ReactorStateTraceWriter>();
+      if(!trace_writer_->Open(capture_filename, num_species_)) {
+        printf("WARNING: could not open reactor state capture file %s.\n",
+               capture_filename.c_str());
+        trace_writer_.reset(nullptr);
+      }
+    }
   } else { //tried_init_
     if(mech_ptr_ == nullptr) {
       return ZERORK_STATUS_FAILED_MECHANISM_PARSE;
@@ -656,6 +1404,10 @@ zerork_status_t ZeroRKReactorManager::LoadBalance()
   if(nranks_ == 1 || !int_options_["load_balance"]) {
     return ZERORK_STATUS_SUCCESS;
   }
+  if(int_options_["load_balance"] == 3) {
+    LoadBalanceDynamic();
+    return ZERORK_STATUS_SUCCESS;
+  }
 
   int n_weighted_reactors = 0;
   std::vector<int> weighted_reactors_on_rank(nranks_,0);
@@ -839,11 +1591,20 @@ zerork_status_t ZeroRKReactorManager::SolveReactors()
   n_cpu_solve_no_temperature_ = 0;
   n_gpu_solve_ = 0;
   n_gpu_solve_no_temperature_ = 0;
+  n_isat_retrieves_ = 0;
+  n_dac_fallbacks_ = 0;
+  sum_dac_active_species_ = 0.0;
+  n_frozen_bypass_ = 0;
+  frozen_max_error_ = 0.0;
 
-  int always_solve_temp = int_options_["always_solve_temperature"];
+#ifdef USE_MPI
+  if(nranks_ > 1 && int_options_["load_balance"] == 3) {
+    return SolveReactorsDynamic();
+  }
+#endif
 
   int n_reactors_self_calc = n_reactors_self_ + n_reactors_other_;
-  std::vector<int> solved_gpu(n_reactors_self_calc, 0);
+  std::vector<int> solved(n_reactors_self_calc, 0);
 
   std::vector<double *> T_ptrs(n_reactors_self_calc);
   std::vector<double *> P_ptrs(n_reactors_self_calc);
@@ -903,6 +1664,7 @@ zerork_status_t ZeroRKReactorManager::SolveReactors()
 
 #ifdef ZERORK_GPU
   if(int_options_["gpu"] != 0 && rank_has_gpu_[rank_]) {
+    int always_solve_temp = int_options_["always_solve_temperature"];
     //Instantiate reactors on first call, after options are set
     if(!reactor_gpu_ptr_) {
       if(int_options_["constant_volume"] == 1) {
@@ -973,7 +1735,11 @@ zerork_status_t ZeroRKReactorManager::SolveReactors()
         std::unique_ptr<SolverBase> solver;
         if(int_options_["integrator"] == 0) {
           solver.reset(new CvodeSolver(*reactor_gpu_ptr_));
+        } else if(int_options_["integrator"] == 2) {
+          solver.reset(new RodasSolver(*reactor_gpu_ptr_));
         } else {
+          // the GPU reactors have no JacobianVectorProduct, SEULEX is
+          // used for integrator 3
           solver.reset(new SeulexSolver(*reactor_gpu_ptr_));
         }
 
@@ -1020,7 +1786,7 @@ zerork_status_t ZeroRKReactorManager::SolveReactors()
               //Transpose mass fractions
               mf_ptrs[k_reactor][j] = mf_gpu[j*n_curr+k_reactor_curr];
             }
-            solved_gpu[k_reactor] = 1;
+            solved[k_reactor] = 1;
             *rc_ptrs[k_reactor] = nstep_reactors;
             *rg_ptrs[k_reactor] = reactor_time/n_curr*gpu_multiplier_;
 
@@ -1042,6 +1808,42 @@ zerork_status_t ZeroRKReactorManager::SolveReactors()
   }
 #endif //ZERORK_GPU
 
+  if(UseBatchCPU()) {
+    SolveReactorsBatchCPU(n_reactors_self_calc, &solved[0], T_ptrs, P_ptrs, mf_ptrs,
+                          dpdt_ptrs, e_src_ptrs, y_src_ptrs, rc_ptrs, rg_ptrs,
+                          root_times_ptrs, temp_delta_ptrs);
+  }
+
+  std::unique_ptr<SolverBase> solver = CreateSolverCPU(n_reactors_self_calc);
+
+  zerork_status_t flag = ZERORK_STATUS_SUCCESS;
+  for(int k = 0; k < n_reactors_self_calc; ++k)
+  {
+    if(solved[k] == 0) {
+      double* dpdt_reactor = dpdt_defined_ ? dpdt_ptrs[k] : nullptr;
+      double* e_src_reactor = e_src_defined_ ? e_src_ptrs[k] : nullptr;
+      double* y_src_reactor = y_src_defined_ ? y_src_ptrs[k] : nullptr;
+      int* reactor_id = reactor_ids_defined_ ? reactor_id_ptrs[k] : nullptr;
+      zerork_status_t reactor_flag =
+        SolveReactorCPU(solver.get(), k, T_ptrs[k], P_ptrs[k], mf_ptrs[k],
+                        dpdt_reactor, e_src_reactor, y_src_reactor,
+                        reactor_id, rc_ptrs[k], rg_ptrs[k],
+                        root_times_ptrs[k], temp_delta_ptrs[k]);
+      if(reactor_flag != ZERORK_STATUS_SUCCESS) {
+        flag = reactor_flag;
+      }
+    }
+  }
+
+#ifdef USE_MPI
+  int local_flag = (int) flag;
+  MPI_Allreduce(&local_flag, &flag, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return flag;
+}
+
+std::unique_ptr<SolverBase> ZeroRKReactorManager::CreateSolverCPU(int n_reactors_calc)
+{
   //Instantiate reactors on first call, after options are set
   if(!reactor_ptr_) {
     if(int_options_["constant_volume"] == 1) {
@@ -1055,87 +1857,613 @@ zerork_status_t ZeroRKReactorManager::SolveReactors()
   reactor_ptr_->SetDoubleOptions(double_options_);
 
   std::unique_ptr<SolverBase> solver;
+  SeulexSolver* seulex_solver = nullptr;
   if(int_options_["integrator"] == 0) {
     solver.reset(new CvodeSolver(*reactor_ptr_));
+  } else if(int_options_["integrator"] == 2) {
+    solver.reset(new RodasSolver(*reactor_ptr_));
+  } else if(int_options_["integrator"] == 3) {
+    if(!exprb_context_) {
+      exprb_context_ = std::make_unique<ExpRosenbrockContext>();
+    }
+    ExpRosenbrockSolver* exprb_solver = new ExpRosenbrockSolver(*reactor_ptr_);
+    exprb_solver->SetContext(exprb_context_.get());
+    solver.reset(exprb_solver);
   } else {
-    solver.reset(new SeulexSolver(*reactor_ptr_));
+    if(!seulex_context_) {
+      seulex_context_ = std::make_unique<SeulexContext>();
+    }
+    seulex_solver = new SeulexSolver(*reactor_ptr_);
+    seulex_solver->SetContext(seulex_context_.get());
+    solver.reset(seulex_solver);
   }
   solver->SetIntOptions(int_options_);
   solver->SetDoubleOptions(double_options_);
-  if(cb_fn_ != nullptr && int_options_["load_balance"] == 0 && n_reactors_self_calc == 1) {
+  if(cb_fn_ != nullptr && int_options_["load_balance"] == 0 && n_reactors_calc == 1) {
     solver->SetCallbackFunction(cb_fn_, cb_fn_data_);
   }
 
   reactor_ptr_->SetIntOption("iterative",solver->Iterative());
   reactor_ptr_->SetStepLimiter(double_options_["step_limiter"]);
 
-  zerork_status_t flag = ZERORK_STATUS_SUCCESS;
-  for(int k = 0; k < n_reactors_self_calc; ++k)
-  {
-    if(solved_gpu[k] == 0) {
-      double dpdt_reactor = 0.0;
-      if(dpdt_defined_) {
-        dpdt_reactor = *dpdt_ptrs[k];
+  // Reactors for the concurrent SEULEX extrapolation columns, initialized
+  // with reactor_ptr_ in SolveReactorCPU
+  if(seulex_solver != nullptr && UseSeulexParallelColumns()) {
+    const size_t num_column_reactors = int_options_["seulex_parallel_columns"] - 1;
+    while(seulex_column_reactors_.size() < num_column_reactors) {
+      if(int_options_["constant_volume"] == 1) {
+        seulex_column_reactors_.push_back(std::make_unique<ReactorConstantVolumeCPU>(mech_ptr_));
+      } else {
+        seulex_column_reactors_.push_back(std::make_unique<ReactorConstantPressureCPU>(mech_ptr_));
       }
-      double e_src_reactor = 0.0;
-      if(e_src_defined_) {
-        e_src_reactor = *e_src_ptrs[k];
+    }
+    seulex_column_reactors_.resize(num_column_reactors);
+    std::vector<ReactorBase*> column_reactors;
+    for(size_t j = 0; j < num_column_reactors; ++j) {
+      seulex_column_reactors_[j]->SetIntOptions(int_options_);
+      seulex_column_reactors_[j]->SetDoubleOptions(double_options_);
+      seulex_column_reactors_[j]->SetIntOption("iterative",solver->Iterative());
+      seulex_column_reactors_[j]->SetStepLimiter(double_options_["step_limiter"]);
+      column_reactors.push_back(seulex_column_reactors_[j].get());
+    }
+    seulex_solver->SetColumnReactors(column_reactors);
+  } else {
+    seulex_column_reactors_.clear();
+  }
+  if(int_options_["isat"] == 1 && !isat_table_) {
+    CreateIsatTable();
+  }
+  return solver;
+}
+
+bool ZeroRKReactorManager::UseSeulexParallelColumns()
+{
+  // The column reactors do not follow the active species of adaptive
+  // chemistry
+  if(int_options_["integrator"] != 1) return false;
+  if(int_options_["seulex_parallel_columns"] <= 1) return false;
+  if(int_options_["adaptive_chemistry"] == 1) return false;
+#ifndef USE_OMP
+  // Without OpenMP the columns would be computed one after the other on
+  // the extra reactors. The option is reset so the warning is printed once.
+  if(rank_ == root_rank_ && int_options_["verbosity"] > 0) {
+    printf("WARNING: seulex_parallel_columns = %d requires OpenMP, "
+           "computing the columns serially.\n",
+           int_options_["seulex_parallel_columns"]);
+  }
+  int_options_["seulex_parallel_columns"] = 1;
+  return false;
+#else
+  return true;
+#endif
+}
+
+bool ZeroRKReactorManager::UseBatchCPU()
+{
+  // The per reactor features (ISAT, frozen chemistry, adaptive chemistry)
+  // and the CVODE dense direct solver, whose matrix is sized for a single
+  // reactor, use the per reactor solve.
+  if(int_options_["cpu_batch_size"] <= 1) return false;
+  if(int_options_["isat"] == 1) return false;
+  if(int_options_["frozen_chemistry_bypass"] == 1) return false;
+  if(int_options_["adaptive_chemistry"] == 1) return false;
+  if(int_options_["integrator"] == 0 &&
+     int_options_["dense"] == 1 && int_options_["iterative"] == 0) return false;
+  return true;
+}
+
+void ZeroRKReactorManager::SolveReactorsBatchCPU(int n_reactors_calc, int* solved,
+                                                 std::vector<double*>& T_ptrs,
+                                                 std::vector<double*>& P_ptrs,
+                                                 std::vector<double*>& mf_ptrs,
+                                                 std::vector<double*>& dpdt_ptrs,
+                                                 std::vector<double*>& e_src_ptrs,
+                                                 std::vector<double*>& y_src_ptrs,
+                                                 std::vector<double*>& rc_ptrs,
+                                                 std::vector<double*>& rg_ptrs,
+                                                 std::vector<double*>& root_times_ptrs,
+                                                 std::vector<double*>& temp_delta_ptrs)
+{
+  const int batch_size = int_options_["cpu_batch_size"];
+  //Instantiate reactors on first call, after options are set
+  if(!reactor_batch_ptr_) {
+    reactor_batch_ptr_ = std::make_unique<ReactorBatchCPU>(mech_ptr_,
+                                                           int_options_["constant_volume"] == 1,
+                                                           batch_size);
+  }
+  reactor_batch_ptr_->SetIntOptions(int_options_);
+  reactor_batch_ptr_->SetDoubleOptions(double_options_);
+
+  std::vector<double> T_batch(batch_size);
+  std::vector<double> T_batch_init(batch_size);
+  std::vector<double> P_batch(batch_size);
+  std::vector<double> dpdt_batch(batch_size);
+  std::vector<double> e_src_batch(batch_size);
+  std::vector<double> y_src_batch;
+  if(y_src_defined_) y_src_batch.resize(num_species_*batch_size);
+  std::vector<double> mf_batch(num_species_*batch_size);
+
+  // Contiguous groups of the sorted reactors have similar cost. A final
+  // group of one reactor is left to the per reactor solve.
+  std::vector<int> batch_reactors;
+  for(int k = 0; k < n_reactors_calc; ++k) {
+    if(solved[k] == 0) batch_reactors.push_back(k);
+  }
+  const int n_batch_reactors = batch_reactors.size();
+  int always_solve_temp = int_options_["always_solve_temperature"];
+  for(int k_start = 0; k_start < n_batch_reactors; k_start += batch_size) {
+    const int n_curr = std::min(batch_size, n_batch_reactors - k_start);
+    if(n_curr < reactor_batch_ptr_->GetMinBatchReactors()) break;
+
+    bool solve_temperature = false;
+    double start_time = getHighResolutionTime();
+    for(int k = 0; k < n_curr; ++k) {
+      const int k_reactor = batch_reactors[k_start + k];
+      T_batch[k] = *T_ptrs[k_reactor];
+      T_batch_init[k] = *T_ptrs[k_reactor];
+      P_batch[k] = *P_ptrs[k_reactor];
+      dpdt_batch[k] = dpdt_defined_ ? *dpdt_ptrs[k_reactor] : 0.0;
+      e_src_batch[k] = e_src_defined_ ? *e_src_ptrs[k_reactor] : 0.0;
+      for(int j = 0; j < num_species_; ++j) {
+        //Transpose mass fractions
+        mf_batch[j*n_curr+k] = mf_ptrs[k_reactor][j];
+        if(y_src_defined_) {
+          y_src_batch[j*n_curr+k] = y_src_ptrs[k_reactor][j];
+        }
       }
-      double* y_src_reactor = nullptr;
-      if(y_src_defined_) {
-        y_src_reactor = y_src_ptrs[k];
+      if(*temp_delta_ptrs[k_reactor] > 0.0 || always_solve_temp == 1) {
+        solve_temperature = true;
       }
-      int reactor_id = k;
-      if(reactor_ids_defined_) {
-        reactor_id = *reactor_id_ptrs[k];
+    }
+
+    std::unique_ptr<SolverBase> solver;
+    if(int_options_["integrator"] == 0) {
+      solver.reset(new CvodeSolver(*reactor_batch_ptr_));
+    } else if(int_options_["integrator"] == 2) {
+      solver.reset(new RodasSolver(*reactor_batch_ptr_));
+    } else if(int_options_["integrator"] == 3) {
+      if(!exprb_context_) {
+        exprb_context_ = std::make_unique<ExpRosenbrockContext>();
       }
-      bool solve_temperature = false;
-      if(*temp_delta_ptrs[k] > 0.0 || always_solve_temp == 1) {
-        solve_temperature = true;
+      ExpRosenbrockSolver* exprb_solver = new ExpRosenbrockSolver(*reactor_batch_ptr_);
+      exprb_solver->SetContext(exprb_context_.get());
+      solver.reset(exprb_solver);
+    } else {
+      if(!seulex_context_) {
+        seulex_context_ = std::make_unique<SeulexContext>();
       }
-      reactor_ptr_->SetSolveTemperature(solve_temperature);
-      double T_init = *T_ptrs[k];
-      reactor_ptr_->SetID(reactor_id);
-      double start_time = getHighResolutionTime();
-      reactor_ptr_->InitializeState(0.0, 1, T_ptrs[k], P_ptrs[k],
-                                    mf_ptrs[k], &dpdt_reactor,
-                                    &e_src_reactor,
-                                    y_src_reactor);
-      int nsteps = solver->Integrate(dt_calc_);
-      double reactor_time = getHighResolutionTime() - start_time;
-      if(nsteps < 0) {
-        flag = ZERORK_STATUS_FAILED_SOLVE;
-        if(int_options_["dump_failed_reactors"]!=0) {
-          DumpReactor("failed_state", k, *T_ptrs[k], *P_ptrs[k],
-                      *rc_ptrs[k], *rg_ptrs[k], mf_ptrs[k]);
-        }
-      } else {
-        reactor_ptr_->GetState(dt_calc_, T_ptrs[k], P_ptrs[k], mf_ptrs[k]);
-        *root_times_ptrs[k] = reactor_ptr_->GetRootTime();
-        n_steps_cpu_ += nsteps;
-        double temp_delta = *T_ptrs[k] - T_init;
-        if(temp_delta < double_options_["solve_temperature_threshold"]) temp_delta = 0.0;
-        *temp_delta_ptrs[k] = temp_delta;
+      SeulexSolver* seulex_solver = new SeulexSolver(*reactor_batch_ptr_);
+      seulex_solver->SetContext(seulex_context_.get());
+      solver.reset(seulex_solver);
+    }
+    solver->SetIntOptions(int_options_);
+    solver->SetDoubleOptions(double_options_);
+
+    reactor_batch_ptr_->SetSolveTemperature(solve_temperature);
+    reactor_batch_ptr_->SetIntOption("iterative",solver->Iterative());
+    reactor_batch_ptr_->SetStepLimiter(double_options_["step_limiter"]);
+    reactor_batch_ptr_->SetID(k_start);
+
+    double* y_src_ptr = y_src_defined_ ? &y_src_batch[0] : nullptr;
+    reactor_batch_ptr_->InitializeState(0.0, n_curr, &T_batch[0], &P_batch[0],
+                                        &mf_batch[0], &dpdt_batch[0],
+                                        &e_src_batch[0], y_src_ptr);
+    long int nstep_reactors = solver->Integrate(dt_calc_);
+    double reactor_time = getHighResolutionTime() - start_time;
+    sum_cpu_reactor_time_ += reactor_time;
+
+    // Reactors of a failed batch are solved one at a time
+    if(nstep_reactors < 0) continue;
+
+    reactor_batch_ptr_->GetState(dt_calc_, &T_batch[0], &P_batch[0], &mf_batch[0]);
+    n_steps_cpu_ += nstep_reactors*n_curr;
+    n_cpu_solve_ += n_curr;
+    if(!solve_temperature) n_cpu_solve_no_temperature_ += n_curr;
+    for(int k = 0; k < n_curr; ++k) {
+      const int k_reactor = batch_reactors[k_start + k];
+      *T_ptrs[k_reactor] = T_batch[k];
+      *P_ptrs[k_reactor] = P_batch[k];
+      for(int j = 0; j < num_species_; ++j) {
+        //Transpose mass fractions
+        mf_ptrs[k_reactor][j] = mf_batch[j*n_curr+k];
       }
-      *rc_ptrs[k] = nsteps;
-      *rg_ptrs[k] = reactor_time;
-      sum_cpu_reactor_time_ += reactor_time;
-      ++n_cpu_solve_;
-      if(!solve_temperature) ++n_cpu_solve_no_temperature_;
+      solved[k_reactor] = 1;
+      *rc_ptrs[k_reactor] = nstep_reactors;
+      *rg_ptrs[k_reactor] = reactor_time/n_curr;
+      *root_times_ptrs[k_reactor] = reactor_batch_ptr_->GetBatchRootTime(k);
+
+      double temp_delta = T_batch[k] - T_batch_init[k];
+      if(temp_delta < double_options_["solve_temperature_threshold"]) temp_delta = 0.0;
+      *temp_delta_ptrs[k_reactor] = temp_delta;
+
       if(int_options_["dump_reactors"]!=0) {
-        DumpReactor("postc", k, *T_ptrs[k], *P_ptrs[k],
-                    *rc_ptrs[k], *rg_ptrs[k], mf_ptrs[k]);
+        DumpReactor("postc", k_reactor, *T_ptrs[k_reactor], *P_ptrs[k_reactor],
+                    *rc_ptrs[k_reactor], *rg_ptrs[k_reactor], mf_ptrs[k_reactor]);
       }
     }
   }
+}
+
+void ZeroRKReactorManager::CreateIsatTable()
+{
+  // Key: mass fractions, T/reference_temperature and log(P).
+  // Output: mass fractions and T/reference_temperature.
+  const int num_vars = num_species_ + 1;
+  std::vector<double> scale(num_vars+1, 1.0);
+  scale[num_species_] = double_options_["isat_temperature_scale"] /
+                        double_options_["reference_temperature"];
+  size_t max_bytes = (size_t)(double_options_["isat_max_memory_mb"]*1024.0*1024.0);
+  isat_table_ = std::make_unique<IsatTable>(num_vars+1, num_vars, scale,
+                                            double_options_["isat_tolerance"],
+                                            double_options_["isat_max_radius"],
+                                            max_bytes,
+                                            int_options_["isat_max_search"]);
+  isat_key_.assign(num_vars+1, 0.0);
+  isat_output_.assign(num_vars, 0.0);
+}
+
+bool ZeroRKReactorManager::UseIsat(double dpdt, double e_src, double* y_src,
+                                   bool solve_temperature)
+{
+  // Only the homogeneous mapping of (Y, T, P) over dt_calc_ is tabulated.
+  // Source terms add inputs that are not part of the key, and ignition
+  // root times can not be interpolated.
+  if(!isat_table_ || !solve_temperature) return false;
+  if(dpdt != 0.0 || e_src != 0.0 || y_src != nullptr) return false;
+  if(double_options_["delta_temperature_ignition"] > 0.0) return false;
+  return true;
+}
+
+int ZeroRKReactorManager::ComputeIsatGradient(std::vector<double>* gradient)
+{
+  // Approximate the mapping gradient by the backward Euler sensitivity
+  // (I - dt*J)^-1 at the end of the step, which is exact for linear
+  // relaxation and remains bounded for stiff modes. The log(P) column is
+  // zero and pressure effects are left to the growth error check.
+  const int num_vars = reactor_ptr_->GetNumStateVariables();
+  const int num_key = num_vars+1;
+  N_Vector& state = reactor_ptr_->GetStateNVectorRef();
+  N_Vector derivative = N_VClone(state);
+  N_Vector rhs = N_VClone(state);
+  N_Vector column = N_VClone(state);
+
+  int flag = reactor_ptr_->GetTimeDerivative(dt_calc_, state, derivative);
+  if(flag == 0) flag = reactor_ptr_->JacobianSetup(dt_calc_, state, derivative);
+  if(flag == 0) flag = reactor_ptr_->JacobianFactor(dt_calc_);
+  if(flag == 0) {
+    gradient->assign(num_vars*num_key, 0.0);
+    for(int j = 0; j < num_vars && flag == 0; ++j) {
+      N_VConst(0.0, rhs);
+      NV_Ith_S(rhs,j) = 1.0;
+      flag = reactor_ptr_->JacobianSolve(dt_calc_, state, derivative, rhs, column);
+      for(int i = 0; i < num_vars; ++i) {
+        (*gradient)[i*num_key+j] = NV_Ith_S(column,i);
+      }
+    }
+  }
+
+  N_VDestroy(derivative);
+  N_VDestroy(rhs);
+  N_VDestroy(column);
+  return flag;
+}
+
+bool ZeroRKReactorManager::FrozenChemistryUpdate(double* error)
+{
+  // Predict the change over the step from the time derivative at the
+  // initial state and at the explicit Euler end point. If both the change
+  // and the difference of the two predictions are below tolerance, take
+  // the trapezoidal update and skip the implicit solve.
+  const int num_vars = reactor_ptr_->GetNumStateVariables();
+  const double species_tolerance = double_options_["frozen_chemistry_tolerance"];
+  const double temperature_tolerance =
+    double_options_["frozen_chemistry_temperature_tolerance"] /
+    double_options_["reference_temperature"];
+  N_Vector& state = reactor_ptr_->GetStateNVectorRef();
+  N_Vector initial_state = N_VClone(state);
+  N_Vector initial_derivative = N_VClone(state);
+  N_Vector final_derivative = N_VClone(state);
+  N_VScale(1.0, state, initial_state);
+  double* y = NV_DATA_S(state);
+  double* y0 = NV_DATA_S(initial_state);
+  double* f0 = NV_DATA_S(initial_derivative);
+  double* f1 = NV_DATA_S(final_derivative);
+
+  bool accept = reactor_ptr_->GetTimeDerivative(0.0, state, initial_derivative) == 0;
+  for(int j = 0; j < num_vars && accept; ++j) {
+    const double tolerance = j < num_species_ ? species_tolerance : temperature_tolerance;
+    if(fabs(dt_calc_*f0[j]) > tolerance) accept = false;
+  }
+  if(accept) {
+    for(int j = 0; j < num_vars; ++j) {
+      y[j] = y0[j] + dt_calc_*f0[j];
+    }
+    accept = reactor_ptr_->GetTimeDerivative(dt_calc_, state, final_derivative) == 0;
+    *error = 0.0;
+    for(int j = 0; j < num_vars && accept; ++j) {
+      const double tolerance = j < num_species_ ? species_tolerance : temperature_tolerance;
+      const double local_error = 0.5*dt_calc_*fabs(f1[j] - f0[j]);
+      if(local_error > tolerance) accept = false;
+      if(j < num_species_) *error = std::max(*error, local_error);
+      y[j] = y0[j] + 0.5*dt_calc_*(f0[j] + f1[j]);
+    }
+    // Species frozen by adaptive chemistry are checked with their full rates
+    if(accept) accept = reactor_ptr_->CheckActiveSpecies(dt_calc_);
+    if(!accept) N_VScale(1.0, initial_state, state);
+  }
+
+  N_VDestroy(initial_state);
+  N_VDestroy(initial_derivative);
+  N_VDestroy(final_derivative);
+  return accept;
+}
+
+zerork_status_t ZeroRKReactorManager::SolveReactorCPU(SolverBase* solver, int k,
+                                                      double* T, double* P, double* mf,
+                                                      double* dpdt, double* e_src, double* y_src,
+                                                      int* reactor_id, double* rc, double* rg,
+                                                      double* root_time, double* temp_delta)
+{
+  zerork_status_t flag = ZERORK_STATUS_SUCCESS;
+  double dpdt_reactor = 0.0;
+  if(dpdt != nullptr) {
+    dpdt_reactor = *dpdt;
+  }
+  double e_src_reactor = 0.0;
+  if(e_src != nullptr) {
+    e_src_reactor = *e_src;
+  }
+  int id = k;
+  if(reactor_id != nullptr) {
+    id = *reactor_id;
+  }
+  bool solve_temperature = false;
+  if(*temp_delta > 0.0 || int_options_["always_solve_temperature"] == 1) {
+    solve_temperature = true;
+  }
+  reactor_ptr_->SetSolveTemperature(solve_temperature);
+  double T_init = *T;
+  reactor_ptr_->SetID(id);
+  double start_time = getHighResolutionTime();
+  reactor_ptr_->InitializeState(0.0, 1, T, P, mf, &dpdt_reactor,
+                                &e_src_reactor, y_src);
+  for(size_t j = 0; j < seulex_column_reactors_.size(); ++j) {
+    seulex_column_reactors_[j]->SetSolveTemperature(solve_temperature);
+    seulex_column_reactors_[j]->SetID(id);
+    seulex_column_reactors_[j]->InitializeState(0.0, 1, T, P, mf, &dpdt_reactor,
+                                                &e_src_reactor, y_src);
+  }
+  int nsteps = 0;
+  bool retrieved = false;
+  if(int_options_["frozen_chemistry_bypass"] == 1) {
+    double error = 0.0;
+    retrieved = FrozenChemistryUpdate(&error);
+    if(retrieved) {
+      ++n_frozen_bypass_;
+      frozen_max_error_ = std::max(frozen_max_error_, error);
+    }
+  }
+  bool use_isat = !retrieved &&
+    UseIsat(dpdt_reactor, e_src_reactor, y_src, solve_temperature);
+  if(use_isat) {
+    const int num_vars = reactor_ptr_->GetNumStateVariables();
+    double* state = NV_DATA_S(reactor_ptr_->GetStateNVectorRef());
+    for(int j = 0; j < num_vars; ++j) {
+      isat_key_[j] = state[j];
+    }
+    isat_key_[num_vars] = log(*P);
+    retrieved = isat_table_->Retrieve(dt_calc_, &isat_key_[0], &isat_output_[0]);
+    if(retrieved) {
+      for(int j = 0; j < num_vars; ++j) {
+        state[j] = isat_output_[j];
+      }
+      ++n_isat_retrieves_;
+    }
+  }
+  if(!retrieved) {
+    nsteps = solver->Integrate(dt_calc_);
+    if(int_options_["adaptive_chemistry"] == 1) {
+      sum_dac_active_species_ += reactor_ptr_->GetNumActiveSpecies();
+      if(nsteps < 0 || !reactor_ptr_->CheckActiveSpecies(dt_calc_)) {
+        // Repeat the step with the full mechanism
+        ++n_dac_fallbacks_;
+        reactor_ptr_->SetIntOption("adaptive_chemistry", 0);
+        reactor_ptr_->InitializeState(0.0, 1, T, P, mf, &dpdt_reactor,
+                                      &e_src_reactor, y_src);
+        nsteps = solver->Integrate(dt_calc_);
+        reactor_ptr_->SetIntOption("adaptive_chemistry", 1);
+      }
+    }
+    if(use_isat && nsteps >= 0) {
+      double* state = NV_DATA_S(reactor_ptr_->GetStateNVectorRef());
+      if(!isat_table_->Grow(dt_calc_, &isat_key_[0], state)) {
+        if(ComputeIsatGradient(&isat_gradient_) == 0) {
+          isat_table_->Add(dt_calc_, &isat_key_[0], state, isat_gradient_);
+        }
+      }
+    }
+  }
+  double reactor_time = getHighResolutionTime() - start_time;
+  if(nsteps < 0) {
+    flag = ZERORK_STATUS_FAILED_SOLVE;
+    if(int_options_["dump_failed_reactors"]!=0) {
+      DumpReactor("failed_state", k, *T, *P, *rc, *rg, mf);
+    }
+  } else {
+    reactor_ptr_->GetState(dt_calc_, T, P, mf);
+    *root_time = reactor_ptr_->GetRootTime();
+    n_steps_cpu_ += nsteps;
+    double delta = *T - T_init;
+    if(delta < double_options_["solve_temperature_threshold"]) delta = 0.0;
+    *temp_delta = delta;
+  }
+  *rc = nsteps;
+  *rg = reactor_time;
+  sum_cpu_reactor_time_ += reactor_time;
+  ++n_cpu_solve_;
+  if(!solve_temperature) ++n_cpu_solve_no_temperature_;
+  if(int_options_["dump_reactors"]!=0) {
+    DumpReactor("postc", k, *T, *P, *rc, *rg, mf);
+  }
+  return flag;
+}
 
 #ifdef USE_MPI
+void ZeroRKReactorManager::LoadBalanceDynamic()
+{
+  const int tx_count = ExchangeCountPerReactor();
+  const int result_count = ResultCountPerReactor();
+
+  batch_size_ = std::max(int_options_["load_balance_batch_size"],1);
+  n_batches_self_ = (n_reactors_self_ + batch_size_ - 1)/batch_size_;
+  n_reactors_stolen_ = 0;
+  batch_counter_ = 0;
+
+  n_reactors_ranks_.assign(nranks_,0);
+  n_batches_ranks_.assign(nranks_,0);
+  MPI_Allgather(&n_reactors_self_,1,MPI_INT,
+                &n_reactors_ranks_[0],1,MPI_INT,MPI_COMM_WORLD);
+  MPI_Allgather(&n_batches_self_,1,MPI_INT,
+                &n_batches_ranks_[0],1,MPI_INT,MPI_COMM_WORLD);
+
+  // Pack our reactors in sorted order so the most expensive batches are
+  // claimed first
+  batch_input_buf_.assign(std::max(n_reactors_self_*tx_count,1),0.0);
+  batch_output_buf_.assign(std::max(n_reactors_self_*result_count,1),0.0);
+  batch_ids_buf_.assign(std::max(n_reactors_self_,1),0);
+  for(int k = 0; k < n_reactors_self_; ++k) {
+    size_t sorted_reactor_idx = sorted_reactor_idxs_[k];
+    PackReactor(sorted_reactor_idx, &batch_input_buf_[k*tx_count]);
+    if(reactor_ids_defined_) {
+      batch_ids_buf_[k] = reactor_ids_self_[sorted_reactor_idx];
+    } else {
+      batch_ids_buf_[k] = sorted_reactor_idx;
+    }
+  }
+
+  MPI_Win_create(&batch_counter_, sizeof(int), sizeof(int),
+                 MPI_INFO_NULL, MPI_COMM_WORLD, &batch_counter_win_);
+  MPI_Win_create(&batch_input_buf_[0], sizeof(double)*batch_input_buf_.size(),
+                 sizeof(double), MPI_INFO_NULL, MPI_COMM_WORLD,
+                 &batch_input_win_);
+  MPI_Win_create(&batch_output_buf_[0], sizeof(double)*batch_output_buf_.size(),
+                 sizeof(double), MPI_INFO_NULL, MPI_COMM_WORLD,
+                 &batch_output_win_);
+  MPI_Win_create(&batch_ids_buf_[0], sizeof(int)*batch_ids_buf_.size(),
+                 sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD,
+                 &batch_ids_win_);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, batch_counter_win_);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, batch_input_win_);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, batch_output_win_);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, batch_ids_win_);
+}
+
+zerork_status_t ZeroRKReactorManager::SolveReactorsDynamic()
+{
+  const int tx_count = ExchangeCountPerReactor();
+  const int result_count = ResultCountPerReactor();
+  std::unique_ptr<SolverBase> solver = CreateSolverCPU(batch_size_);
+
+  std::vector<double> input_buf(batch_size_*tx_count);
+  std::vector<double> output_buf(batch_size_*result_count);
+  std::vector<int> ids_buf(batch_size_);
+
+  // Start with our own batches, then steal from the other ranks in turn.
+  // A rank is skipped once its counter has passed its number of batches.
+  zerork_status_t flag = ZERORK_STATUS_SUCCESS;
+  std::vector<int> exhausted(nranks_,0);
+  int n_exhausted = 0;
+  int victim = rank_;
+  const int one = 1;
+  while(n_exhausted < nranks_) {
+    if(exhausted[victim]) {
+      victim = (victim+1) % nranks_;
+      continue;
+    }
+    int batch;
+    MPI_Fetch_and_op(&one, &batch, MPI_INT, victim, 0, MPI_SUM,
+                     batch_counter_win_);
+    MPI_Win_flush(victim, batch_counter_win_);
+    if(batch >= n_batches_ranks_[victim]) {
+      exhausted[victim] = 1;
+      ++n_exhausted;
+      victim = (victim+1) % nranks_;
+      continue;
+    }
+
+    const int first_reactor = batch*batch_size_;
+    const int n_batch = std::min(batch_size_,
+                                 n_reactors_ranks_[victim]-first_reactor);
+    MPI_Get(&input_buf[0], n_batch*tx_count, MPI_DOUBLE, victim,
+            first_reactor*tx_count, n_batch*tx_count, MPI_DOUBLE,
+            batch_input_win_);
+    MPI_Get(&ids_buf[0], n_batch, MPI_INT, victim,
+            first_reactor, n_batch, MPI_INT, batch_ids_win_);
+    MPI_Win_flush(victim, batch_input_win_);
+    MPI_Win_flush(victim, batch_ids_win_);
+    if(victim != rank_) {
+      n_reactors_stolen_ += n_batch;
+    }
+
+    n_reactors_other_ = n_batch;
+    ResizeOtherReactors();
+    for(int k = 0; k < n_batch; ++k) {
+      UnpackReactor(&input_buf[k*tx_count], k);
+      zerork_status_t reactor_flag =
+        SolveReactorCPU(solver.get(), ids_buf[k], &T_other_[k], &P_other_[k],
+                        &mf_other_[k*num_species_],
+                        dpdt_defined_ ? &dpdt_other_[k] : nullptr,
+                        e_src_defined_ ? &e_src_other_[k] : nullptr,
+                        y_src_defined_ ? &y_src_other_[k*num_species_] : nullptr,
+                        reactor_ids_defined_ ? &ids_buf[k] : nullptr,
+                        &rc_other_[k], &rg_other_[k],
+                        &root_times_other_[k], &temp_delta_other_[k]);
+      if(reactor_flag != ZERORK_STATUS_SUCCESS) {
+        flag = reactor_flag;
+      }
+      PackResult(k, &output_buf[k*result_count]);
+    }
+
+    // Return the results without waiting for the owner
+    MPI_Put(&output_buf[0], n_batch*result_count, MPI_DOUBLE, victim,
+            first_reactor*result_count, n_batch*result_count, MPI_DOUBLE,
+            batch_output_win_);
+    MPI_Win_flush(victim, batch_output_win_);
+  }
+  n_reactors_other_ = 0;
+
+  if(int_options_["verbosity"] >= 2) {
+    printf("RANK[%d]: Solved %d reactors, %d taken from other ranks.\n",
+           rank_, n_cpu_solve_, n_reactors_stolen_);
+  }
+
   int local_flag = (int) flag;
   MPI_Allreduce(&local_flag, &flag, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-#endif
   return flag;
 }
 
+void ZeroRKReactorManager::RedistributeResultsDynamic()
+{
+  const int result_count = ResultCountPerReactor();
+
+  // All puts into our output window are complete once every rank has
+  // released its epoch and the windows are freed
+  MPI_Win_unlock_all(batch_counter_win_);
+  MPI_Win_unlock_all(batch_input_win_);
+  MPI_Win_unlock_all(batch_output_win_);
+  MPI_Win_unlock_all(batch_ids_win_);
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Win_free(&batch_counter_win_);
+  MPI_Win_free(&batch_input_win_);
+  MPI_Win_free(&batch_output_win_);
+  MPI_Win_free(&batch_ids_win_);
+
+  for(int k = 0; k < n_reactors_self_; ++k) {
+    UnpackResult(&batch_output_buf_[k*result_count], sorted_reactor_idxs_[k]);
+  }
+}
+#endif
+
 #ifndef USE_MPI
 zerork_status_t ZeroRKReactorManager::RedistributeResults()
 {
@@ -1147,6 +2475,11 @@ zerork_status_t ZeroRKReactorManager::RedistributeResults()
   if(nranks_ == 1 || !int_options_["load_balance"]) {
     return ZERORK_STATUS_SUCCESS;
   }
+  if(int_options_["load_balance"] == 3) {
+    RedistributeResultsDynamic();
+    return ZERORK_STATUS_SUCCESS;
+  }
+  const int result_count = ResultCountPerReactor();
   //startTime = getHighResolutionTime();
   MPI_Barrier(MPI_COMM_WORLD);
   //double synchTime = getHighResolutionTime() - startTime;
@@ -1160,40 +2493,26 @@ zerork_status_t ZeroRKReactorManager::RedistributeResults()
       int send_nreactors = comm_mtx_reactors_[i];
       if(send_nreactors > 0)
       {
-        std::vector<double> send_buf(6+num_species_);
+        std::vector<double> send_buf(result_count);
         if(int_options_["load_balance_mem"] != 0) {
-          send_buf.resize((6+num_species_)*send_nreactors);
+          send_buf.resize(result_count*send_nreactors);
         }
         int buf_idx = 0;
         for(int k = 0; k < send_nreactors; ++k) {
           if(int_options_["load_balance_mem"] == 0) {
             buf_idx = 0;
           }
-          send_buf[buf_idx] = rg_other_[send_idx];
-          buf_idx += 1;
-          send_buf[buf_idx] = rc_other_[send_idx];
-          buf_idx += 1;
-          send_buf[buf_idx] = T_other_[send_idx];
-          buf_idx += 1;
-          send_buf[buf_idx] = P_other_[send_idx];
-          buf_idx += 1;
-          send_buf[buf_idx] = root_times_other_[send_idx];
-          buf_idx += 1;
-          send_buf[buf_idx] = temp_delta_other_[send_idx];
-          buf_idx += 1;
-          for(int j = 0; j < num_species_; ++j) {
-            send_buf[buf_idx] = mf_other_[send_idx*num_species_+j];
-            buf_idx += 1;
-          }
+          PackResult(send_idx, &send_buf[buf_idx]);
+          buf_idx += result_count;
 
           if(int_options_["load_balance_mem"] == 0) {
-            MPI_Send(&send_buf[0], 6+num_species_, MPI_DOUBLE,
+            MPI_Send(&send_buf[0], result_count, MPI_DOUBLE,
                      recv_rank, EXCHANGE_RETURN_TAG_,MPI_COMM_WORLD);
           }
           send_idx += 1;
         }
         if(int_options_["load_balance_mem"] != 0) {
-          MPI_Send(&send_buf[0], (6+num_species_)*send_nreactors, MPI_DOUBLE,
+          MPI_Send(&send_buf[0], result_count*send_nreactors, MPI_DOUBLE,
                    recv_rank, EXCHANGE_RETURN_TAG_,MPI_COMM_WORLD);
         }
       }
@@ -1212,10 +2531,10 @@ zerork_status_t ZeroRKReactorManager::RedistributeResults()
         if(recv_rank == rank_) {
           int recv_nreactors = comm_mtx_reactors_[j];
           if(recv_nreactors > 0) {
-            std::vector<double> recv_buf(6+num_species_);
+            std::vector<double> recv_buf(result_count);
             if(int_options_["load_balance_mem"] != 0) {
-              recv_buf.resize((6+num_species_)*recv_nreactors);
-              MPI_Recv(&recv_buf[0], (6+num_species_)*recv_nreactors, MPI_DOUBLE,
+              recv_buf.resize(result_count*recv_nreactors);
+              MPI_Recv(&recv_buf[0], result_count*recv_nreactors, MPI_DOUBLE,
                        send_rank, EXCHANGE_RETURN_TAG_, MPI_COMM_WORLD,
                        &status);
             }
@@ -1224,28 +2543,14 @@ zerork_status_t ZeroRKReactorManager::RedistributeResults()
               recv_idx -= 1;
               size_t sorted_recv_idx = sorted_reactor_idxs_[recv_idx];
               if(int_options_["load_balance_mem"] == 0) {
-                MPI_Recv(&recv_buf[0], 6+num_species_, MPI_DOUBLE,
+                MPI_Recv(&recv_buf[0], result_count, MPI_DOUBLE,
                          send_rank, EXCHANGE_RETURN_TAG_, MPI_COMM_WORLD,
                          &status);
 
                 buf_idx = 0;
               }
-              rg_self_[sorted_recv_idx] = recv_buf[buf_idx];
-              buf_idx += 1;
-              rc_self_[sorted_recv_idx] = recv_buf[buf_idx];
-              buf_idx += 1;
-              T_self_[sorted_recv_idx] = recv_buf[buf_idx];
-              buf_idx += 1;
-              P_self_[sorted_recv_idx] = recv_buf[buf_idx];
-              buf_idx += 1;
-              root_times_self_[sorted_recv_idx] = recv_buf[buf_idx];
-              buf_idx += 1;
-              temp_delta_self_[sorted_recv_idx] = recv_buf[buf_idx];
-              buf_idx += 1;
-              for(int kk = 0; kk < num_species_; ++kk) {
-                mf_self_[sorted_recv_idx*num_species_stride_+kk] = recv_buf[buf_idx];
-                buf_idx += 1;
-              }
+              UnpackResult(&recv_buf[buf_idx], sorted_recv_idx);
+              buf_idx += result_count;
             }
           }
         }
@@ -1258,6 +2563,7 @@ zerork_status_t ZeroRKReactorManager::RedistributeResults()
 #endif
 
 zerork_status_t ZeroRKReactorManager::PostSolve() {
+  if(clustered_) UnclusterReactors();
   if (int_options_["output_performance_log"]) ProcessPerformance();
 #ifdef ZERORK_GPU
   UpdateRankWeights();
@@ -1273,6 +2579,13 @@ void ZeroRKReactorManager::ProcessPerformance()
 
   n_reactors_solved_ranks_[rank_] = n_cpu_solve_ + n_gpu_solve_;
   all_time_ranks_[rank_] = all_time;
+  int n_reactors_input = n_reactors_input_;
+  int n_clusters = n_clusters_;
+  double cluster_max_dT = cluster_max_dT_;
+  double cluster_max_dY = cluster_max_dY_;
+  int n_isat_records = isat_table_ ? isat_table_->num_records() : 0;
+  double isat_memory_mb = isat_table_ ?
+    isat_table_->num_records()*isat_table_->bytes_per_record()/(1024.0*1024.0) : 0.0;
 #ifdef USE_MPI
   if(nranks_ > 1) {
     int n_total_solved = n_cpu_solve_ + n_gpu_solve_;
@@ -1298,6 +2611,37 @@ void ZeroRKReactorManager::ProcessPerformance()
     MPI_Reduce(&n_steps_gpu_,&ri,1,MPI_DOUBLE,MPI_SUM,root_rank_,MPI_COMM_WORLD);
     if(rank_ == root_rank_) n_steps_gpu_ = ri;
 
+    if(int_options_["isat"] == 1) {
+      MPI_Reduce(&n_isat_retrieves_,&ri,1,MPI_INT,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) n_isat_retrieves_ = ri;
+      MPI_Reduce(&n_isat_records,&ri,1,MPI_INT,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) n_isat_records = ri;
+      MPI_Reduce(&isat_memory_mb,&rr,1,MPI_DOUBLE,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) isat_memory_mb = rr;
+    }
+    if(int_options_["adaptive_chemistry"] == 1) {
+      MPI_Reduce(&n_dac_fallbacks_,&ri,1,MPI_INT,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) n_dac_fallbacks_ = ri;
+      MPI_Reduce(&sum_dac_active_species_,&rr,1,MPI_DOUBLE,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) sum_dac_active_species_ = rr;
+    }
+    if(int_options_["frozen_chemistry_bypass"] == 1) {
+      MPI_Reduce(&n_frozen_bypass_,&ri,1,MPI_INT,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) n_frozen_bypass_ = ri;
+      MPI_Reduce(&frozen_max_error_,&rr,1,MPI_DOUBLE,MPI_MAX,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) frozen_max_error_ = rr;
+    }
+    if(int_options_["cluster_reactors"] == 1) {
+      MPI_Reduce(&n_reactors_input_,&ri,1,MPI_INT,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) n_reactors_input = ri;
+      MPI_Reduce(&n_clusters_,&ri,1,MPI_INT,MPI_SUM,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) n_clusters = ri;
+      MPI_Reduce(&cluster_max_dT_,&rr,1,MPI_DOUBLE,MPI_MAX,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) cluster_max_dT = rr;
+      MPI_Reduce(&cluster_max_dY_,&rr,1,MPI_DOUBLE,MPI_MAX,root_rank_,MPI_COMM_WORLD);
+      if(rank_ == root_rank_) cluster_max_dY = rr;
+    }
+
     //Get max time for cpu and gpu
     MPI_Reduce(&sum_cpu_reactor_time_,&rr,1,MPI_DOUBLE,MPI_MAX,root_rank_,MPI_COMM_WORLD);
     if(rank_ == root_rank_) max_cpu_reactor_time = rr;
@@ -1355,6 +2699,26 @@ void ZeroRKReactorManager::ProcessPerformance()
     reactor_log_file_ << std::setw(17) <<  gpu_per_step_time;
     reactor_log_file_ << std::setw(17) <<  avg_time;
     reactor_log_file_ << std::setw(17) <<  max_time;
+    if(int_options_["isat"] == 1) {
+      reactor_log_file_ << std::setw(17) <<  n_isat_retrieves_;
+      reactor_log_file_ << std::setw(17) <<  n_isat_records;
+      reactor_log_file_ << std::setw(17) <<  isat_memory_mb;
+    }
+    if(int_options_["adaptive_chemistry"] == 1) {
+      double dac_active_avg = n_cpu_solve_ > 0 ? sum_dac_active_species_/n_cpu_solve_ : 0;
+      reactor_log_file_ << std::setw(17) <<  n_dac_fallbacks_;
+      reactor_log_file_ << std::setw(17) <<  dac_active_avg;
+    }
+    if(int_options_["frozen_chemistry_bypass"] == 1) {
+      reactor_log_file_ << std::setw(17) <<  n_frozen_bypass_;
+      reactor_log_file_ << std::setw(17) <<  frozen_max_error_;
+    }
+    if(int_options_["cluster_reactors"] == 1) {
+      reactor_log_file_ << std::setw(17) <<  n_reactors_input;
+      reactor_log_file_ << std::setw(17) <<  n_clusters;
+      reactor_log_file_ << std::setw(17) <<  cluster_max_dT;
+      reactor_log_file_ << std::setw(17) <<  cluster_max_dY;
+    }
     reactor_log_file_ << std::endl;
     reactor_log_file_.flush();
 
@@ -7,9 +7,19 @@
 #include <memory>
 #include <fstream>
 
+#ifdef USE_MPI
+#include "mpi.h"
+#endif
+
 #include "zerork_reactor_manager_base.h"
 
 #include "reactor_base.h"
+#include "reactor_batch_cpu.h"
+#include "solver_base.h"
+#include "solver_seulex.h"
+#include "solver_exprb.h"
+#include "isat_table.h"
+#include "reactor_state_trace.h"
 
 #include "zerork/mechanism.h"
 #ifdef ZERORK_GPU
@@ -37,6 +47,26 @@ class ZeroRKReactorManager : public ZeroRKReactorManagerBase
   zerork_status_t SetCallbackFunction(zerork_callback_fn fn, void* cb_fn_data);
   zerork_status_t SetReactorIDs(int* reactor_ids);
 
+  zerork_status_t GetNumSpecies(int* num_species);
+  zerork_status_t GetSpeciesIndex(const std::string& species_name,
+                                  int* species_index);
+  zerork_status_t GetPremixedMassFractions(const double* fuel_mole_fracs,
+                                           const double* oxid_mole_fracs,
+                                           double phi,
+                                           double egr,
+                                           double* mass_fracs);
+
+  zerork_status_t GetArrheniusParameters(int reaction_id, int direction,
+                                         double* A, double* Tpow, double* Ea);
+  zerork_status_t SetArrheniusParameters(int reaction_id, int direction,
+                                         double A, double Tpow, double Ea);
+  zerork_status_t GetNumPLogLines(int reaction_id, int* num_lines);
+  zerork_status_t GetPLogParameters(int reaction_id, int line_id,
+                                    double* pressure, double* A,
+                                    double* Tpow, double* Ea);
+  zerork_status_t SetPLogParameters(int reaction_id, int line_id,
+                                    double A, double Tpow, double Ea);
+
   zerork_status_t FinishInit();
   zerork_status_t LoadBalance();
   zerork_status_t SolveReactors();
@@ -45,6 +75,9 @@ class ZeroRKReactorManager : public ZeroRKReactorManagerBase
 
  private:
   std::shared_ptr<zerork::mechanism> mech_ptr_;
+  // mech_ptr_ is from the process wide registry and shared with the other
+  // handles, it must not be changed
+  bool mech_shared_;
 #ifdef ZERORK_GPU
   std::shared_ptr<zerork::mechanism_cuda> mech_cuda_ptr_;
 #endif
@@ -131,6 +164,20 @@ class ZeroRKReactorManager : public ZeroRKReactorManagerBase
   void* cb_fn_data_;
 
   std::unique_ptr<ReactorBase> reactor_ptr_;
+
+  // Sets mech_ptr_ to the shared mechanism of the current files and rate
+  // constant table options (share_mechanism == 1) or to a mechanism of its
+  // own, without a rate constant table
+  zerork_status_t LoadCpuMechanism(bool shared,
+                                   const std::string& cklog_filename);
+  // Loads the mechanism on first use by the species and kinetic parameter
+  // functions
+  zerork_status_t RequireMechanism();
+  // Replaces a shared mechanism with one of its own before the kinetic
+  // parameters are changed
+  zerork_status_t RequirePrivateMechanism();
+  // Drops results that depend on the old kinetic parameters
+  zerork_status_t KineticsChanged();
 #ifdef ZERORK_GPU
   int n_cpu_ranks_;
   int n_gpu_ranks_;
@@ -147,8 +194,146 @@ class ZeroRKReactorManager : public ZeroRKReactorManagerBase
 #if USE_MPI
   int RecvReactors(size_t send_rank);
   void SendReactors(std::vector<size_t> send_reactor_idxs, size_t recv_rank);
+
+  // Packed layouts of the reactor inputs and results used by the exchanges
+  int ExchangeCountPerReactor();
+  int ResultCountPerReactor();
+  void PackReactor(size_t self_idx, double* buf);
+  void UnpackReactor(const double* buf, size_t other_idx);
+  void PackResult(size_t other_idx, double* buf);
+  void UnpackResult(const double* buf, size_t self_idx);
+  void ResizeOtherReactors();
+
+  // Dynamic load balancing (load_balance == 3). Each rank packs its own
+  // reactors in sorted (most expensive first) order into batches that are
+  // exposed in RMA windows. Every rank starts on its own batches at once and
+  // then steals the remaining batches of other ranks. Batches are claimed
+  // through an atomic counter on the owning rank, and inputs and results are
+  // moved with one-sided gets and puts, so no rank waits for a transfer
+  // plan or for the other ranks to finish.
+  void LoadBalanceDynamic();
+  zerork_status_t SolveReactorsDynamic();
+  void RedistributeResultsDynamic();
+
+  int batch_size_;
+  int batch_counter_;
+  int n_batches_self_;
+  int n_reactors_stolen_;
+  std::vector<int> n_batches_ranks_;
+  std::vector<int> n_reactors_ranks_;
+  std::vector<double> batch_input_buf_;
+  std::vector<double> batch_output_buf_;
+  std::vector<int> batch_ids_buf_;
+  MPI_Win batch_counter_win_;
+  MPI_Win batch_input_win_;
+  MPI_Win batch_output_win_;
+  MPI_Win batch_ids_win_;
 #endif
 
+  // Batched CPU reactors (cpu_batch_size > 1). Contiguous groups of the
+  // sorted unsolved reactors are integrated as one system by ReactorBatchCPU and
+  // marked in solved. Reactors of a failed batch are left unsolved for the
+  // per reactor solve.
+  bool UseBatchCPU();
+  void SolveReactorsBatchCPU(int n_reactors_calc, int* solved,
+                             std::vector<double*>& T_ptrs,
+                             std::vector<double*>& P_ptrs,
+                             std::vector<double*>& mf_ptrs,
+                             std::vector<double*>& dpdt_ptrs,
+                             std::vector<double*>& e_src_ptrs,
+                             std::vector<double*>& y_src_ptrs,
+                             std::vector<double*>& rc_ptrs,
+                             std::vector<double*>& rg_ptrs,
+                             std::vector<double*>& root_times_ptrs,
+                             std::vector<double*>& temp_delta_ptrs);
+  std::unique_ptr<ReactorBatchCPU> reactor_batch_ptr_;
+
+  std::unique_ptr<SolverBase> CreateSolverCPU(int n_reactors_calc);
+  // SEULEX parallel extrapolation (seulex_parallel_columns > 1) of the per
+  // reactor CPU solve. The extrapolation columns are computed concurrently
+  // by reactor_ptr_ and seulex_parallel_columns-1 column reactors.
+  bool UseSeulexParallelColumns();
+  std::vector<std::unique_ptr<ReactorBase>> seulex_column_reactors_;
+  // SEULEX workspace kept across solves, warm starts with seulex_warm_start
+  std::unique_ptr<SeulexContext> seulex_context_;
+  // exprb32 work vectors and Krylov basis kept across solves
+  std::unique_ptr<ExpRosenbrockContext> exprb_context_;
+
+  zerork_status_t SolveReactorCPU(SolverBase* solver, int k,
+                                  double* T, double* P, double* mf,
+                                  double* dpdt, double* e_src, double* y_src,
+                                  int* reactor_id, double* rc, double* rg,
+                                  double* root_time, double* temp_delta);
+
+  // In-situ adaptive tabulation of the CPU reactor mappings (isat == 1).
+  // The key is the reactor state vector at the start of the step plus
+  // log(P), and the tabulated output is the state vector at the end of the
+  // step.
+  void CreateIsatTable();
+  bool UseIsat(double dpdt, double e_src, double* y_src, bool solve_temperature);
+  int ComputeIsatGradient(std::vector<double>* gradient);
+  std::unique_ptr<IsatTable> isat_table_;
+  std::vector<double> isat_key_;
+  std::vector<double> isat_output_;
+  std::vector<double> isat_gradient_;
+  int n_isat_retrieves_;
+
+  // Frozen chemistry bypass (frozen_chemistry_bypass == 1). Reactors whose
+  // predicted change over the step is below tolerance take an explicit
+  // update instead of the implicit solve.
+  bool FrozenChemistryUpdate(double* error);
+  int n_frozen_bypass_;
+  double frozen_max_error_;
+
+  // Dynamic adaptive chemistry statistics of the current solve
+  int n_dac_fallbacks_;
+  double sum_dac_active_species_;
+
+  // Composition-space clustering (cluster_reactors == 1). The input
+  // reactors are binned in (T, log P, progress variable, equivalence
+  // ratio) and each bin is replaced by its mean state before load
+  // balancing, so only the representatives are distributed and solved.
+  // The increments of each representative are applied to its members in
+  // PostSolve.
+  void ClusterReactors();
+  void UnclusterReactors();
+  bool clustered_;
+  int n_reactors_input_;
+  int n_clusters_;
+  double cluster_max_dT_;
+  double cluster_max_dY_;
+  std::vector<int> cluster_of_reactor_;
+  std::vector<int> cluster_carbon_count_;
+  std::vector<int> cluster_hydrogen_count_;
+  std::vector<int> cluster_oxygen_count_;
+  std::vector<int> cluster_progress_species_;
+  std::vector<double> T_cluster_;
+  std::vector<double> P_cluster_;
+  std::vector<double> mf_cluster_;
+  std::vector<double> dpdt_cluster_;
+  std::vector<double> rc_cluster_;
+  std::vector<double> rg_cluster_;
+  std::vector<double> root_times_cluster_;
+  std::vector<double> temp_delta_cluster_;
+  std::vector<double> T_cluster_init_;
+  std::vector<double> P_cluster_init_;
+  std::vector<double> mf_cluster_init_;
+  double* T_input_;
+  double* P_input_;
+  double* mf_input_;
+  double* dpdt_input_;
+  double* rc_input_;
+  double* rg_input_;
+  double* root_times_input_;
+  double* temp_delta_input_;
+  int num_species_stride_input_;
+  bool reactor_ids_defined_input_;
+
+  // Capture of the solve inputs (reactor_state_capture_file). Each rank
+  // writes its own trace, suffixed with the rank when there is more than
+  // one.
+  std::unique_ptr<ReactorStateTraceWriter> trace_writer_;
+
   void ProcessPerformance();
 
   void DumpReactor(std::string tag, int id, double T, double P,
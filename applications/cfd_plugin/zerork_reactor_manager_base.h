@@ -28,6 +28,29 @@ class ZeroRKReactorManagerBase : public Optionable
   virtual zerork_status_t SetCallbackFunction(zerork_callback_fn fn, void* user_data) = 0;
   virtual zerork_status_t SetReactorIDs(int* field_pointer) = 0;
 
+  virtual zerork_status_t GetNumSpecies(int* num_species) = 0;
+  virtual zerork_status_t GetSpeciesIndex(const std::string& species_name,
+                                          int* species_index) = 0;
+  virtual zerork_status_t GetPremixedMassFractions(const double* fuel_mole_fracs,
+                                                   const double* oxid_mole_fracs,
+                                                   double phi,
+                                                   double egr,
+                                                   double* mass_fracs) = 0;
+
+  virtual zerork_status_t GetArrheniusParameters(int reaction_id, int direction,
+                                                 double* A, double* Tpow,
+                                                 double* Ea) = 0;
+  virtual zerork_status_t SetArrheniusParameters(int reaction_id, int direction,
+                                                 double A, double Tpow,
+                                                 double Ea) = 0;
+  virtual zerork_status_t GetNumPLogLines(int reaction_id, int* num_lines) = 0;
+  virtual zerork_status_t GetPLogParameters(int reaction_id, int line_id,
+                                            double* pressure, double* A,
+                                            double* Tpow, double* Ea) = 0;
+  virtual zerork_status_t SetPLogParameters(int reaction_id, int line_id,
+                                            double A, double Tpow,
+                                            double Ea) = 0;
+
   virtual zerork_status_t FinishInit() = 0;
   virtual zerork_status_t LoadBalance() = 0;
   virtual zerork_status_t SolveReactors() = 0;
@@ -474,6 +474,9 @@ int main(int argc, char *argv[])
         printf("Number of preconditioner evaluations: %ld\n", njacsetups);
         printf("Number of preconditioner solves: %ld\n", njacsolves);
       }
+      if(flame_params.jacobian_policy_.enabled()) {
+        flame_params.jacobian_policy_.Report(my_pe == 0);
+      }
       // Compute T
       for(int j=0; j<num_local_points; ++j) {
         temperature_jump[j] =
@@ -776,6 +779,8 @@ int main(int argc, char *argv[])
   if(flame_params.comm_rank_ == 0 && flame_params.my_pe_ == 0) {
     printf("# Simulation setup time   [s]: %12.5e\n",setup_time);
     printf("# Time in integrator loop [s]: %12.5e\n",loop_time);
+    printf("# Time in AF transposes   [s]: %12.5e\n",
+           flame_params.transpose_time_);
     if(flame_params.parser_->sensitivity_analysis()) printf("# Time in sensitivity loop [s]: %12.5e\n",sensanal_time);
 
   }
@@ -783,6 +788,9 @@ int main(int argc, char *argv[])
     "# Simulation setup time   [s]: %12.5e\n",setup_time);
   flame_params.logger_->PrintF(
     "# Time in integrator loop [s]: %12.5e\n",loop_time);
+  flame_params.logger_->PrintF(
+    "# Time in AF transposes   [s]: %12.5e\n",
+    flame_params.transpose_time_);
 
   if(flame_params.integrator_type_ == 2) {
     if(flame_params.superlu_serial_) {
@@ -27,6 +27,7 @@ FlameParams::FlameParams(const std::string &input_name)
   sparse_matrix_chem_.clear();
   valid_jacobian_structure_ = true;
   valid_jacobian_structure_ = true;
+  transpose_time_ = 0.0;
 
   if(!zerork::utilities::FileIsReadable(input_name)) {
     printf("# ERROR: Input file %s is not readable\n",input_name.c_str());
@@ -808,6 +809,14 @@ void FlameParams::SetMemory()
   integrator_type_ = parser_->integrator_type();
   store_jacobian_  = parser_->store_jacobian();
 
+  jacobian_policy_.SetOptions(parser_->jacobian_policy(),
+                              parser_->jacobian_max_reuse(),
+                              parser_->jacobian_convergence_rate(),
+                              parser_->jacobian_max_linear_iterations(),
+                              parser_->jacobian_symbolic_interval(),
+                              logger_);
+  jacobian_policy_.Reset();
+
   // Set Jacobian parameters
   // Case 1 is a block tridiagonal (potentially sparse) matrix solved with SuperLU
   if(integrator_type_ == 2) {
@@ -1061,6 +1070,14 @@ void FlameParams::SetMemory()
     banded_jacobian2_.assign(num_points*storage * num_states_local_, 0.0);
     banded_jacobian_serial_.assign(num_points*4*num_states_local_, 0.0);
     pivots_serial_.assign(num_points*num_states_local_, 0);
+
+    solution_species_.assign(num_local_points*num_states, 0.0);
+    solution_allspecies_.assign(num_points*num_states_local_, 0.0);
+    transpose_buffer_.assign(num_points*storage*num_states_local_, 0.0);
+    transpose_grid_counts_.assign(npes_, 0);
+    transpose_grid_displs_.assign(npes_, 0);
+    transpose_species_counts_.assign(npes_, 0);
+    transpose_species_displs_.assign(npes_, 0);
   } // if integrator_type == 3
 
 }
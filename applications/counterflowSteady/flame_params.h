@@ -5,6 +5,7 @@
 #include <vector>
 
 #include <file_utilities.h>
+#include <jacobian_policy.h>
 
 #include <mpi.h>
 
@@ -159,6 +160,10 @@ class FlameParams
 
   // For SuperLU serial
   bool superlu_serial_;
+
+  // Decides when the preconditioner is refactored
+  zerork::utilities::JacobianPolicy jacobian_policy_;
+
   SparseMatrix *sparse_matrix_;
 
   // For SuperLU_DIST
@@ -188,6 +193,17 @@ class FlameParams
   std::vector<double> banded_jacobian_serial_;
   std::vector<int> pivots_serial_;
 
+  // Persistent buffers of the AF transport solve. The transpose between
+  // the grid point and species distributions is a single MPI_Alltoallv.
+  std::vector<double> solution_species_;
+  std::vector<double> solution_allspecies_;
+  std::vector<double> transpose_buffer_;
+  std::vector<int> transpose_grid_counts_;
+  std::vector<int> transpose_grid_displs_;
+  std::vector<int> transpose_species_counts_;
+  std::vector<int> transpose_species_displs_;
+  double transpose_time_;
+
  private:
   void SetInlet();
   void SetGrid();
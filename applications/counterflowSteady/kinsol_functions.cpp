@@ -4,6 +4,20 @@
 extern "C" void dgbtrf_(int* dim1, int* dim2, int* nu, int* nl, double* a, int* lda, int* ipiv, int* info);
 extern "C" void dgbtrs_(char *TRANS, int *N, int *NRHS, int* nu, int* nl, double *A, int *LDA, int *IPIV, double *B, int *LDB, int *INFO);
 
+// Transpose between the grid point distribution (num_states blocks of
+// block_size values per processor) and the species distribution used by
+// the banded transport solve (num_states_local_ blocks of npes_*block_size
+// values per processor) with a single MPI_Alltoallv
+static void TransposeGridToSpecies(FlameParams *params,
+                                   const int block_size,
+                                   const double grid_data[],
+                                   double species_data[]);
+
+static void TransposeSpeciesToGrid(FlameParams *params,
+                                   const int block_size,
+                                   const double species_data[],
+                                   double grid_data[]);
+
 static double FindMaximumParallel(const int num_points,
                                   const double f[],
                                   int *j_at_max,
@@ -15,6 +29,25 @@ static double FindMinimumParallel(const int num_points,
                                   MPI_Comm comm);
 
 
+// Ask the Jacobian policy whether the preconditioner needs to be refactored.
+// The residual norm is only computed (a global reduction) when the policy
+// is enabled.
+static int GetJacobianSetupAction(N_Vector ydot,
+                                  N_Vector ydotscale,
+                                  FlameParams *params)
+{
+  double residual_norm = 0.0;
+  double shift = 0.0;
+  if(params->jacobian_policy_.enabled()) {
+    residual_norm = N_VWL2Norm(ydot, ydotscale);
+  }
+  if(params->pseudo_unsteady_) {
+    shift = 1.0/params->dt_;
+  }
+  return params->jacobian_policy_.GetSetupAction(residual_norm, shift);
+}
+
+
 // Main RHS function
 int ConstPressureFlame(N_Vector y,
 		       N_Vector ydot,
@@ -853,6 +886,12 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
   int npes  = params->npes_;
   const int nover=params->nover_;
 
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscale, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
   // Create work arrays
   std::vector<double> y_saved,rhs_ext_saved;
   y_saved.assign(num_local_points*num_states,0.0);
@@ -976,7 +1015,8 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
 
   // Factorize with SuperLU (parallel is default, serial if specified in input)
   if(params->superlu_serial_) {
-    if(params->sparse_matrix_->IsFirstFactor()) {
+    if(params->sparse_matrix_->IsFirstFactor() ||
+       setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
       error_flag =
         params->sparse_matrix_->FactorNewPatternCRS(num_nonzeros_loc,
                                                     &params->col_id_[0],
@@ -987,7 +1027,8 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
         params->sparse_matrix_->FactorSamePattern(&params->reactor_jacobian_dist_[0]);
     } //if first factor
   } else {
-    if(params->sparse_matrix_dist_->IsFirstFactor_dist()) {
+    if(params->sparse_matrix_dist_->IsFirstFactor_dist() ||
+       setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
       error_flag =
         params->sparse_matrix_dist_->FactorNewPatternCCS_dist(num_nonzeros_loc,
                                                               &params->col_id_[0],
@@ -1002,6 +1043,7 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
     } //if first factor
   } // if superlu serial
 
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
   return error_flag;
 }
 // Banded block diagonal finite difference Jacobian, solved with SuperLU
@@ -1027,6 +1069,7 @@ int ReactorBBDSolve(N_Vector y, // [in] state vector
   double *solution = NV_DATA_P(vv);
   int error_flag = 0;
 
+  params->jacobian_policy_.RecordSolve();
   if(params->superlu_serial_) {
     error_flag = params->sparse_matrix_->Solve(&solution[0],&solution[0]);
   } else {
@@ -1075,6 +1118,12 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
   const bool finite_separation = params->parser_->finite_separation();
   const bool fixed_temperature = params->parser_->fixed_temperature();
 
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscale, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
   // Initialize transport Jacobian
   for(int j=0; j<num_local_points*5*num_states; j++)
     params->banded_jacobian_[j] = 0.0;
@@ -1362,7 +1411,8 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
           params->saved_jacobian_chem_[j*num_nonzeros_zerod+k];
       }
       // factor the numerical jacobian
-      if(params->sparse_matrix_chem_[j]->IsFirstFactor()) {
+      if(params->sparse_matrix_chem_[j]->IsFirstFactor() ||
+         setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
         error_flag =
           params->sparse_matrix_chem_[j]->FactorNewPatternCCS(num_nonzeros_zerod,
                                                               &params->row_id_chem_[0],
@@ -1417,7 +1467,8 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
       }
 
       // factor the numerical jacobian
-      if(params->sparse_matrix_chem_[j]->IsFirstFactor()) {
+      if(params->sparse_matrix_chem_[j]->IsFirstFactor() ||
+         setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
         error_flag =
           params->sparse_matrix_chem_[j]->FactorNewPatternCCS(num_nonzeros_zerod,
                                                               &params->row_id_chem_[0],
@@ -1468,25 +1519,10 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
 
   // Communications to solve banded transport Jacobian
   // Each processor handles the full grid for a subset of species
-  MPI_Comm comm = params->comm_;
-  long int dsize = num_local_points*5;
-  int nodeDest;
-  // Gather the Jacobian to have all grid points for each species
-  for(int j=0; j<num_states; ++j) {
-    nodeDest = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_band = j*(num_local_points*5);
-    int start_band2 = jlocal*(num_total_points*5);
-
-    MPI_Gather(&params->banded_jacobian_[start_band],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               &params->banded_jacobian2_[start_band2],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               nodeDest,
-               comm);
-  }
+  TransposeGridToSpecies(params,
+                         num_local_points*5,
+                         &params->banded_jacobian_[0],
+                         &params->banded_jacobian2_[0]);
 
   // Reorder
   for(int j=0; j<num_states_local; ++j) {
@@ -1513,6 +1549,7 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
             &error_flag);
   }
 
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
   return error_flag;
 }
 
@@ -1535,8 +1572,10 @@ int ReactorAFSolve(N_Vector y, // [in] state vector
 {
 #endif
   double *solution = NV_DATA_P(vv);
+  FlameParams *params = (FlameParams *)user_data;
   int error_flag = 0;
 
+  params->jacobian_policy_.RecordSolve();
   error_flag = AFSolve(&solution[0], user_data);
   return error_flag;
 
@@ -1583,36 +1622,20 @@ int AFSolve(double solution[],
   }
 
   // Banded transport
-  // Communications for banded_jacobian2
-  MPI_Comm comm = params->comm_;
-  long int dsize = num_local_points;
-  int nodeDest, nodeFrom;
-
-  std::vector<double> solution_allspecies, solution_species;
-  solution_allspecies.assign(num_total_points*num_states_local, 0.0);
-  solution_species.assign(num_local_points*num_states, 0.0);
+  // Persistent work vectors of the species distributed solve
+  std::vector<double> &solution_allspecies = params->solution_allspecies_;
+  std::vector<double> &solution_species = params->solution_species_;
 
   // Reorder solution vector by species
   for(int j=0; j<num_states; ++j)
     for(int i=0; i<num_local_points; ++i)
       solution_species[j*num_local_points+i] = solution[j+i*num_states];
 
-  // Gather all grid points for each species
-  for(int j=0; j<num_states; ++j) {
-    nodeDest = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_id = j*num_local_points;
-    int start_id2 = jlocal*num_total_points;
-
-    MPI_Gather(&solution_species[start_id],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               &solution_allspecies[start_id2],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               nodeDest,
-               comm);
-  }
+  // Transpose to have all grid points for each local species
+  TransposeGridToSpecies(params,
+                         num_local_points,
+                         &solution_species[0],
+                         &solution_allspecies[0]);
 
   // Solve banded matrix for each species
   int dim = num_total_points;
@@ -1636,22 +1659,11 @@ int AFSolve(double solution[],
       printf("AFSolve banded matrix error: %d\n", error_flag);
   }
 
-  //Scatter back the solution vector for each species
-  for(int j=0; j<num_states; ++j) {
-    nodeFrom = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_id = j*num_local_points;
-    int start_id2 = jlocal*num_total_points;
-
-    MPI_Scatter(&solution_allspecies[start_id2],
-                dsize,
-                PVEC_REAL_MPI_TYPE,
-		&solution_species[start_id],
-                dsize,
-                PVEC_REAL_MPI_TYPE,
-                nodeFrom,
-                comm);
-  }
+  // Transpose back to have all species for each local grid point
+  TransposeSpeciesToGrid(params,
+                         num_local_points,
+                         &solution_allspecies[0],
+                         &solution_species[0]);
 
   // Reorder solution vector by grid points
   for(int j=0; j<num_states; ++j)
@@ -1723,3 +1735,93 @@ static double FindMinimumParallel(const int num_points,
 
   return out.value;
 }
+
+static void SetTransposeCounts(FlameParams *params,
+                               const int block_size)
+{
+  const int npes = params->npes_;
+  const int num_states = params->reactor_->GetNumStates();
+  const int num_states_local = params->num_states_local_;
+  const int num_states_per_proc = params->num_states_per_proc_;
+
+  for(int j=0; j<npes; ++j) {
+    int num_states_j = num_states_per_proc;
+    if(j == npes-1) {
+      num_states_j = num_states - (npes-1)*num_states_per_proc;
+    }
+    // Species owned by processor j are contiguous in the grid layout
+    params->transpose_grid_counts_[j] = num_states_j*block_size;
+    params->transpose_grid_displs_[j] = j*num_states_per_proc*block_size;
+    // Local species of processor j arrive as one contiguous chunk
+    params->transpose_species_counts_[j] = num_states_local*block_size;
+    params->transpose_species_displs_[j] = j*num_states_local*block_size;
+  }
+}
+
+static void TransposeGridToSpecies(FlameParams *params,
+                                   const int block_size,
+                                   const double grid_data[],
+                                   double species_data[])
+{
+  const int npes = params->npes_;
+  const int num_states_local = params->num_states_local_;
+  double *buffer = &params->transpose_buffer_[0];
+  double start_time = MPI_Wtime();
+
+  SetTransposeCounts(params, block_size);
+  MPI_Alltoallv(grid_data,
+                &params->transpose_grid_counts_[0],
+                &params->transpose_grid_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                buffer,
+                &params->transpose_species_counts_[0],
+                &params->transpose_species_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                params->comm_);
+
+  // Reorder from processor-major to species-major
+  for(int p=0; p<npes; ++p) {
+    for(int j=0; j<num_states_local; ++j) {
+      const double *source = &buffer[(p*num_states_local + j)*block_size];
+      double *dest = &species_data[(j*npes + p)*block_size];
+      for(int k=0; k<block_size; ++k) {
+        dest[k] = source[k];
+      }
+    }
+  }
+  params->transpose_time_ += MPI_Wtime() - start_time;
+}
+
+static void TransposeSpeciesToGrid(FlameParams *params,
+                                   const int block_size,
+                                   const double species_data[],
+                                   double grid_data[])
+{
+  const int npes = params->npes_;
+  const int num_states_local = params->num_states_local_;
+  double *buffer = &params->transpose_buffer_[0];
+  double start_time = MPI_Wtime();
+
+  // Reorder from species-major to processor-major
+  for(int p=0; p<npes; ++p) {
+    for(int j=0; j<num_states_local; ++j) {
+      const double *source = &species_data[(j*npes + p)*block_size];
+      double *dest = &buffer[(p*num_states_local + j)*block_size];
+      for(int k=0; k<block_size; ++k) {
+        dest[k] = source[k];
+      }
+    }
+  }
+
+  SetTransposeCounts(params, block_size);
+  MPI_Alltoallv(buffer,
+                &params->transpose_species_counts_[0],
+                &params->transpose_species_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                grid_data,
+                &params->transpose_grid_counts_[0],
+                &params->transpose_grid_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                params->comm_);
+  params->transpose_time_ += MPI_Wtime() - start_time;
+}
@@ -440,6 +440,9 @@ int main(int argc, char *argv[])
       printf("Number of preconditioner evaluations: %ld\n", njacsetups);
       printf("Number of preconditioner solves: %ld\n", njacsolves);
     }
+    if(flame_params.jacobian_policy_.enabled()) {
+      flame_params.jacobian_policy_.Report(my_pe == 0);
+    }
 
     // Get min/max of sum(Y_i)
     min_sum_mass_fraction = minSumMassFractions(flame_state_ptr,flame_params);
@@ -918,6 +921,8 @@ int main(int argc, char *argv[])
   if(my_pe == 0) {
     printf("# Simulation setup time   [s]: %12.5e\n",setup_time);
     printf("# Time in integrator loop [s]: %12.5e\n",loop_time);
+    printf("# Time in AF transposes   [s]: %12.5e\n",
+           flame_params.transpose_time_);
     if(flame_params.sensitivity_analysis_) printf("# Time in sensitivity loop [s]: %12.5e\n",sensanal_time);
     if(flame_params.uncertainty_quantification_) printf("# Time in UQ loop [s]: %12.5e\n",uq_time);
   }
@@ -925,6 +930,9 @@ int main(int argc, char *argv[])
     "# Simulation setup time   [s]: %12.5e\n",setup_time);
   flame_params.logger_->PrintF(
     "# Time in integrator loop [s]: %12.5e\n",loop_time);
+  flame_params.logger_->PrintF(
+    "# Time in AF transposes   [s]: %12.5e\n",
+    flame_params.transpose_time_);
 
   if(flame_params.integrator_type_ == 2) {
     flame_params.sparse_matrix_dist_->SparseMatrixClean_dist();
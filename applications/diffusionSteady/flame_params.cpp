@@ -25,6 +25,7 @@ FlameParams::FlameParams(const std::string &input_name, MPI_Comm &comm)
   MPI_Comm_size(comm_, &npes_);
   MPI_Comm_rank(comm_, &my_pe_);
   nover_ = 2;
+  transpose_time_ = 0.0;
 
   int error_code;
 
@@ -918,6 +919,13 @@ void FlameParams::SetMemory()
   // integrators
   integrator_type_ = parser_->integrator_type();
   store_jacobian_  = parser_->store_jacobian();
+  jacobian_policy_.SetOptions(parser_->jacobian_policy(),
+                              parser_->jacobian_max_reuse(),
+                              parser_->jacobian_convergence_rate(),
+                              parser_->jacobian_max_linear_iterations(),
+                              parser_->jacobian_symbolic_interval(),
+                              logger_);
+  jacobian_policy_.Reset();
 
   // Reaction rate limiter
   step_limiter_.assign( reactor_->GetNumSteps(), parser_->step_limiter() );
@@ -1213,6 +1221,14 @@ void FlameParams::SetMemory()
     banded_jacobian_serial_.assign(num_points*4*num_states_local_, 0.0);
     pivots_serial_.assign(num_points*num_states_local_, 0);
 
+    solution_species_.assign(num_local_points*num_states, 0.0);
+    solution_allspecies_.assign(num_points*num_states_local_, 0.0);
+    transpose_buffer_.assign(num_points*storage*num_states_local_, 0.0);
+    transpose_grid_counts_.assign(npes_, 0);
+    transpose_grid_displs_.assign(npes_, 0);
+    transpose_species_counts_.assign(npes_, 0);
+    transpose_species_displs_.assign(npes_, 0);
+
   }// if integrator_type == 3
 
 }
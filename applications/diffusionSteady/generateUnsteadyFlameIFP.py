@@ -202,6 +202,51 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':'jacobian_policy',
+    'type':'bool',
+    'longDesc' : "Flag that when set to true [y] lets the preconditioner setup reuse the current factorization while the residual keeps decreasing, instead of refactoring at every KINSOL setup call",
+    'defaultValue' : 0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_max_reuse',
+    'type':'int',
+    'shortDesc' : "Maximum number of setup calls that reuse a factorization (jacobian_policy)",
+    'defaultValue' : 10
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_convergence_rate',
+    'type':'double',
+    'longDesc' : "Refactor when the scaled residual norm is reduced by less than this factor between setup calls (jacobian_policy)",
+    'defaultValue' : 0.5
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_max_linear_iterations',
+    'type':'int',
+    'longDesc' : "Refactor when the average number of linear iterations per setup call made with the current factorization exceeds this value (jacobian_policy)",
+    'defaultValue' : 50
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_symbolic_interval',
+    'type':'int',
+    'longDesc' : "Number of numeric refactorizations after which the ordering and pivoting are recomputed, 0 = only after a failed factorization (jacobian_policy)",
+    'defaultValue' : 0
+}
+)
+
 spify_parser_params.append(
 {
     'name':'pseudo_unsteady',
@@ -5,6 +5,20 @@
 extern "C" void dgbtrf_(int* dim1, int* dim2, int* nu, int* nl, double* a, int* lda, int* ipiv, int* info);
 extern "C" void dgbtrs_(char *TRANS, int *N, int *NRHS, int* nu, int* nl, double *A, int *LDA, int *IPIV, double *B, int *LDB, int *INFO);
 
+// Transpose between the grid point distribution (num_states blocks of
+// block_size values per processor) and the species distribution used by
+// the banded transport solve (num_states_local_ blocks of npes_*block_size
+// values per processor) with a single MPI_Alltoallv
+static void TransposeGridToSpecies(FlameParams *params,
+                                   const int block_size,
+                                   const double grid_data[],
+                                   double species_data[]);
+
+static void TransposeSpeciesToGrid(FlameParams *params,
+                                   const int block_size,
+                                   const double species_data[],
+                                   double grid_data[]);
+
 // Upwind scheme for convective term
 static double NonLinearConvectUpwind(double velocity,
                                      double y_previous,
@@ -13,6 +27,25 @@ static double NonLinearConvectUpwind(double velocity,
                                      double inv_dz_prev,
                                      double inv_dz);
 
+
+// Ask the Jacobian policy whether the preconditioner needs to be refactored.
+// The residual norm is only computed (a global reduction) when the policy
+// is enabled.
+static int GetJacobianSetupAction(N_Vector ydot,
+                                  N_Vector ydotscale,
+                                  FlameParams *params)
+{
+  double residual_norm = 0.0;
+  double shift = 0.0;
+  if(params->jacobian_policy_.enabled()) {
+    residual_norm = N_VWL2Norm(ydot, ydotscale);
+  }
+  if(params->pseudo_unsteady_) {
+    shift = 1.0/params->dt_;
+  }
+  return params->jacobian_policy_.GetSetupAction(residual_norm, shift);
+}
+
 // Main RHS function
 int ConstPressureFlame(N_Vector y,
 		       N_Vector ydot,
@@ -836,13 +869,17 @@ int ReactorAFSetup(N_Vector y,      // [in]  state vector
   const int num_states_local = params->num_states_local_;
   double *y_ptr          = NV_DATA_P(y); //_S // caution: assumes realtype == double
   int error_flag = 0;
-  MPI_Comm comm = params->comm_;
-  int nodeDest;
   int my_pe = params->my_pe_;
 
   const double constant = params->jacobian_constant_;
   const int nover = params->nover_;
 
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscake, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
   // Transport Jacobian, evaluated analytically
   for(int j=0; j<num_local_points*5*num_states; j++)
       params->banded_jacobian_[j] = 0.0;
@@ -1190,7 +1227,8 @@ int ReactorAFSetup(N_Vector y,      // [in]  state vector
         params->reactor_jacobian_[k] = params->saved_jacobian_[j*num_nonzeros+k];
 
       // factor the numerical jacobian
-      if(params->sparse_matrix_[j]->IsFirstFactor()) {
+      if(params->sparse_matrix_[j]->IsFirstFactor() ||
+         setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
         error_flag =
           params->sparse_matrix_[j]->FactorNewPatternCCS(num_nonzeros,
                                                          &params->row_id_[0],
@@ -1240,7 +1278,8 @@ int ReactorAFSetup(N_Vector y,      // [in]  state vector
       }
 
       // factor the numerical jacobian
-      if(params->sparse_matrix_[j]->IsFirstFactor()) {
+      if(params->sparse_matrix_[j]->IsFirstFactor() ||
+         setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
         error_flag =
           params->sparse_matrix_[j]->FactorNewPatternCCS(num_nonzeros,
 						 &params->row_id_[0],
@@ -1293,23 +1332,10 @@ int ReactorAFSetup(N_Vector y,      // [in]  state vector
 
   // Reorganize transport Jacobian for more efficient parallelization prior to factorization
   // Communications to get banded_jacobian2
-  long int dsize = num_local_points*5;
-
-  for(int j=0; j<num_states; ++j) {
-    nodeDest = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_band = j*(num_local_points*5);
-    int start_band2 = jlocal*(num_total_points*5);
-
-    MPI_Gather(&params->banded_jacobian_[start_band],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               &params->banded_jacobian2_[start_band2],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               nodeDest,
-               comm);
-  }
+  TransposeGridToSpecies(params,
+                         num_local_points*5,
+                         &params->banded_jacobian_[0],
+                         &params->banded_jacobian2_[0]);
 
   // TODO: Do without jacobian2
   for(int j=0; j<num_states_local; ++j) {
@@ -1336,6 +1362,7 @@ int ReactorAFSetup(N_Vector y,      // [in]  state vector
             &error_flag);
   }//for j<num_states_local
 
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
   return 0;
 }
 
@@ -1366,6 +1393,7 @@ int ReactorAFSolve(N_Vector y,      // [in]  state vector
   int error_flag = 0;
   int start_id=0;
 
+  params->jacobian_policy_.RecordSolve();
   // Local sparse chemistry
   for(int j=0; j<num_local_points; ++j) {
     error_flag = params->sparse_matrix_[j]->Solve(&solution[start_id],
@@ -1378,36 +1406,20 @@ int ReactorAFSolve(N_Vector y,      // [in]  state vector
   }
 
   // Banded transport Jacobian
-  // Communications for banded_jacobian2
-  MPI_Comm comm = params->comm_;
-  long int dsize = num_local_points;
-  int nodeDest, nodeFrom;
-
-  std::vector<double> solution_allspecies, solution_species;
-  solution_allspecies.assign(num_total_points*num_states_local, 0.0);
-  solution_species.assign(num_local_points*num_states, 0.0);
+  // Persistent work vectors of the species distributed solve
+  std::vector<double> &solution_allspecies = params->solution_allspecies_;
+  std::vector<double> &solution_species = params->solution_species_;
 
   // Reorder solution vector by species
   for(int j=0; j<num_states; ++j)
     for(int i=0; i<num_local_points; ++i)
       solution_species[j*num_local_points+i] = solution[j+i*num_states];
 
-  // Gather all grid points
-  for(int j=0; j<num_states; ++j) {
-    nodeDest = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_id = j*num_local_points;
-    int start_id2 = jlocal*num_total_points;
-
-    MPI_Gather(&solution_species[start_id],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               &solution_allspecies[start_id2],
-               dsize,
-               PVEC_REAL_MPI_TYPE,
-               nodeDest,
-               comm);
-  }
+  // Transpose to have all grid points for each local species
+  TransposeGridToSpecies(params,
+                         num_local_points,
+                         &solution_species[0],
+                         &solution_allspecies[0]);
 
   // Solve banded matrix
   int dim = num_total_points;
@@ -1431,22 +1443,11 @@ int ReactorAFSolve(N_Vector y,      // [in]  state vector
       cerr << "Solve banded matrix error: " << error_flag << "\n";
   }
 
-  //Scatter back
-  for(int j=0; j<num_states; ++j) {
-    nodeFrom = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_id = j*num_local_points;
-    int start_id2 = jlocal*num_total_points;
-
-    MPI_Scatter(&solution_allspecies[start_id2],
-                dsize,
-                PVEC_REAL_MPI_TYPE,
-                &solution_species[start_id],
-                dsize,
-                PVEC_REAL_MPI_TYPE,
-                nodeFrom,
-                comm);
-  }
+  // Transpose back to have all species for each local grid point
+  TransposeSpeciesToGrid(params,
+                         num_local_points,
+                         &solution_allspecies[0],
+                         &solution_species[0]);
 
   for(int j=0; j<num_states; ++j)
     for(int i=0; i<num_local_points; ++i)
@@ -1493,6 +1494,12 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
   int npes  = params->npes_;
   const int nover=params->nover_;
 
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscale, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
   std::vector<double> y_saved,rhs_ext_saved;
   y_saved.assign(num_local_points*num_states,0.0);
   rhs_ext_saved.assign((num_local_points+2*nover)*num_states,0.0);
@@ -1612,7 +1619,8 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
   } // for j < num_local_states
 
   // Factorize
-  if(params->sparse_matrix_dist_->IsFirstFactor_dist()) {
+  if(params->sparse_matrix_dist_->IsFirstFactor_dist() ||
+     setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
     error_flag =
       params->sparse_matrix_dist_->FactorNewPatternCCS_dist(num_nonzeros_loc,
                                                             &params->col_id_[0],
@@ -1626,6 +1634,7 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
                                                              &params->reactor_jacobian_dist_[0]);
   } //if first factor
 
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
   return error_flag;
 }
 
@@ -1651,6 +1660,7 @@ int ReactorBBDSolve(N_Vector y, // [in] state vector
   double *solution = NV_DATA_P(vv);
   int error_flag = 0;
 
+  params->jacobian_policy_.RecordSolve();
   error_flag = params->sparse_matrix_dist_->Solve_dist(&solution[0],&solution[0]);
 
   return error_flag;
@@ -1686,3 +1696,93 @@ double NonLinearConvectUpwind(double velocity,
     return (velocity*(y_next - y_current)*inv_dz);
   }
 }
+
+static void SetTransposeCounts(FlameParams *params,
+                               const int block_size)
+{
+  const int npes = params->npes_;
+  const int num_states = params->reactor_->GetNumStates();
+  const int num_states_local = params->num_states_local_;
+  const int num_states_per_proc = params->num_states_per_proc_;
+
+  for(int j=0; j<npes; ++j) {
+    int num_states_j = num_states_per_proc;
+    if(j == npes-1) {
+      num_states_j = num_states - (npes-1)*num_states_per_proc;
+    }
+    // Species owned by processor j are contiguous in the grid layout
+    params->transpose_grid_counts_[j] = num_states_j*block_size;
+    params->transpose_grid_displs_[j] = j*num_states_per_proc*block_size;
+    // Local species of processor j arrive as one contiguous chunk
+    params->transpose_species_counts_[j] = num_states_local*block_size;
+    params->transpose_species_displs_[j] = j*num_states_local*block_size;
+  }
+}
+
+static void TransposeGridToSpecies(FlameParams *params,
+                                   const int block_size,
+                                   const double grid_data[],
+                                   double species_data[])
+{
+  const int npes = params->npes_;
+  const int num_states_local = params->num_states_local_;
+  double *buffer = &params->transpose_buffer_[0];
+  double start_time = MPI_Wtime();
+
+  SetTransposeCounts(params, block_size);
+  MPI_Alltoallv(grid_data,
+                &params->transpose_grid_counts_[0],
+                &params->transpose_grid_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                buffer,
+                &params->transpose_species_counts_[0],
+                &params->transpose_species_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                params->comm_);
+
+  // Reorder from processor-major to species-major
+  for(int p=0; p<npes; ++p) {
+    for(int j=0; j<num_states_local; ++j) {
+      const double *source = &buffer[(p*num_states_local + j)*block_size];
+      double *dest = &species_data[(j*npes + p)*block_size];
+      for(int k=0; k<block_size; ++k) {
+        dest[k] = source[k];
+      }
+    }
+  }
+  params->transpose_time_ += MPI_Wtime() - start_time;
+}
+
+static void TransposeSpeciesToGrid(FlameParams *params,
+                                   const int block_size,
+                                   const double species_data[],
+                                   double grid_data[])
+{
+  const int npes = params->npes_;
+  const int num_states_local = params->num_states_local_;
+  double *buffer = &params->transpose_buffer_[0];
+  double start_time = MPI_Wtime();
+
+  // Reorder from species-major to processor-major
+  for(int p=0; p<npes; ++p) {
+    for(int j=0; j<num_states_local; ++j) {
+      const double *source = &species_data[(j*npes + p)*block_size];
+      double *dest = &buffer[(p*num_states_local + j)*block_size];
+      for(int k=0; k<block_size; ++k) {
+        dest[k] = source[k];
+      }
+    }
+  }
+
+  SetTransposeCounts(params, block_size);
+  MPI_Alltoallv(buffer,
+                &params->transpose_species_counts_[0],
+                &params->transpose_species_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                grid_data,
+                &params->transpose_grid_counts_[0],
+                &params->transpose_grid_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                params->comm_);
+  params->transpose_time_ += MPI_Wtime() - start_time;
+}
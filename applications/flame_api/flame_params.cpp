@@ -80,63 +80,7 @@ FlameParams::FlameParams(ConstPressureReactor* reactor,
     SetMemory();
   }
   if(error_status_ == 0) {
-    if(string_options_["transport_model"] == "ConstantLewis") {
-      bool need_lewis_update = false;
-      int lewis_grid_point = -1;
-      if(string_options_["constant_lewis_setting"] == "GridPoint") {
-        need_lewis_update = true;
-        lewis_grid_point = int_options_["constant_lewis_grid_point"];
-        if(lewis_grid_point == -1) {
-          lewis_grid_point = num_points_ - 1;
-        }
-      } else if(string_options_["constant_lewis_setting"] == "Tfix") {
-        need_lewis_update = true;
-        lewis_grid_point = j_fix_;
-      }
-      if(need_lewis_update) {
-        lewis_grid_point = std::min(std::max(0,lewis_grid_point),num_points_-1);
-
-#ifdef ZERORK_MPI
-        int lewis_grid_point_rank = lewis_grid_point / num_local_points_;
-        int lewis_grid_point_local = lewis_grid_point - (lewis_grid_point_rank*num_local_points_);
-        std::vector<double> lewis_state(num_states_);
-        if(my_pe_ == lewis_grid_point_rank) {
-          for(int k=0; k<num_states_; ++k) {
-            lewis_state[k] = y_[lewis_grid_point_local*num_states_+k];
-          }
-        }
-        MPI_Bcast(&lewis_state[0], num_states_, MPI_DOUBLE, lewis_grid_point_rank, comm_);
-
-        for(int k=0; k<num_species_; ++k) {
-          transport_input_.mass_fraction_[k] = lewis_state[k];
-          transport_input_.grad_mass_fraction_[k] = 0.0;
-        }
-        transport_input_.temperature_ = reference_temperature_*lewis_state[num_states_-1];
-        transport_input_.grad_temperature_[0] = 0.0;
-#else
-        for(int k=0; k<num_species_; ++k) {
-          transport_input_.mass_fraction_[k] = y_[lewis_grid_point*num_states_+k];
-          transport_input_.grad_mass_fraction_[k] = 0.0;
-        }
-        transport_input_.temperature_ = reference_temperature_*y_[(lewis_grid_point+1)*num_states_-1];
-        transport_input_.grad_temperature_[0] = 0.0;
-#endif
-
-        transport::FlexibleTransport* flexible_transport = dynamic_cast<transport::FlexibleTransport*>(transport_);
-        flexible_transport->SetMixAvg(true);
-        int transport_error = flexible_transport->GetSpeciesMassFlux(
-				   transport_input_,
-				   num_species_,
-				   nullptr, //conductivity (computed internally)
-				   nullptr, //specific heat (computed(internally)
-				   &species_mass_flux_[0], //unused
-				   &species_lewis_numbers_[0]); //unused
-        flexible_transport->SetMixAvg(false);
-        if(transport_error != transport::NO_ERROR) {
-          error_status_ = 1;
-        }
-      }
-    }
+    SetConstantLewis();
   }
 }
 
@@ -248,6 +192,103 @@ void FlameParams::SetInitialCondition(double flame_speed, const double* T, const
   }
 } // void FlameParams::SetInitialCondition()
 
+// Re-use the memory and the sparse matrix structures of this object for a
+// new flame with the same number of grid points and the same options. The
+// symbolic factorizations of the preconditioner are kept between solves.
+void FlameParams::Reinitialize(const std::vector<double>& grid,
+                               double flame_speed,
+                               const double* T,
+                               const double* mass_fractions,
+                               double pressure)
+{
+  const int num_points_old = num_points_;
+  error_status_ = 0;
+  num_kinsol_errors_ = 0;
+  num_points_ = grid.size()-1;
+  z_ = grid;
+  pressure_ = pressure;
+  transport_input_.pressure_ = pressure_;
+  pseudo_unsteady_ = int_options_["pseudo_unsteady"] != 0;
+  dt_ = double_options_["pseudo_unsteady_dt"];
+
+  SetInitialCondition(flame_speed,T,mass_fractions);
+  if(error_status_ == 0 && num_points_ != num_points_old) {
+    // Grid size changed, the caller should have created a new object
+    error_status_ = 1;
+  }
+  if(error_status_ == 0) {
+    SetGrid();
+  }
+  if(error_status_ == 0) {
+    SetTfix();
+  }
+  if(error_status_ == 0) {
+    y_old_.assign(num_local_points_*num_states_, 0.0);
+    SetConstantLewis();
+  }
+}
+
+void FlameParams::SetConstantLewis()
+{
+  if(string_options_["transport_model"] == "ConstantLewis") {
+    bool need_lewis_update = false;
+    int lewis_grid_point = -1;
+    if(string_options_["constant_lewis_setting"] == "GridPoint") {
+      need_lewis_update = true;
+      lewis_grid_point = int_options_["constant_lewis_grid_point"];
+      if(lewis_grid_point == -1) {
+        lewis_grid_point = num_points_ - 1;
+      }
+    } else if(string_options_["constant_lewis_setting"] == "Tfix") {
+      need_lewis_update = true;
+      lewis_grid_point = j_fix_;
+    }
+    if(need_lewis_update) {
+      lewis_grid_point = std::min(std::max(0,lewis_grid_point),num_points_-1);
+
+#ifdef ZERORK_MPI
+      int lewis_grid_point_rank = lewis_grid_point / num_local_points_;
+      int lewis_grid_point_local = lewis_grid_point - (lewis_grid_point_rank*num_local_points_);
+      std::vector<double> lewis_state(num_states_);
+      if(my_pe_ == lewis_grid_point_rank) {
+        for(int k=0; k<num_states_; ++k) {
+          lewis_state[k] = y_[lewis_grid_point_local*num_states_+k];
+        }
+      }
+      MPI_Bcast(&lewis_state[0], num_states_, MPI_DOUBLE, lewis_grid_point_rank, comm_);
+
+      for(int k=0; k<num_species_; ++k) {
+        transport_input_.mass_fraction_[k] = lewis_state[k];
+        transport_input_.grad_mass_fraction_[k] = 0.0;
+      }
+      transport_input_.temperature_ = reference_temperature_*lewis_state[num_states_-1];
+      transport_input_.grad_temperature_[0] = 0.0;
+#else
+      for(int k=0; k<num_species_; ++k) {
+        transport_input_.mass_fraction_[k] = y_[lewis_grid_point*num_states_+k];
+        transport_input_.grad_mass_fraction_[k] = 0.0;
+      }
+      transport_input_.temperature_ = reference_temperature_*y_[(lewis_grid_point+1)*num_states_-1];
+      transport_input_.grad_temperature_[0] = 0.0;
+#endif
+
+      transport::FlexibleTransport* flexible_transport = dynamic_cast<transport::FlexibleTransport*>(transport_);
+      flexible_transport->SetMixAvg(true);
+      int transport_error = flexible_transport->GetSpeciesMassFlux(
+				   transport_input_,
+				   num_species_,
+				   nullptr, //conductivity (computed internally)
+				   nullptr, //specific heat (computed(internally)
+				   &species_mass_flux_[0], //unused
+				   &species_lewis_numbers_[0]); //unused
+      flexible_transport->SetMixAvg(false);
+      if(transport_error != transport::NO_ERROR) {
+        error_status_ = 1;
+      }
+    }
+  }
+}
+
 // Set the grid
 void FlameParams::SetGrid()
 {
@@ -159,10 +159,16 @@ class FlameParams : public Optionable
 
   void SetTfix();
   void GetTemperatureAndMassFractions(double* T, double* mass_fractions);
+  void Reinitialize(const std::vector<double>& grid,
+                    double flame_speed,
+                    const double* T,
+                    const double* mass_fractions,
+                    double pressure);
  private:
   void SetInitialCondition(double flame_speed, const double* T, const double* mass_fractions);
   void SetGrid();
   void SetMemory();
+  void SetConstantLewis();
 };
 
 
@@ -293,6 +293,33 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':'reuse_workspace',
+    'type':'int',
+    'shortDesc' : "Flag that when set non-zero re-uses solver memory between solves with the same number of grid points",
+    'defaultValue' : 1
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'solution_library_size',
+    'type':'int',
+    'shortDesc' : "Maximum number of converged flames kept as initial guesses for warm-started solves",
+    'defaultValue' : 32
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'batch_ranks_per_flame',
+    'type':'int',
+    'shortDesc' : "Number of MPI ranks solving each flame in a batch solve (0 for all ranks)",
+    'defaultValue' : 0
+}
+)
+
 #Generate parser code
 spg().generate(spify_parser_name,spify_parser_params)
 
@@ -97,6 +97,43 @@ zerork_flame_status_t zerork_flame_solve(int num_grid_points, const double* grid
   return flag;
 }
 
+extern "C"
+zerork_flame_status_t zerork_flame_solve_warm_start(int num_grid_points, const double* grid_points,
+                         double P, double* flame_speed, double* T, double* mass_fractions,
+                         zerork_flame_handle handle)
+{
+  if(handle == nullptr) return ZERORK_FLAME_STATUS_INVALID_HANDLE;
+  ZeroRKFlameManager* zfm = handle->r.get();
+  zerork_flame_status_t flag = zfm->FinishInit();
+  if(flag != ZERORK_FLAME_STATUS_SUCCESS) return flag;
+  flag = zfm->SolveWarmStart(num_grid_points, grid_points, P, flame_speed, T, mass_fractions);
+  return flag;
+}
+
+extern "C"
+zerork_flame_status_t zerork_flame_solve_batch(int num_flames, int num_grid_points,
+                         const double* grid_points, const double* P, double* flame_speed,
+                         double* T, double* mass_fractions, zerork_flame_status_t* flame_status,
+                         zerork_flame_handle handle)
+{
+  if(handle == nullptr) return ZERORK_FLAME_STATUS_INVALID_HANDLE;
+  ZeroRKFlameManager* zfm = handle->r.get();
+  zerork_flame_status_t flag = zfm->FinishInit();
+  if(flag != ZERORK_FLAME_STATUS_SUCCESS) return flag;
+  flag = zfm->SolveBatch(num_flames, num_grid_points, grid_points, P, flame_speed,
+                         T, mass_fractions, flame_status);
+  return flag;
+}
+
+extern "C"
+zerork_flame_status_t zerork_flame_clear_solution_library(zerork_flame_handle handle)
+{
+  if(handle == nullptr) return ZERORK_FLAME_STATUS_INVALID_HANDLE;
+  ZeroRKFlameManager* zfm = handle->r.get();
+  zfm->ClearSolutionLibrary();
+  return ZERORK_FLAME_STATUS_SUCCESS;
+}
+
 extern "C"
 zerork_flame_status_t zerork_flame_set_int_option(const char* option_name_chr,
                                   int option_value,
@@ -175,6 +212,9 @@ zerork_flame_status_t zerork_flame_free(zerork_flame_handle handle) {
   if(handle == nullptr) {
       return ZERORK_FLAME_STATUS_INVALID_HANDLE;
   } else {
+      // Free the MPI resources of the workspace while MPI is still
+      // initialized, before the manager itself is destroyed
+      if(handle->r != nullptr) handle->r->FreeWorkspace();
       handle->r.reset(nullptr);
       delete handle;
       return ZERORK_FLAME_STATUS_SUCCESS;
@@ -45,6 +45,32 @@ zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_solve(int num_grid_point
                                                               double *mass_fractions,    //array (in/out) of mass fractions ([grid_idx*num_species + species_idx])
                                                               zerork_flame_handle handle);
 
+//Same as zerork_flame_solve, but starts from the closest previously converged flame
+//(by pressure and inlet state) when one is available. The inlet state T[0] and
+//mass_fractions[0:num_species] must be set.
+zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_solve_warm_start(int num_grid_points,
+                                                                         const double *grid_points,
+                                                                         double P,
+                                                                         double *flame_speed,
+                                                                         double *T,
+                                                                         double *mass_fractions,
+                                                                         zerork_flame_handle handle);
+
+//Solve num_flames flames with warm starts. Arrays are stored flame by flame
+//(e.g. T[flame_idx*num_grid_points + grid_idx]). With MPI the flames are distributed
+//over groups of "batch_ranks_per_flame" ranks.
+zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_solve_batch(int num_flames,                       //scalar (in)
+                                                                    int num_grid_points,                  //scalar (in)
+                                                                    const double *grid_points,            //array (in)
+                                                                    const double *P,                      //array (in)
+                                                                    double *flame_speed,                  //array (in/out)
+                                                                    double *T,                            //array (in/out)
+                                                                    double *mass_fractions,               //array (in/out)
+                                                                    zerork_flame_status_t *flame_status,  //array (out)
+                                                                    zerork_flame_handle handle);
+
+zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_clear_solution_library(zerork_flame_handle handle);
+
 zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_set_int_option(const char* option_name_chr,
                                   int option_value,
                                   zerork_flame_handle handle);
@@ -75,6 +101,10 @@ zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_get_string_option(const
 //                                                                        void* cb_fn_data,
 //                                                                        zerork_flame_handle handle);
 
+// Frees the handle and its solver workspace. With MPI the workspace holds
+// SuperLU_DIST grids and communicators, so zerork_flame_free must be called
+// before MPI_Finalize. Handles still alive after MPI_Finalize leak their
+// workspace rather than make MPI calls.
 zerork_flame_status_t ZERORK_FLAME_EXPORTS zerork_flame_free(zerork_flame_handle handle);
 
 
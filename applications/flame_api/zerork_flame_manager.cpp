@@ -55,6 +55,13 @@ void kin_err_handler(int error_code, const char *module,
 ZeroRKFlameManager::ZeroRKFlameManager() {
   reactor_   = nullptr;
   transport_ = nullptr;
+  flame_params_ = nullptr;
+  next_library_slot_ = 0;
+#ifdef ZERORK_MPI
+  flame_params_comm_ = MPI_COMM_NULL;
+  batch_comm_ = MPI_COMM_NULL;
+  batch_ranks_per_flame_ = -1;
+#endif
 
   tried_init_  = false;
   init_status_ = ZERORK_FLAME_STATUS_SUCCESS;
@@ -88,11 +95,41 @@ ZeroRKFlameManager::ZeroRKFlameManager() {
   int_options_["pseudo_unsteady_max_iterations"] = 20;
   double_options_["pseudo_unsteady_time"] = 1.0;
 
+  //Warm start and batch options
+  int_options_["reuse_workspace"] = 1;
+  int_options_["solution_library_size"] = 32;
+  int_options_["batch_ranks_per_flame"] = 0; // 0 for all ranks
+
   //File-output Options
   string_options_["mechanism_parsing_log_filename"] = std::string(zerork::utilities::null_filename);
   string_options_["transport_parsing_log_filename"] = std::string(zerork::utilities::null_filename);
 }
 
+ZeroRKFlameManager::~ZeroRKFlameManager() {
+  FreeWorkspace();
+}
+
+void ZeroRKFlameManager::FreeWorkspace() {
+#ifdef ZERORK_MPI
+  int mpi_finalized = 0;
+  MPI_Finalized(&mpi_finalized);
+  if(mpi_finalized) {
+    // The FlameParams destructor cleans up SuperLU_DIST with MPI calls,
+    // which is not allowed after MPI_Finalize. The handle was not freed
+    // with zerork_flame_free before finalizing, so the workspace is leaked.
+    flame_params_.release();
+    return;
+  }
+  flame_params_.reset(nullptr);
+  flame_params_comm_ = MPI_COMM_NULL;
+  if(batch_comm_ != MPI_COMM_NULL) {
+    MPI_Comm_free(&batch_comm_);
+  }
+#else
+  flame_params_.reset(nullptr);
+#endif
+}
+
 zerork_flame_status_t ZeroRKFlameManager::ReadOptionsFile(const std::string& options_filename) {
   std::unique_ptr<ZeroRKFlameAPITesterIFP> inputFileDBptr;
   try {
@@ -112,6 +149,9 @@ zerork_flame_status_t ZeroRKFlameManager::ReadOptionsFile(const std::string& opt
   int_options_["pseudo_unsteady"] = inputFileDB.pseudo_unsteady();
   int_options_["pseudo_unsteady_max_iterations"] = inputFileDB.pseudo_unsteady_max_iterations();
   int_options_["constant_lewis_grid_point"] = inputFileDB.constant_lewis_grid_point();
+  int_options_["reuse_workspace"] = inputFileDB.reuse_workspace();
+  int_options_["solution_library_size"] = inputFileDB.solution_library_size();
+  int_options_["batch_ranks_per_flame"] = inputFileDB.batch_ranks_per_flame();
 
   double_options_["absolute_tolerance"] = inputFileDB.absolute_tolerance();
   double_options_["relative_tolerance"] = inputFileDB.relative_tolerance();
@@ -189,6 +229,328 @@ zerork_flame_status_t ZeroRKFlameManager::FinishInit() {
 
 zerork_flame_status_t ZeroRKFlameManager::Solve(int num_grid_points, const double* grid_points, double P,
                                                 double* flame_speed, double* T, double* mass_fractions)
+{
+#ifdef ZERORK_MPI
+  zerork_flame_status_t flag = SolveFlame(num_grid_points, grid_points, P, flame_speed,
+                                          T, mass_fractions, MPI_COMM_WORLD);
+  int my_pe = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &my_pe);
+#else
+  zerork_flame_status_t flag = SolveFlame(num_grid_points, grid_points, P, flame_speed,
+                                          T, mass_fractions);
+  int my_pe = 0;
+#endif
+  if(flag == ZERORK_FLAME_STATUS_SUCCESS && my_pe == 0) {
+    AddToSolutionLibrary(num_grid_points, grid_points, P, *flame_speed, T, mass_fractions);
+  }
+  return flag;
+}
+
+// Solve using the nearest flame of the solution library as the initial
+// guess. The inlet state (first grid point) of T and mass_fractions must be
+// set by the caller. The rest of the profile is only used when the library
+// is empty, or if the solve from the library guess fails.
+zerork_flame_status_t ZeroRKFlameManager::SolveWarmStart(int num_grid_points, const double* grid_points, double P,
+                                                         double* flame_speed, double* T, double* mass_fractions)
+{
+#ifdef ZERORK_MPI
+  return SolveFlameWarmStart(num_grid_points, grid_points, P, flame_speed,
+                             T, mass_fractions, MPI_COMM_WORLD);
+#else
+  return SolveFlameWarmStart(num_grid_points, grid_points, P, flame_speed,
+                             T, mass_fractions);
+#endif
+}
+
+#ifdef ZERORK_MPI
+zerork_flame_status_t ZeroRKFlameManager::SolveFlameWarmStart(int num_grid_points, const double* grid_points, double P,
+                                                              double* flame_speed, double* T, double* mass_fractions,
+                                                              MPI_Comm comm)
+#else
+zerork_flame_status_t ZeroRKFlameManager::SolveFlameWarmStart(int num_grid_points, const double* grid_points, double P,
+                                                              double* flame_speed, double* T, double* mass_fractions)
+#endif
+{
+  const int num_species = reactor_->GetNumSpecies();
+  int my_pe = 0;
+#ifdef ZERORK_MPI
+  MPI_Comm_rank(comm, &my_pe);
+#endif
+
+  // Keep the caller's guess to fall back on
+  double flame_speed_guess = *flame_speed;
+  std::vector<double> T_guess;
+  std::vector<double> mass_fractions_guess;
+  int used_library = 0;
+  if(my_pe == 0) {
+    T_guess.assign(T, T+num_grid_points);
+    mass_fractions_guess.assign(mass_fractions, mass_fractions+num_grid_points*num_species);
+    if(GetSolutionLibraryGuess(num_grid_points, grid_points, P, flame_speed, T, mass_fractions)) {
+      used_library = 1;
+    }
+  }
+#ifdef ZERORK_MPI
+  MPI_Bcast(&used_library, 1, MPI_INT, 0, comm);
+  zerork_flame_status_t flag = SolveFlame(num_grid_points, grid_points, P, flame_speed,
+                                          T, mass_fractions, comm);
+#else
+  zerork_flame_status_t flag = SolveFlame(num_grid_points, grid_points, P, flame_speed,
+                                          T, mass_fractions);
+#endif
+
+  if(flag != ZERORK_FLAME_STATUS_SUCCESS && used_library == 1) {
+    if(int_options_["verbosity"] > 0 && my_pe == 0) {
+      printf("Failed solve from solution library guess, retrying with input guess\n");
+    }
+    *flame_speed = flame_speed_guess;
+    if(my_pe == 0) {
+      std::copy(T_guess.begin(), T_guess.end(), T);
+      std::copy(mass_fractions_guess.begin(), mass_fractions_guess.end(), mass_fractions);
+    }
+#ifdef ZERORK_MPI
+    flag = SolveFlame(num_grid_points, grid_points, P, flame_speed,
+                      T, mass_fractions, comm);
+#else
+    flag = SolveFlame(num_grid_points, grid_points, P, flame_speed,
+                      T, mass_fractions);
+#endif
+  }
+
+  if(flag == ZERORK_FLAME_STATUS_SUCCESS && my_pe == 0) {
+    AddToSolutionLibrary(num_grid_points, grid_points, P, *flame_speed, T, mass_fractions);
+  }
+  return flag;
+}
+
+// Solve num_flames flames stored contiguously in the input arrays. With MPI
+// the ranks are split into groups of batch_ranks_per_flame ranks and each
+// group solves a subset of the flames with warm starts from its own solution
+// library. Inputs are read from and results are returned to rank 0.
+zerork_flame_status_t ZeroRKFlameManager::SolveBatch(int num_flames, int num_grid_points,
+                                                     const double* grid_points, const double* P,
+                                                     double* flame_speed, double* T,
+                                                     double* mass_fractions,
+                                                     zerork_flame_status_t* flame_status)
+{
+  const int num_species = reactor_->GetNumSpecies();
+#ifdef ZERORK_MPI
+  int my_pe, npes;
+  MPI_Comm_rank(MPI_COMM_WORLD, &my_pe);
+  MPI_Comm_size(MPI_COMM_WORLD, &npes);
+  MPI_Bcast(&num_flames, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&num_grid_points, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  int ranks_per_flame = int_options_["batch_ranks_per_flame"];
+  if(ranks_per_flame <= 0 || ranks_per_flame > npes || npes % ranks_per_flame != 0) {
+    ranks_per_flame = npes;
+  }
+  if(ranks_per_flame != batch_ranks_per_flame_) {
+    if(batch_comm_ != MPI_COMM_NULL) {
+      if(flame_params_comm_ == batch_comm_) {
+        flame_params_.reset(nullptr);
+      }
+      MPI_Comm_free(&batch_comm_);
+    }
+    MPI_Comm_split(MPI_COMM_WORLD, my_pe/ranks_per_flame, my_pe, &batch_comm_);
+    batch_ranks_per_flame_ = ranks_per_flame;
+  }
+  const int num_groups = npes/ranks_per_flame;
+  const int group_id = my_pe/ranks_per_flame;
+  int group_pe;
+  MPI_Comm_rank(batch_comm_, &group_pe);
+
+  // Every rank gets a copy of the inputs, only the group roots use them
+  const int num_flame_values = num_grid_points*(num_species+2) + 2;
+  std::vector<double> inputs(num_flames*num_flame_values, 0.0);
+  if(my_pe == 0) {
+    for(int j=0; j<num_flames; ++j) {
+      double* flame_inputs = &inputs[j*num_flame_values];
+      flame_inputs[0] = P[j];
+      flame_inputs[1] = flame_speed[j];
+      std::copy(&grid_points[j*num_grid_points], &grid_points[(j+1)*num_grid_points], &flame_inputs[2]);
+      std::copy(&T[j*num_grid_points], &T[(j+1)*num_grid_points], &flame_inputs[2+num_grid_points]);
+      std::copy(&mass_fractions[j*num_grid_points*num_species], &mass_fractions[(j+1)*num_grid_points*num_species],
+                &flame_inputs[2+2*num_grid_points]);
+    }
+  }
+  MPI_Bcast(inputs.data(), inputs.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  // Results are zero except on the group root that solved the flame, so
+  // they can be summed onto rank 0
+  std::vector<double> outputs(num_flames*num_flame_values, 0.0);
+  std::vector<int> status(num_flames, 0);
+  for(int j=group_id; j<num_flames; j+=num_groups) {
+    double* flame_inputs = &inputs[j*num_flame_values];
+    double flame_speed_j = flame_inputs[1];
+    zerork_flame_status_t flag = SolveFlameWarmStart(num_grid_points,
+                                                     &flame_inputs[2],
+                                                     flame_inputs[0],
+                                                     &flame_speed_j,
+                                                     &flame_inputs[2+num_grid_points],
+                                                     &flame_inputs[2+2*num_grid_points],
+                                                     batch_comm_);
+    if(group_pe == 0) {
+      std::copy(flame_inputs, flame_inputs+num_flame_values, &outputs[j*num_flame_values]);
+      outputs[j*num_flame_values+1] = flame_speed_j;
+      status[j] = (int)flag;
+    }
+  }
+
+  std::vector<double> outputs_root;
+  std::vector<int> status_root;
+  if(my_pe == 0) {
+    outputs_root.assign(outputs.size(), 0.0);
+    status_root.assign(num_flames, 0);
+  }
+  MPI_Reduce(outputs.data(), outputs_root.data(), outputs.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(status.data(), status_root.data(), num_flames, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  int num_failed = 0;
+  if(my_pe == 0) {
+    for(int j=0; j<num_flames; ++j) {
+      const double* flame_outputs = &outputs_root[j*num_flame_values];
+      flame_speed[j] = flame_outputs[1];
+      std::copy(&flame_outputs[2+num_grid_points], &flame_outputs[2+2*num_grid_points], &T[j*num_grid_points]);
+      std::copy(&flame_outputs[2+2*num_grid_points], &flame_outputs[num_flame_values],
+                &mass_fractions[j*num_grid_points*num_species]);
+      flame_status[j] = (zerork_flame_status_t)status_root[j];
+      if(flame_status[j] != ZERORK_FLAME_STATUS_SUCCESS) {
+        num_failed += 1;
+      }
+    }
+  }
+  MPI_Bcast(&num_failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#else
+  int num_failed = 0;
+  for(int j=0; j<num_flames; ++j) {
+    flame_status[j] = SolveFlameWarmStart(num_grid_points,
+                                          &grid_points[j*num_grid_points],
+                                          P[j],
+                                          &flame_speed[j],
+                                          &T[j*num_grid_points],
+                                          &mass_fractions[j*num_grid_points*num_species]);
+    if(flame_status[j] != ZERORK_FLAME_STATUS_SUCCESS) {
+      num_failed += 1;
+    }
+  }
+#endif
+  if(num_failed > 0) {
+    return ZERORK_FLAME_STATUS_FAILED_SOLVE;
+  }
+  return ZERORK_FLAME_STATUS_SUCCESS;
+}
+
+void ZeroRKFlameManager::ClearSolutionLibrary()
+{
+  solution_library_.clear();
+  next_library_slot_ = 0;
+}
+
+void ZeroRKFlameManager::AddToSolutionLibrary(int num_grid_points, const double* grid_points,
+                                              double P, double flame_speed,
+                                              const double* T, const double* mass_fractions)
+{
+  const int num_species = reactor_->GetNumSpecies();
+  const int library_size = int_options_["solution_library_size"];
+  if(library_size <= 0) {
+    return;
+  }
+  FlameSolution solution;
+  solution.pressure = P;
+  solution.flame_speed = flame_speed;
+  solution.grid.assign(grid_points, grid_points+num_grid_points);
+  solution.T.assign(T, T+num_grid_points);
+  solution.mass_fractions.assign(mass_fractions, mass_fractions+num_grid_points*num_species);
+
+  // Replace the oldest entry once the library is full
+  if((int)solution_library_.size() < library_size) {
+    solution_library_.push_back(solution);
+  } else {
+    next_library_slot_ = next_library_slot_ % solution_library_.size();
+    solution_library_[next_library_slot_] = solution;
+    next_library_slot_ += 1;
+  }
+}
+
+// Find the converged flame closest to the requested pressure and inlet
+// state, and interpolate its profile onto the requested grid. The inlet
+// state in T[0] and mass_fractions[0:num_species] is not modified.
+bool ZeroRKFlameManager::GetSolutionLibraryGuess(int num_grid_points, const double* grid_points,
+                                                 double P, double* flame_speed,
+                                                 double* T, double* mass_fractions)
+{
+  const int num_species = reactor_->GetNumSpecies();
+  if(solution_library_.size() == 0 || num_grid_points < 2) {
+    return false;
+  }
+
+  // Distance on log pressure, relative inlet temperature and inlet
+  // composition
+  int nearest = -1;
+  double nearest_distance = 1.0e300;
+  for(size_t j=0; j<solution_library_.size(); ++j) {
+    const FlameSolution& solution = solution_library_[j];
+    double distance = fabs(log(P/solution.pressure)) +
+                      fabs(T[0]-solution.T[0])/solution.T[0];
+    for(int k=0; k<num_species; ++k) {
+      distance += fabs(mass_fractions[k]-solution.mass_fractions[k]);
+    }
+    if(distance < nearest_distance) {
+      nearest_distance = distance;
+      nearest = j;
+    }
+  }
+  const FlameSolution& solution = solution_library_[nearest];
+  const int num_solution_points = solution.grid.size();
+
+  int interval = 0;
+  for(int j=1; j<num_grid_points; ++j) {
+    const double z = grid_points[j];
+    while(interval < num_solution_points-2 && solution.grid[interval+1] < z) {
+      interval += 1;
+    }
+    double weight = (z-solution.grid[interval])/
+                    (solution.grid[interval+1]-solution.grid[interval]);
+    weight = std::min(std::max(weight, 0.0), 1.0);
+    T[j] = (1.0-weight)*solution.T[interval] + weight*solution.T[interval+1];
+    for(int k=0; k<num_species; ++k) {
+      mass_fractions[j*num_species+k] =
+        (1.0-weight)*solution.mass_fractions[interval*num_species+k] +
+        weight*solution.mass_fractions[(interval+1)*num_species+k];
+    }
+  }
+  *flame_speed = solution.flame_speed;
+
+  if(int_options_["verbosity"] > 0) {
+    printf("Using solution library flame %d (P = %g Pa, T_u = %g K, S_L = %g m/s) as initial guess\n",
+           nearest, solution.pressure, solution.T[0], solution.flame_speed);
+  }
+  return true;
+}
+
+// The cached FlameParams holds a copy of the options from when it was
+// created, so it can only be re-used if none have changed since
+bool ZeroRKFlameManager::FlameParamsOptionsMatch()
+{
+  IntOptions int_options;
+  DoubleOptions double_options;
+  StringOptions string_options;
+  flame_params_->GetIntOptions(&int_options);
+  flame_params_->GetDoubleOptions(&double_options);
+  flame_params_->GetStringOptions(&string_options);
+  return int_options == int_options_ &&
+         double_options == double_options_ &&
+         string_options == string_options_;
+}
+
+#ifdef ZERORK_MPI
+zerork_flame_status_t ZeroRKFlameManager::SolveFlame(int num_grid_points, const double* grid_points, double P,
+                                                     double* flame_speed, double* T, double* mass_fractions,
+                                                     MPI_Comm comm)
+#else
+zerork_flame_status_t ZeroRKFlameManager::SolveFlame(int num_grid_points, const double* grid_points, double P,
+                                                     double* flame_speed, double* T, double* mass_fractions)
+#endif
 {
   const int num_species     = reactor_->GetNumSpecies();
   const int integrator_type = int_options_["integrator_type"];
@@ -198,14 +560,40 @@ zerork_flame_status_t ZeroRKFlameManager::Solve(int num_grid_points, const doubl
   reactor_->SetReferenceTemperature(double_options_["reference_temperature"]);
   reactor_->SetPressure(P);
 
-  // Initialize flame params
+  // Initialize flame params, re-using the workspace of the previous solve
+  // when possible
+  int reuse_flame_params = 0;
+  int my_pe = 0;
 #ifdef ZERORK_MPI
-  FlameParams flame_params(reactor_.get(), transport_.get(), grid, *flame_speed, T, mass_fractions, P, MPI_COMM_WORLD, *this);
+  MPI_Comm_rank(comm, &my_pe);
+  if(flame_params_ != nullptr && comm != flame_params_comm_) {
+    flame_params_.reset(nullptr);
+  }
+#endif
+  if(my_pe == 0) {
+    reuse_flame_params = (int_options_["reuse_workspace"] != 0 &&
+                          flame_params_ != nullptr &&
+                          flame_params_->num_points_ == num_grid_points-1 &&
+                          FlameParamsOptionsMatch()) ? 1 : 0;
+  }
+#ifdef ZERORK_MPI
+  MPI_Bcast(&reuse_flame_params, 1, MPI_INT, 0, comm);
+#endif
+  if(reuse_flame_params == 1) {
+    flame_params_->Reinitialize(grid, *flame_speed, T, mass_fractions, P);
+  } else {
+    flame_params_.reset(nullptr);
+#ifdef ZERORK_MPI
+    flame_params_ = std::make_unique<FlameParams>(reactor_.get(), transport_.get(), grid, *flame_speed, T, mass_fractions, P, comm, *this);
+    flame_params_comm_ = comm;
 #else
-  FlameParams flame_params(reactor_.get(), transport_.get(), grid, *flame_speed, T, mass_fractions, P, *this);
+    flame_params_ = std::make_unique<FlameParams>(reactor_.get(), transport_.get(), grid, *flame_speed, T, mass_fractions, P, *this);
 #endif
+  }
+  FlameParams& flame_params = *flame_params_;
   if(flame_params.error_status_ != 0) {
     // We may want to add some status'es for more information on what/why FlameParams errored
+    flame_params_.reset(nullptr);
     return ZERORK_FLAME_STATUS_FAILED_SOLVE;
   }
 
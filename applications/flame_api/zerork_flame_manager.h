@@ -7,6 +7,10 @@
 #include <memory>
 #include <fstream>
 
+#ifdef ZERORK_MPI
+#include <mpi.h>
+#endif
+
 #include "zerork/mechanism.h"
 #include <reactor/const_pressure_reactor.h>
 #include <transport/mass_transport_factory.h>
@@ -15,12 +19,13 @@
 
 #include "optionable.h"
 
+class FlameParams;
 
 class ZeroRKFlameManager : public Optionable
 {
  public:
   ZeroRKFlameManager();
-  virtual ~ZeroRKFlameManager() {};
+  virtual ~ZeroRKFlameManager();
 
   zerork_flame_status_t ReadOptionsFile(const std::string& options_filename);
   zerork_flame_status_t LoadMechanism();
@@ -31,11 +36,68 @@ class ZeroRKFlameManager : public Optionable
   zerork_flame_status_t Solve(int num_grid_points, const double* grid_points,
                               double P, double* flame_speed,
                               double* T, double* mass_fractions);
+  zerork_flame_status_t SolveWarmStart(int num_grid_points, const double* grid_points,
+                                       double P, double* flame_speed,
+                                       double* T, double* mass_fractions);
+  zerork_flame_status_t SolveBatch(int num_flames, int num_grid_points,
+                                   const double* grid_points, const double* P,
+                                   double* flame_speed, double* T,
+                                   double* mass_fractions,
+                                   zerork_flame_status_t* flame_status);
+  void ClearSolutionLibrary();
+  // Frees the solver workspace and the batch communicator, which make MPI
+  // calls. After MPI_Finalize the workspace is leaked instead.
+  void FreeWorkspace();
 
  private:
+#ifdef ZERORK_MPI
+  zerork_flame_status_t SolveFlame(int num_grid_points, const double* grid_points,
+                                   double P, double* flame_speed,
+                                   double* T, double* mass_fractions,
+                                   MPI_Comm comm);
+  zerork_flame_status_t SolveFlameWarmStart(int num_grid_points, const double* grid_points,
+                                            double P, double* flame_speed,
+                                            double* T, double* mass_fractions,
+                                            MPI_Comm comm);
+#else
+  zerork_flame_status_t SolveFlame(int num_grid_points, const double* grid_points,
+                                   double P, double* flame_speed,
+                                   double* T, double* mass_fractions);
+  zerork_flame_status_t SolveFlameWarmStart(int num_grid_points, const double* grid_points,
+                                            double P, double* flame_speed,
+                                            double* T, double* mass_fractions);
+#endif
+  void AddToSolutionLibrary(int num_grid_points, const double* grid_points,
+                            double P, double flame_speed,
+                            const double* T, const double* mass_fractions);
+  bool GetSolutionLibraryGuess(int num_grid_points, const double* grid_points,
+                               double P, double* flame_speed,
+                               double* T, double* mass_fractions);
+  bool FlameParamsOptionsMatch();
+
   std::shared_ptr<ConstPressureReactor> reactor_;
   std::shared_ptr<transport::MassTransportInterface> transport_;
 
+  // Converged flames kept on the root rank of the solving communicator
+  struct FlameSolution {
+    double pressure;
+    double flame_speed;
+    std::vector<double> grid;
+    std::vector<double> T;
+    std::vector<double> mass_fractions;
+  };
+  std::vector<FlameSolution> solution_library_;
+  size_t next_library_slot_;
+
+  // Kept between solves so the preconditioner memory and symbolic
+  // factorizations are re-used for grids of the same size
+  std::unique_ptr<FlameParams> flame_params_;
+#ifdef ZERORK_MPI
+  MPI_Comm flame_params_comm_;
+  MPI_Comm batch_comm_;
+  int batch_ranks_per_flame_;
+#endif
+
   bool tried_init_;
   zerork_flame_status_t init_status_;
 };
@@ -3,12 +3,27 @@
 #include <math.h>
 
 #include <fstream>
+#include <algorithm>
 #include <utilities/string_utilities.h>
 #include <utilities/math_utilities.h>
 #include <utilities/file_utilities.h>
 
 #include "flame_params.h"
 
+// Position of the (row, column) term of the local compressed row storage
+// Jacobian, or -1 if the term is not in the pattern. The row is local and
+// the column is global.
+int FlameParams::FindSparseIndex(const int row, const int column) const
+{
+  const int *start = &col_id_[0] + row_sum_[row];
+  const int *end   = &col_id_[0] + row_sum_[row+1];
+  const int *found = std::lower_bound(start, end, column);
+  if(found != end && *found == column) {
+    return (int)(found - &col_id_[0]);
+  }
+  return -1;
+}
+
 static double NormalizeComposition(const size_t num_elements,
                                    double composition[]);
 
@@ -21,6 +36,7 @@ FlameParams::FlameParams(const std::string &input_name)
   num_comms_ = 1;
 
   nover_ = 2;
+  transpose_time_ = 0.0;
   int error_code;
 
   parser_  = NULL;
@@ -61,6 +77,9 @@ FlameParams::FlameParams(const std::string &input_name)
     } else if(npes_ / parser_->sensitivity_processors_per_solution() <= 1) {
       printf("Warning: Total number of processors less than or equal to sensitivity_processors_per_solution\n");
       printf("         Continuing without parallelizing sensitivity analysis\n");
+    } else if(parser_->adaptive_grid()) {
+      printf("Warning: adaptive_grid is not supported with sensitivity_processors_per_solution\n");
+      printf("         Continuing without parallelizing sensitivity analysis\n");
     } else {
       num_comms_ = npes_ / parser_->sensitivity_processors_per_solution();
       comm_rank_ = my_pe_ / parser_->sensitivity_processors_per_solution();
@@ -166,7 +185,7 @@ FlameParams::~FlameParams()
   if(transport_input_.grad_mass_fraction_ != NULL) {
     delete [] transport_input_.grad_mass_fraction_;
   }
-  if(integrator_type_ == 2) {
+  if(integrator_type_ == 2 || integrator_type_ == 4) {
     if (superlu_serial_) {
       if (sparse_matrix_ != NULL) {
 	delete sparse_matrix_;
@@ -637,8 +656,16 @@ void FlameParams::SetGrid()
     z_.erase(z_.begin());
   }
 
+  SetGridSpacing();
+  diameter_ = parser_->diameter();
+}
+
+// Compute the grid spacings, the local (with ghost points) spacing arrays
+// and the grid sized work arrays from z_. Requires z_ to be set first.
+void FlameParams::SetGridSpacing()
+{
   const int num_states   = reactor_->GetNumStates();
-  num_points = z_.size();
+  int num_points = z_.size();
   num_points_ = num_points;
   num_local_points_ = num_points/npes_;
 
@@ -751,8 +778,65 @@ void FlameParams::SetGrid()
   // Create relative volume arrays
   rel_vol_.assign(num_local_points_,0.0);
   rel_vol_ext_.assign(num_local_points_+2*nover_,0.0);
+}
 
-  diameter_ = parser_->diameter();
+// Replace the computational grid with a new set of interior points and
+// rebuild all the grid dependent data structures. The caller is responsible
+// for interpolating the state onto the new grid.
+void FlameParams::ResetGrid(const std::vector<double> &z)
+{
+  FreeGridMemory();
+  z_ = z;
+  SetGridSpacing();
+  SetWallProperties();
+  SetMemory();
+  logger_->FFlush();
+}
+
+// Release the memory allocated by SetMemory()
+void FlameParams::FreeGridMemory()
+{
+  if(transport_input_.mass_fraction_ != NULL) {
+    delete [] transport_input_.mass_fraction_;
+    transport_input_.mass_fraction_ = NULL;
+  }
+  if(transport_input_.grad_temperature_ != NULL) {
+    delete [] transport_input_.grad_temperature_;
+    transport_input_.grad_temperature_ = NULL;
+  }
+  if(transport_input_.grad_pressure_ != NULL) {
+    delete [] transport_input_.grad_pressure_;
+    transport_input_.grad_pressure_ = NULL;
+  }
+  if(transport_input_.grad_mass_fraction_ != NULL) {
+    delete [] transport_input_.grad_mass_fraction_;
+    transport_input_.grad_mass_fraction_ = NULL;
+  }
+  if(integrator_type_ == 2 || integrator_type_ == 4) {
+    if (superlu_serial_) {
+      if (sparse_matrix_ != NULL) {
+        sparse_matrix_->SparseMatrixClean();
+	delete sparse_matrix_;
+        sparse_matrix_ = NULL;
+      }
+#ifdef ZERORK_MPI
+    } else {
+      if (sparse_matrix_dist_ != NULL) {
+        sparse_matrix_dist_->SparseMatrixClean_dist();
+	delete sparse_matrix_dist_;
+        sparse_matrix_dist_ = NULL;
+      }
+#endif
+    }
+  }
+  if(integrator_type_ == 3) {
+    for(size_t j=0; j<sparse_matrix_chem_.size(); ++j) {
+      if(sparse_matrix_chem_[j] != NULL) {
+	delete sparse_matrix_chem_[j];
+      }
+    }
+    sparse_matrix_chem_.clear();
+  }
 }
 
 // For simulations with wall heat losses, set the wall temperature profile
@@ -941,10 +1025,20 @@ void FlameParams::SetMemory()
   integrator_type_ = parser_->integrator_type();
   store_jacobian_  = parser_->store_jacobian();
 
+  // The factorization history is discarded with the old grid
+  jacobian_policy_.SetOptions(parser_->jacobian_policy(),
+                              parser_->jacobian_max_reuse(),
+                              parser_->jacobian_convergence_rate(),
+                              parser_->jacobian_max_linear_iterations(),
+                              parser_->jacobian_symbolic_interval(),
+                              logger_);
+  jacobian_policy_.Reset();
+
 
   // Set Jacobian parameters
-  // Case 3 is a block tridiagonal (potentially sparse) matrix solved with SuperLU
-  if(integrator_type_ == 2) {
+  // Case 2 is a block tridiagonal (potentially sparse) matrix solved with SuperLU
+  // Case 4 is the same matrix with sparse blocks, assembled analytically
+  if(integrator_type_ == 2 || integrator_type_ == 4) {
     row_id_zerod.assign(num_nonzeros_zerod, 0);
     col_id_zerod.assign(num_nonzeros_zerod, 0);
 
@@ -952,10 +1046,19 @@ void FlameParams::SetMemory()
     reactor_->GetJacobianPattern(&row_id_zerod[0],
                                  &col_id_zerod[0]);
 
-    // Set to 1 to force dense blocks
-    dense_to_sparse_.assign(num_states*num_states, 1); //, 1); //force dense!!
-    dense_to_sparse_offdiag_.assign(num_states*num_states, 1);
-    printf("# WARNING: Using dense block tridiagonal Jacobian\n");
+    if(integrator_type_ == 2) {
+      // Set to 1 to force dense blocks
+      dense_to_sparse_.assign(num_states*num_states, 1); //, 1); //force dense!!
+      dense_to_sparse_offdiag_.assign(num_states*num_states, 1);
+      printf("# WARNING: Using dense block tridiagonal Jacobian\n");
+    } else {
+      // Transport only couples a state to the same state at the neighboring
+      // points, except at j_fix where the energy equation is moved to the
+      // mass flux row
+      dense_to_sparse_.assign(num_states*num_states, 0);
+      dense_to_sparse_offdiag_.assign(num_states*num_states, 0);
+      dense_to_sparse_offdiag_[num_states*(num_states-1) + num_states-2] = 1;
+    }
 
     // The following is to use sparse blocks, only matters if
     // dense_to_sparse_/offdiag_ is initialized at 0 above
@@ -1088,10 +1191,10 @@ void FlameParams::SetMemory()
       row_sum_[j+1] += row_sum_[j];
     }
 
-  } // if (integrator_type_ == 2)
+  } // if (integrator_type_ == 2 || integrator_type_ == 4)
 
   // Set sparse matrix
-  if(integrator_type_ == 2) {
+  if(integrator_type_ == 2 || integrator_type_ == 4) {
     if(superlu_serial_) {
       sparse_matrix_ = new SparseMatrix(num_local_points*num_states, num_nonzeros_loc_);
       if(sparse_matrix_ == NULL) {
@@ -1116,13 +1219,10 @@ void FlameParams::SetMemory()
       //saved_jacobian_.assign(num_nonzeros, 0.0);
       saved_jacobian_dist_.assign(num_nonzeros_loc_, 0.0);
     }
-  } // if integrator_type == 2
+  } // if integrator_type == 2 || integrator_type == 4
 
-  // Case 3 is an approximately factorized matrix
-  // local sparse matrices at each grid point for the chemical Jacobian (SuperLU)
-  // global tridiagonal matrix for the transport Jacobian (LAPACK)
-  if(integrator_type_ == 3) {
-    //SuperLU
+  // Single reactor Jacobian pattern used by cases 3 and 4
+  if(integrator_type_ == 3 || integrator_type_ == 4) {
     row_id_chem_.assign(num_nonzeros_zerod, 0);
     column_id_chem_.assign(num_nonzeros_zerod, 0);
     column_sum_chem_.assign(num_states+1,0);
@@ -1161,7 +1261,64 @@ void FlameParams::SetMemory()
 	exit(-1); // TODO: add recoverable failure
       }
     }
+  } // if integrator_type == 3 || integrator_type == 4
+
+  // Case 4 maps the single reactor Jacobian and the transport terms to
+  // the local rows of the global matrix. The pattern is fixed for the grid,
+  // so the mapping is only built once.
+  if(integrator_type_ == 4) {
+    const int mass_flux_id = num_species;
+    const int temperature_id = num_species+1;
+    chem_to_dist_id_.assign(num_local_points*num_nonzeros_zerod, -1);
+    lower_dist_id_.assign(num_local_points*num_states, -1);
+    upper_dist_id_.assign(num_local_points*num_states, -1);
+    lower_fix_dist_id_.assign(num_local_points, -1);
+    upper_fix_dist_id_.assign(num_local_points, -1);
+
+    for(int j=0; j<num_local_points; ++j) {
+      const int jglobal = j + my_pe_*num_local_points;
+      for(int k=0; k<num_nonzeros_zerod; ++k) {
+        chem_to_dist_id_[j*num_nonzeros_zerod+k] =
+          FindSparseIndex(j*num_states + row_id_chem_[k],
+                          jglobal*num_states + column_id_chem_[k]);
+      }
+      for(int k=0; k<num_states; ++k) {
+        if(jglobal > 0) {
+          lower_dist_id_[j*num_states+k] =
+            FindSparseIndex(j*num_states + k, (jglobal-1)*num_states + k);
+        }
+        if(jglobal < num_points-1) {
+          upper_dist_id_[j*num_states+k] =
+            FindSparseIndex(j*num_states + k, (jglobal+1)*num_states + k);
+        }
+      }
+      if(jglobal > 0) {
+        lower_fix_dist_id_[j] =
+          FindSparseIndex(j*num_states + mass_flux_id,
+                          (jglobal-1)*num_states + temperature_id);
+      }
+      if(jglobal < num_points-1) {
+        upper_fix_dist_id_[j] =
+          FindSparseIndex(j*num_states + mass_flux_id,
+                          (jglobal+1)*num_states + temperature_id);
+      }
+    }
+    for(int j=0; j<num_local_points*num_nonzeros_zerod; ++j) {
+      if(chem_to_dist_id_[j] == -1) {
+        logger_->PrintF(
+          "# ERROR: reactor Jacobian term %d at grid point %d is missing\n"
+          "#        from the block tridiagonal Jacobian pattern\n",
+          j % num_nonzeros_zerod, j/num_nonzeros_zerod);
+        valid_jacobian_structure_ = false;
+        exit(-1); // TODO: add recoverable failure
+      }
+    }
+  } // if integrator_type == 4
 
+  // Case 3 is an approximately factorized matrix
+  // local sparse matrices at each grid point for the chemical Jacobian (SuperLU)
+  // global tridiagonal matrix for the transport Jacobian (LAPACK)
+  if(integrator_type_ == 3) {
     sparse_matrix_chem_.assign(num_reactors, NULL);
     for(int j=0; j<num_reactors; ++j) {
       sparse_matrix_chem_[j] = new SparseMatrix(num_states, num_nonzeros_zerod);
@@ -1197,6 +1354,14 @@ void FlameParams::SetMemory()
     banded_jacobian_serial_.assign(num_points*4*num_states_local_, 0.0);
     pivots_serial_.assign(num_points*num_states_local_, 0);
 
+    solution_species_.assign(num_local_points*num_states, 0.0);
+    solution_allspecies_.assign(num_points*num_states_local_, 0.0);
+    transpose_buffer_.assign(num_points*storage*num_states_local_, 0.0);
+    transpose_grid_counts_.assign(npes_, 0);
+    transpose_grid_displs_.assign(npes_, 0);
+    transpose_species_counts_.assign(npes_, 0);
+    transpose_species_displs_.assign(npes_, 0);
+
 
   } // if integrator_type == 3
 
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include <file_utilities.h>
+#include <jacobian_policy.h>
 #ifdef ZERORK_MPI
 #include <mpi.h>
 #endif
@@ -32,6 +33,8 @@ class FlameParams
   explicit FlameParams(const std::string &input_name);
   ~FlameParams();
 
+  void ResetGrid(const std::vector<double> &z);
+
   //MPI
 #ifdef ZERORK_MPI
   MPI_Comm comm_;
@@ -127,10 +130,9 @@ class FlameParams
 
   // single reactor Jacobian structure (needed for sparse preconditioner
   // and banded solvers
-  int integrator_type_; // 0 KINSOL BBD
-                        // 2 ScaLAPACK banded matrix
-                        // 3 SuperLU sparse matrix (global)
-                        // 4 SuperLU sparse (local) + LAPACK tridiagonal
+  int integrator_type_; // 2 Finite difference block tridiagonal (SuperLU)
+                        // 3 SuperLU sparse (local) + LAPACK tridiagonal
+                        // 4 Analytic block tridiagonal (SuperLU)
   bool store_jacobian_;
   bool valid_jacobian_structure_;
 
@@ -142,6 +144,9 @@ class FlameParams
 
   bool superlu_serial_;
 
+  // Decides when the preconditioner is refactored
+  zerork::utilities::JacobianPolicy jacobian_policy_;
+
   // For SuperLU serial
   SparseMatrix *sparse_matrix_;
 
@@ -157,6 +162,15 @@ class FlameParams
   std::vector<int>    dense_to_sparse_offdiag_;
   int num_nonzeros_loc_;
 
+  // For the analytic Jacobian, position in reactor_jacobian_dist_ of each
+  // single reactor Jacobian term and of the transport terms coupling a
+  // state to the same state at the previous (lower) and next (upper) point
+  std::vector<int>    chem_to_dist_id_;       // size = num_local_points*nnz
+  std::vector<int>    lower_dist_id_;         // size = num_local_points*num_states
+  std::vector<int>    upper_dist_id_;         // size = num_local_points*num_states
+  std::vector<int>    lower_fix_dist_id_;     // size = num_local_points
+  std::vector<int>    upper_fix_dist_id_;     // size = num_local_points
+
   // For SuperLU serial for local chemistry
   std::vector<SparseMatrix *> sparse_matrix_chem_;
   std::vector<int>     row_id_chem_;
@@ -174,12 +188,26 @@ class FlameParams
   std::vector<double> banded_jacobian_serial_;
   std::vector<int> pivots_serial_;
 
+  // Persistent buffers of the AF transport solve. The transpose between
+  // the grid point and species distributions is a single MPI_Alltoallv.
+  std::vector<double> solution_species_;
+  std::vector<double> solution_allspecies_;
+  std::vector<double> transpose_buffer_;
+  std::vector<int> transpose_grid_counts_;
+  std::vector<int> transpose_grid_displs_;
+  std::vector<int> transpose_species_counts_;
+  std::vector<int> transpose_species_displs_;
+  double transpose_time_;
+
  private:
   void SetInlet();
   void SetInitialComposition();
   void SetGrid();
+  void SetGridSpacing();
   void SetWallProperties();
   void SetMemory();
+  void FreeGridMemory();
+  int FindSparseIndex(const int row, const int column) const;
 };
 
 
@@ -271,7 +271,7 @@ spify_parser_params.append(
 {
     'name':'integrator_type',
     'type':'int',
-    'longDesc' : "Integrator type: (0, 1 = unsupported, 2 = Exact Jacobian with SuperLU solver, 3 = Approximate Jacobian with SuperLU + LAPACK solvers)",
+    'longDesc' : "Integrator type: (0, 1 = unsupported, 2 = Exact Jacobian with SuperLU solver, 3 = Approximate Jacobian with SuperLU + LAPACK solvers, 4 = Analytic Jacobian with SuperLU solver)",
     'defaultValue' : 3
 }
 )
@@ -285,6 +285,51 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':'jacobian_policy',
+    'type':'bool',
+    'longDesc' : "Flag that when set to true [y] lets the preconditioner setup reuse the current factorization while the residual keeps decreasing, instead of refactoring at every KINSOL setup call",
+    'defaultValue' : 0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_max_reuse',
+    'type':'int',
+    'shortDesc' : "Maximum number of setup calls that reuse a factorization (jacobian_policy)",
+    'defaultValue' : 10
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_convergence_rate',
+    'type':'double',
+    'longDesc' : "Refactor when the scaled residual norm is reduced by less than this factor between setup calls (jacobian_policy)",
+    'defaultValue' : 0.5
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_max_linear_iterations',
+    'type':'int',
+    'longDesc' : "Refactor when the average number of linear iterations per setup call made with the current factorization exceeds this value (jacobian_policy)",
+    'defaultValue' : 50
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'jacobian_symbolic_interval',
+    'type':'int',
+    'longDesc' : "Number of numeric refactorizations after which the ordering and pivoting are recomputed, 0 = only after a failed factorization (jacobian_policy)",
+    'defaultValue' : 0
+}
+)
+
 spify_parser_params.append(
 {
     'name':'superlu_serial',
@@ -430,6 +475,78 @@ spify_parser_params.append(
 }
 )
 
+spify_parser_params.append(
+{
+    'name':'adaptive_grid',
+    'type':'bool',
+    'longDesc' : "Flag that when set to true [y] refines and coarsens the grid based on the gradient and curvature of the temperature and major species after each converged solution, then re-solves on the new grid",
+    'defaultValue' : 0
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_max_iterations',
+    'type':'int',
+    'shortDesc' : "Maximum number of grid adaptation and re-solve cycles",
+    'defaultValue' : 10
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_max_points',
+    'type':'int',
+    'shortDesc' : "Maximum number of grid points allowed by the grid adaptation",
+    'defaultValue' : 1000
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_gradient_ratio',
+    'type':'double',
+    'longDesc' : "Maximum change of a variable between two grid points as a fraction of its range over the domain before a point is inserted",
+    'defaultValue' : 0.05
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_curvature_ratio',
+    'type':'double',
+    'longDesc' : "Maximum change of the slope of a variable between two grid intervals as a fraction of its slope range over the domain before points are inserted",
+    'defaultValue' : 0.1
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_coarsen_ratio',
+    'type':'double',
+    'longDesc' : "A grid point is removed when the gradient and curvature criteria without that point are below this fraction of grid_gradient_ratio and grid_curvature_ratio. Set to zero to disable coarsening.",
+    'defaultValue' : 0.2
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_min_spacing',
+    'type':'double',
+    'shortDesc' : "Minimum grid spacing [m] created by the grid adaptation",
+    'defaultValue' : 1.0e-7
+}
+)
+
+spify_parser_params.append(
+{
+    'name':'grid_species_threshold',
+    'type':'double',
+    'longDesc' : "Species with a maximum mass fraction in the domain above this value are used in the grid adaptation criteria",
+    'defaultValue' : 1.0e-3
+}
+)
+
 spify_parser_params.append(
 {
     'name':'sensitivity_analysis',
@@ -0,0 +1,256 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <algorithm>
+
+#ifdef ZERORK_MPI
+#include <mpi.h>
+#endif
+
+#include "grid_adaptation.h"
+
+static bool CompareScoreDescending(const std::pair<double, int> &a,
+                                   const std::pair<double, int> &b)
+{
+  return a.first > b.first;
+}
+
+void GatherFlameState(const FlameParams &flame_params,
+                      const double local_state[],
+                      std::vector<double> *global_state)
+{
+  const int num_states = flame_params.reactor_->GetNumStates();
+  const int num_points = flame_params.z_.size();
+  const int num_local_states = flame_params.num_local_points_*num_states;
+
+  global_state->assign(num_points*num_states, 0.0);
+#ifdef ZERORK_MPI
+  MPI_Allgather((void *)local_state, num_local_states, MPI_DOUBLE,
+                &(*global_state)[0], num_local_states, MPI_DOUBLE,
+                flame_params.comm_);
+#else
+  for(int j=0; j<num_local_states; ++j) {
+    (*global_state)[j] = local_state[j];
+  }
+#endif
+}
+
+int AdaptGrid(const FlameParams &flame_params,
+              const std::vector<double> &global_state,
+              std::vector<double> *new_z,
+              std::vector<double> *new_state,
+              int *new_j_fix)
+{
+  const std::vector<double> &z = flame_params.z_;
+  const int num_points  = z.size();
+  const int num_states  = flame_params.reactor_->GetNumStates();
+  const int num_species = flame_params.reactor_->GetNumSpecies();
+  const int npes        = flame_params.npes_;
+  const int j_fix       = flame_params.j_fix_;
+  const int min_points  = flame_params.nover_*npes;
+  const int max_points  =
+    std::max(num_points,
+             (flame_params.parser_->grid_max_points()/npes)*npes);
+
+  const double gradient_ratio  = flame_params.parser_->grid_gradient_ratio();
+  const double curvature_ratio = flame_params.parser_->grid_curvature_ratio();
+  const double coarsen_ratio   = flame_params.parser_->grid_coarsen_ratio();
+  const double min_spacing     = flame_params.parser_->grid_min_spacing();
+  const double species_threshold =
+    flame_params.parser_->grid_species_threshold();
+
+  // Use the temperature and the major species as refinement variables
+  std::vector<int> component_id;
+  component_id.push_back(num_states-1);
+  for(int k=0; k<num_species; ++k) {
+    double max_mass_fraction = 0.0;
+    for(int j=0; j<num_points; ++j) {
+      max_mass_fraction = std::max(max_mass_fraction,
+                                   global_state[j*num_states+k]);
+    }
+    if(max_mass_fraction > species_threshold) {
+      component_id.push_back(k);
+    }
+  }
+
+  // interval_score[j] is the largest ratio of the gradient or curvature
+  // criteria to their threshold on the interval [z_j, z_j+1]. point_score[j]
+  // is the same ratio evaluated on the interval [z_j-1, z_j+1] that remains
+  // if point j is removed. The end points are never removed.
+  std::vector<double> interval_score(num_points-1, 0.0);
+  std::vector<double> point_score(num_points, 1.0e300);
+  for(int j=1; j<num_points-1; ++j) {
+    point_score[j] = 0.0;
+  }
+
+  std::vector<double> value(num_points, 0.0);
+  std::vector<double> slope(num_points-1, 0.0);
+  for(size_t c=0; c<component_id.size(); ++c) {
+    for(int j=0; j<num_points; ++j) {
+      value[j] = global_state[j*num_states+component_id[c]];
+    }
+    const double value_range =
+      *std::max_element(value.begin(), value.end()) -
+      *std::min_element(value.begin(), value.end());
+    if(value_range <= 1.0e-300) {
+      continue;
+    }
+    for(int j=0; j<num_points-1; ++j) {
+      slope[j] = (value[j+1]-value[j])/(z[j+1]-z[j]);
+    }
+    const double slope_range =
+      *std::max_element(slope.begin(), slope.end()) -
+      *std::min_element(slope.begin(), slope.end());
+
+    for(int j=0; j<num_points-1; ++j) {
+      interval_score[j] =
+        std::max(interval_score[j],
+                 fabs(value[j+1]-value[j])/(gradient_ratio*value_range));
+    }
+    for(int j=1; j<num_points-1; ++j) {
+      double curvature_score = 0.0;
+      if(slope_range > 1.0e-300) {
+        curvature_score =
+          fabs(slope[j]-slope[j-1])/(curvature_ratio*slope_range);
+      }
+      interval_score[j-1] = std::max(interval_score[j-1], curvature_score);
+      interval_score[j]   = std::max(interval_score[j],   curvature_score);
+
+      point_score[j] =
+        std::max(point_score[j],
+                 fabs(value[j+1]-value[j-1])/(gradient_ratio*value_range));
+      point_score[j] = std::max(point_score[j], curvature_score);
+    }
+  }
+
+  // Intervals that cannot be split without violating the minimum spacing
+  // are never refined
+  std::vector<bool> can_refine(num_points-1, true);
+  for(int j=0; j<num_points-1; ++j) {
+    if(z[j+1]-z[j] < 2.0*min_spacing) {
+      can_refine[j] = false;
+    }
+  }
+
+  std::vector<int> refine(num_points-1, 0);
+  std::vector<int> remove(num_points, 0);
+  int num_inserted = 0;
+  int num_removed = 0;
+  for(int j=0; j<num_points-1; ++j) {
+    if(can_refine[j] && interval_score[j] > 1.0) {
+      refine[j] = 1;
+      ++num_inserted;
+    }
+  }
+  if(coarsen_ratio > 0.0) {
+    for(int j=1; j<num_points-1; ++j) {
+      if(j != j_fix && point_score[j] < coarsen_ratio &&
+         refine[j-1] == 0 && refine[j] == 0 && remove[j-1] == 0) {
+        remove[j] = 1;
+        ++num_removed;
+      }
+    }
+  }
+
+  // Sort the intervals by score to decide which insertions to keep or add
+  // when enforcing the point limits
+  std::vector<std::pair<double, int> > order(num_points-1);
+  for(int j=0; j<num_points-1; ++j) {
+    order[j] = std::make_pair(interval_score[j], j);
+  }
+  std::stable_sort(order.begin(), order.end(), CompareScoreDescending);
+
+  // Drop the lowest scoring insertions beyond the maximum number of points
+  for(int j=num_points-2; j>=0; --j) {
+    if(num_points + num_inserted - num_removed <= max_points) {
+      break;
+    }
+    if(refine[order[j].second] == 1) {
+      refine[order[j].second] = 0;
+      --num_inserted;
+    }
+  }
+  // Keep enough points for the second order stencil on each processor
+  for(int j=1; j<num_points-1; ++j) {
+    if(num_points + num_inserted - num_removed >= min_points) {
+      break;
+    }
+    if(remove[j] == 1) {
+      remove[j] = 0;
+      --num_removed;
+    }
+  }
+
+  // The number of grid points must be divisible by the number of processors.
+  // Restore removed points first, then insert points in the highest scoring
+  // intervals, and finally drop the lowest scoring insertions.
+  while((num_points + num_inserted - num_removed) % npes != 0) {
+    int changed = 0;
+    for(int j=1; j<num_points-1 && changed == 0; ++j) {
+      if(remove[j] == 1) {
+        remove[j] = 0;
+        --num_removed;
+        changed = 1;
+      }
+    }
+    if(changed == 0 && num_points + num_inserted - num_removed < max_points) {
+      for(int j=0; j<num_points-1 && changed == 0; ++j) {
+        const int id = order[j].second;
+        if(refine[id] == 0 && can_refine[id] &&
+           remove[id] == 0 && remove[id+1] == 0) {
+          refine[id] = 1;
+          ++num_inserted;
+          changed = 1;
+        }
+      }
+    }
+    for(int j=num_points-2; j>=0 && changed == 0; --j) {
+      if(refine[order[j].second] == 1) {
+        refine[order[j].second] = 0;
+        --num_inserted;
+        changed = 1;
+      }
+    }
+    if(changed == 0) {
+      break;
+    }
+  }
+
+  // Build the new grid and interpolate the state
+  new_z->clear();
+  new_state->clear();
+  *new_j_fix = j_fix;
+  for(int j=0; j<num_points; ++j) {
+    if(remove[j] == 0) {
+      if(j == j_fix) {
+        *new_j_fix = (int)new_z->size();
+      }
+      new_z->push_back(z[j]);
+      for(int k=0; k<num_states; ++k) {
+        new_state->push_back(global_state[j*num_states+k]);
+      }
+    }
+    if(j < num_points-1 && refine[j] == 1) {
+      new_z->push_back(0.5*(z[j]+z[j+1]));
+      for(int k=0; k<num_states; ++k) {
+        new_state->push_back(0.5*(global_state[j*num_states+k] +
+                                  global_state[(j+1)*num_states+k]));
+      }
+    }
+  }
+
+  if(flame_params.my_pe_ == 0) {
+    printf("# Grid adaptation: %d points -> %d points"
+           " (%d inserted, %d removed, %d refinement variables)\n",
+           num_points, (int)new_z->size(), num_inserted, num_removed,
+           (int)component_id.size());
+  }
+  flame_params.logger_->PrintF(
+    "# Grid adaptation: %d points -> %d points"
+    " (%d inserted, %d removed, %d refinement variables)\n",
+    num_points, (int)new_z->size(), num_inserted, num_removed,
+    (int)component_id.size());
+
+  return num_inserted + num_removed;
+}
@@ -0,0 +1,27 @@
+#ifndef GRID_ADAPTATION_H_
+#define GRID_ADAPTATION_H_
+
+#include <vector>
+
+#include "flame_params.h"
+
+// Gather the grid-distributed state of all processors into a global state
+// vector ordered by grid point
+void GatherFlameState(const FlameParams &flame_params,
+                      const double local_state[],
+                      std::vector<double> *global_state);
+
+// Compute a new grid from the gradient and curvature of the temperature and
+// major species in the converged global state. Points are inserted at the
+// midpoint of intervals that fail the criteria and removed where the
+// solution is well resolved. The state is linearly interpolated onto the
+// new grid. The number of points is kept divisible by the number of
+// processors. Returns the number of points inserted plus removed, so a
+// return value of zero means the grid is converged.
+int AdaptGrid(const FlameParams &flame_params,
+              const std::vector<double> &global_state,
+              std::vector<double> *new_z,
+              std::vector<double> *new_state,
+              int *new_j_fix);
+
+#endif
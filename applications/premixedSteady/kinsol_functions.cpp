@@ -4,6 +4,40 @@
 extern "C" void dgbtrf_(int* dim1, int* dim2, int* nu, int* nl, double* a, int* lda, int* ipiv, int* info);
 extern "C" void dgbtrs_(char *TRANS, int *N, int *NRHS, int* nu, int* nl, double *A, int *LDA, int *IPIV, double *B, int *LDB, int *INFO);
 
+#ifdef ZERORK_MPI
+// Transpose between the grid point distribution (num_states blocks of
+// block_size values per processor) and the species distribution used by
+// the banded transport solve (num_states_local_ blocks of npes_*block_size
+// values per processor) with a single MPI_Alltoallv
+static void TransposeGridToSpecies(FlameParams *params,
+                                   const int block_size,
+                                   const double grid_data[],
+                                   double species_data[]);
+
+static void TransposeSpeciesToGrid(FlameParams *params,
+                                   const int block_size,
+                                   const double species_data[],
+                                   double grid_data[]);
+#endif
+
+
+// Ask the Jacobian policy whether the preconditioner needs to be refactored.
+// The residual norm is only computed (a global reduction) when the policy
+// is enabled.
+static int GetJacobianSetupAction(N_Vector ydot,
+                                  N_Vector ydotscale,
+                                  FlameParams *params)
+{
+  double residual_norm = 0.0;
+  double shift = 0.0;
+  if(params->jacobian_policy_.enabled()) {
+    residual_norm = N_VWL2Norm(ydot, ydotscale);
+  }
+  if(params->pseudo_unsteady_) {
+    shift = 1.0/params->dt_;
+  }
+  return params->jacobian_policy_.GetSetupAction(residual_norm, shift);
+}
 
 int ConstPressureFlame(N_Vector y,
 		       N_Vector ydot, // ydot is the residual
@@ -642,6 +676,12 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
   int npes  = params->npes_;
   const int nover=params->nover_;
 
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscale, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
   // Create work arrays
   std::vector<double> y_saved,rhs_ext_saved;
   y_saved.assign(num_local_points*num_states,0.0);
@@ -762,7 +802,8 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
 
   // Factorize with SuperLU (parallel is default, serial if specified in input)
   if(params->superlu_serial_) {
-    if(params->sparse_matrix_->IsFirstFactor()) {
+    if(params->sparse_matrix_->IsFirstFactor() ||
+       setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
       error_flag =
 	params->sparse_matrix_->FactorNewPatternCRS(num_nonzeros_loc,
 						    &params->col_id_[0],
@@ -774,7 +815,8 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
     } //if first factor
 #ifdef ZERORK_MPI
   } else {
-    if(params->sparse_matrix_dist_->IsFirstFactor_dist()) {
+    if(params->sparse_matrix_dist_->IsFirstFactor_dist() ||
+       setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
       error_flag =
 	params->sparse_matrix_dist_->FactorNewPatternCCS_dist(num_nonzeros_loc,
 							      &params->col_id_[0],
@@ -790,6 +832,7 @@ int ReactorBBDSetup(N_Vector y, // [in] state vector
 #endif
   } // if superlu serial
 
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
   return error_flag;
 }
 
@@ -820,6 +863,7 @@ int ReactorBBDSolve(N_Vector y, // [in] state vector
 #endif
   int error_flag = 0;
 
+  params->jacobian_policy_.RecordSolve();
   if(params->superlu_serial_) {
     error_flag = params->sparse_matrix_->Solve(&solution[0],&solution[0]);
 #ifdef ZERORK_MPI
@@ -831,6 +875,260 @@ int ReactorBBDSolve(N_Vector y, // [in] state vector
   return error_flag;
 }
 
+//------------------------------------------------------------------
+// Analytic block tridiagonal Jacobian, factorized with SuperLU
+// The diagonal blocks are the single reactor Jacobians. The transport
+// and convection terms use the coefficients (conductivity, specific heat,
+// Lewis numbers and relative volume) frozen at the last residual
+// evaluation. The pattern is built once per grid in SetMemory().
+#if defined SUNDIALS2
+int ReactorAnalyticSetup(N_Vector y, // [in] state vector
+                         N_Vector yscale, // [in] state scaler
+                         N_Vector ydot, // [in] state derivative
+                         N_Vector ydotscale, // [in] state derivative scaler
+                         void *user_data, // [in/out]
+                         N_Vector tmp1, N_Vector tmp2)
+{
+#elif defined SUNDIALS3 || defined SUNDIALS4
+int ReactorAnalyticSetup(N_Vector y, // [in] state vector
+                         N_Vector yscale, // [in] state scaler
+                         N_Vector ydot, // [in] state derivative
+                         N_Vector ydotscale, // [in] state derivative scaler
+                         void *user_data) // [in/out]
+{
+#endif
+  FlameParams *params    = (FlameParams *)user_data;
+  const int num_local_points = params->num_local_points_;
+  const int num_states   = params->reactor_->GetNumStates();
+  const int num_species  = num_states - 2;
+  const int mflux_id     = num_species;
+  const int temp_id      = num_species + 1;
+  const int num_total_points = params->num_points_;
+  const int num_nonzeros_zerod = params->reactor_->GetJacobianSize();
+  const int num_nonzeros_loc = params->num_nonzeros_loc_;
+  const int convective_scheme_type = params->convective_scheme_type_;
+  const int nover = params->nover_;
+  const int my_pe = params->my_pe_;
+#ifdef ZERORK_MPI
+  double *y_ptr          = NV_DATA_P(y);
+#else
+  double *y_ptr = NV_DATA_S(y);
+#endif
+  int error_flag = 0;
+
+  int temp_out_of_bounds = 0;
+  int global_temp_out_of_bounds = 0;
+  for(int j=0; j<num_local_points; ++j) {
+    double temperature = y_ptr[j*num_states + num_states-1]*params->ref_temperature_;
+    if(temperature < 100.0 || temperature > 10000) {
+      temp_out_of_bounds += 1;
+    }
+  }
+#ifdef ZERORK_MPI
+  MPI_Allreduce(&temp_out_of_bounds,&global_temp_out_of_bounds,1,MPI_INT,MPI_MAX,params->comm_);
+#else
+  global_temp_out_of_bounds = temp_out_of_bounds;
+#endif
+  if(global_temp_out_of_bounds > 0) return 1;// recoverable error
+
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscale, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
+  // Location of the mass flux and temperature coupling terms in the single
+  // reactor Jacobian, swapped at the fixed temperature point
+  int mflux_temp_chem_id = -1;
+  int temp_mflux_chem_id = -1;
+  for(int k=0; k<num_nonzeros_zerod; ++k) {
+    if(params->row_id_chem_[k] == mflux_id &&
+       params->column_id_chem_[k] == temp_id) {
+      mflux_temp_chem_id = k;
+    }
+    if(params->row_id_chem_[k] == temp_id &&
+       params->column_id_chem_[k] == mflux_id) {
+      temp_mflux_chem_id = k;
+    }
+  }
+  const int mflux_mflux_chem_id = params->diagonal_id_chem_[mflux_id];
+  const int temp_temp_chem_id   = params->diagonal_id_chem_[temp_id];
+
+  const double *dz      = &params->dz_local_[0];
+  const double *inv_dz  = &params->inv_dz_local_[0];
+  const double *inv_dzm = &params->inv_dzm_local_[0];
+  const double wall_term = 4.0*params->nusselt_/
+    (params->diameter_*params->diameter_);
+
+  double *jacobian = &params->reactor_jacobian_dist_[0];
+  for(int j=0; j<num_nonzeros_loc; ++j) {
+    jacobian[j] = 0.0;
+  }
+
+  for(int j=0; j<num_local_points; ++j) {
+    const int jext = j + nover;
+    const int jglobal = j + my_pe*num_local_points;
+    const bool Tfix = (jglobal == params->j_fix_);
+    const bool last_point = (jglobal == num_total_points-1);
+    const double mass_flux = y_ptr[j*num_states+mflux_id];
+    const double relative_volume_j = params->rel_vol_ext_[jext];
+    const int *chem_to_dist = &params->chem_to_dist_id_[j*num_nonzeros_zerod];
+    const int *lower_dist   = &params->lower_dist_id_[j*num_states];
+    const int *upper_dist   = &params->upper_dist_id_[j*num_states];
+
+    // Chemistry and the mass flux column of the convective terms
+    params->reactor_->GetJacobianSteady(&y_ptr[j*num_states],
+                                        &params->rhsConv_[j*num_states],
+                                        Tfix,
+                                        &params->step_limiter_[0],
+                                        &params->reactor_jacobian_chem_[0]);
+    double *jacobian_chem = &params->reactor_jacobian_chem_[0];
+    if(Tfix) {
+      // The energy equation is in the mass flux row, and the temperature
+      // row is T - T_fix
+      jacobian_chem[mflux_temp_chem_id]  = jacobian_chem[temp_temp_chem_id];
+      jacobian_chem[temp_temp_chem_id]   = 1.0;
+      jacobian_chem[mflux_mflux_chem_id] = jacobian_chem[temp_mflux_chem_id];
+      jacobian_chem[temp_mflux_chem_id]  = 0.0;
+    }
+    if(params->pseudo_unsteady_) {
+      for(int k=0; k<num_species; ++k) {
+        jacobian_chem[params->diagonal_id_chem_[k]] -= 1.0/params->dt_;
+      }
+      jacobian_chem[temp_temp_chem_id] -= 1.0/params->dt_;
+    }
+    for(int k=0; k<num_nonzeros_zerod; ++k) {
+      jacobian[chem_to_dist[k]] += jacobian_chem[k];
+    }
+
+    // Convective coefficients of the j+1, j, j-1 terms. The j-2 term of the
+    // second order upwind scheme is outside of the block tridiagonal
+    // pattern and is dropped.
+    double b=0,c=0,d=0;
+    if(convective_scheme_type == 0) {
+      c =  inv_dz[jext];
+      d = -inv_dz[jext];
+    } else if(convective_scheme_type == 1) {
+      c = inv_dz[jext] + 1.0/(dz[jext]+dz[jext-1]);
+      d = -(dz[jext]+dz[jext-1])/(dz[jext]*dz[jext-1]);
+    } else if(convective_scheme_type == 2) {
+      b = dz[jext]/dz[jext+1]/(dz[jext]+dz[jext+1]);
+      c = (dz[jext+1]-dz[jext])/dz[jext+1]/dz[jext];
+      d = -dz[jext+1]/dz[jext]/(dz[jext]+dz[jext+1]);
+    }
+
+    // Species
+    for(int k=0; k<num_species; ++k) {
+      const double diff_m = params->thermal_conductivity_[j]*inv_dz[jext]/
+        (params->mixture_specific_heat_mid_[j]*
+         params->species_lewis_numbers_[j*num_species+k]);
+      const double diff_p = params->thermal_conductivity_[j+1]*inv_dz[jext+1]/
+        (params->mixture_specific_heat_mid_[j+1]*
+         params->species_lewis_numbers_[(j+1)*num_species+k]);
+      const double lower = relative_volume_j*
+        (diff_m*inv_dzm[jext] - d*mass_flux);
+      const double upper = relative_volume_j*
+        (diff_p*inv_dzm[jext] - b*mass_flux);
+      double diagonal = -relative_volume_j*
+        ((diff_m+diff_p)*inv_dzm[jext] + c*mass_flux);
+      // zero gradient outlet
+      if(last_point) {
+        diagonal += upper;
+      } else {
+        jacobian[upper_dist[k]] += upper;
+      }
+      if(jglobal > 0) {
+        jacobian[lower_dist[k]] += lower;
+      }
+      jacobian[chem_to_dist[params->diagonal_id_chem_[k]]] += diagonal;
+    }
+
+    // Temperature
+    double cp_flux_sum = 0.0;
+    for(int k=0; k<num_species; ++k) {
+      cp_flux_sum += params->species_specific_heats_[num_species*j+k]*
+        0.5*(params->species_mass_flux_[num_species*j+k]+
+             params->species_mass_flux_[num_species*(j+1)+k]);
+    }
+    const double mixture_cp = params->mixture_specific_heat_[j];
+    const double conduction = relative_volume_j*inv_dzm[jext]/mixture_cp;
+    const double convection = relative_volume_j*
+      (mass_flux + cp_flux_sum/mixture_cp);
+    const double lower =
+      conduction*params->thermal_conductivity_[j]*inv_dz[jext] - d*convection;
+    const double upper =
+      conduction*params->thermal_conductivity_[j+1]*inv_dz[jext+1] - b*convection;
+    double diagonal =
+      -conduction*(params->thermal_conductivity_[j]*inv_dz[jext] +
+                   params->thermal_conductivity_[j+1]*inv_dz[jext+1]) -
+      c*convection -
+      0.5*wall_term*(params->thermal_conductivity_[j]+
+                     params->thermal_conductivity_[j+1])*
+      relative_volume_j/mixture_cp;
+    if(last_point) {
+      diagonal += upper;
+    }
+    if(Tfix) {
+      jacobian[chem_to_dist[mflux_temp_chem_id]] += diagonal;
+      if(!last_point) {
+        jacobian[params->upper_fix_dist_id_[j]] += upper;
+      }
+      if(jglobal > 0) {
+        jacobian[params->lower_fix_dist_id_[j]] += lower;
+      }
+    } else {
+      jacobian[chem_to_dist[temp_temp_chem_id]] += diagonal;
+      if(!last_point) {
+        jacobian[upper_dist[temp_id]] += upper;
+      }
+      if(jglobal > 0) {
+        jacobian[lower_dist[temp_id]] += lower;
+      }
+    }
+
+    // Mass flux, continuity is integrated away from j_fix
+    if(jglobal > params->j_fix_) {
+      jacobian[chem_to_dist[mflux_mflux_chem_id]] += inv_dz[jext];
+      jacobian[lower_dist[mflux_id]] -= inv_dz[jext];
+    } else if(jglobal < params->j_fix_) {
+      jacobian[chem_to_dist[mflux_mflux_chem_id]] += inv_dz[jext+1];
+      jacobian[upper_dist[mflux_id]] -= inv_dz[jext+1];
+    }
+  } // for j<num_local_points
+
+  // Factorize with SuperLU. The pattern does not change between setups.
+  if(params->superlu_serial_) {
+    if(params->sparse_matrix_->IsFirstFactor() ||
+       setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
+      error_flag =
+	params->sparse_matrix_->FactorNewPatternCRS(num_nonzeros_loc,
+						    &params->col_id_[0],
+						    &params->row_sum_[0],
+						    jacobian);
+    } else {
+      error_flag =
+	params->sparse_matrix_->FactorSamePattern(jacobian);
+    } //if first factor
+#ifdef ZERORK_MPI
+  } else {
+    if(params->sparse_matrix_dist_->IsFirstFactor_dist() ||
+       setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
+      error_flag =
+	params->sparse_matrix_dist_->FactorNewPatternCCS_dist(num_nonzeros_loc,
+							      &params->col_id_[0],
+							      &params->row_sum_[0],
+							      jacobian);
+    } else {
+      error_flag =
+	params->sparse_matrix_dist_->FactorSamePattern_dist(jacobian);
+    } //if first factor
+#endif
+  } // if superlu serial
+
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
+  return error_flag;
+}
+
 
 //------------------------------------------------------------------
 // Approximate factorization preconditioner
@@ -886,6 +1184,12 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
 #endif
   if(global_temp_out_of_bounds > 0) return 1;// recoverable error
 
+  // Keep the current factorization if the policy allows it
+  const int setup_action = GetJacobianSetupAction(ydot, ydotscale, params);
+  if(setup_action == zerork::utilities::JACOBIAN_REUSE) {
+    return 0;
+  }
+
   // Initialize transport Jacobian
   for(int j=0; j<num_local_points*5*num_states; j++)
     params->banded_jacobian_[j] = 0.0;
@@ -1097,7 +1401,8 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
 	  params->saved_jacobian_chem_[j*num_nonzeros_zerod+k];
       }
       // factor the numerical jacobian
-      if(params->sparse_matrix_chem_[j]->IsFirstFactor()) {
+      if(params->sparse_matrix_chem_[j]->IsFirstFactor() ||
+         setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
         error_flag =
           params->sparse_matrix_chem_[j]->FactorNewPatternCCS(num_nonzeros_zerod,
 							      &params->row_id_chem_[0],
@@ -1172,7 +1477,8 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
       }
 
       // factor the numerical jacobian
-      if(params->sparse_matrix_chem_[j]->IsFirstFactor()) {
+      if(params->sparse_matrix_chem_[j]->IsFirstFactor() ||
+         setup_action == zerork::utilities::JACOBIAN_SYMBOLIC_FACTOR) {
         error_flag =
           params->sparse_matrix_chem_[j]->FactorNewPatternCCS(num_nonzeros_zerod,
 							      &params->row_id_chem_[0],
@@ -1224,27 +1530,10 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
 #ifdef ZERORK_MPI
   // Communications to solve banded transport Jacobian
   // Each processor handles the full grid for a subset of species
-  MPI_Comm comm = params->comm_;
-  long int dsize = num_local_points*5;
-  int nodeDest;
-
-  // Gather the Jacobian to have all grid points for each species
-  for(int j=0; j<num_states; ++j) {
-    nodeDest = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_band = j*(num_local_points*5);
-    int start_band2 = jlocal*(num_total_points*5);
-    double* dest = params->my_pe_ == nodeDest ? &params->banded_jacobian2_[start_band2] : nullptr;
-
-    MPI_Gather(&params->banded_jacobian_[start_band],
-    	       dsize,
-    	       PVEC_REAL_MPI_TYPE,
-               dest,
-    	       dsize,
-    	       PVEC_REAL_MPI_TYPE,
-	       nodeDest,
-    	       comm);
-  }
+  TransposeGridToSpecies(params,
+                         num_local_points*5,
+                         &params->banded_jacobian_[0],
+                         &params->banded_jacobian2_[0]);
 #else
   for(int j=0; j<params->banded_jacobian2_.size(); j++) {
     params->banded_jacobian2_[j] = params->banded_jacobian_[j];
@@ -1275,6 +1564,7 @@ int ReactorAFSetup(N_Vector y, // [in] state vector
 	    &error_flag);
   }
 
+  params->jacobian_policy_.RecordSetup(setup_action, error_flag);
   return error_flag;
 }
 
@@ -1301,8 +1591,10 @@ int ReactorAFSolve(N_Vector y, // [in] state vector
 #else
   double *solution = NV_DATA_S(vv);
 #endif
+  FlameParams *params = (FlameParams *)user_data;
   int error_flag = 0;
 
+  params->jacobian_policy_.RecordSolve();
   error_flag = AFSolve(&solution[0], user_data);
   return error_flag;
 
@@ -1349,16 +1641,9 @@ int AFSolve(double solution[],
   }
 
   // Banded transport
-  // Communications for banded_jacobian2
-#ifdef ZERORK_MPI
-  MPI_Comm comm = params->comm_;
-#endif
-  long int dsize = num_local_points;
-  int nodeDest, nodeFrom;
-
-  std::vector<double> solution_allspecies, solution_species;
-  solution_allspecies.assign(num_total_points*num_states_local, 0.0);
-  solution_species.assign(num_local_points*num_states, 0.0);
+  // Persistent work vectors of the species distributed solve
+  std::vector<double> &solution_allspecies = params->solution_allspecies_;
+  std::vector<double> &solution_species = params->solution_species_;
 
   // Reorder solution vector by species
   for(int j=0; j<num_states; ++j)
@@ -1366,23 +1651,11 @@ int AFSolve(double solution[],
       solution_species[j*num_local_points+i] = solution[j+i*num_states];
 
 #ifdef ZERORK_MPI
-  // Gather all grid points for each species
-  for(int j=0; j<num_states; ++j) {
-    nodeDest = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_id = j*num_local_points;
-    int start_id2 = jlocal*num_total_points;
-    double* dest = params->my_pe_ == nodeDest ? &solution_allspecies[start_id2] : nullptr;
-
-    MPI_Gather(&solution_species[start_id],
-    	       dsize,
-    	       PVEC_REAL_MPI_TYPE,
-               dest,
-    	       dsize,
-    	       PVEC_REAL_MPI_TYPE,
-	       nodeDest,
-    	       comm);
-  }
+  // Transpose to have all grid points for each local species
+  TransposeGridToSpecies(params,
+                         num_local_points,
+                         &solution_species[0],
+                         &solution_allspecies[0]);
 #else
   for(int j=0; j<solution_allspecies.size(); j++) {
     solution_allspecies[j] = solution_species[j];
@@ -1410,23 +1683,11 @@ int AFSolve(double solution[],
       printf("AFSolve banded matrix error: %d\n", error_flag);
   }
 #ifdef ZERORK_MPI
-  //Scatter back the solution vector for each species
-  for(int j=0; j<num_states; ++j) {
-    nodeFrom = j/params->num_states_per_proc_;
-    int jlocal = j % params->num_states_per_proc_;
-    int start_id = j*num_local_points;
-    int start_id2 = jlocal*num_total_points;
-    double* source = params->my_pe_ == nodeFrom ? &solution_allspecies[start_id2] : nullptr;
-
-    MPI_Scatter(source,
-    		dsize,
-    		PVEC_REAL_MPI_TYPE,
-    		&solution_species[start_id],
-    		dsize,
-    		PVEC_REAL_MPI_TYPE,
-    		nodeFrom,
-    		comm);
-  }
+  // Transpose back to have all species for each local grid point
+  TransposeSpeciesToGrid(params,
+                         num_local_points,
+                         &solution_allspecies[0],
+                         &solution_species[0]);
 #else
   for(int j=0; j<solution_allspecies.size(); j++)
     solution_species[j] = solution_allspecies[j];
@@ -1573,3 +1834,95 @@ int compare_rxnSens_t(const void *A, const void *B)
   }
   return 0;
 }
+
+#ifdef ZERORK_MPI
+static void SetTransposeCounts(FlameParams *params,
+                               const int block_size)
+{
+  const int npes = params->npes_;
+  const int num_states = params->reactor_->GetNumStates();
+  const int num_states_local = params->num_states_local_;
+  const int num_states_per_proc = params->num_states_per_proc_;
+
+  for(int j=0; j<npes; ++j) {
+    int num_states_j = num_states_per_proc;
+    if(j == npes-1) {
+      num_states_j = num_states - (npes-1)*num_states_per_proc;
+    }
+    // Species owned by processor j are contiguous in the grid layout
+    params->transpose_grid_counts_[j] = num_states_j*block_size;
+    params->transpose_grid_displs_[j] = j*num_states_per_proc*block_size;
+    // Local species of processor j arrive as one contiguous chunk
+    params->transpose_species_counts_[j] = num_states_local*block_size;
+    params->transpose_species_displs_[j] = j*num_states_local*block_size;
+  }
+}
+
+static void TransposeGridToSpecies(FlameParams *params,
+                                   const int block_size,
+                                   const double grid_data[],
+                                   double species_data[])
+{
+  const int npes = params->npes_;
+  const int num_states_local = params->num_states_local_;
+  double *buffer = &params->transpose_buffer_[0];
+  double start_time = MPI_Wtime();
+
+  SetTransposeCounts(params, block_size);
+  MPI_Alltoallv(grid_data,
+                &params->transpose_grid_counts_[0],
+                &params->transpose_grid_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                buffer,
+                &params->transpose_species_counts_[0],
+                &params->transpose_species_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                params->comm_);
+
+  // Reorder from processor-major to species-major
+  for(int p=0; p<npes; ++p) {
+    for(int j=0; j<num_states_local; ++j) {
+      const double *source = &buffer[(p*num_states_local + j)*block_size];
+      double *dest = &species_data[(j*npes + p)*block_size];
+      for(int k=0; k<block_size; ++k) {
+        dest[k] = source[k];
+      }
+    }
+  }
+  params->transpose_time_ += MPI_Wtime() - start_time;
+}
+
+static void TransposeSpeciesToGrid(FlameParams *params,
+                                   const int block_size,
+                                   const double species_data[],
+                                   double grid_data[])
+{
+  const int npes = params->npes_;
+  const int num_states_local = params->num_states_local_;
+  double *buffer = &params->transpose_buffer_[0];
+  double start_time = MPI_Wtime();
+
+  // Reorder from species-major to processor-major
+  for(int p=0; p<npes; ++p) {
+    for(int j=0; j<num_states_local; ++j) {
+      const double *source = &species_data[(j*npes + p)*block_size];
+      double *dest = &buffer[(p*num_states_local + j)*block_size];
+      for(int k=0; k<block_size; ++k) {
+        dest[k] = source[k];
+      }
+    }
+  }
+
+  SetTransposeCounts(params, block_size);
+  MPI_Alltoallv(buffer,
+                &params->transpose_species_counts_[0],
+                &params->transpose_species_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                grid_data,
+                &params->transpose_grid_counts_[0],
+                &params->transpose_grid_displs_[0],
+                PVEC_REAL_MPI_TYPE,
+                params->comm_);
+  params->transpose_time_ += MPI_Wtime() - start_time;
+}
+#endif
@@ -36,6 +36,13 @@ int ReactorBBDSolve(N_Vector y, // [in] ODE state vector
 		    N_Vector vv, // [in] ??
 		    void *params, // [in/out]
                     N_Vector tmp);
+// Analytic block tridiagonal Jacobian, solved with ReactorBBDSolve
+int ReactorAnalyticSetup(N_Vector y, // [in] ODE state vector
+                         N_Vector yscale, // [in] ODE state scaler
+                         N_Vector ydot, // [in] ODE state derivative
+                         N_Vector ydotscale, // [in] ODE state derivative scaler
+                         void *params, // [in/out]
+                         N_Vector tmp1, N_Vector tmp2);
 // SuperLU + ScaLapack Approximate Factorization
 int ReactorAFSetup(N_Vector y, // [in] ODE state vector
 		   N_Vector yscale, // [in] ODE state scaler
@@ -65,6 +72,13 @@ int ReactorBBDSolve(N_Vector y, // [in] ODE state vector
 		    N_Vector vv, // [in] ??
 		    void *params); // [in/out]
 
+// Analytic block tridiagonal Jacobian, solved with ReactorBBDSolve
+int ReactorAnalyticSetup(N_Vector y, // [in] ODE state vector
+                         N_Vector yscale, // [in] ODE state scaler
+                         N_Vector ydot, // [in] ODE state derivative
+                         N_Vector ydotscale, // [in] ODE state derivative scaler
+                         void *params); // [in/out]
+
 // SuperLU + ScaLapack Approximate Factorization
 int ReactorAFSetup(N_Vector y, // [in] ODE state vector
 		   N_Vector yscale, // [in] ODE state scaler
@@ -15,6 +15,7 @@
 #include "flame_params.h"
 #include "kinsol_functions.h"
 #include "set_initial_conditions.h"
+#include "grid_adaptation.h"
 
 #ifdef ZERORK_MPI
 #include <nvector/nvector_parallel.h> // serial N_Vector types, fcts., and macros
@@ -114,6 +115,18 @@ static int GetStateMaxima(const std::vector<int> &state_id,
 
 static int SootOutput(FlameParams &params, const double state[], const bool print = true);
 
+static void *CreateKinsolSolver(FlameParams &params,
+#if defined SUNDIALS3 || defined SUNDIALS4
+                                SUNLinearSolver *LS,
+#endif
+                                N_Vector state,
+                                N_Vector constraints,
+                                const int maxl,
+                                const int maxlrst,
+                                const int maxiter,
+                                const int mset,
+                                const int print_level);
+
 int main(int argc, char *argv[])
 {
   double clock_time = getHighResolutionTime();
@@ -161,15 +174,15 @@ int main(int argc, char *argv[])
   int Nlocal;
 
   int flag = 0;
-  const int num_grid_points = flame_params.z_.size();
-  const int num_local_points = flame_params.num_local_points_;
+  int num_grid_points = flame_params.z_.size();
+  int num_local_points = flame_params.num_local_points_;
   const int num_states = flame_params.reactor_->GetNumStates();
   const int num_steps = flame_params.reactor_->GetNumSteps();
   int num_reactions = flame_params.reactor_->GetNumReactions();
   long int num_local_states = num_local_points*num_states;
   long int total_states = num_grid_points*num_states;
   const double ref_temperature = flame_params.ref_temperature_;
-  const double dz = flame_params.dz_[(int)num_grid_points/2]; //should be min(dz_)
+  double dz = flame_params.dz_[(int)num_grid_points/2]; //should be min(dz_)
   int num_prints = 0;
   double current_time = 0.0;
   double time_offset;
@@ -230,96 +243,23 @@ int main(int argc, char *argv[])
 
     //----------------------------------------------------------------------------
     // Setup KINSOL solver
-    // Create KINSOL pointer
-    kinsol_ptr = KINCreate();
-
-    // Initialize KINSOL module with RHS function and state vector
-    flag = KINInit(kinsol_ptr, ConstPressureFlame, flame_state);
-
-    // Set function to handle errors and exit cleanly
-    flag = KINSetErrHandlerFn(kinsol_ptr, ErrorFunction, &flame_params);
-
-    // Set user data
-    flag = KINSetUserData(kinsol_ptr, &flame_params);
-
-    // Set constraints
-    flag = KINSetConstraints(kinsol_ptr, constraints);
+    kinsol_ptr = CreateKinsolSolver(flame_params,
+#if defined SUNDIALS3 || defined SUNDIALS4
+                                    &LS,
+#endif
+                                    flame_state,
+                                    constraints,
+                                    maxl,
+                                    maxlrst,
+                                    maxiter,
+                                    mset,
+                                    1);
 #ifdef ZERORK_MPI
     N_VDestroy_Parallel(constraints);
 #else
     N_VDestroy_Serial(constraints);
 #endif
 
-    // Set tolerances
-    // RHS(y) < fnormtol
-    flag = KINSetFuncNormTol(kinsol_ptr, flame_params.parser_->rel_tol());
-    // Step tolerance: dy < steptol
-    flag = KINSetScaledStepTol(kinsol_ptr, flame_params.parser_->abs_tol());
-
-    // Setup KINSol
-
-#ifdef SUNDIALS2
-      // Initialize Linear Solver
-    flag = KINSpgmr(kinsol_ptr, maxl);
-    flag = KINSpilsSetMaxRestarts(kinsol_ptr, maxlrst);
-    // Set preconditioner
-    if (flame_params.integrator_type_ == 2) {
-      flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorBBDSetup, ReactorBBDSolve);
-    } else if(flame_params.integrator_type_ == 3){
-      flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorAFSetup, ReactorAFSolve);
-    } else {
-      if(flame_params.my_pe_ == 0) {
-        printf("integrator_type == %d not currently supported\n",
-               flame_params.integrator_type_);
-      }
-      flag = -1;
-    }
-#elif SUNDIALS3
-    // Initialize Linear Solver
-    LS = SUNSPGMR(flame_state, PREC_RIGHT, maxl);
-    flag = KINSpilsSetLinearSolver(kinsol_ptr, LS);
-    flag = SUNSPGMRSetMaxRestarts(LS, maxlrst);
-
-    // Set preconditioner
-    if (flame_params.integrator_type_ == 2) {
-      flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorBBDSetup, ReactorBBDSolve);
-    } else if(flame_params.integrator_type_ == 3){
-      flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorAFSetup, ReactorAFSolve);
-    } else {
-      if(flame_params.my_pe_ == 0) {
-        printf("integrator_type == %d not currently supported\n",
-               flame_params.integrator_type_);
-        flag = -1;
-      }
-    }
-#elif SUNDIALS4
-    // Initialize Linear Solver
-    LS = SUNLinSol_SPGMR(flame_state, PREC_RIGHT, maxl);
-    flag = KINSetLinearSolver(kinsol_ptr, LS, NULL);
-    flag = SUNLinSol_SPGMRSetMaxRestarts(LS, maxlrst);
-
-    // Set preconditioner
-    if (flame_params.integrator_type_ == 2) {
-      flag = KINSetPreconditioner(kinsol_ptr, ReactorBBDSetup, ReactorBBDSolve);
-    } else if(flame_params.integrator_type_ == 3){
-      flag = KINSetPreconditioner(kinsol_ptr, ReactorAFSetup, ReactorAFSolve);
-    } else {
-      if(flame_params.my_pe_ == 0) {
-        printf("integrator_type == %d not currently supported\n",
-               flame_params.integrator_type_);
-      }
-      flag = -1;
-    }
-#endif
-
-    flag = KINSetNumMaxIters(kinsol_ptr, maxiter);
-
-    //0 for default, 1 for exact Newton, > 1 for modified Newton
-    flag = KINSetMaxSetupCalls(kinsol_ptr, mset);
-
-    flag = KINSetPrintLevel(kinsol_ptr, 1);
-    // 0 for no info, 1 for scaled l2 norm, 3 for additional linear solver info
-
     //----------------------------------------------------------------------------
 
     temperature_jump.assign(num_local_points,0.0);
@@ -478,6 +418,86 @@ int main(int argc, char *argv[])
 
     KINGetFuncNorm(kinsol_ptr, &fnorm);
 
+    // Adaptive grid: refine/coarsen the converged solution, repartition the
+    // new grid across processors and re-solve until the grid is converged
+    if(flame_params.parser_->adaptive_grid()) {
+      int grid_iteration = 0;
+      while((flag==0 || flag==1) && fnorm != 0.0 &&
+            grid_iteration < flame_params.parser_->grid_max_iterations()) {
+        std::vector<double> global_state, new_z, new_state;
+        int new_j_fix;
+
+        GatherFlameState(flame_params, flame_state_ptr, &global_state);
+        int num_grid_changes = AdaptGrid(flame_params,
+                                         global_state,
+                                         &new_z,
+                                         &new_state,
+                                         &new_j_fix);
+        ++grid_iteration;
+        if(num_grid_changes == 0) {
+          break;
+        }
+
+        KINFree(&kinsol_ptr);
+#if defined SUNDIALS3 || defined SUNDIALS4
+        SUNLinSolFree(LS);
+#endif
+#ifdef ZERORK_MPI
+        N_VDestroy_Parallel(flame_state);
+        N_VDestroy_Parallel(scaler);
+#else
+        N_VDestroy_Serial(flame_state);
+        N_VDestroy_Serial(scaler);
+#endif
+
+        flame_params.ResetGrid(new_z);
+        flame_params.j_fix_ = new_j_fix;
+
+        num_grid_points = flame_params.z_.size();
+        num_local_points = flame_params.num_local_points_;
+        num_local_states = num_local_points*num_states;
+        total_states = num_grid_points*num_states;
+        Nlocal = num_local_states;
+        dz = flame_params.dz_[(int)num_grid_points/2];
+        temperature_jump.assign(num_local_points,0.0);
+
+#ifdef ZERORK_MPI
+        flame_state     = N_VNew_Parallel(flame_params.comm_, Nlocal, total_states);
+        flame_state_ptr = NV_DATA_P(flame_state);
+        scaler          = N_VNew_Parallel(flame_params.comm_, Nlocal, total_states);
+#else
+        flame_state     = N_VNew_Serial(total_states);
+        flame_state_ptr = NV_DATA_S(flame_state);
+        scaler          = N_VNew_Serial(total_states);
+#endif
+        N_VConst(1.0, scaler);
+        const int state_offset = flame_params.my_pe_*num_local_states;
+        for(int j=0; j<num_local_states; ++j) {
+          flame_state_ptr[j] = new_state[state_offset+j];
+        }
+
+        kinsol_ptr = CreateKinsolSolver(flame_params,
+#if defined SUNDIALS3 || defined SUNDIALS4
+                                        &LS,
+#endif
+                                        flame_state,
+                                        NULL,
+                                        maxl,
+                                        maxlrst,
+                                        maxiter,
+                                        mset,
+                                        flame_params.my_pe_ == 0 ? 1 : 0);
+
+        flag = KINSol(kinsol_ptr,
+                      flame_state,
+                      KIN_NONE,
+                      scaler,
+                      scaler);
+
+        KINGetFuncNorm(kinsol_ptr, &fnorm);
+      }
+    }
+
     if((flag==0 || flag==1) && fnorm != 0.0){
       // Get KINSOL stats
       flag = KINGetNumFuncEvals(kinsol_ptr,&nfevals);
@@ -503,6 +523,9 @@ int main(int argc, char *argv[])
         printf("Number of preconditioner evaluations: %ld\n", njacsetups);
         printf("Number of preconditioner solves: %ld\n", njacsolves);
       }
+      if(flame_params.jacobian_policy_.enabled()) {
+        flame_params.jacobian_policy_.Report(flame_params.my_pe_ == 0);
+      }
 
       // Compute T-Twall
       for(int j=0; j<num_local_points; ++j) {
@@ -696,54 +719,17 @@ int main(int argc, char *argv[])
           flame_params.reactor_->SetAMultiplierOfStepId(revId, multiplier);
 
         // 2.2) Compute solution
-        kinsol_ptr = KINCreate();
-        flag = KINInit(kinsol_ptr, ConstPressureFlame, flame_state);
-        flag = KINSetErrHandlerFn(kinsol_ptr, ErrorFunction, &flame_params);
-        flag = KINSetUserData(kinsol_ptr, &flame_params);
-        flag = KINSetFuncNormTol(kinsol_ptr, flame_params.parser_->rel_tol());
-        flag = KINSetScaledStepTol(kinsol_ptr, flame_params.parser_->abs_tol());
-#ifdef SUNDIALS2
-        flag = KINSpgmr(kinsol_ptr, maxl);
-        flag = KINSpilsSetMaxRestarts(kinsol_ptr, maxlrst);
-        if (flame_params.integrator_type_ == 2) {
-          flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorBBDSetup, ReactorBBDSolve);
-        } else if(flame_params.integrator_type_ == 3){
-          flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorAFSetup, ReactorAFSolve);
-        } else {
-          printf("integrator_type == %d not supported\n",
-                 flame_params.parser_->integrator_type());
-          flag = -1;
-        }
-#elif SUNDIALS3
-        LS = SUNSPGMR(flame_state, PREC_RIGHT, maxl);
-        flag = KINSpilsSetLinearSolver(kinsol_ptr, LS);
-        flag = SUNSPGMRSetMaxRestarts(LS, maxlrst);
-        if (flame_params.integrator_type_ == 2) {
-          flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorBBDSetup, ReactorBBDSolve);
-        } else if(flame_params.integrator_type_ == 3){
-          flag = KINSpilsSetPreconditioner(kinsol_ptr, ReactorAFSetup, ReactorAFSolve);
-        } else {
-          printf("integrator_type == %d not supported\n",
-                 flame_params.parser_->integrator_type());
-          flag = -1;
-        }
-#elif SUNDIALS4
-        LS = SUNLinSol_SPGMR(flame_state, PREC_RIGHT, maxl);
-        flag = KINSetLinearSolver(kinsol_ptr, LS, NULL);
-        flag = SUNLinSol_SPGMRSetMaxRestarts(LS, maxlrst);
-        if (flame_params.integrator_type_ == 2) {
-          flag = KINSetPreconditioner(kinsol_ptr, ReactorBBDSetup, ReactorBBDSolve);
-        } else if(flame_params.integrator_type_ == 3){
-          flag = KINSetPreconditioner(kinsol_ptr, ReactorAFSetup, ReactorAFSolve);
-        } else {
-          printf("integrator_type == %d not supported\n",
-                 flame_params.parser_->integrator_type());
-          flag = -1;
-        }
+        kinsol_ptr = CreateKinsolSolver(flame_params,
+#if defined SUNDIALS3 || defined SUNDIALS4
+                                        &LS,
 #endif
-        flag = KINSetNumMaxIters(kinsol_ptr, maxiter);
-        flag = KINSetMaxSetupCalls(kinsol_ptr, mset);
-        flag = KINSetPrintLevel(kinsol_ptr, 0);
+                                        flame_state,
+                                        NULL,
+                                        maxl,
+                                        maxlrst,
+                                        maxiter,
+                                        mset,
+                                        0);
 
 
         flag = KINSol(kinsol_ptr,
@@ -904,14 +890,19 @@ int main(int argc, char *argv[])
   if(flame_params.comm_rank_ == 0 && flame_params.my_pe_ == 0) {
     printf("# Simulation setup time   [s]: %12.5e\n",setup_time);
     printf("# Time in integrator loop [s]: %12.5e\n",loop_time);
+    printf("# Time in AF transposes   [s]: %12.5e\n",
+           flame_params.transpose_time_);
     if(flame_params.parser_->sensitivity_analysis()) printf("# Time in sensitivity loop [s]: %12.5e\n",sensanal_time);
   }
   flame_params.logger_->PrintF(
     "# Simulation setup time   [s]: %12.5e\n",setup_time);
   flame_params.logger_->PrintF(
     "# Time in integrator loop [s]: %12.5e\n",loop_time);
+  flame_params.logger_->PrintF(
+    "# Time in AF transposes   [s]: %12.5e\n",
+    flame_params.transpose_time_);
 
-  if(flame_params.integrator_type_ == 2) {
+  if(flame_params.integrator_type_ == 2 || flame_params.integrator_type_ == 4) {
     if(flame_params.superlu_serial_) {
       flame_params.sparse_matrix_->SparseMatrixClean();
 #ifdef ZERORK_MPI
@@ -1587,3 +1578,94 @@ static int SootOutput(FlameParams &params,
 
   return 0;
 }
+
+// Create and initialize the KINSOL solver of the flame with the SPGMR linear
+// solver and the preconditioner of params.integrator_type_. The constraints
+// are only set if not NULL.
+static void *CreateKinsolSolver(FlameParams &params,
+#if defined SUNDIALS3 || defined SUNDIALS4
+                                SUNLinearSolver *LS,
+#endif
+                                N_Vector state,
+                                N_Vector constraints,
+                                const int maxl,
+                                const int maxlrst,
+                                const int maxiter,
+                                const int mset,
+                                const int print_level)
+{
+  int flag;
+  // Create KINSOL pointer
+  void *kinsol_ptr = KINCreate();
+
+  // Initialize KINSOL module with RHS function and state vector
+  flag = KINInit(kinsol_ptr, ConstPressureFlame, state);
+
+  // Set function to handle errors and exit cleanly
+  flag = KINSetErrHandlerFn(kinsol_ptr, ErrorFunction, &params);
+
+  // Set user data
+  flag = KINSetUserData(kinsol_ptr, &params);
+
+  // Set constraints
+  if(constraints != NULL) {
+    flag = KINSetConstraints(kinsol_ptr, constraints);
+  }
+
+  // Set tolerances
+  // RHS(y) < fnormtol
+  flag = KINSetFuncNormTol(kinsol_ptr, params.parser_->rel_tol());
+  // Step tolerance: dy < steptol
+  flag = KINSetScaledStepTol(kinsol_ptr, params.parser_->abs_tol());
+
+  // Initialize Linear Solver
+#ifdef SUNDIALS2
+  flag = KINSpgmr(kinsol_ptr, maxl);
+  flag = KINSpilsSetMaxRestarts(kinsol_ptr, maxlrst);
+#elif SUNDIALS3
+  *LS = SUNSPGMR(state, PREC_RIGHT, maxl);
+  flag = KINSpilsSetLinearSolver(kinsol_ptr, *LS);
+  flag = SUNSPGMRSetMaxRestarts(*LS, maxlrst);
+#elif SUNDIALS4
+  *LS = SUNLinSol_SPGMR(state, PREC_RIGHT, maxl);
+  flag = KINSetLinearSolver(kinsol_ptr, *LS, NULL);
+  flag = SUNLinSol_SPGMRSetMaxRestarts(*LS, maxlrst);
+#endif
+
+  // Set preconditioner
+#if defined SUNDIALS2 || defined SUNDIALS3
+  KINSpilsPrecSetupFn prec_setup = NULL;
+  KINSpilsPrecSolveFn prec_solve = NULL;
+#elif SUNDIALS4
+  KINLsPrecSetupFn prec_setup = NULL;
+  KINLsPrecSolveFn prec_solve = NULL;
+#endif
+  if (params.integrator_type_ == 2) {
+    prec_setup = ReactorBBDSetup;
+    prec_solve = ReactorBBDSolve;
+  } else if(params.integrator_type_ == 4){
+    prec_setup = ReactorAnalyticSetup;
+    prec_solve = ReactorBBDSolve;
+  } else if(params.integrator_type_ == 3){
+    prec_setup = ReactorAFSetup;
+    prec_solve = ReactorAFSolve;
+  } else if(params.my_pe_ == 0) {
+    printf("integrator_type == %d not currently supported\n",
+           params.integrator_type_);
+  }
+#if defined SUNDIALS2 || defined SUNDIALS3
+  flag = KINSpilsSetPreconditioner(kinsol_ptr, prec_setup, prec_solve);
+#elif SUNDIALS4
+  flag = KINSetPreconditioner(kinsol_ptr, prec_setup, prec_solve);
+#endif
+
+  flag = KINSetNumMaxIters(kinsol_ptr, maxiter);
+
+  //0 for default, 1 for exact Newton, > 1 for modified Newton
+  flag = KINSetMaxSetupCalls(kinsol_ptr, mset);
+
+  // 0 for no info, 1 for scaled l2 norm, 3 for additional linear solver info
+  flag = KINSetPrintLevel(kinsol_ptr, print_level);
+
+  return kinsol_ptr;
+}
@@ -1,5 +1,6 @@
 
 from .mech_optimizer import *
 from .cv_opt import *
+from .cv_lib_opt import *
 from .psr_opt import *
 
@@ -0,0 +1,292 @@
+
+import os
+import ctypes
+import pkg_resources
+
+import numpy as np
+from ruamel.yaml import YAML
+
+from .opt_app import opt_app
+from .config import ZERORK_ROOT
+
+yaml=YAML(typ="safe")
+
+ZERORK_CFD_PLUGIN_LIB=os.getenv("ZERORK_CFD_PLUGIN_LIB", default=os.path.join(ZERORK_ROOT,'lib','libzerork_cfd_plugin.so'))
+
+ZERORK_FIELD_IGNITION_TIME=5
+
+c_double_p = ctypes.POINTER(ctypes.c_double)
+c_int_p = ctypes.POINTER(ctypes.c_int)
+
+def _load_plugin(lib_file):
+    lib = ctypes.CDLL(lib_file)
+    lib.zerork_reactor_init.restype = ctypes.c_void_p
+    lib.zerork_reactor_init.argtypes = []
+    prototypes = {
+        'zerork_reactor_set_mechanism_files': [ctypes.c_char_p, ctypes.c_char_p],
+        'zerork_reactor_load_mechanism': [],
+        'zerork_reactor_set_int_option': [ctypes.c_char_p, ctypes.c_int],
+        'zerork_reactor_set_double_option': [ctypes.c_char_p, ctypes.c_double],
+        'zerork_reactor_set_string_option': [ctypes.c_char_p, ctypes.c_char_p],
+        'zerork_reactor_set_aux_field_pointer': [ctypes.c_int, c_double_p],
+        'zerork_reactor_solve': [ctypes.c_int, ctypes.c_double, ctypes.c_double, ctypes.c_int,
+                                 c_double_p, c_double_p, c_double_p],
+        'zerork_reactor_get_num_species': [c_int_p],
+        'zerork_reactor_get_species_index': [ctypes.c_char_p, c_int_p],
+        'zerork_reactor_get_premixed_mass_fractions': [c_double_p, c_double_p, ctypes.c_double,
+                                                       ctypes.c_double, c_double_p],
+        'zerork_reactor_get_arrhenius_parameters': [ctypes.c_int, ctypes.c_int,
+                                                    c_double_p, c_double_p, c_double_p],
+        'zerork_reactor_set_arrhenius_parameters': [ctypes.c_int, ctypes.c_int,
+                                                    ctypes.c_double, ctypes.c_double, ctypes.c_double],
+        'zerork_reactor_get_num_plog_lines': [ctypes.c_int, c_int_p],
+        'zerork_reactor_get_plog_parameters': [ctypes.c_int, ctypes.c_int, c_double_p,
+                                               c_double_p, c_double_p, c_double_p],
+        'zerork_reactor_set_plog_parameters': [ctypes.c_int, ctypes.c_int,
+                                               ctypes.c_double, ctypes.c_double, ctypes.c_double],
+        'zerork_reactor_free': [],
+    }
+    for name, args in prototypes.items():
+        fn = getattr(lib, name)
+        fn.restype = ctypes.c_int
+        fn.argtypes = args + [ctypes.c_void_p]
+    return lib
+
+def _as_double_p(array):
+    return array.ctypes.data_as(c_double_p)
+
+class zerork_idt(object):
+    '''
+    Constant volume ignition delay times computed in this process with the
+    Zero-RK CFD plugin library. The mechanism is parsed once; the Arrhenius
+    and PLOG parameters of its reactions can then be changed between calls to
+    idts() without writing or reparsing a mechanism file. If the plugin
+    library was built with MPI, MPI must be initialized (e.g. by importing
+    mpi4py) before the first zerork_idt is created.
+    '''
+    def __init__(self, mech_file, therm_file, lib_file=None, log_file=os.devnull):
+        self.lib = _load_plugin(ZERORK_CFD_PLUGIN_LIB if lib_file is None else lib_file)
+        self.handle = ctypes.c_void_p(self.lib.zerork_reactor_init())
+        self._check(self.lib.zerork_reactor_set_mechanism_files(mech_file.encode(),
+                                                                 therm_file.encode(), self.handle),
+                    "set_mechanism_files")
+        self._check(self.lib.zerork_reactor_set_string_option(b"mechanism_parsing_log_filename",
+                                                               log_file.encode(), self.handle),
+                    "set_string_option")
+        self._check(self.lib.zerork_reactor_load_mechanism(self.handle), "load_mechanism")
+        self._check(self.lib.zerork_reactor_set_int_option(b"constant_volume", 1, self.handle),
+                    "set_int_option")
+        self._check(self.lib.zerork_reactor_set_int_option(b"stop_after_ignition", 1, self.handle),
+                    "set_int_option")
+        n = ctypes.c_int(0)
+        self._check(self.lib.zerork_reactor_get_num_species(ctypes.byref(n), self.handle),
+                    "get_num_species")
+        self.num_species = n.value
+        self.n_cycle = 0
+
+    def __del__(self):
+        if getattr(self, 'handle', None) is not None:
+            self.lib.zerork_reactor_free(self.handle)
+            self.handle = None
+
+    def _check(self, status, fn_name):
+        if status != 0:
+            raise RuntimeError(f"zerork_reactor_{fn_name} failed with status {status}")
+
+    def set_tolerances(self, rel_tol, abs_tol):
+        self._check(self.lib.zerork_reactor_set_double_option(b"rel_tol", rel_tol, self.handle),
+                    "set_double_option")
+        self._check(self.lib.zerork_reactor_set_double_option(b"abs_tol", abs_tol, self.handle),
+                    "set_double_option")
+
+    def mole_fractions(self, composition):
+        x = np.zeros(self.num_species)
+        for name, value in composition.items():
+            idx = ctypes.c_int(-1)
+            self._check(self.lib.zerork_reactor_get_species_index(name.encode(), ctypes.byref(idx),
+                                                                   self.handle),
+                        f"get_species_index ({name})")
+            x[idx.value] = value
+        return x
+
+    def premixed_mass_fractions(self, fuel_mole_fracs, oxid_mole_fracs, phi, egr):
+        x_fuel = self.mole_fractions(fuel_mole_fracs)
+        x_oxid = self.mole_fractions(oxid_mole_fracs)
+        y = np.zeros(self.num_species)
+        self._check(self.lib.zerork_reactor_get_premixed_mass_fractions(
+                        _as_double_p(x_fuel), _as_double_p(x_oxid), phi, egr,
+                        _as_double_p(y), self.handle),
+                    "get_premixed_mass_fractions")
+        return y
+
+    def get_arrhenius(self, rxn_idx, direction=1):
+        A, n, Ea = ctypes.c_double(), ctypes.c_double(), ctypes.c_double()
+        self._check(self.lib.zerork_reactor_get_arrhenius_parameters(
+                        rxn_idx, direction, ctypes.byref(A), ctypes.byref(n), ctypes.byref(Ea),
+                        self.handle),
+                    f"get_arrhenius_parameters (reaction {rxn_idx})")
+        return A.value, n.value, Ea.value
+
+    def set_arrhenius(self, rxn_idx, A, n, Ea, direction=1):
+        self._check(self.lib.zerork_reactor_set_arrhenius_parameters(
+                        rxn_idx, direction, A, n, Ea, self.handle),
+                    f"set_arrhenius_parameters (reaction {rxn_idx})")
+
+    def get_plog(self, rxn_idx):
+        '''List of [pressure (atm), A, n, Ea] ordered by pressure, empty if not PLOG'''
+        n_lines = ctypes.c_int(0)
+        self._check(self.lib.zerork_reactor_get_num_plog_lines(rxn_idx, ctypes.byref(n_lines),
+                                                                self.handle),
+                    f"get_num_plog_lines (reaction {rxn_idx})")
+        lines = []
+        for lidx in range(n_lines.value):
+            p, A, n, Ea = ctypes.c_double(), ctypes.c_double(), ctypes.c_double(), ctypes.c_double()
+            self._check(self.lib.zerork_reactor_get_plog_parameters(
+                            rxn_idx, lidx, ctypes.byref(p), ctypes.byref(A), ctypes.byref(n),
+                            ctypes.byref(Ea), self.handle),
+                        f"get_plog_parameters (reaction {rxn_idx})")
+            lines.append([p.value, A.value, n.value, Ea.value])
+        return lines
+
+    def set_plog(self, rxn_idx, line_idx, A, n, Ea):
+        self._check(self.lib.zerork_reactor_set_plog_parameters(
+                        rxn_idx, line_idx, A, n, Ea, self.handle),
+                    f"set_plog_parameters (reaction {rxn_idx})")
+
+    def idts(self, temperatures, pressures, mass_fracs, temperature_deltas, stop_time):
+        '''
+        Ignition delay times [s] for each initial state (rows) and temperature
+        rise (columns). States that do not ignite report stop_time.
+        '''
+        n_reactors = len(temperatures)
+        idts = np.zeros((n_reactors, len(temperature_deltas)))
+        for j, delta in enumerate(temperature_deltas):
+            self._check(self.lib.zerork_reactor_set_double_option(
+                            b"delta_temperature_ignition", delta, self.handle),
+                        "set_double_option")
+            T = np.array(temperatures, dtype=np.float64)
+            P = np.array(pressures, dtype=np.float64)
+            Y = np.array(mass_fracs, dtype=np.float64).reshape(n_reactors*self.num_species)
+            root_times = np.full(n_reactors, -1.0)
+            self._check(self.lib.zerork_reactor_set_aux_field_pointer(
+                            ZERORK_FIELD_IGNITION_TIME, _as_double_p(root_times), self.handle),
+                        "set_aux_field_pointer")
+            self._check(self.lib.zerork_reactor_solve(self.n_cycle, 0.0, stop_time, n_reactors,
+                                                      _as_double_p(T), _as_double_p(P),
+                                                      _as_double_p(Y), self.handle),
+                        "solve")
+            self.n_cycle += 1
+            idts[:,j] = np.where(root_times > 0.0, root_times, stop_time)
+        return idts
+
+
+class cv_lib_opt(opt_app):
+    '''
+    In-process version of cv_opt. The ignition delay times of the reduced
+    mechanism are computed with zerork_idt after applying the optimized
+    reaction parameters, so each objective evaluation costs only the
+    integration. Uses the initial conditions of the cv_opt input files.
+    '''
+    in_process = True
+
+    def __init__(self, full_mechanism, full_therm, input_file=None, lib_file=None):
+        base_yaml_file = pkg_resources.resource_filename('rate_opt', 'data/cv_base.yml')
+        if input_file is None:
+            input_file = base_yaml_file
+        with open(input_file,'r') as yfile:
+            self.yaml = yaml.load(yfile)
+        self.full_mechanism = full_mechanism
+        self.full_therm = full_therm
+        self.lib_file = lib_file
+        self.idt_calc = None
+        self.rxn_orig = dict()
+        self.curr_idts = None
+        self.comp_idts = None
+        self.n_data = 0
+        self.error_fn = self.mean_square_log_error
+        self.error_fn_map = {
+             'mean_square_log_error': self.mean_square_log_error,
+             'mean_absolute_log_error': self.mean_absolute_log_error,
+             'mean_absolute_relative_error': self.mean_absolute_relative_error,
+        }
+
+    def set(self, key, value):
+        self.yaml[key] = value
+
+    def set_error_fn(self, error_fn_name):
+        assert (error_fn_name in self.error_fn_map), f"Unrecognized error_fn_name: {error_fn_name}"
+        self.error_fn = self.error_fn_map[error_fn_name]
+
+    def mean_square_log_error(self):
+        return np.sum(np.power(np.log(self.curr_idts) - np.log(self.comp_idts),2))/self.n_data
+
+    def mean_absolute_log_error(self):
+        return np.sum(np.abs(np.log(self.curr_idts) - np.log(self.comp_idts)))/self.n_data
+
+    def mean_absolute_relative_error(self):
+        return np.sum(np.abs((self.curr_idts - self.comp_idts)/self.comp_idts))/self.n_data
+
+    def _make_idt_calc(self, mech_file, therm_file):
+        idt_calc = zerork_idt(mech_file, therm_file, lib_file=self.lib_file)
+        idt_calc.set_tolerances(self.yaml['relative_tolerance'], self.yaml['absolute_tolerance'])
+        return idt_calc
+
+    def _initial_states(self, idt_calc):
+        temperatures = []
+        pressures = []
+        mass_fracs = []
+        for phi in self.yaml['initial_phis']:
+            for egr in self.yaml['initial_egrs']:
+                y = idt_calc.premixed_mass_fractions(self.yaml['fuel_mole_fracs'],
+                                                     self.yaml['oxidizer_mole_fracs'], phi, egr)
+                for p in self.yaml['initial_pressures']:
+                    for T in self.yaml['initial_temperatures']:
+                        temperatures.append(T)
+                        pressures.append(p)
+                        mass_fracs.append(y)
+        return temperatures, pressures, mass_fracs
+
+    def run(self, idt_calc):
+        temperatures, pressures, mass_fracs = self._initial_states(idt_calc)
+        return idt_calc.idts(temperatures, pressures, mass_fracs,
+                             self.yaml['temperature_deltas'], self.yaml['stop_time'])
+
+    def opt_fn(self, mech_file, therm_file):
+        raise NotImplementedError("cv_lib_opt is evaluated with opt_fn_reactions")
+
+    def opt_fn_reactions(self, mech_file, therm_file, reactions, rxn_idxs):
+        '''
+        Objective for the reactions of mech_optimizer. mech_file is the
+        unmodified mechanism; the A, n and Ea (and PLOG lines) of the reactions
+        in rxn_idxs are applied as factors on and offsets from the original
+        values so that the unit conventions of the file and library agree.
+        '''
+        if self.comp_idts is None:
+            full_calc = self._make_idt_calc(self.full_mechanism, self.full_therm)
+            self.comp_idts = self.run(full_calc)
+            self.n_data = self.comp_idts.size
+            del full_calc
+        if self.idt_calc is None:
+            self.idt_calc = self._make_idt_calc(mech_file, therm_file)
+
+        for ridx in rxn_idxs:
+            rxn = reactions[ridx]
+            A_mult = rxn['A']/rxn['Aorig']
+            Ea_delta = rxn['Ea'] - rxn['Eaorig']
+            if ridx not in self.rxn_orig:
+                plog_orig = self.idt_calc.get_plog(ridx)
+                if len(plog_orig) > 0:
+                    self.rxn_orig[ridx] = plog_orig
+                else:
+                    self.rxn_orig[ridx] = self.idt_calc.get_arrhenius(ridx)
+            if 'plog_orig' in rxn:
+                for lidx, (p, A, n, Ea) in enumerate(self.rxn_orig[ridx]):
+                    self.idt_calc.set_plog(ridx, lidx, A*A_mult, n, Ea+Ea_delta)
+            else:
+                A, n, Ea = self.rxn_orig[ridx]
+                self.idt_calc.set_arrhenius(ridx, A*A_mult, n, Ea+Ea_delta)
+
+        self.curr_idts = self.run(self.idt_calc)
+        assert(self.curr_idts.shape == self.comp_idts.shape)
+        self.err = self.error_fn()
+        return self.err
@@ -26,6 +26,7 @@ class mech_optimizer(object):
         self.param_fns = []
         self.opt_rxn_idxs = set()
         self.mech_file=None #we don't run with original mech at all
+        self.base_mech_file = mech_file #except for in-process apps
         self.therm_file = therm_file
         self.parse(mech_file)
     def parse(self, mech_file):
@@ -163,22 +164,32 @@ class mech_optimizer(object):
            for line in self.postlines:
                mfile.write(line)
     def opt_fn(self, params):
-        tmpdir = tempfile.mkdtemp(dir='.')
-        mech_file=os.path.join(tmpdir,'chem.inp')
-        self.write_mech(params,mech_file)
+        for p, fn in zip(params, self.param_fns):
+            fn(p)
+        #In-process apps change the reaction parameters of their loaded
+        # mechanism and don't need a mechanism file
+        lib_apps = [app for app in self.opt_apps if getattr(app, 'in_process', False)]
+        file_apps = [app for app in self.opt_apps if not getattr(app, 'in_process', False)]
         val = 0
-        try:
-            if self.nprocs > 1:
-                inputs = [(app, mech_file, self.therm_file) for app in self.opt_apps]
-                with Pool(self.nprocs) as p:
-                    values = p.map(parallel_opt_fn, inputs)
-                val = np.sum(values)
-            else:
-                for app in self.opt_apps:
-                    val += app.opt_fn(mech_file, self.therm_file)
-            val = val / len(self.opt_apps)
-        finally:
-            shutil.rmtree(tmpdir)
+        for app in lib_apps:
+            val += app.opt_fn_reactions(self.base_mech_file, self.therm_file,
+                                        self.reactions, sorted(self.opt_rxn_idxs))
+        if len(file_apps) > 0:
+            tmpdir = tempfile.mkdtemp(dir='.')
+            mech_file=os.path.join(tmpdir,'chem.inp')
+            self.write_mech(params,mech_file)
+            try:
+                if self.nprocs > 1:
+                    inputs = [(app, mech_file, self.therm_file) for app in file_apps]
+                    with Pool(self.nprocs) as p:
+                        values = p.map(parallel_opt_fn, inputs)
+                    val += np.sum(values)
+                else:
+                    for app in file_apps:
+                        val += app.opt_fn(mech_file, self.therm_file)
+            finally:
+                shutil.rmtree(tmpdir)
+        val = val / len(self.opt_apps)
         if(self.verbose):
             if not self.printed_header:
                 print("#"+",".join([f"p{i}" for i,p in enumerate(params)])+ f",objective")
@@ -47,6 +47,7 @@
 
 #include <numeric>
 #include <algorithm>
+#include <unordered_set>
 #include <fstream>
 #include <iomanip>
 #include <math.h>
@@ -628,6 +629,11 @@ next:
         int ntok;
         int nsp = 0;
 
+        // names already in the list, used to find duplicates
+        unordered_set<string> declared;
+        for (size_t k = 0; k < species.size(); k++)
+            declared.insert(species[k].name);
+
         while (1 > 0) {
 
  next:
@@ -649,8 +655,7 @@ next:
                         else {
                             Species sp;
                             sp.name = toks[i];
-                            if (find(species.begin(), species.end(), sp) 
-                                < species.end()) {
+                            if (!declared.insert(sp.name).second) {
                                 if (m_log)
                                     *m_log << "warning... duplicate species " 
                                            << sp.name << " (ignored)." << endl;
@@ -766,7 +771,14 @@ next:
         bool getAllSpecies = (nsp > 0 && match(names[0],"<ALL>"));
         if (getAllSpecies) names.clear();
 
-        map<string, int> dup; // used to check for duplicate THERMO records
+        // Only the records of the species in 'names' are parsed in full.
+        // The remaining records of a large database are skipped after
+        // their name is read.
+        unordered_set<string> wanted(names.begin(), names.end());
+        const unordered_set<string>* wantedPtr = 
+            (getAllSpecies ? 0 : &wanted);
+
+        unordered_set<string> dup; // used to check for duplicate THERMO records
         bool already_read;
 
         while (1 > 0) {
@@ -775,13 +787,13 @@ next:
 
             Species spec;
             Species storedSpec;
-            readThermoRecord(spec);
+            readThermoRecord(spec, wantedPtr);
 
             if (spec.name == "<END>") {
                 break;
             } 
             // check for duplicate thermo data
-            if (dup[spec.name] == 2) {
+            if (!dup.insert(spec.name).second) {
                 log << "Warning: more than one THERMO record for "
                     << "species " << spec.name << endl;
                 log << "Record at line " << m_line 
@@ -789,7 +801,7 @@ next:
                 already_read = true;
 		storedSpec=species[spec.name]; // previously stored value
 		
-		if(!compareSpeciesData(storedSpec,spec,log))
+		if(spec.valid == 1 && !compareSpeciesData(storedSpec,spec,log))
 		  {
 		    log << "Warning: NASA thermo polynomial record at line "
                         << m_line << endl;
@@ -799,11 +811,8 @@ next:
 		
 		
             }
-            dup[spec.name] = 2;
 
-            if (!already_read && (getAllSpecies 
-                    || (find(names.begin(), names.end(), spec.name) 
-                        < names.end())))
+            if (!already_read && spec.valid == 1)
             {
 
                 if (spec.tmid == 0.0) {
@@ -838,11 +847,15 @@ next:
 
     /**
      *
-     * Read one 4-line species definition record in NASA format.
+     * Read one 4-line species definition record in NASA format. If
+     * 'wanted' is not null and does not contain the species name, the
+     * remaining lines of the record are skipped without being parsed and
+     * sp.valid is left at zero.
      *
      */
 
-    void CKParser::readThermoRecord(Species& sp) {
+    void CKParser::readThermoRecord(Species& sp,
+                                    const unordered_set<string>* wanted) {
         string s;
         string numstr;
         double cf;
@@ -917,6 +930,15 @@ next:
           //       freeform_composition.c_str());
         }
 
+        if (wanted != 0 && wanted->count(sp.name) == 0) {
+            for (int line = 2; line <= 4; line++) {
+                getCKLine(s, comment);
+                if (s.size() < 80) illegalThermoLineTooShort(*m_log, m_line);
+                if (s[79] != '0' + line) illegalThermoLine(*m_log, s[79], m_line);
+            }
+            return;
+        }
+
         int iloc;
         string elementSym;
         double atoms;
@@ -1074,6 +1096,9 @@ next:
         vector<string> rc, pr;
         vector_int c;
 
+        const unordered_set<string> speciesNameSet(speciesNames.begin(),
+                                                   speciesNames.end());
+
     // advance to the beginning of the REACTION section
         do {
             getCKLine(s, comment);
@@ -1350,8 +1375,7 @@ next:
                     rxn.reactants, debug, *m_log);
                 int ir = static_cast<int>(rxn.reactants.size());
                 for (int iir = 0; iir < ir; iir++) {
-                    if (find(speciesNames.begin(), speciesNames.end(),
-                            rxn.reactants[iir].name) >= speciesNames.end()) 
+                    if (speciesNameSet.count(rxn.reactants[iir].name) == 0)
                         throw CK_SyntaxError(*m_log,
                             "undeclared reactant species "
                             +rxn.reactants[iir].name, m_line);
@@ -1445,8 +1469,7 @@ next:
                     rxn.products, debug, *m_log);
                 int ip = static_cast<int>(rxn.products.size());
                 for (int iip = 0; iip < ip; iip++) {
-                    if (find(speciesNames.begin(), speciesNames.end(),
-                            rxn.products[iip].name) >= speciesNames.end()) 
+                    if (speciesNameSet.count(rxn.products[iip].name) == 0)
                         throw CK_SyntaxError(*m_log,
                             "undeclared product species "+rxn.products[iip].name, m_line);
                 }
@@ -1653,8 +1676,7 @@ next:
                         missingAuxData("PLOG");
                       }
                     } // end of PLOG reaction     
-                    else if (find(speciesNames.begin(), speciesNames.end(), name) 
-                        < speciesNames.end()) {
+                    else if (speciesNameSet.count(name) > 0) {
                         if (hasAuxData) {
                             if (rxn.thirdBody == name || rxn.thirdBody == "M")
                                 rxn.e3b[name] = de_atof(data);
@@ -16,6 +16,7 @@
 #include <fstream>
 #include <string>
 #include <iostream>
+#include <unordered_set>
 using namespace std;
 
 #include "ckr_defs.h"
@@ -78,7 +79,8 @@ namespace ckr {
         ostream* m_log;
         bool m_nasafmt;
         char m_last_eol;
-        void readThermoRecord(Species& sp);
+        void readThermoRecord(Species& sp,
+                              const unordered_set<string>* wanted);
         void getCKLine(string& s, string& comment);    
         void putCKLine(string& s, string& comment);
         void missingAuxData(const string& kw);
@@ -154,6 +154,7 @@ class ConstPressureReactor::Impl: public ReactorBase
 						double perturbed_derivative[],
 						double jacobian_column[]);
   int GetNetStoichiometry(const int species_id, const int step_id);
+  void SetNonIntegerInverseConcentrations();
 
   double ref_temperature_;
   double inv_ref_temperature_;
@@ -169,12 +170,11 @@ class ConstPressureReactor::Impl: public ReactorBase
   std::vector<double> destruction_rates_;
   std::vector<double> step_rates_;
 
-  // Jacobian storage arrays
-  std::vector<int> destroy_concentration_id_;
-  std::vector<int> destroy_step_id_;
+  // Jacobian storage arrays, the term ids index the mass action Jacobian
+  // terms of the mechanism (see zerork::mass_action_jacobian)
+  std::vector<int> destroy_term_id_;
   std::vector<int> destroy_sparse_id_;
-  std::vector<int> create_concentration_id_;
-  std::vector<int> create_step_id_;
+  std::vector<int> create_term_id_;
   std::vector<int> create_sparse_id_;
   std::vector<int> jacobian_row_id_;
   std::vector<int> jacobian_column_id_;
@@ -185,6 +185,15 @@ class ConstPressureReactor::Impl: public ReactorBase
 
   // Jacobian calculation work arrays
   std::vector<double> inv_concentrations_;
+  std::vector<double> rate_coefficients_;
+  std::vector<double> mass_action_terms_;
+  std::vector<double> no_step_limiter_;
+  std::vector<double> step_temperature_derivatives_;
+  std::vector<double> step_csum_derivatives_;
+  std::vector<double> step_concentration_derivatives_;
+  std::vector<double> net_temperature_derivatives_;
+  std::vector<double> specific_heat_derivatives_;
+  std::unique_ptr<zerork::rate_const_workspace> rate_const_work_;
   std::vector<double> original_state_;
   std::vector<double> perturbed_state_;
   std::vector<double> original_derivative_;
@@ -289,6 +298,17 @@ ConstPressureReactor::Impl::Impl(const char mechanism_name[],
   step_rates_.assign(num_steps,0.0);
   // pre-assign the size of the internal jacobian space vectors
   inv_concentrations_.assign(num_species,0.0);
+  rate_coefficients_.assign(num_steps,0.0);
+  mass_action_terms_.assign(
+    mechanism_ptr->getMassActionJacobian()->getNumTerms()+1,0.0);
+  no_step_limiter_.assign(num_steps,1.0e+300);
+  step_temperature_derivatives_.assign(num_steps,0.0);
+  step_csum_derivatives_.assign(num_steps,0.0);
+  step_concentration_derivatives_.assign(
+    mechanism_ptr->getNumRateConstConcentrationTerms()+1,0.0);
+  net_temperature_derivatives_.assign(num_species,0.0);
+  specific_heat_derivatives_.assign(num_species,0.0);
+  rate_const_work_ = mechanism_ptr->createRateConstWorkspace();
   original_state_.assign(num_states,0.0);
   perturbed_state_.assign(num_states,0.0);
   original_derivative_.assign(num_states,0.0);
@@ -853,13 +873,13 @@ int ConstPressureReactor::Impl::BuildSparseJacobianArrays()
   const int num_species = mechanism_ptr->getNumSpecies();
   const int num_steps   = mechanism_ptr->getNumSteps();
   const int num_states  = num_species + 2; // relative volume/mass flux & temperature
+  const zerork::mass_action_jacobian *mass_action =
+    mechanism_ptr->getMassActionJacobian();
 
   // clear the jacobian arrays
-  destroy_concentration_id_.clear();
-  destroy_step_id_.clear();
+  destroy_term_id_.clear();
   destroy_sparse_id_.clear();
-  create_concentration_id_.clear();
-  create_step_id_.clear();
+  create_term_id_.clear();
   create_sparse_id_.clear();
   jacobian_row_id_.clear();
   jacobian_column_id_.clear();
@@ -878,6 +898,7 @@ int ConstPressureReactor::Impl::BuildSparseJacobianArrays()
     for(int k=0; k<num_reactants; ++k) {
       // get the index of the species being perturbed for the Jacobian
       column_id = mechanism_ptr->getSpecIdxOfStepReactant(j,k);
+      const int term_id = mass_action->getTermIdx(j,k);
 
       // set the Jacobian terms related to the destruction of a particular
       // species affected by the perturbation of species column_id
@@ -891,8 +912,7 @@ int ConstPressureReactor::Impl::BuildSparseJacobianArrays()
           // won't change the net production rate of the species
           dense_id = row_id+column_id*num_states;
 
-          destroy_concentration_id_.push_back(column_id);
-          destroy_step_id_.push_back(j);
+          destroy_term_id_.push_back(term_id);
           destroy_sparse_id_.push_back(dense_id);
 
           // record position in dense matrix
@@ -919,8 +939,7 @@ int ConstPressureReactor::Impl::BuildSparseJacobianArrays()
           // won't change the net production rate of the species
           dense_id = row_id+column_id*num_states;
 
-          create_concentration_id_.push_back(column_id);
-          create_step_id_.push_back(j);
+          create_term_id_.push_back(term_id);
           create_sparse_id_.push_back(dense_id);
 
           // record position in dense matrix
@@ -1058,13 +1077,13 @@ ReactorError
   const double inv_ref_temperature = inv_ref_temperature_;
   const double pressure            = pressure_;
   const double temperature         = ref_temperature*state[num_species+1];
+  const int num_steps              = GetNumSteps();
   const int num_destroy  = static_cast<int>(destroy_sparse_id_.size());
   const int num_create   = static_cast<int>(create_sparse_id_.size());
 
   double mix_mass_cp, RuT;
   double mass_sum, enthalpy_sum;
-  double d_temperature, d_relative_volume;
-  double min_concentration;
+  double d_relative_volume;
   zerork::mechanism *mechanism_ptr;
 
   mechanism_ptr = GetMechanism();
@@ -1081,45 +1100,56 @@ ReactorError
     jacobian[j] = 0.0;
   }
 
-  // Copy the original state and correct any mass_fractions that get adjusted
-  // by the minimum concentration. Note that one molecule in a 1 m^3 volume is
-  // taken to be the minimum concentration
+  // Copy the original state. The mass action Jacobian terms are products of
+  // the other reactant concentrations, so the concentrations are used as is
+  // without a minimum magnitude.
   for(int j=0; j<num_states; ++j) {
     original_state_[j] = state[j];
   }
-  min_concentration = 1.0/mechanism_ptr->getAvogadroNumber();
   for(int j=0; j<num_species; ++j) {
     concentrations_[j] = density*state[j]*inv_molecular_mass_[j];
-    if(fabs(concentrations_[j]) < min_concentration) {
-      // preserve the sign of the concentration when pushing to the minimum
-      // magnitude
-      if(concentrations_[j] >= 0.0) {
-        concentrations_[j] = min_concentration;
-      } else {
-        concentrations_[j] = -min_concentration;
-      }
-      // recompute original state from new concentrations
-      original_state_[j] =
-        relative_volume*concentrations_[j]*molecular_mass_[j];
-    }
-    inv_concentrations_[j] = 1.0/concentrations_[j];
   }
 
-  // compute the rate of change of the species concentration
-  mechanism_ptr->getReactionRates_perturbROP(temperature,
-                                             &concentrations_[0],
-                                             GetAMultipliers(),
-                                             &net_reaction_rates_[0],
-                                             &creation_rates_[0],
-                                             &destruction_rates_[0],
-                                             &step_rates_[0]);
-
-  // use the step rates and inverse concentrations with the elementary
-  // Jacobian term lists to compute dwdot[i]/dC[j]
+  // compute the rate of change of the species concentration, and the
+  // temperature derivative of the rate of progress of each step at constant
+  // concentration
+  mechanism_ptr->getReactionRateDerivativesLimiter(
+    temperature,
+    &concentrations_[0],
+    &no_step_limiter_[0],
+    &net_reaction_rates_[0],
+    &creation_rates_[0],
+    &destruction_rates_[0],
+    &step_rates_[0],
+    &rate_coefficients_[0],
+    &step_temperature_derivatives_[0],
+    &step_csum_derivatives_[0],
+    &step_concentration_derivatives_[0],
+    rate_const_work_.get());
+  const double *a_multipliers = GetAMultipliers();
+  for(int j=0; j<num_steps; ++j) {
+    step_rates_[j] *= a_multipliers[j];
+    rate_coefficients_[j] *= a_multipliers[j];
+    step_temperature_derivatives_[j] *= a_multipliers[j];
+  }
+  mechanism_ptr->getNetRatesFromStepRates(&step_temperature_derivatives_[0],
+                                          &net_temperature_derivatives_[0],
+                                          &creation_rates_[0],
+                                          &destruction_rates_[0]);
+  mechanism_ptr->getNetRatesFromStepRates(&step_rates_[0],
+                                          &net_reaction_rates_[0],
+                                          &creation_rates_[0],
+                                          &destruction_rates_[0]);
+
+  // use the mass action Jacobian terms d(step_rate[j])/dC[k] with the
+  // elementary Jacobian term lists to compute dwdot[i]/dC[k]
+  mechanism_ptr->getMassActionJacobian()->getTermValues(
+    &rate_coefficients_[0],
+    &concentrations_[0],
+    &mass_action_terms_[0]);
   // Destruction terms
   for(int j=0; j<num_destroy; ++j) {
-    int conc_id   = destroy_concentration_id_[j];
-    int step_id   = destroy_step_id_[j];
+    int term_id   = destroy_term_id_[j];
     int sparse_id = destroy_sparse_id_[j];
     // [START DEBUG]
     //int print_row_id = 3;
@@ -1128,15 +1158,14 @@ ReactorError
     //   jacobian_column_id_[sparse_id] == print_col_id) {
     //  printf("Destroy term[%d,%d](sparse %d) = -%24.18e\n",
     //         print_row_id, print_col_id,sparse_id,
-    //         step_rates_[step_id]*inv_concentrations_[conc_id]);
+    //         mass_action_terms_[term_id]);
     //}
     // [END DEBUG]
-    jacobian[sparse_id] -= step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] -= mass_action_terms_[term_id];
   }
   // Creation terms
   for(int j=0; j<num_create; ++j) {
-    int conc_id   = create_concentration_id_[j];
-    int step_id   = create_step_id_[j];
+    int term_id   = create_term_id_[j];
     int sparse_id = create_sparse_id_[j];
     // [START DEBUG]
     //int print_row_id = 3;
@@ -1145,10 +1174,10 @@ ReactorError
     //   jacobian_column_id_[sparse_id] == print_col_id) {
     //  printf("Create  term[%d,%d](sparse %d) = +%24.18e\n",
     //         print_row_id, print_col_id,sparse_id,
-    //         step_rates_[step_id]*inv_concentrations_[conc_id]);
+    //         mass_action_terms_[term_id]);
     //}
     // [END DEBUG]
-    jacobian[sparse_id] += step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] += mass_action_terms_[term_id];
   }
 
   // process the non-integer Jacobian information
@@ -1160,6 +1189,7 @@ ReactorError
       noninteger_jacobian_[j] = 0.0;
     }
 
+    SetNonIntegerInverseConcentrations();
     mechanism_ptr->getNonIntegerReactionNetwork()->GetSpeciesJacobian(
       &inv_concentrations_[0],
       &step_rates_[0],
@@ -1278,7 +1308,43 @@ ReactorError
   //         GetNameOfStateId(j));
   //}
 
-  // perturb the relative volume
+  // compute the temperature column from the analytic temperature derivative
+  // of the net species rates, dwdot[i]/dT, at constant mass fractions and
+  // relative volume (i.e. constant concentrations)
+  double *temperature_column = &jacobian[jacobian_column_sum_[num_species+1]];
+  const double mix_mass_dcp_dT =
+    mechanism_ptr->getMassdCpdTFromTY(temperature,
+                                      &original_state_[0],
+                                      &specific_heat_derivatives_[0])/
+    mechanism_ptr->getGasConstant();
+  // dT/dt = -T/Cp_mix * \sum_i (h_RT[i] * v*wdot[i]) in [K/s]
+  const double temperature_derivative =
+    original_derivative_[num_species+1]*ref_temperature;
+  double mass_derivative_sum = 0.0;
+  double enthalpy_derivative_sum = 0.0;
+  for(int j=0; j<num_species; ++j) {
+    const double net_derivative =
+      relative_volume*net_temperature_derivatives_[j];
+    temperature_column[j] =
+      ref_temperature*molecular_mass_[j]*net_derivative;
+    mass_derivative_sum += net_derivative;
+    enthalpy_derivative_sum += enthalpies_[j]*net_derivative +
+      (specific_heats_[j]-enthalpies_[j])*
+      original_derivative_[j]*inv_molecular_mass_[j]/temperature;
+  }
+  const double dtemperature_derivative_dT =
+    (-enthalpy_sum - temperature*enthalpy_derivative_sum -
+     temperature_derivative*mix_mass_dcp_dT)/mix_mass_cp;
+
+  temperature_column[num_species] = ref_temperature*(
+    relative_volume*(dtemperature_derivative_dT -
+                     temperature_derivative/temperature)/temperature +
+    (mechanism_ptr->getGasConstant()/pressure)*
+    (mass_sum + temperature*mass_derivative_sum));
+  temperature_column[num_species+1] = dtemperature_derivative_dT;
+
+  // perturb the relative volume, note that this overwrites the species
+  // thermodynamics and rates stored in the time derivative arrays
   d_relative_volume = original_state_[num_species]*perturb_factor;
   GetJacobianColumnFromPerturbation(num_species,
                                  d_relative_volume,
@@ -1288,16 +1354,6 @@ ReactorError
                                  &perturbed_state_[0],
                                  &perturbed_derivative_[0],
 				 &jacobian[jacobian_column_sum_[num_species]]);
-  // perturb the temperature
-  d_temperature = original_state_[num_species+1]*perturb_factor;
-  GetJacobianColumnFromPerturbation(num_species+1,
-                               d_temperature,
-                               reactor_time,
-                               &original_state_[0],
-                               &original_derivative_[0],
-                               &perturbed_state_[0],
-                               &perturbed_derivative_[0],
-			       &jacobian[jacobian_column_sum_[num_species+1]]);
 
 
  return NONE;
@@ -1326,7 +1382,6 @@ ReactorError
   double mix_mass_cp, RuT;
   double mass_sum, enthalpy_sum;
   double d_temperature;
-  double min_concentration;
   zerork::mechanism *mechanism_ptr;
 
   mechanism_ptr = GetMechanism();
@@ -1348,28 +1403,14 @@ ReactorError
     jacobian[j] = 0.0;
   }
 
-  // Copy the original state and correct any mass_fractions that get adjusted
-  // by the minimum concentration. Note that one molecule in a 1 m^3 volume is
-  // taken to be the minimum concentration
+  // Copy the original state. The mass action Jacobian terms are products of
+  // the other reactant concentrations, so the concentrations are used as is
+  // without a minimum magnitude.
   for(int j=0; j<num_states; ++j) {
     original_state_[j] = state[j];
   }
-  min_concentration = 1.0/mechanism_ptr->getAvogadroNumber();
   for(int j=0; j<num_species; ++j) {
     concentrations_[j] = density*state[j]*inv_molecular_mass_[j];
-    if(fabs(concentrations_[j]) < min_concentration) {
-      // preserve the sign of the concentration when pushing to the minimum
-      // magnitude
-      if(concentrations_[j] >= 0.0) {
-        concentrations_[j] = min_concentration;
-      } else {
-        concentrations_[j] = -min_concentration;
-      }
-      // recompute original state from new concentrations
-      original_state_[j] =
-        relative_volume*concentrations_[j]*molecular_mass_[j];
-    }
-    inv_concentrations_[j] = 1.0/concentrations_[j];
   }
 
   // compute the rate of change of the species concentration
@@ -1380,14 +1421,18 @@ ReactorError
                                                     &net_reaction_rates_[0],
                                                     &creation_rates_[0],
                                                     &destruction_rates_[0],
-                                                    &step_rates_[0]);
-
-  // use the step rates and inverse concentrations with the elementary
-  // Jacobian term lists to compute dwdot[i]/dC[j]
+                                                    &step_rates_[0],
+                                                    &rate_coefficients_[0]);
+
+  // use the mass action Jacobian terms d(step_rate[j])/dC[k] with the
+  // elementary Jacobian term lists to compute dwdot[i]/dC[k]
+  mechanism_ptr->getMassActionJacobian()->getTermValues(
+    &rate_coefficients_[0],
+    &concentrations_[0],
+    &mass_action_terms_[0]);
   // Destruction terms
   for(int j=0; j<num_destroy; ++j) {
-    int conc_id   = destroy_concentration_id_[j];
-    int step_id   = destroy_step_id_[j];
+    int term_id   = destroy_term_id_[j];
     int sparse_id = destroy_sparse_id_[j];
     // [START DEBUG]
     //int print_row_id = 3;
@@ -1396,15 +1441,14 @@ ReactorError
     //   jacobian_column_id_[sparse_id] == print_col_id) {
     //  printf("Destroy term[%d,%d](sparse %d) = -%24.18e\n",
     //         print_row_id, print_col_id,sparse_id,
-    //         step_rates_[step_id]*inv_concentrations_[conc_id]);
+    //         mass_action_terms_[term_id]);
     //}
     // [END DEBUG]
-    jacobian[sparse_id] -= step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] -= mass_action_terms_[term_id];
   }
   // Creation terms
   for(int j=0; j<num_create; ++j) {
-    int conc_id   = create_concentration_id_[j];
-    int step_id   = create_step_id_[j];
+    int term_id   = create_term_id_[j];
     int sparse_id = create_sparse_id_[j];
     // [START DEBUG]
     //int print_row_id = 3;
@@ -1413,11 +1457,11 @@ ReactorError
     //   jacobian_column_id_[sparse_id] == print_col_id) {
     //  printf("Create  term[%d,%d](sparse %d) = +%24.18e\n",
     //         print_row_id, print_col_id,sparse_id,
-    //         step_rates_[step_id]*inv_concentrations_[conc_id]);
+    //         mass_action_terms_[term_id]);
     //}
     // [END DEBUG]
 
-    jacobian[sparse_id] += step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] += mass_action_terms_[term_id];
   }
 
   // process the non-integer Jacobian information
@@ -1429,6 +1473,7 @@ ReactorError
       noninteger_jacobian_[j] = 0.0;
     }
 
+    SetNonIntegerInverseConcentrations();
     mechanism_ptr->getNonIntegerReactionNetwork()->GetSpeciesJacobian(
       &inv_concentrations_[0],
       &step_rates_[0],
@@ -1563,7 +1608,6 @@ ReactorError
   double mix_mass_cp, RuT, mix_molecular_mass;
   double mass_sum, enthalpy_sum;
   double d_temperature, d_relative_volume;
-  double min_concentration;
   zerork::mechanism *mechanism_ptr;
 
   mechanism_ptr = GetMechanism();
@@ -1580,28 +1624,14 @@ ReactorError
     jacobian[j] = 0.0;
   }
 
-  // Copy the original state and correct any mass_fractions that get adjusted
-  // by the minimum concentration. Note that one molecule in a 1 m^3 volume is
-  // taken to be the minimum concentration
+  // Copy the original state. The mass action Jacobian terms are products of
+  // the other reactant concentrations, so the concentrations are used as is
+  // without a minimum magnitude.
   for(int j=0; j<num_states; ++j) {
     original_state_[j] = state[j];
   }
-  min_concentration = 1.0/mechanism_ptr->getAvogadroNumber();
   for(int j=0; j<num_species; ++j) {
     concentrations_[j] = density*state[j]*inv_molecular_mass_[j];
-    if(fabs(concentrations_[j]) < min_concentration) {
-      // preserve the sign of the concentration when pushing to the minimum
-      // magnitude
-      if(concentrations_[j] >= 0.0) {
-        concentrations_[j] = min_concentration;
-      } else {
-        concentrations_[j] = -min_concentration;
-      }
-      // recompute original state from new concentrations
-      original_state_[j] =
-        relative_volume*concentrations_[j]*molecular_mass_[j];
-    }
-    inv_concentrations_[j] = 1.0/concentrations_[j];
   }
 
   // compute the rate of change of the species concentration
@@ -1612,25 +1642,28 @@ ReactorError
                                                     &net_reaction_rates_[0],
                                                     &creation_rates_[0],
                                                     &destruction_rates_[0],
-                                                    &step_rates_[0]);
-
-  // use the step rates and inverse concentrations with the elementary
-  // Jacobian term lists to compute dwdot[i]/dC[j]
+                                                    &step_rates_[0],
+                                                    &rate_coefficients_[0]);
+
+  // use the mass action Jacobian terms d(step_rate[j])/dC[k] with the
+  // elementary Jacobian term lists to compute dwdot[i]/dC[k]
+  mechanism_ptr->getMassActionJacobian()->getTermValues(
+    &rate_coefficients_[0],
+    &concentrations_[0],
+    &mass_action_terms_[0]);
   // Destruction terms
   for(int j=0; j<num_destroy; ++j) {
-    int conc_id   = destroy_concentration_id_[j];
-    int step_id   = destroy_step_id_[j];
+    int term_id   = destroy_term_id_[j];
     int sparse_id = destroy_sparse_id_[j];
 
-    jacobian[sparse_id] -= step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] -= mass_action_terms_[term_id];
   }
   // Creation terms
   for(int j=0; j<num_create; ++j) {
-    int conc_id   = create_concentration_id_[j];
-    int step_id   = create_step_id_[j];
+    int term_id   = create_term_id_[j];
     int sparse_id = create_sparse_id_[j];
 
-    jacobian[sparse_id] += step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] += mass_action_terms_[term_id];
   }
   // process the non-integer Jacobian information
   const int num_noninteger_jacobian_nonzeros =
@@ -1641,6 +1674,7 @@ ReactorError
       noninteger_jacobian_[j] = 0.0;
     }
 
+    SetNonIntegerInverseConcentrations();
     mechanism_ptr->getNonIntegerReactionNetwork()->GetSpeciesJacobian(
       &inv_concentrations_[0],
       &step_rates_[0],
@@ -1801,7 +1835,6 @@ ReactorError
   double mix_mass_cp, RuT, mix_molecular_mass;
   double mass_sum, enthalpy_sum;
   double d_temperature, d_relative_volume;
-  double min_concentration;
   zerork::mechanism *mechanism_ptr;
 
   mechanism_ptr = GetMechanism();
@@ -1818,28 +1851,14 @@ ReactorError
     jacobian[j] = 0.0;
   }
 
-  // Copy the original state and correct any mass_fractions that get adjusted
-  // by the minimum concentration. Note that one molecule in a 1 m^3 volume is
-  // taken to be the minimum concentration
+  // Copy the original state. The mass action Jacobian terms are products of
+  // the other reactant concentrations, so the concentrations are used as is
+  // without a minimum magnitude.
   for(int j=0; j<num_states; ++j) {
     original_state_[j] = state[j];
   }
-  min_concentration = 1.0/mechanism_ptr->getAvogadroNumber();
   for(int j=0; j<num_species; ++j) {
     concentrations_[j] = density*state[j]*inv_molecular_mass_[j];
-    if(fabs(concentrations_[j]) < min_concentration) {
-      // preserve the sign of the concentration when pushing to the minimum
-      // magnitude
-      if(concentrations_[j] >= 0.0) {
-        concentrations_[j] = min_concentration;
-      } else {
-        concentrations_[j] = -min_concentration;
-      }
-      // recompute original state from new concentrations
-      original_state_[j] =
-        relative_volume*concentrations_[j]*molecular_mass_[j];
-    }
-    inv_concentrations_[j] = 1.0/concentrations_[j];
   }
 
   // compute the rate of change of the species concentration
@@ -1850,25 +1869,28 @@ ReactorError
                                                     &net_reaction_rates_[0],
                                                     &creation_rates_[0],
                                                     &destruction_rates_[0],
-                                                    &step_rates_[0]);
-
-  // use the step rates and inverse concentrations with the elementary
-  // Jacobian term lists to compute dwdot[i]/dC[j]
+                                                    &step_rates_[0],
+                                                    &rate_coefficients_[0]);
+
+  // use the mass action Jacobian terms d(step_rate[j])/dC[k] with the
+  // elementary Jacobian term lists to compute dwdot[i]/dC[k]
+  mechanism_ptr->getMassActionJacobian()->getTermValues(
+    &rate_coefficients_[0],
+    &concentrations_[0],
+    &mass_action_terms_[0]);
   // Destruction terms
   for(int j=0; j<num_destroy; ++j) {
-    int conc_id   = destroy_concentration_id_[j];
-    int step_id   = destroy_step_id_[j];
+    int term_id   = destroy_term_id_[j];
     int sparse_id = destroy_sparse_id_[j];
 
-    jacobian[sparse_id] -= step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] -= mass_action_terms_[term_id];
   }
   // Creation terms
   for(int j=0; j<num_create; ++j) {
-    int conc_id   = create_concentration_id_[j];
-    int step_id   = create_step_id_[j];
+    int term_id   = create_term_id_[j];
     int sparse_id = create_sparse_id_[j];
 
-    jacobian[sparse_id] += step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] += mass_action_terms_[term_id];
   }
   // process the non-integer Jacobian information
   const int num_noninteger_jacobian_nonzeros =
@@ -1879,6 +1901,7 @@ ReactorError
       noninteger_jacobian_[j] = 0.0;
     }
 
+    SetNonIntegerInverseConcentrations();
     mechanism_ptr->getNonIntegerReactionNetwork()->GetSpeciesJacobian(
       &inv_concentrations_[0],
       &step_rates_[0],
@@ -2040,7 +2063,6 @@ ReactorError
   double mix_mass_cp, RuT;
   double mass_sum, enthalpy_sum;
   double d_temperature, d_relative_volume;
-  double min_concentration;
   zerork::mechanism *mechanism_ptr;
 
   mechanism_ptr = GetMechanism();
@@ -2057,28 +2079,14 @@ ReactorError
     jacobian[j] = 0.0;
   }
 
-  // Copy the original state and correct any mass_fractions that get adjusted
-  // by the minimum concentration. Note that one molecule in a 1 m^3 volume is
-  // taken to be the minimum concentration
+  // Copy the original state. The mass action Jacobian terms are products of
+  // the other reactant concentrations, so the concentrations are used as is
+  // without a minimum magnitude.
   for(int j=0; j<num_states; ++j) {
     original_state_[j] = state[j];
   }
-  min_concentration = 1.0/mechanism_ptr->getAvogadroNumber();
   for(int j=0; j<num_species; ++j) {
     concentrations_[j] = density*state[j]*inv_molecular_mass_[j];
-    if(fabs(concentrations_[j]) < min_concentration) {
-      // preserve the sign of the concentration when pushing to the minimum
-      // magnitude
-      if(concentrations_[j] >= 0.0) {
-        concentrations_[j] = min_concentration;
-      } else {
-        concentrations_[j] = -min_concentration;
-      }
-      // recompute original state from new concentrations
-      original_state_[j] =
-        relative_volume*concentrations_[j]*molecular_mass_[j];
-    }
-    inv_concentrations_[j] = 1.0/concentrations_[j];
   }
 
   // compute the rate of change of the species concentration
@@ -2089,14 +2097,18 @@ ReactorError
                                                     &net_reaction_rates_[0],
                                                     &creation_rates_[0],
                                                     &destruction_rates_[0],
-                                                    &step_rates_[0]);
-
-  // use the step rates and inverse concentrations with the elementary
-  // Jacobian term lists to compute dwdot[i]/dC[j]
+                                                    &step_rates_[0],
+                                                    &rate_coefficients_[0]);
+
+  // use the mass action Jacobian terms d(step_rate[j])/dC[k] with the
+  // elementary Jacobian term lists to compute dwdot[i]/dC[k]
+  mechanism_ptr->getMassActionJacobian()->getTermValues(
+    &rate_coefficients_[0],
+    &concentrations_[0],
+    &mass_action_terms_[0]);
   // Destruction terms
   for(int j=0; j<num_destroy; ++j) {
-    int conc_id   = destroy_concentration_id_[j];
-    int step_id   = destroy_step_id_[j];
+    int term_id   = destroy_term_id_[j];
     int sparse_id = destroy_sparse_id_[j];
     // [START DEBUG]
     //int print_row_id = 3;
@@ -2105,15 +2117,14 @@ ReactorError
     //   jacobian_column_id_[sparse_id] == print_col_id) {
     //  printf("Destroy term[%d,%d](sparse %d) = -%24.18e\n",
     //         print_row_id, print_col_id,sparse_id,
-    //         step_rates_[step_id]*inv_concentrations_[conc_id]);
+    //         mass_action_terms_[term_id]);
     //}
     // [END DEBUG]
-    jacobian[sparse_id] -= step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] -= mass_action_terms_[term_id];
   }
   // Creation terms
   for(int j=0; j<num_create; ++j) {
-    int conc_id   = create_concentration_id_[j];
-    int step_id   = create_step_id_[j];
+    int term_id   = create_term_id_[j];
     int sparse_id = create_sparse_id_[j];
     // [START DEBUG]
     //int print_row_id = 3;
@@ -2122,11 +2133,11 @@ ReactorError
     //   jacobian_column_id_[sparse_id] == print_col_id) {
     //  printf("Create  term[%d,%d](sparse %d) = +%24.18e\n",
     //         print_row_id, print_col_id,sparse_id,
-    //         step_rates_[step_id]*inv_concentrations_[conc_id]);
+    //         mass_action_terms_[term_id]);
     //}
     // [END DEBUG]
 
-    jacobian[sparse_id] += step_rates_[step_id]*inv_concentrations_[conc_id];
+    jacobian[sparse_id] += mass_action_terms_[term_id];
   }
   // process the non-integer Jacobian information
   const int num_noninteger_jacobian_nonzeros =
@@ -2137,6 +2148,7 @@ ReactorError
       noninteger_jacobian_[j] = 0.0;
     }
 
+    SetNonIntegerInverseConcentrations();
     mechanism_ptr->getNonIntegerReactionNetwork()->GetSpeciesJacobian(
       &inv_concentrations_[0],
       &step_rates_[0],
@@ -2516,6 +2528,25 @@ void ConstPressureReactor::Impl::
   }
 }
 
+// The non-integer reaction network computes its Jacobian terms from the
+// step rates and the inverse concentrations, which are taken with a minimum
+// magnitude of one molecule in a 1 m^3 volume.
+void ConstPressureReactor::Impl::SetNonIntegerInverseConcentrations()
+{
+  const int num_species = GetNumSpecies();
+  const double min_concentration =
+    1.0/GetMechanism()->getAvogadroNumber();
+  for(int j=0; j<num_species; ++j) {
+    if(fabs(concentrations_[j]) >= min_concentration) {
+      inv_concentrations_[j] = 1.0/concentrations_[j];
+    } else if(concentrations_[j] >= 0.0) {
+      inv_concentrations_[j] = 1.0/min_concentration;
+    } else {
+      inv_concentrations_[j] = -1.0/min_concentration;
+    }
+  }
+}
+
 int ConstPressureReactor::Impl::GetNetStoichiometry(const int species_id,
                                                     const int step_id)
 {
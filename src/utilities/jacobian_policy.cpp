@@ -0,0 +1,199 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <chrono>
+
+#include "jacobian_policy.h"
+
+namespace zerork {
+namespace utilities {
+
+static const char *action_names[] = {"reuse", "numeric", "symbolic"};
+
+static double GetWallTime()
+{
+  return std::chrono::duration<double>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+JacobianPolicy::JacobianPolicy()
+{
+  enabled_ = false;
+  max_reuse_ = 10;
+  max_convergence_rate_ = 0.5;
+  max_linear_iterations_ = 50;
+  symbolic_interval_ = 0;
+  logger_ = NULL;
+
+  num_setup_calls_ = 0;
+  num_reuse_ = 0;
+  num_numeric_ = 0;
+  num_symbolic_ = 0;
+  num_failed_ = 0;
+  factor_time_ = 0.0;
+
+  Reset();
+}
+
+void JacobianPolicy::SetOptions(const bool enabled,
+                                const int max_reuse,
+                                const double max_convergence_rate,
+                                const int max_linear_iterations,
+                                const int symbolic_interval,
+                                Logger *logger)
+{
+  enabled_ = enabled;
+  max_reuse_ = max_reuse;
+  max_convergence_rate_ = max_convergence_rate;
+  max_linear_iterations_ = max_linear_iterations;
+  symbolic_interval_ = symbolic_interval;
+  logger_ = logger;
+}
+
+void JacobianPolicy::Reset()
+{
+  have_factor_ = false;
+  setup_pending_ = false;
+  force_symbolic_ = false;
+  reuse_count_ = 0;
+  numeric_since_symbolic_ = 0;
+  num_solves_since_factor_ = 0;
+  num_setups_since_factor_ = 0;
+  last_residual_norm_ = -1.0;
+  last_shift_ = 0.0;
+  setup_start_time_ = 0.0;
+}
+
+int JacobianPolicy::GetSetupAction(const double residual_norm,
+                                   const double shift)
+{
+  int action = JACOBIAN_REUSE;
+  const char *reason = "converging";
+
+  ++num_setup_calls_;
+  // A setup that never reached RecordSetup() returned early with an error
+  if(setup_pending_) {
+    ++num_failed_;
+    force_symbolic_ = true;
+    have_factor_ = false;
+  }
+
+  if(!enabled_) {
+    action = JACOBIAN_NUMERIC_FACTOR;
+    reason = "policy disabled";
+  } else if(!have_factor_) {
+    action = JACOBIAN_NUMERIC_FACTOR;
+    reason = "no valid factorization";
+  } else if(shift != last_shift_) {
+    action = JACOBIAN_NUMERIC_FACTOR;
+    reason = "time step changed";
+  } else if(reuse_count_ >= max_reuse_) {
+    action = JACOBIAN_NUMERIC_FACTOR;
+    reason = "maximum age";
+  } else if(last_residual_norm_ >= 0.0 &&
+            residual_norm > max_convergence_rate_*last_residual_norm_) {
+    action = JACOBIAN_NUMERIC_FACTOR;
+    reason = "slow residual reduction";
+  } else if(num_solves_since_factor_ >
+            max_linear_iterations_*num_setups_since_factor_) {
+    action = JACOBIAN_NUMERIC_FACTOR;
+    reason = "too many linear iterations";
+  }
+
+  if(action == JACOBIAN_NUMERIC_FACTOR) {
+    if(force_symbolic_) {
+      action = JACOBIAN_SYMBOLIC_FACTOR;
+      reason = "previous factorization failed";
+    } else if(enabled_ && symbolic_interval_ > 0 &&
+              numeric_since_symbolic_ >= symbolic_interval_) {
+      action = JACOBIAN_SYMBOLIC_FACTOR;
+      reason = "symbolic refresh interval";
+    }
+  }
+
+  if(enabled_ && logger_ != NULL) {
+    logger_->PrintF(
+      "# Jacobian policy: setup %d action = %s (%s), |F| = %.6e,"
+      " age = %d, linear iterations = %d\n",
+      num_setup_calls_,
+      action_names[action],
+      reason,
+      residual_norm,
+      reuse_count_,
+      num_solves_since_factor_);
+  }
+
+  last_residual_norm_ = residual_norm;
+  last_shift_ = shift;
+  ++num_setups_since_factor_;
+  if(action == JACOBIAN_REUSE) {
+    ++reuse_count_;
+    ++num_reuse_;
+  } else {
+    setup_pending_ = true;
+    setup_start_time_ = GetWallTime();
+  }
+  return action;
+}
+
+void JacobianPolicy::RecordSetup(const int action, const int error_flag)
+{
+  const double elapsed = GetWallTime() - setup_start_time_;
+  factor_time_ += elapsed;
+  setup_pending_ = false;
+
+  if(error_flag != 0) {
+    ++num_failed_;
+    force_symbolic_ = true;
+    have_factor_ = false;
+  } else {
+    if(action == JACOBIAN_SYMBOLIC_FACTOR) {
+      ++num_symbolic_;
+      numeric_since_symbolic_ = 0;
+    } else {
+      ++num_numeric_;
+      ++numeric_since_symbolic_;
+    }
+    force_symbolic_ = false;
+    have_factor_ = true;
+  }
+  reuse_count_ = 0;
+  num_solves_since_factor_ = 0;
+  num_setups_since_factor_ = 0;
+
+  if(enabled_ && logger_ != NULL) {
+    logger_->PrintF(
+      "# Jacobian policy: %s factorization took %.6e [s], error flag = %d\n",
+      action_names[action],
+      elapsed,
+      error_flag);
+  }
+}
+
+void JacobianPolicy::Report(const bool use_stdout) const
+{
+  const char *format =
+    "# Jacobian policy: %d setup calls, %d reused, %d numeric,"
+    " %d symbolic, %d failed factorizations, %.6e [s] in setup\n";
+  if(use_stdout) {
+    printf(format,
+           num_setup_calls_,
+           num_reuse_,
+           num_numeric_,
+           num_symbolic_,
+           num_failed_,
+           factor_time_);
+  }
+  if(logger_ != NULL) {
+    logger_->PrintF(format,
+                    num_setup_calls_,
+                    num_reuse_,
+                    num_numeric_,
+                    num_symbolic_,
+                    num_failed_,
+                    factor_time_);
+  }
+}
+
+} // end namespace utilities
+} // end namespace zerork
@@ -0,0 +1,88 @@
+#ifndef JACOBIAN_POLICY_H_
+#define JACOBIAN_POLICY_H_
+
+#include "file_utilities.h"
+
+namespace zerork {
+namespace utilities {
+
+// Actions returned by JacobianPolicy::GetSetupAction()
+enum JacobianSetupAction {
+  JACOBIAN_REUSE           = 0, // keep the current factorization
+  JACOBIAN_NUMERIC_FACTOR  = 1, // recompute and refactor on the same pattern
+  JACOBIAN_SYMBOLIC_FACTOR = 2  // recompute and redo the full factorization
+                                // including the ordering and pivoting
+};
+
+// The JacobianPolicy decides at each call of the KINSOL preconditioner setup
+// whether the current factorization can be reused, refactored numerically
+// with the existing ordering, or refactored from scratch. The decision is
+// based on the residual reduction since the previous setup call, the number
+// of preconditioner solves (linear iterations) made with the current
+// factorization, and its age. A setup call without any progress of the
+// residual, as happens when KINSOL retries after a linear solver failure,
+// always refactors. When the policy is disabled every setup call is a
+// numeric refactorization, which is the original behavior. The policy is
+// shared by the KINSOL preconditioners of the steady flame solvers.
+class JacobianPolicy
+{
+ public:
+  JacobianPolicy();
+
+  void SetOptions(const bool enabled,
+                  const int max_reuse,
+                  const double max_convergence_rate,
+                  const int max_linear_iterations,
+                  const int symbolic_interval,
+                  Logger *logger);
+
+  // Forget the factorization history, e.g. after the grid has changed
+  void Reset();
+
+  // Called at the start of a preconditioner setup with the scaled norm of
+  // the current residual and the diagonal shift of the Jacobian (1/dt for
+  // pseudo-unsteady steps, zero otherwise)
+  int GetSetupAction(const double residual_norm, const double shift);
+  // Called at the end of a successful or failed factorization
+  void RecordSetup(const int action, const int error_flag);
+  // Called for each preconditioner solve
+  void RecordSolve() {++num_solves_since_factor_;}
+
+  // Print the setup statistics to stdout and to the log
+  void Report(const bool use_stdout) const;
+
+  bool enabled() const {return enabled_;}
+
+ private:
+  bool enabled_;
+  int max_reuse_;
+  double max_convergence_rate_;
+  int max_linear_iterations_;
+  int symbolic_interval_;
+  Logger *logger_;
+
+  // state of the current factorization
+  bool have_factor_;
+  bool setup_pending_;
+  bool force_symbolic_;
+  int reuse_count_;
+  int numeric_since_symbolic_;
+  int num_solves_since_factor_;
+  int num_setups_since_factor_;
+  double last_residual_norm_;
+  double last_shift_;
+  double setup_start_time_;
+
+  // cumulative statistics
+  int num_setup_calls_;
+  int num_reuse_;
+  int num_numeric_;
+  int num_symbolic_;
+  int num_failed_;
+  double factor_time_;
+};
+
+} // end namespace utilities
+} // end namespace zerork
+
+#endif
@@ -568,14 +568,12 @@ int info_net::getSpecIdxOfStepProduct(const int stepId,
 
 int info_net::spcIdxOfString(ckr::CKReader &ckrobj, string spcName)
 {
-  int j;
-  int nSpc = static_cast<int>(ckrobj.species.size());
-  for(j=0; j<nSpc; j++)
-    {
-      if(ckrobj.species[j].name == spcName)
-	{return j;}
-    }
-  return zerork::MIN_INT32;
+  const int nSpc = static_cast<int>(ckrobj.species.size());
+  ckr::speciesTable::const_iterator iter = ckrobj.speciesData.find(spcName);
+  if(iter == ckrobj.speciesData.end() || iter->second.index < 0 ||
+     iter->second.index >= nSpc)
+    {return zerork::MIN_INT32;}
+  return iter->second.index;
 }
 
 } // namespace zerork
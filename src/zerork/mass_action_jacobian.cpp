@@ -0,0 +1,162 @@
+#include "mass_action_jacobian.h"
+
+namespace zerork {
+
+mass_action_jacobian::mass_action_jacobian(const info_net &net)
+{
+  num_steps_ = net.getNumSteps();
+  step_term_start_.assign(num_steps_, -1);
+  step_term_stride_.assign(num_steps_, 0);
+
+  for(int j=0; j<num_steps_; ++j) {
+    const int order = net.getOrderOfStep(j);
+    if(order == 1) {
+      first_order_step_.push_back(j);
+      first_order_reactant_.push_back(net.getSpecIdxOfStepReactant(j,0));
+    } else if(order == 2) {
+      second_order_step_.push_back(j);
+      second_order_reactant0_.push_back(net.getSpecIdxOfStepReactant(j,0));
+      second_order_reactant1_.push_back(net.getSpecIdxOfStepReactant(j,1));
+    } else if(order == 3) {
+      third_order_step_.push_back(j);
+      third_order_reactant0_.push_back(net.getSpecIdxOfStepReactant(j,0));
+      third_order_reactant1_.push_back(net.getSpecIdxOfStepReactant(j,1));
+      third_order_reactant2_.push_back(net.getSpecIdxOfStepReactant(j,2));
+    } else if(order > 3) {
+      higher_order_step_.push_back(j);
+      for(int m=0; m<order; ++m) {
+        higher_order_reactants_.push_back(net.getSpecIdxOfStepReactant(j,m));
+      }
+    }
+  }
+  const int num_first  = static_cast<int>(first_order_step_.size());
+  const int num_second = static_cast<int>(second_order_step_.size());
+  const int num_third  = static_cast<int>(third_order_step_.size());
+  const int num_higher = static_cast<int>(higher_order_step_.size());
+
+  first_order_end_  = num_first;
+  second_order_end_ = first_order_end_ + 2*num_second;
+  third_order_end_  = second_order_end_ + 3*num_third;
+  num_terms_ = third_order_end_ +
+    static_cast<int>(higher_order_reactants_.size());
+
+  for(int k=0; k<num_first; ++k) {
+    step_term_start_[first_order_step_[k]] = k;
+  }
+  for(int k=0; k<num_second; ++k) {
+    step_term_start_[second_order_step_[k]]  = first_order_end_ + k;
+    step_term_stride_[second_order_step_[k]] = num_second;
+  }
+  for(int k=0; k<num_third; ++k) {
+    step_term_start_[third_order_step_[k]]  = second_order_end_ + k;
+    step_term_stride_[third_order_step_[k]] = num_third;
+  }
+  higher_order_start_.assign(1, 0);
+  for(int k=0; k<num_higher; ++k) {
+    const int step_id = higher_order_step_[k];
+    step_term_start_[step_id]  = third_order_end_ + higher_order_start_[k];
+    step_term_stride_[step_id] = 1;
+    higher_order_start_.push_back(higher_order_start_[k] +
+                                  net.getOrderOfStep(step_id));
+  }
+}
+
+void mass_action_jacobian::getTermPattern(int step_id[],
+                                          int species_id[]) const
+{
+  const int num_first  = static_cast<int>(first_order_step_.size());
+  const int num_second = static_cast<int>(second_order_step_.size());
+  const int num_third  = static_cast<int>(third_order_step_.size());
+  const int num_higher = static_cast<int>(higher_order_step_.size());
+
+  for(int k=0; k<num_first; ++k) {
+    step_id[k]    = first_order_step_[k];
+    species_id[k] = first_order_reactant_[k];
+  }
+  for(int k=0; k<num_second; ++k) {
+    step_id[first_order_end_+k]               = second_order_step_[k];
+    species_id[first_order_end_+k]            = second_order_reactant0_[k];
+    step_id[first_order_end_+num_second+k]    = second_order_step_[k];
+    species_id[first_order_end_+num_second+k] = second_order_reactant1_[k];
+  }
+  for(int k=0; k<num_third; ++k) {
+    step_id[second_order_end_+k]                = third_order_step_[k];
+    species_id[second_order_end_+k]             = third_order_reactant0_[k];
+    step_id[second_order_end_+num_third+k]      = third_order_step_[k];
+    species_id[second_order_end_+num_third+k]   = third_order_reactant1_[k];
+    step_id[second_order_end_+2*num_third+k]    = third_order_step_[k];
+    species_id[second_order_end_+2*num_third+k] = third_order_reactant2_[k];
+  }
+  for(int k=0; k<num_higher; ++k) {
+    for(int m=higher_order_start_[k]; m<higher_order_start_[k+1]; ++m) {
+      step_id[third_order_end_+m]    = higher_order_step_[k];
+      species_id[third_order_end_+m] = higher_order_reactants_[m];
+    }
+  }
+}
+
+void mass_action_jacobian::getTermValues(const double K[],
+                                         const double C[],
+                                         double values[]) const
+{
+  const int num_first  = static_cast<int>(first_order_step_.size());
+  const int num_second = static_cast<int>(second_order_step_.size());
+  const int num_third  = static_cast<int>(third_order_step_.size());
+  const int num_higher = static_cast<int>(higher_order_step_.size());
+
+  // first order: d(K*C[r0])/dC[r0] = K
+  const int *first_step = first_order_step_.data();
+  for(int k=0; k<num_first; ++k) {
+    values[k] = K[first_step[k]];
+  }
+
+  // second order
+  const int *second_step = second_order_step_.data();
+  const int *second_r0   = second_order_reactant0_.data();
+  const int *second_r1   = second_order_reactant1_.data();
+  double *second_d0 = &values[first_order_end_];
+  double *second_d1 = second_d0 + num_second;
+  for(int k=0; k<num_second; ++k) {
+    const double rate_coef = K[second_step[k]];
+    second_d0[k] = rate_coef*C[second_r1[k]];
+    second_d1[k] = rate_coef*C[second_r0[k]];
+  }
+
+  // third order
+  const int *third_step = third_order_step_.data();
+  const int *third_r0   = third_order_reactant0_.data();
+  const int *third_r1   = third_order_reactant1_.data();
+  const int *third_r2   = third_order_reactant2_.data();
+  double *third_d0 = &values[second_order_end_];
+  double *third_d1 = third_d0 + num_third;
+  double *third_d2 = third_d1 + num_third;
+  for(int k=0; k<num_third; ++k) {
+    const double rate_coef = K[third_step[k]];
+    const double c0 = C[third_r0[k]];
+    const double c1 = C[third_r1[k]];
+    const double c2 = C[third_r2[k]];
+    third_d0[k] = rate_coef*c1*c2;
+    third_d1[k] = rate_coef*c0*c2;
+    third_d2[k] = rate_coef*c0*c1;
+  }
+
+  // higher order: the product of the reactants before m (prefix) times the
+  // product of the reactants after m (suffix)
+  for(int k=0; k<num_higher; ++k) {
+    const int start = higher_order_start_[k];
+    const int end   = higher_order_start_[k+1];
+    double *higher_d = &values[third_order_end_];
+    double prefix = K[higher_order_step_[k]];
+    for(int m=start; m<end; ++m) {
+      higher_d[m] = prefix;
+      prefix *= C[higher_order_reactants_[m]];
+    }
+    double suffix = 1.0;
+    for(int m=end-1; m>=start; --m) {
+      higher_d[m] *= suffix;
+      suffix *= C[higher_order_reactants_[m]];
+    }
+  }
+}
+
+} // namespace zerork
@@ -0,0 +1,84 @@
+#ifndef ZERORK_MASS_ACTION_JACOBIAN_H
+#define ZERORK_MASS_ACTION_JACOBIAN_H
+
+#include <vector>
+
+#include "info_net.h"
+
+namespace zerork {
+
+// Elementary terms of the mass action Jacobian. A step j with reactants
+// r_0, ..., r_{n-1} (repeated for stoichiometric coefficients greater than
+// one) has the rate of progress K_j * C[r_0] * ... * C[r_{n-1}], and one
+// term for each reactant occurrence m:
+//
+//   d(ROP_j)/dC[r_m] = K_j * (product of C[r_i] over i != m)
+//
+// so the derivatives are evaluated as products of the other reactant
+// concentrations, without dividing the rate of progress by C[r_m]. The
+// terms are exact for zero and negative concentrations, and need no
+// minimum concentration clipping.
+//
+// The terms are grouped by the order of their step. The first, second and
+// third order groups store one index array per reactant position (structure
+// of arrays), so each group is evaluated by a fixed-width loop of gathers
+// and products with unit-stride stores, e.g. the second order group writes
+// all the d/dC[r_0] terms, then all the d/dC[r_1] terms. The rare steps of
+// higher order are evaluated per step with prefix and suffix products.
+// Steps of the non-integer reaction network (zero order in info_net) have
+// no terms.
+class mass_action_jacobian
+{
+ public:
+  explicit mass_action_jacobian(const info_net &net);
+
+  int getNumTerms() const {return num_terms_;}
+  // step and reactant species (column) of each term
+  void getTermPattern(int step_id[], int species_id[]) const;
+  // term of the derivative with respect to reactant reacId of step stepId,
+  // -1 for the steps without terms
+  int getTermIdx(const int stepId, const int reacId) const
+  {
+    return ((step_term_start_[stepId] < 0) ? -1 :
+            step_term_start_[stepId] + reacId*step_term_stride_[stepId]);
+  }
+
+  // Evaluates the terms from the rate coefficient K of each step, i.e. the
+  // rate of progress before the concentration products.
+  void getTermValues(const double K[],
+                     const double C[],
+                     double values[]) const;
+
+ private:
+  int num_steps_;
+  int num_terms_;
+
+  std::vector<int> step_term_start_;
+  std::vector<int> step_term_stride_;
+
+  // first order steps, terms [0, n1)
+  std::vector<int> first_order_step_;
+  std::vector<int> first_order_reactant_;
+  // second order steps, terms [first_order_end_, first_order_end_+2*n2)
+  int first_order_end_;
+  std::vector<int> second_order_step_;
+  std::vector<int> second_order_reactant0_;
+  std::vector<int> second_order_reactant1_;
+  // third order steps, terms [second_order_end_, second_order_end_+3*n3)
+  int second_order_end_;
+  std::vector<int> third_order_step_;
+  std::vector<int> third_order_reactant0_;
+  std::vector<int> third_order_reactant1_;
+  std::vector<int> third_order_reactant2_;
+  // higher order steps, terms [third_order_end_, num_terms_) contiguous by
+  // step, the reactants of higher_order_step_[k] are
+  // higher_order_reactants_[higher_order_start_[k], higher_order_start_[k+1])
+  int third_order_end_;
+  std::vector<int> higher_order_step_;
+  std::vector<int> higher_order_start_;
+  std::vector<int> higher_order_reactants_;
+};
+
+} // namespace zerork
+
+#endif
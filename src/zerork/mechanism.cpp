@@ -8,8 +8,11 @@
 #include <string>
 #include <algorithm> //for std::sort
 #include <exception>
+#include <map>
+#include <mutex>
 
 #include "mechanism.h"
+#include "sparse_ordering.h"
 
 namespace zerork {
 
@@ -67,6 +70,7 @@ mechanism::mechanism(const char *mechFileName,
 
 mechanism::~mechanism()
 {
+  delete massActionJacobian;
   delete perfNet;
   delete Kconst;
   delete infoNet;
@@ -100,6 +104,9 @@ void mechanism::build_mechanism(ckr::CKReader *ckrobj)
 
   assert(ckrobj != NULL);
 
+  rate_const_table_set_ = false;
+  kinetics_changed_ = false;
+
   // set the gas constant
   Ru=NIST_RU;
 
@@ -150,6 +157,7 @@ void mechanism::build_mechanism(ckr::CKReader *ckrobj)
 
 
   initialize_ptrs(ckrobj);
+  massActionJacobian = new mass_action_jacobian(*infoNet);
   non_integer_network_ = infoNet->getNonIntegerReactionNetwork();
   //printf("# INFO: Number of non-integer reactions = %d\n",
   //       non_integer_network.GetNumNonIntegerReactions());
@@ -446,6 +454,20 @@ double mechanism::getMassCvFromTY(const double T, const double y[]) const
   return getMassCvFromTY(T,y,&cvSpc[0]);
 }
 
+double mechanism::getMassdCpdTFromTY(const double T, const double y[],
+				         double dcpSpc[]) const
+{
+  double dcpMix=0.0;
+  thermo->getdCp_RdT(T,&dcpSpc[0]);
+  for(int j=0; j<nSpc; j++)
+    {
+      dcpSpc[j]*=RuInvMolWt[j];
+      dcpMix+=dcpSpc[j]*y[j];
+    }
+
+  return dcpMix;
+}
+
 double mechanism::getMolarCvFromTC(const double T, const double c[],
 				       double cvSpc[]) const
 {
@@ -624,6 +646,84 @@ void mechanism::getReactionRatesLimiter(const double T,
 				       &stepOut[0]);
 }
 
+void mechanism::getReactionRatesLimiter(const double T,
+                                        const double C[],
+		                        const double step_limiter[],
+			                double netOut[],
+                                        double createOut[],
+			                double destroyOut[],
+                                        double stepOut[],
+                                        rate_const_workspace *work) const
+{
+  perfNet->calcRatesFromTC_StepLimiter(T,
+                                       &C[0],
+                                       &step_limiter[0],
+				       &netOut[0],
+                                       &createOut[0],
+                                       &destroyOut[0],
+				       &stepOut[0],
+                                       work);
+}
+
+void mechanism::getReactionRatesLimiter(const double T,
+                                        const double C[],
+		                        const double step_limiter[],
+			                double netOut[],
+                                        double createOut[],
+			                double destroyOut[],
+                                        double stepOut[],
+                                        double rateCoefOut[],
+                                        rate_const_workspace *work) const
+{
+  perfNet->calcRatesFromTC_StepLimiter(T,
+                                       &C[0],
+                                       &step_limiter[0],
+				       &netOut[0],
+                                       &createOut[0],
+                                       &destroyOut[0],
+				       &stepOut[0],
+                                       rateCoefOut,
+                                       work);
+}
+
+void mechanism::getReactionRateDerivativesLimiter(const double T,
+                                                  const double C[],
+                                                  const double step_limiter[],
+                                                  double netOut[],
+                                                  double createOut[],
+                                                  double destroyOut[],
+                                                  double stepOut[],
+                                                  double rateCoefOut[],
+                                                  double dStepdT[],
+                                                  double dStepdCsum[],
+                                                  double dStepdC[],
+                                                  rate_const_workspace *work) const
+{
+  perfNet->calcRateDerivativesFromTC_StepLimiter(T,
+                                                 &C[0],
+                                                 &step_limiter[0],
+                                                 &netOut[0],
+                                                 &createOut[0],
+                                                 &destroyOut[0],
+                                                 &stepOut[0],
+                                                 rateCoefOut,
+                                                 &dStepdT[0],
+                                                 &dStepdCsum[0],
+                                                 dStepdC,
+                                                 work);
+}
+
+void mechanism::getNetRatesFromStepRates(const double stepIn[],
+                                         double netOut[],
+                                         double createOut[],
+                                         double destroyOut[]) const
+{
+  perfNet->calcNetRatesFromStepRates(&stepIn[0],
+                                     &netOut[0],
+                                     &createOut[0],
+                                     &destroyOut[0]);
+}
+
 void mechanism::getReactionRatesLimiter_perturbROP(const double T,
                                                    const double C[],
                                                    const double step_limiter[],
@@ -643,6 +743,27 @@ void mechanism::getReactionRatesLimiter_perturbROP(const double T,
                                                   &stepOut[0]);
 }
 
+void mechanism::getReactionRatesLimiter_perturbROP(const double T,
+                                                   const double C[],
+                                                   const double step_limiter[],
+                                                   const double perturbMult[],
+                                                   double netOut[],
+                                                   double createOut[],
+                                                   double destroyOut[],
+                                                   double stepOut[],
+                                                   double rateCoefOut[])
+{
+  perfNet->calcRatesFromTC_StepLimiter_perturbROP(T,
+                                                  &C[0],
+                                                  &step_limiter[0],
+                                                  &perturbMult[0],
+                                                  &netOut[0],
+                                                  &createOut[0],
+                                                  &destroyOut[0],
+                                                  &stepOut[0],
+                                                  &rateCoefOut[0]);
+}
+
 void mechanism::getEnthalpy_RT_mr(const int nReactors, const double T[], double h_RT[]) const
 {
   thermo->getH_RT_mr(nReactors,T,h_RT);
@@ -1189,6 +1310,299 @@ void mechanism::initExternalFuncs()
 #endif
 }
 
+double mechanism::setRateConstTable(const double min_temperature,
+                                    const double max_temperature,
+                                    const double rtol,
+                                    const int max_points)
+{
+  // tables are kept while any mechanism is using them
+  static std::mutex table_mutex;
+  static std::map<std::string, std::weak_ptr<const rateConstTable> >
+    table_registry;
+
+  if(min_temperature <= 0.0 || max_temperature <= min_temperature) {
+    return -1.0;
+  }
+  char table_settings[256];
+  snprintf(table_settings,
+           sizeof(table_settings),
+           "|%.17g|%.17g|%.17g|%d",
+           min_temperature,
+           max_temperature,
+           rtol,
+           max_points);
+  const std::string key = mechFileStr + "|" + thermFileStr + table_settings;
+
+  std::shared_ptr<const rateConstTable> table;
+  if(kinetics_changed_) {
+    // the parameters no longer match the mechanism files
+    table = Kconst->buildTemperatureTable(min_temperature,
+                                          max_temperature,
+                                          rtol,
+                                          max_points);
+  } else {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    table = table_registry[key].lock();
+    if(table == NULL) {
+      table = Kconst->buildTemperatureTable(min_temperature,
+                                            max_temperature,
+                                            rtol,
+                                            max_points);
+      table_registry[key] = table;
+    }
+  }
+  if(!Kconst->setTemperatureTable(table)) {
+    rate_const_table_set_ = false;
+    return -1.0;
+  }
+  rate_const_table_set_ = true;
+  rate_const_table_min_temperature_ = min_temperature;
+  rate_const_table_max_temperature_ = max_temperature;
+  rate_const_table_rtol_ = rtol;
+  rate_const_table_max_points_ = max_points;
+  return table->maxRelativeError;
+}
+
+void mechanism::unsetRateConstTable()
+{
+  rate_const_table_set_ = false;
+  Kconst->unsetTemperatureTable();
+}
+
+double mechanism::getRateConstTableError() const
+{
+  std::shared_ptr<const rateConstTable> table = Kconst->getTemperatureTable();
+  if(!rate_const_table_set_ || table == NULL) {
+    return -1.0;
+  }
+  return table->maxRelativeError;
+}
+
+// rate_const drops its temperature table when a parameter changes
+void mechanism::kineticsChanged()
+{
+  kinetics_changed_ = true;
+  if(rate_const_table_set_) {
+    setRateConstTable(rate_const_table_min_temperature_,
+                      rate_const_table_max_temperature_,
+                      rate_const_table_rtol_,
+                      rate_const_table_max_points_);
+  }
+}
+
+void mechanism::getJacobianPattern(std::vector<int> *column_sums,
+                                   std::vector<int> *row_indexes)
+{
+  const int num_states = nSpc+1;
+  std::vector<char> is_nonzero(num_states*num_states, 0);
+  // the diagonal, the temperature row and the temperature column
+  for(int j=0; j<num_states; ++j) {
+    is_nonzero[j*num_states+j] = 1;
+    is_nonzero[j*num_states+nSpc] = 1;
+    is_nonzero[nSpc*num_states+j] = 1;
+  }
+  // d(rate of species k)/d(species j) for reactant j of each step
+  for(int step_id=0; step_id<nStep; ++step_id) {
+    const int num_reactants = infoNet->getOrderOfStep(step_id);
+    const int num_products = infoNet->getNumProductsOfStep(step_id);
+    for(int k=0; k<num_reactants; ++k) {
+      const int column_id = infoNet->getSpecIdxOfStepReactant(step_id,k);
+      for(int m=0; m<num_reactants; ++m) {
+        const int row_id = infoNet->getSpecIdxOfStepReactant(step_id,m);
+        is_nonzero[column_id*num_states+row_id] = 1;
+      }
+      for(int m=0; m<num_products; ++m) {
+        const int row_id = infoNet->getSpecIdxOfStepProduct(step_id,m);
+        is_nonzero[column_id*num_states+row_id] = 1;
+      }
+    }
+  }
+  const int num_noninteger = non_integer_network_.GetNumJacobianNonzeros();
+  if(num_noninteger > 0) {
+    std::vector<int> row_id(num_noninteger), column_id(num_noninteger);
+    non_integer_network_.GetJacobianPattern(&row_id[0], &column_id[0]);
+    for(int j=0; j<num_noninteger; ++j) {
+      is_nonzero[column_id[j]*num_states+row_id[j]] = 1;
+    }
+  }
+  // d(rate of species k)/d(species j) for an enhanced third body j of each
+  // third body and falloff step
+  const int num_terms = getNumRateConstConcentrationTerms();
+  std::vector<int> term_step(num_terms), term_species(num_terms);
+  getRateConstConcentrationTerms(term_step.data(), term_species.data());
+  for(int j=0; j<num_terms; ++j) {
+    const int step_id = term_step[j];
+    const int column_id = term_species[j];
+    for(int m=0; m<infoNet->getOrderOfStep(step_id); ++m) {
+      const int row_id = infoNet->getSpecIdxOfStepReactant(step_id,m);
+      is_nonzero[column_id*num_states+row_id] = 1;
+    }
+    for(int m=0; m<infoNet->getNumProductsOfStep(step_id); ++m) {
+      const int row_id = infoNet->getSpecIdxOfStepProduct(step_id,m);
+      is_nonzero[column_id*num_states+row_id] = 1;
+    }
+  }
+
+  column_sums->assign(num_states+1, 0);
+  row_indexes->clear();
+  for(int j=0; j<num_states; ++j) {
+    for(int k=0; k<num_states; ++k) {
+      if(is_nonzero[j*num_states+k] != 0) {
+        row_indexes->push_back(k);
+      }
+    }
+    (*column_sums)[j+1] = static_cast<int>(row_indexes->size());
+  }
+}
+
+void mechanism::getJacobianOrdering(std::vector<int> *perm_c)
+{
+  std::lock_guard<std::mutex> lock(jacobian_ordering_mutex_);
+  if(jacobian_ordering_.empty()) {
+    std::vector<int> column_sums, row_indexes;
+    getJacobianPattern(&column_sums, &row_indexes);
+    getMinimumDegreeOrdering(nSpc+1,
+                             &column_sums[0],
+                             &row_indexes[0],
+                             1, // temperature
+                             &jacobian_ordering_);
+  }
+  *perm_c = jacobian_ordering_;
+}
+
+int mechanism::getArrheniusParameters(const int rxn_id,
+                                      const int dir,
+                                      double *A,
+                                      double *Tpow,
+                                      double *Eact) const
+{
+  if(rxn_id < 0 || rxn_id >= nRxn || (dir != 1 && dir != -1)) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,dir);
+  if(!Kconst->getArrheniusParameters(step_id,A,Tpow,Eact)) {
+    return -1;
+  }
+  return 0;
+}
+
+int mechanism::setArrheniusParameters(const int rxn_id,
+                                      const int dir,
+                                      const double A,
+                                      const double Tpow,
+                                      const double Eact)
+{
+  if(rxn_id < 0 || rxn_id >= nRxn || (dir != 1 && dir != -1)) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,dir);
+  if(!Kconst->setArrheniusParameters(step_id,A,Tpow,Eact)) {
+    return -1;
+  }
+  kineticsChanged();
+  return 0;
+}
+
+int mechanism::getFalloffLowParameters(const int rxn_id,
+                                       double *A,
+                                       double *Tpow,
+                                       double *Eact) const
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,1);
+  if(!Kconst->getFalloffLowParameters(step_id,A,Tpow,Eact)) {
+    return -1;
+  }
+  return 0;
+}
+
+int mechanism::setFalloffLowParameters(const int rxn_id,
+                                       const double A,
+                                       const double Tpow,
+                                       const double Eact)
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,1);
+  if(!Kconst->setFalloffLowParameters(step_id,A,Tpow,Eact)) {
+    return -1;
+  }
+  kineticsChanged();
+  return 0;
+}
+
+int mechanism::getFalloffParameters(const int rxn_id,
+                                    std::vector<double> *params) const
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,1);
+  if(!Kconst->getFalloffParameters(step_id,params)) {
+    return -1;
+  }
+  return 0;
+}
+
+int mechanism::setFalloffParameters(const int rxn_id,
+                                    const std::vector<double> &params)
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,1);
+  if(!Kconst->setFalloffParameters(step_id,params)) {
+    return -1;
+  }
+  kineticsChanged();
+  return 0;
+}
+
+int mechanism::getNumPLogLines(const int rxn_id) const
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  return Kconst->getNumPLogLines(infoNet->getStepIdxOfRxn(rxn_id,1));
+}
+
+int mechanism::getPLogParameters(const int rxn_id,
+                                 const int line_id,
+                                 double *pressure,
+                                 double *A,
+                                 double *Tpow,
+                                 double *Eact) const
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,1);
+  if(!Kconst->getPLogParameters(step_id,line_id,pressure,A,Tpow,Eact)) {
+    return -1;
+  }
+  return 0;
+}
+
+int mechanism::setPLogParameters(const int rxn_id,
+                                 const int line_id,
+                                 const double A,
+                                 const double Tpow,
+                                 const double Eact)
+{
+  if(rxn_id < 0 || rxn_id >= nRxn) {
+    return -1;
+  }
+  const int step_id = infoNet->getStepIdxOfRxn(rxn_id,1);
+  if(!Kconst->setPLogParameters(step_id,line_id,A,Tpow,Eact)) {
+    return -1;
+  }
+  kineticsChanged();
+  return 0;
+}
+
 void mechanism::buildReactionString(const int idx,
                                     string &str)
 {
@@ -1,11 +1,14 @@
 #ifndef ZERORK_MECHANISM_H
 #define ZERORK_MECHANISM_H
 
+#include <mutex>
 #include <string>
+#include <vector>
 #include "../CKconverter/CKReader.h"
 #include "element.h"
 #include "species.h"
 #include "info_net.h"
+#include "mass_action_jacobian.h"
 #include "perf_net.h"
 #include "rate_const.h"
 #include "constants.h"
@@ -102,6 +105,10 @@ class mechanism
   double getMassCvFromTY(const double T, const double y[],
 			 double cvSpc[]) const;
   double getMassCvFromTY(const double T, const double y[]) const;
+  // temperature derivative of the mass specific heats [J/kg/K^2], the same
+  // for Cp and Cv
+  double getMassdCpdTFromTY(const double T, const double y[],
+			    double dcpSpc[]) const;
   double getMolarCvFromTC(const double T, const double c[],
 			 double cvSpc[]) const;
   double getMolarCvFromTC(const double T, const double c[]) const;
@@ -147,6 +154,68 @@ class mechanism
                                double createOut[],
 			       double destroyOut[],
                                double stepOut[]);
+  // Same as above with the rate constant work arrays of one thread. The
+  // functions taking a workspace do not change the mechanism, so threads
+  // with their own workspaces can share a mechanism as long as none of them
+  // changes its parameters or rate constant table meanwhile.
+  std::unique_ptr<rate_const_workspace> createRateConstWorkspace() const
+  {return Kconst->createWorkspace();}
+  void getReactionRatesLimiter(const double T,
+                               const double C[],
+		               const double step_limiter[],
+			       double netOut[],
+                               double createOut[],
+			       double destroyOut[],
+                               double stepOut[],
+                               rate_const_workspace *work) const;
+  // Same as above, also returning the limited rate coefficient of each step
+  // for the mass action Jacobian terms (see getMassActionJacobian)
+  void getReactionRatesLimiter(const double T,
+                               const double C[],
+		               const double step_limiter[],
+			       double netOut[],
+                               double createOut[],
+			       double destroyOut[],
+                               double stepOut[],
+                               double rateCoefOut[],
+                               rate_const_workspace *work) const;
+
+  // Same as above, also returning the derivatives of the rate-of-progress
+  // of each step with the limited rate coefficient: dStepdT[j] with respect
+  // to temperature at constant concentrations, and with respect to the
+  // concentrations
+  //
+  //   d(stepOut[j])/dC[k] = (reactant terms of mass action)
+  //                         + dStepdCsum[j] + sum of dStepdC[m] over the
+  //                           rate constant concentration terms m of step j
+  //                           and species k
+  //
+  // where the last two are the third body, falloff and PLOG dependence of
+  // the rate coefficient (see rate_const::updateKDerivatives). The reactant
+  // terms of mass action are evaluated by getMassActionJacobian() from the
+  // limited rate coefficients in rateCoefOut, which may be NULL.
+  int getNumRateConstConcentrationTerms() const
+  {return Kconst->getNumConcentrationTerms();}
+  void getRateConstConcentrationTerms(int step_id[], int species_id[]) const
+  {Kconst->getConcentrationTerms(step_id,species_id);}
+  void getReactionRateDerivativesLimiter(const double T,
+                                         const double C[],
+                                         const double step_limiter[],
+                                         double netOut[],
+                                         double createOut[],
+                                         double destroyOut[],
+                                         double stepOut[],
+                                         double rateCoefOut[],
+                                         double dStepdT[],
+                                         double dStepdCsum[],
+                                         double dStepdC[],
+                                         rate_const_workspace *work) const;
+  // Species rates from the rate-of-progress of each step, e.g. the
+  // temperature derivative of netOut from dStepdT.
+  void getNetRatesFromStepRates(const double stepIn[],
+                                double netOut[],
+                                double createOut[],
+                                double destroyOut[]) const;
 
   void getReactionRatesLimiter_perturbROP(const double T,
                                           const double C[],
@@ -156,6 +225,23 @@ class mechanism
                                           double createOut[],
                                           double destroyOut[],
                                           double stepOut[]);
+  // Same as above, also returning the limited and perturbed rate
+  // coefficient of each step
+  void getReactionRatesLimiter_perturbROP(const double T,
+                                          const double C[],
+                                          const double step_limiter[],
+                                          const double perturbMult[],
+                                          double netOut[],
+                                          double createOut[],
+                                          double destroyOut[],
+                                          double stepOut[],
+                                          double rateCoefOut[]);
+
+  // Elementary terms d(ROP_j)/dC[k] of the mass action rate of progress of
+  // the integer order steps, evaluated from the rate coefficients returned
+  // above without dividing by the concentrations
+  const mass_action_jacobian * getMassActionJacobian() const
+  {return massActionJacobian;}
 
   // these may need to be inherited
   double getMolarAtomicOxygenRemainder(const double x[]) const;
@@ -184,6 +270,72 @@ class mechanism
   // load external func lib if called for
   void initExternalFuncs();
 
+  // Interpolate the temperature dependent terms of the rate constants and
+  // equilibrium constants from a table (see rateConstTable) for temperatures
+  // in [min_temperature, max_temperature]. The table grid is refined until
+  // the interpolated terms are within rtol of their exact values or the
+  // table reaches max_points temperatures. Mechanisms built from the same
+  // files with the same table settings share one table. Returns the measured
+  // maximum relative error of the table, or a negative value if the table
+  // could not be used.
+  double setRateConstTable(const double min_temperature,
+                           const double max_temperature,
+                           const double rtol,
+                           const int max_points = 4096);
+  void unsetRateConstTable();
+  // Maximum relative error of the rate constant table in use, or a negative
+  // value if there is none
+  double getRateConstTableError() const;
+
+  // Change the kinetic parameters of reaction rxn_id at runtime, without
+  // reparsing the mechanism. Parameters are in the units of the mechanism
+  // file (A in mol, cm^3 and s, the activation energy in the energy units of
+  // the mechanism file). dir is 1 for the forward rate constant and -1 for
+  // the reverse rate constant of a reaction with explicit REV parameters;
+  // the reverse rate constants computed from equilibrium follow the forward
+  // rate constant. The forward Arrhenius parameters of a falloff reaction
+  // are its high pressure limit. Only this mechanism object is changed, and
+  // a rate constant table in use is rebuilt for the new parameters (see
+  // setRateConstTable). The functions return 0 on success and -1 if the
+  // reaction does not have the parameters.
+  int getArrheniusParameters(const int rxn_id,
+                             const int dir,
+                             double *A,
+                             double *Tpow,
+                             double *Eact) const;
+  int setArrheniusParameters(const int rxn_id,
+                             const int dir,
+                             const double A,
+                             const double Tpow,
+                             const double Eact);
+  int getFalloffLowParameters(const int rxn_id,
+                              double *A,
+                              double *Tpow,
+                              double *Eact) const;
+  int setFalloffLowParameters(const int rxn_id,
+                              const double A,
+                              const double Tpow,
+                              const double Eact);
+  // Troe (alpha, T***, T*[, T**]) or SRI (a, b, c[, d, e]) parameters,
+  // empty for Lindemann reactions
+  int getFalloffParameters(const int rxn_id,
+                           std::vector<double> *params) const;
+  int setFalloffParameters(const int rxn_id,
+                           const std::vector<double> &params);
+  // PLOG lines of a reaction are ordered by pressure [atm]
+  int getNumPLogLines(const int rxn_id) const;
+  int getPLogParameters(const int rxn_id,
+                        const int line_id,
+                        double *pressure,
+                        double *A,
+                        double *Tpow,
+                        double *Eact) const;
+  int setPLogParameters(const int rxn_id,
+                        const int line_id,
+                        const double A,
+                        const double Tpow,
+                        const double Eact);
+
   // multi-reactor functions
   void getMassCpFromTY_mr(const int nReactors, const double T[],
                           const double y[], double cpSpc[],
@@ -231,6 +383,20 @@ class mechanism
   NonIntegerReactionNetwork * getNonIntegerReactionNetwork()
   {return &non_integer_network_;}
 
+  // Compressed column pattern of the Jacobian of the state of species and
+  // temperature (temperature last): the dependency of the species rates on
+  // the reactants of each step plus the non-integer reaction network and
+  // the enhanced third bodies, the diagonal, and a full temperature row and
+  // column.
+  void getJacobianPattern(std::vector<int> *column_sums,
+                          std::vector<int> *row_indexes);
+  // Fill-reducing column ordering of the Jacobian pattern above in the
+  // perm_c convention of SuperLU (see sparse_ordering.h). Temperature is
+  // ordered last so the first getNumSpecies() entries also order the
+  // species-only Jacobian. Computed on the first call and stored with the
+  // mechanism.
+  void getJacobianOrdering(std::vector<int> *perm_c);
+
  protected:
   void buildReactionString(const int idx,
                            string &str);
@@ -246,6 +412,7 @@ class mechanism
   rate_const *Kconst;
   perf_net *perfNet;
   info_net *infoNet;
+  mass_action_jacobian *massActionJacobian;
   NonIntegerReactionNetwork non_integer_network_;
   string *rxnDefinition;
 
@@ -274,6 +441,19 @@ class mechanism
   double *destroyRateWorkspace;
   double *stepROPWorkspace;
 
+  // settings of the rate constant table in use, the table is private to
+  // this mechanism once its kinetic parameters are changed
+  bool rate_const_table_set_;
+  bool kinetics_changed_;
+  double rate_const_table_min_temperature_;
+  double rate_const_table_max_temperature_;
+  double rate_const_table_rtol_;
+  int rate_const_table_max_points_;
+  void kineticsChanged();
+
+  std::mutex jacobian_ordering_mutex_;
+  std::vector<int> jacobian_ordering_;
+
   // handles for loading funcs from external lib
   void * externalFuncLibHandle;
   external_func_check_t ex_func_check; // test out loaded library,
@@ -76,6 +76,33 @@ void nasa_poly_group::getCp_R(const double T, double Cp_R[]) const
     }
 }
 
+void nasa_poly_group::getdCp_RdT(const double T, double dCp_RdT[]) const
+{
+  int j,coefAddr;
+  double Tmid;
+
+  coefAddr=0;
+  for(j=0; j<nGroupSpc; j++)
+    {
+      Tmid=thermoCoef[coefAddr];
+      if(T < Tmid)
+	{
+	  dCp_RdT[j]=     thermoCoef[coefAddr+2]+
+	              T*(2.0*thermoCoef[coefAddr+3]+
+		      T*(3.0*thermoCoef[coefAddr+4]+
+		      T* 4.0*thermoCoef[coefAddr+5]));
+	}
+      else
+	{
+	  dCp_RdT[j]=     thermoCoef[coefAddr+9 ]+
+	              T*(2.0*thermoCoef[coefAddr+10]+
+		      T*(3.0*thermoCoef[coefAddr+11]+
+		      T* 4.0*thermoCoef[coefAddr+12]));
+	}
+      coefAddr+=LDA_THERMO_POLY_D5R2;
+    }
+}
+
 void nasa_poly_group::getH_RT(const double T, double H_RT[]) const
 {
   int j,coefAddr;
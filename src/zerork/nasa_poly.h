@@ -11,6 +11,8 @@ class nasa_poly_group
 
   virtual ~nasa_poly_group();
   void getCp_R(const double T, double Cp_R[]) const;
+  // temperature derivative of Cp/R [1/K]
+  void getdCp_RdT(const double T, double dCp_RdT[]) const;
   void getH_RT(const double T, double H_RT[]) const;
   void getG_RT(const double T, double G_RT[]) const;
 
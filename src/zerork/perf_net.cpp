@@ -273,6 +273,172 @@ void perf_net::calcRatesFromTC_StepLimiter(const double T,
   cpuNetTime += getHighResolutionTime() - startTime;
 }
 
+void perf_net::calcRatesFromTC_StepLimiter(const double T,
+                                           const double C[],
+		                           const double step_limiter[],
+			                   double netOut[],
+                                           double createOut[],
+			                   double destroyOut[],
+                                           double stepOut[],
+                                           rate_const_workspace *work) const
+{
+  calcRatesFromTC_StepLimiter(T,C,step_limiter,netOut,createOut,destroyOut,
+                              stepOut,NULL,work);
+}
+
+void perf_net::calcRatesFromTC_StepLimiter(const double T,
+                                           const double C[],
+		                           const double step_limiter[],
+			                   double netOut[],
+                                           double createOut[],
+			                   double destroyOut[],
+                                           double stepOut[],
+                                           double rateCoefOut[],
+                                           rate_const_workspace *work) const
+{
+  int j;
+
+  // store K(T,p,C) in stepOut[]
+  rateConstPtr->updateK(T,&C[0],&stepOut[0],work);
+
+  // Apply the step_limiter to each K
+  const int const_num_steps = nStep;
+  for(j=0; j<const_num_steps; ++j) {
+    if(0.0 < step_limiter[j] && step_limiter[j] < 1.0e+300) {
+      stepOut[j] *= step_limiter[j]/(step_limiter[j]+stepOut[j]);
+    }
+  }
+  if(rateCoefOut != NULL) {
+    memcpy(rateCoefOut,stepOut,nStep*sizeof(double));
+  }
+
+  if(use_external_rates)
+  {
+      UnsupportedFeature(__FILE__, __LINE__);
+      (*ex_func_calc_rates)(&C[0],&stepOut[0],&createOut[0],&destroyOut[0]);
+  }
+  else
+  {
+      // compute the rate of progress of each step
+      for(j=0; j<totReac; ++j)
+        {stepOut[reactantStepIdxList[j]]*=C[reactantSpcIdxList[j]];}
+
+      memset(createOut,0,nSpc*sizeof(double));
+      memset(destroyOut,0,nSpc*sizeof(double));
+
+      if(use_non_integer_network_) {
+        non_integer_network_.UpdateRatesOfProgress(C,stepOut);
+        non_integer_network_.GetCreationRates(stepOut,createOut);
+        non_integer_network_.GetDestructionRates(stepOut,destroyOut);
+      }
+
+      // compute the species destruction rate by adding each steps rate of progress
+      // to the sum for each reactant species found
+      for(j=0; j<totReac; ++j)
+        {destroyOut[reactantSpcIdxList[j]]+=stepOut[reactantStepIdxList[j]];}
+
+      // compute the species creation rate by adding each steps rate of progress
+      // to the sum for each product species found
+      for(j=0; j<totProd; ++j)
+        {createOut[productSpcIdxList[j]]+=stepOut[productStepIdxList[j]];}
+  }
+
+  // compute the net species production rate = create - destroy
+  for(j=0; j<nSpc; ++j)
+    {netOut[j]=createOut[j]-destroyOut[j];}
+}
+
+void perf_net::calcRateDerivativesFromTC_StepLimiter(const double T,
+                                                     const double C[],
+                                                     const double step_limiter[],
+                                                     double netOut[],
+                                                     double createOut[],
+                                                     double destroyOut[],
+                                                     double stepOut[],
+                                                     double rateCoefOut[],
+                                                     double dStepdT[],
+                                                     double dStepdCsum[],
+                                                     double dStepdC[],
+                                                     rate_const_workspace *work) const
+{
+  int j;
+  const int num_terms = rateConstPtr->getNumConcentrationTerms();
+  std::vector<int> term_step(num_terms), term_species(num_terms);
+  // d(stepOut)/dK of each step
+  std::vector<double> step_scale(nStep,1.0);
+
+  if(use_external_rates) {
+    UnsupportedFeature(__FILE__, __LINE__);
+  }
+
+  // store K(T,p,C) in stepOut[]
+  rateConstPtr->updateKDerivatives(T,
+                                   &C[0],
+                                   &stepOut[0],
+                                   &dStepdT[0],
+                                   &dStepdCsum[0],
+                                   &dStepdC[0],
+                                   work);
+
+  // Apply the step_limiter to each K, dK_lim/dK = [L/(K + L)]**2
+  const int const_num_steps = nStep;
+  for(j=0; j<const_num_steps; ++j) {
+    if(0.0 < step_limiter[j] && step_limiter[j] < 1.0e+300) {
+      const double limit_ratio = step_limiter[j]/(step_limiter[j]+stepOut[j]);
+      stepOut[j] *= limit_ratio;
+      step_scale[j] = limit_ratio*limit_ratio;
+    }
+  }
+  if(rateCoefOut != NULL) {
+    memcpy(rateCoefOut,stepOut,nStep*sizeof(double));
+  }
+
+  // compute the rate of progress of each step
+  for(j=0; j<totReac; ++j) {
+    stepOut[reactantStepIdxList[j]]*=C[reactantSpcIdxList[j]];
+    step_scale[reactantStepIdxList[j]]*=C[reactantSpcIdxList[j]];
+  }
+
+  if(use_non_integer_network_) {
+    non_integer_network_.UpdateRatesOfProgress(C,stepOut);
+    non_integer_network_.UpdateRatesOfProgress(C,&step_scale[0]);
+  }
+
+  for(j=0; j<const_num_steps; ++j) {
+    dStepdT[j]    *= step_scale[j];
+    dStepdCsum[j] *= step_scale[j];
+  }
+  rateConstPtr->getConcentrationTerms(term_step.data(),term_species.data());
+  for(j=0; j<num_terms; ++j) {
+    dStepdC[j] *= step_scale[term_step[j]];
+  }
+
+  calcNetRatesFromStepRates(stepOut,netOut,createOut,destroyOut);
+}
+
+void perf_net::calcNetRatesFromStepRates(const double stepIn[],
+                                         double netOut[],
+                                         double createOut[],
+                                         double destroyOut[]) const
+{
+  int j;
+  memset(createOut,0,nSpc*sizeof(double));
+  memset(destroyOut,0,nSpc*sizeof(double));
+
+  if(use_non_integer_network_) {
+    non_integer_network_.GetCreationRates(stepIn,createOut);
+    non_integer_network_.GetDestructionRates(stepIn,destroyOut);
+  }
+
+  for(j=0; j<totReac; ++j)
+    {destroyOut[reactantSpcIdxList[j]]+=stepIn[reactantStepIdxList[j]];}
+  for(j=0; j<totProd; ++j)
+    {createOut[productSpcIdxList[j]]+=stepIn[productStepIdxList[j]];}
+
+  for(j=0; j<nSpc; ++j)
+    {netOut[j]=createOut[j]-destroyOut[j];}
+}
+
 void perf_net::calcRatesFromTC_StepLimiter_perturbROP(const double T,
                                                       const double C[],
                                                       const double step_limiter[],
@@ -281,6 +447,21 @@ void perf_net::calcRatesFromTC_StepLimiter_perturbROP(const double T,
                                                       double createOut[],
                                                       double destroyOut[],
                                                       double stepOut[])
+{
+  calcRatesFromTC_StepLimiter_perturbROP(T,C,step_limiter,perturbMult,
+                                         netOut,createOut,destroyOut,stepOut,
+                                         NULL);
+}
+
+void perf_net::calcRatesFromTC_StepLimiter_perturbROP(const double T,
+                                                      const double C[],
+                                                      const double step_limiter[],
+                                                      const double perturbMult[],
+                                                      double netOut[],
+                                                      double createOut[],
+                                                      double destroyOut[],
+                                                      double stepOut[],
+                                                      double rateCoefOut[])
 
 {
   int j,loopLim; //,reacId,stepId;
@@ -309,6 +490,9 @@ void perf_net::calcRatesFromTC_StepLimiter_perturbROP(const double T,
   // apply the multiplicative perturbation to the ROP array
   for(j=0; j<nStep; j++)
     {stepOut[j]*=perturbMult[j];}
+  if(rateCoefOut != NULL) {
+    memcpy(rateCoefOut,stepOut,nStep*sizeof(double));
+  }
 
 
   if(use_external_rates)
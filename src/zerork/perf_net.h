@@ -52,6 +52,54 @@ class perf_net
                                    double createOut[],
 			           double destroyOut[],
                                    double stepOut[]);
+  // Same as above with the rate constants evaluated in the workspace work,
+  // see rate_const::updateK. The timing counters are not updated, so the
+  // function can be called by several threads with their own workspaces.
+  void calcRatesFromTC_StepLimiter(const double T,
+                                   const double C[],
+		                   const double step_limiter[],
+			           double netOut[],
+                                   double createOut[],
+			           double destroyOut[],
+                                   double stepOut[],
+                                   rate_const_workspace *work) const;
+  // Same as above, also copying the limited rate coefficient of each step,
+  // i.e. stepOut before the concentration products, to rateCoefOut for the
+  // mass action Jacobian terms (see mass_action_jacobian).
+  void calcRatesFromTC_StepLimiter(const double T,
+                                   const double C[],
+		                   const double step_limiter[],
+			           double netOut[],
+                                   double createOut[],
+			           double destroyOut[],
+                                   double stepOut[],
+                                   double rateCoefOut[],
+                                   rate_const_workspace *work) const;
+
+  // Same as above, also returning the derivatives of the rate of progress
+  // of each step: dStepdT at constant concentrations, and dStepdCsum and
+  // dStepdC with respect to the concentrations as described for the rate
+  // constants in rate_const::updateKDerivatives. rateCoefOut may be NULL.
+  void calcRateDerivativesFromTC_StepLimiter(const double T,
+                                             const double C[],
+                                             const double step_limiter[],
+                                             double netOut[],
+                                             double createOut[],
+                                             double destroyOut[],
+                                             double stepOut[],
+                                             double rateCoefOut[],
+                                             double dStepdT[],
+                                             double dStepdCsum[],
+                                             double dStepdC[],
+                                             rate_const_workspace *work) const;
+
+  // Species creation, destruction and net rates from the rate of progress
+  // of each step, e.g. to map dStepdT to the temperature derivative of the
+  // net rates.
+  void calcNetRatesFromStepRates(const double stepIn[],
+                                 double netOut[],
+                                 double createOut[],
+                                 double destroyOut[]) const;
 
   void calcRatesFromTC_StepLimiter_perturbROP(const double T,
                                               const double C[],
@@ -61,6 +109,17 @@ class perf_net
                                               double createOut[],
                                               double destroyOut[],
                                               double stepOut[]);
+  // Same as above, also copying the limited and perturbed rate coefficient
+  // of each step to rateCoefOut
+  void calcRatesFromTC_StepLimiter_perturbROP(const double T,
+                                              const double C[],
+                                              const double step_limiter[],
+                                              const double perturbMult[],
+                                              double netOut[],
+                                              double createOut[],
+                                              double destroyOut[],
+                                              double stepOut[],
+                                              double rateCoefOut[]);
 
 
 //  void writeExplicitRateFunc(const char *fileName, const char *funcName);
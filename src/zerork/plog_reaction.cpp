@@ -144,14 +144,20 @@ void PLogReaction::CountDuplicatePressures()
 // indicate special processing.  If use_extrapolation_ is true, 'id' is set
 // to the first or last pressure range index. 
 int PLogReaction::GetPressureRangeIndex(const double pressure)
+{
+  return GetPressureRangeIndex(pressure, &last_bounded_range_id_);
+}
+
+int PLogReaction::GetPressureRangeIndex(const double pressure,
+                                        int *last_range_id) const
 {
   const int num_ranges=num_pressure_points_-1;
 
   if(min_pressure_ <= pressure && pressure < max_pressure_) {
     // check if the pressure is in the same range
-    if(pressure_points_[last_bounded_range_id_] <= pressure &&
-            pressure < pressure_points_[last_bounded_range_id_+1]) {
-      return last_bounded_range_id_;
+    if(pressure_points_[*last_range_id] <= pressure &&
+            pressure < pressure_points_[*last_range_id+1]) {
+      return *last_range_id;
     }
     // otherwise scan all the ranges
     for(int j=0; j<num_ranges; ++j) {
@@ -174,7 +180,7 @@ int PLogReaction::GetPressureRangeIndex(const double pressure)
 double PLogReaction::GetRateCoefficientAtPressure(const int pressure_id,
                                                const double temperature,
                                                const double inv_temperature,
-                                               const double log_e_temperature)
+                                               const double log_e_temperature) const
 {
   double rate_coefficient = 0.0;
  
@@ -194,11 +200,55 @@ double PLogReaction::GetRateCoefficientAtPressure(const int pressure_id,
   return rate_coefficient;
 } 
 
+double PLogReaction::GetRateCoefficientAtPressure(const int pressure_id,
+                                               const double temperature,
+                                               const double inv_temperature,
+                                               const double log_e_temperature,
+                                               double *dk_dlnT) const
+{
+  double rate_coefficient = 0.0;
+  *dk_dlnT = 0.0;
+
+  if(pressure_id < 0 || pressure_id >= (int)pressure_points_.size()) {
+    return rate_coefficient;
+  }
+
+  const int num_lines = num_lines_at_pressure_[pressure_id];
+  int line_id = start_line_at_pressure_[pressure_id];
+
+  for(int j=0; j<num_lines; ++j) {
+    const double line_coefficient = sign_afactor_[line_id+j]*
+      exp(log_e_afactor_[line_id+j] +
+          log_e_temperature*temperature_power_[line_id+j] -
+          inv_temperature*activation_temperature_[line_id+j]);
+    rate_coefficient += line_coefficient;
+    *dk_dlnT += line_coefficient*(temperature_power_[line_id+j] +
+                                  inv_temperature*
+                                  activation_temperature_[line_id+j]);
+  }
+  return rate_coefficient;
+}
+
 double PLogReaction::GetRateCoefficientFromTP(const double temperature,
                                            const double inv_temperature,
                                            const double log_e_temperature,
                                            const double pressure,
 				           const double log_e_pressure)
+{
+  return GetRateCoefficientFromTP(temperature,
+                                  inv_temperature,
+                                  log_e_temperature,
+                                  pressure,
+                                  log_e_pressure,
+                                  &last_bounded_range_id_);
+}
+
+double PLogReaction::GetRateCoefficientFromTP(const double temperature,
+                                           const double inv_temperature,
+                                           const double log_e_temperature,
+                                           const double pressure,
+				           const double log_e_pressure,
+                                           int *last_range_id) const
 {
   double rate_coefficient_p1, rate_coefficient_p2;
   const int num_ranges = num_pressure_points_-1;
@@ -246,11 +296,11 @@ double PLogReaction::GetRateCoefficientFromTP(const double temperature,
   }
   
   // compute the rate coefficient using logarithmic interploation
-  int range_id = GetPressureRangeIndex(pressure);
+  int range_id = GetPressureRangeIndex(pressure, last_range_id);
 
   if(0 <= range_id && range_id < num_ranges) {
 
-    last_bounded_range_id_ = range_id;
+    *last_range_id = range_id;
 
     // logarithmic interpolation (or extrapolation)
     rate_coefficient_p1 = GetRateCoefficientAtPressure(range_id, 
@@ -319,6 +369,80 @@ double PLogReaction::GetRateCoefficientFromTP(const double temperature,
   } 
   return rate_coefficient;
 }
+
+double PLogReaction::GetRateCoefficientDerivativesFromTP(
+                                           const double temperature,
+                                           const double inv_temperature,
+                                           const double log_e_temperature,
+                                           const double pressure,
+                                           const double log_e_pressure,
+                                           int *last_range_id,
+                                           double *dlnk_dlnT,
+                                           double *dlnk_dlnp) const
+{
+  double dk_dlnT_p1, dk_dlnT_p2;
+  const int num_ranges = num_pressure_points_-1;
+  *dlnk_dlnT = 0.0;
+  *dlnk_dlnp = 0.0;
+
+  // the warnings and the special cases of the rate coefficient are handled
+  // by the evaluation without derivatives
+  const double rate_coefficient = GetRateCoefficientFromTP(temperature,
+                                                           inv_temperature,
+                                                           log_e_temperature,
+                                                           pressure,
+                                                           log_e_pressure,
+                                                           last_range_id);
+  if(rate_coefficient == 0.0) {
+    return rate_coefficient;
+  }
+
+  // pressure point used without interpolation, if any
+  int pressure_id = -1;
+  if(num_ranges == 0 ||
+     (pressure <= min_pressure_ && use_extrapolation_ == false)) {
+    pressure_id = 0;
+  } else if(pressure >= max_pressure_ && use_extrapolation_ == false) {
+    pressure_id = num_ranges;
+  }
+
+  if(pressure_id < 0) {
+    const int range_id = GetPressureRangeIndex(pressure, last_range_id);
+    // k = k1*(p/p1)**n with n = ln(k2/k1)/ln(p2/p1)
+    const double rate_coefficient_p1 =
+      GetRateCoefficientAtPressure(range_id,
+                                   temperature,
+                                   inv_temperature,
+                                   log_e_temperature,
+                                   &dk_dlnT_p1);
+    const double rate_coefficient_p2 =
+      GetRateCoefficientAtPressure(range_id+1,
+                                   temperature,
+                                   inv_temperature,
+                                   log_e_temperature,
+                                   &dk_dlnT_p2);
+    const double inv_log_range =
+      1.0/(log_e_pressure_points_[range_id+1]-log_e_pressure_points_[range_id]);
+    const double weight =
+      (log_e_pressure-log_e_pressure_points_[range_id])*inv_log_range;
+
+    *dlnk_dlnT = (1.0-weight)*dk_dlnT_p1/rate_coefficient_p1 +
+                 weight*dk_dlnT_p2/rate_coefficient_p2;
+    *dlnk_dlnp = log(rate_coefficient_p2/rate_coefficient_p1)*inv_log_range;
+  } else {
+    // single pressure point or a pressure outside the range without
+    // extrapolation
+    const double rate_coefficient_p1 =
+      GetRateCoefficientAtPressure(pressure_id,
+                                   temperature,
+                                   inv_temperature,
+                                   log_e_temperature,
+                                   &dk_dlnT_p1);
+    *dlnk_dlnT = dk_dlnT_p1/rate_coefficient_p1;
+  }
+  return rate_coefficient;
+}
+
 double PLogReaction::GetRateCoefficientFromTP(const double temperature,
                                               const double pressure)
 {
@@ -340,5 +464,35 @@ double PLogReaction::GetRateCoefficientFromTP(const double temperature,
                                   log(pressure));
 }
 
+void PLogReaction::GetArrheniusLine(const int line_id,
+                                    double *pressure,
+                                    double *Afactor,
+                                    double *Tpow,
+                                    double *Tact) const
+{
+  assert(0 <= line_id && line_id < total_arrhenius_lines_);
+  // pressure_points_ only holds the distinct pressures
+  int pressure_id = 0;
+  while(pressure_id+1 < num_pressure_points_ &&
+        start_line_at_pressure_[pressure_id+1] <= line_id) {
+    ++pressure_id;
+  }
+  (*pressure) = pressure_points_[pressure_id];
+  (*Afactor)  = sign_afactor_[line_id]*exp(log_e_afactor_[line_id]);
+  (*Tpow)     = temperature_power_[line_id];
+  (*Tact)     = activation_temperature_[line_id];
+}
+
+void PLogReaction::SetArrheniusLine(const int line_id,
+                                    const double Afactor,
+                                    const double Tpow,
+                                    const double Tact)
+{
+  assert(0 <= line_id && line_id < total_arrhenius_lines_);
+  log_e_afactor_[line_id]          = log(fabs(Afactor));
+  sign_afactor_[line_id]           = ((Afactor < 0.0) ? -1.0 : 1.0);
+  temperature_power_[line_id]      = Tpow;
+  activation_temperature_[line_id] = Tact;
+}
 
 } // end of namespace zerork
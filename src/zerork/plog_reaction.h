@@ -35,8 +35,40 @@ class PLogReaction {
                                const double log_e_temperature,
                                const double pressure,
                                const double log_e_pressure);
+  // Same as above with the last bounded pressure range kept by the caller
+  // in *last_range_id instead of in the reaction, so that one reaction can
+  // be evaluated by several threads. *last_range_id must start at zero.
+  int GetPressureRangeIndex(const double pressure, int *last_range_id) const;
+  double GetRateCoefficientFromTP(const double tempreature,
+                               const double inv_temperature,
+                               const double log_e_temperature,
+                               const double pressure,
+                               const double log_e_pressure,
+                               int *last_range_id) const;
   double GetRateCoefficientFromTP(const double temperature,
                                const double pressure);
+  // Same as above, also returning the logarithmic derivatives of the rate
+  // coefficient d(ln k)/d(ln T) at constant pressure and d(ln k)/d(ln p) at
+  // constant temperature. Both are zero when the rate coefficient is zero.
+  double GetRateCoefficientDerivativesFromTP(const double temperature,
+                               const double inv_temperature,
+                               const double log_e_temperature,
+                               const double pressure,
+                               const double log_e_pressure,
+                               int *last_range_id,
+                               double *dlnk_dlnT,
+                               double *dlnk_dlnp) const;
+  // Arrhenius parameters of the lines in pressure order, in the internal
+  // units [Pa] and [K]
+  void GetArrheniusLine(const int line_id,
+                        double *pressure,
+                        double *Afactor,
+                        double *Tpow,
+                        double *Tact) const;
+  void SetArrheniusLine(const int line_id,
+                        const double Afactor,
+                        const double Tpow,
+                        const double Tact);
   
  private:
   void SortByPressure();
@@ -44,7 +76,13 @@ class PLogReaction {
   double GetRateCoefficientAtPressure(const int pressure_id,
                                       const double temperature,
                                       const double inv_temperature,
-                                      const double log_e_temperature); 
+                                      const double log_e_temperature) const;
+  // rate coefficient at a pressure point and its derivative dk/d(ln T)
+  double GetRateCoefficientAtPressure(const int pressure_id,
+                                      const double temperature,
+                                      const double inv_temperature,
+                                      const double log_e_temperature,
+                                      double *dk_dlnT) const;
 
 
   double max_pressure_;
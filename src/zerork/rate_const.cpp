@@ -83,9 +83,7 @@ rate_const::rate_const(ckr::CKReader *ckrobj, info_net *netobj,
   thermoPtr=tobj;
   nStep=netobj->getNumSteps();
   cpySize=nStep*sizeof(double);
-  Kwork = new double[nStep];
   nSpc=ckrobj->species.size();
-  Gibbs_RT = new double[nSpc];
 
   setStepCount_Ttype(ckrobj); // count tempertature dependent step types
   setRxnCount_Ptype(*ckrobj); // count pressure     dependent rxn  types
@@ -101,19 +99,11 @@ rate_const::rate_const(ckr::CKReader *ckrobj, info_net *netobj,
   setFromKeqStepList(*ckrobj,*netobj);
   setThirdBodyRxnList(*ckrobj,*netobj);
   setFalloffRxnList(*ckrobj,*netobj);
+  setPressureRxnArrays();
   setPLogInterpolationStepList(*ckrobj,*netobj);
 
-  Tchanged = true;
-  Tcurrent = 0;
-
-  int allocSize = nDistinctArrhenius;
-  allocSize = ((allocSize + 31)/32)*32; //round to next even multiple of 32
-  arrWorkArray = (double*)aligned_alloc(32, sizeof(double)*allocSize);
-  memset(arrWorkArray,0.0,sizeof(double)*allocSize);
-  allocSize = nFromKeqStep;
-  allocSize = ((allocSize + 31)/32)*32; //round to next even multiple of 32
-  keqWorkArray = (double*)aligned_alloc(32, sizeof(double)*allocSize);
-  memset(keqWorkArray,0.0,sizeof(double)*allocSize);
+  parameters_version_ = 0;
+  work_ = createWorkspace();
 
   use_external_arrh = false;
   use_external_keq = false;
@@ -131,10 +121,6 @@ rate_const::~rate_const()
     delete [] distinctArrheniusTpow;
     delete [] distinctArrheniusTact;
   }
-  delete [] Gibbs_RT;
-  delete [] Kwork;
-  _aligned_free(arrWorkArray);
-  _aligned_free(keqWorkArray);
 }
 
 void rate_const::setStepCount_Ttype(ckr::CKReader *ckrobj)
@@ -309,6 +295,19 @@ void rate_const::setArrheniusStepList(ckr::CKReader *ckrobj,
     distinctArrheniusTact     = NULL;
     arrheniusStepList         = NULL;
   }
+
+  // unit conversions of the individual steps for the parameter accessors
+  step_arrhenius_pos_.assign(nStep,-1);
+  arrhenius_a_conversion_.assign(nArrheniusStep,1.0);
+  for(j=0; j<nArrheniusStep; j++) {
+    const int stepIdx=arrheniusStepList[j].stepIdx;
+    rxnIdx=netobj->getRxnIdxOfStep(stepIdx);
+    step_arrhenius_pos_[stepIdx]=j;
+    arrhenius_a_conversion_[j]=
+      pow(convertC,(1.0-netobj->getRealOrderOfStep(stepIdx)));
+    if(ckrobj->reactions[rxnIdx].isThreeBodyRxn)
+      {arrhenius_a_conversion_[j]/=convertC;}
+  }
 }
 
 void rate_const::setFromKeqStepList(ckr::CKReader &ckrobj,
@@ -408,6 +407,7 @@ void rate_const::setFalloffRxnList(ckr::CKReader &ckrobj,
   string spcName;
 
   falloffRxnList=new falloffRxn[nFalloffRxn];
+  falloff_a_low_conversion_.assign(nFalloffRxn,1.0);
 
   k=0; // falloffRxn counter
   for(j=0; j<nRxn; j++) {
@@ -449,9 +449,9 @@ void rate_const::setFalloffRxnList(ckr::CKReader &ckrobj,
       falloffRxnList[k].nEnhanced=nEnh;
 
       falloffRxnList[k].param.resize(7);
-      log_e_Alow = ckrobj.reactions[j].kf_aux.A*
-        pow(convertC,
-	   -netobj.getRealOrderOfStep(falloffRxnList[k].fwdStepIdx));
+      falloff_a_low_conversion_[k] = pow(convertC,
+        -netobj.getRealOrderOfStep(falloffRxnList[k].fwdStepIdx));
+      log_e_Alow = ckrobj.reactions[j].kf_aux.A*falloff_a_low_conversion_[k];
 
       falloffRxnList[k].param[0]=log(log_e_Alow);
       falloffRxnList[k].param[1]=ckrobj.reactions[j].kf_aux.n;
@@ -519,78 +519,257 @@ void rate_const::setFalloffRxnList(ckr::CKReader &ckrobj,
 void rate_const::updateK(const double T, const double C[])
 {
   int j;
-  double pressure;
-  // initialize to aid in debugging
-  for(j=0; j<nStep; j++)
-    {Kwork[j]=0.0;}
-
-  updateTcurrent(T);
-  Csum=0.0;
+  double Csum=0.0;
   for(j=0; j<nSpc;)
     {Csum+=C[j]; ++j;}
-  pressure = Csum*NIST_RU*T;
-
-  if(use_external_arrh)
-  {
-     ex_func_calc_arrh(Tcurrent,arrWorkArray,Kwork,
-                       nDistinctArrhenius,
-                       distinctArrheniusLogAfact,
-                       distinctArrheniusTpow,
-                       distinctArrheniusTact);
-  }
-  else
-  {
-      updateArrheniusStep();
-  }
-  // PLOG reactions must be updated before computing the reverse rates from
-  // Keq
-  updatePLogInterpolationStep(pressure,
-                              log(pressure));
-
-  if(use_external_keq)
-  {
-     thermoPtr->getG_RT(Tcurrent,Gibbs_RT);
-     ex_func_calc_keq(nFromKeqStep,Gibbs_RT,keqWorkArray,Kwork,log_e_PatmInvRuT);
-  }
-  else
-  {
-      updateFromKeqStep();
-  }
-
-  updateThirdBodyRxn(&C[0]);
-  updateFalloffRxn(&C[0]);
+  work_->Csum = Csum;
+  computeK(T,C,*work_);
 }
 
 // Update the reaction rate constants using the TCM state variable
 // (C = concentration, M = mixture concentration, T = temperature).  The
-// function is a copied from updateK, with the Csum calcuation replaced with
+// function is the same as updateK, with the Csum calcuation replaced with
 // the function argument C_mix.  This allows for the mixture concentration,
 // and, in effect, the pressure to be changed independently of the species
 // composition concentration.
 void rate_const::updateK_TCM(const double T,
                              const double C[],
                              const double C_mix)
+{
+  work_->Csum = C_mix;
+  computeK(T,C,*work_);
+}
+
+
+void rate_const::updateK(const double T, const double C[], double Kcopy[])
+{
+  updateK(T,C);
+  memcpy(Kcopy,&work_->Kwork[0],cpySize);
+}
+void rate_const::updateK_TCM(const double T,
+                             const double C[],
+                             const double C_mix,
+                             double Kcopy[])
+{
+  updateK_TCM(T,C,C_mix);
+  memcpy(Kcopy,&work_->Kwork[0],cpySize);
+}
+
+void rate_const::updateK(const double T,
+                         const double C[],
+                         double Kcopy[],
+                         rate_const_workspace *work) const
+{
+  int j;
+  double Csum=0.0;
+  for(j=0; j<nSpc;)
+    {Csum+=C[j]; ++j;}
+  work->Csum = Csum;
+  computeK(T,C,*work);
+  memcpy(Kcopy,&work->Kwork[0],cpySize);
+}
+
+void rate_const::updateKDerivatives(const double T,
+                                    const double C[],
+                                    double Kcopy[],
+                                    double dKdT[],
+                                    double dKdCsum[],
+                                    double dKdC[],
+                                    rate_const_workspace *work) const
+{
+  int j,k;
+  rate_const_workspace &ws = *work;
+  double Csum=0.0;
+  for(j=0; j<nSpc;)
+    {Csum+=C[j]; ++j;}
+  ws.Csum = Csum;
+  const double inv_T = 1.0/T;
+  const double pressure = Csum*NIST_RU*T;
+  const double log_e_10 = log(10.0);
+  double *Kwork = &ws.Kwork[0];
+
+  computeBaseK(T,ws);
+
+  // d(ln K)/dT and d(ln K)/dCsum of the rate constants before the third
+  // body and falloff corrections
+  for(j=0; j<nStep; ++j) {
+    dKdT[j] = 0.0;
+    dKdCsum[j] = 0.0;
+  }
+  for(j=0; j<nArrheniusStep; ++j) {
+    const int arrhenius_id = arrheniusStepList[j].arrheniusIdx;
+    dKdT[arrheniusStepList[j].stepIdx] =
+      (distinctArrheniusTpow[arrhenius_id]+
+       distinctArrheniusTact[arrhenius_id]*inv_T)*inv_T;
+  }
+  for(j=0; j<nPLogInterpolationStep; ++j) {
+    double dlnk_dlnT, dlnk_dlnp;
+    const int step_id = plogInterpolationStepList[j].step_index();
+    plogInterpolationStepList[j].GetRateCoefficientDerivativesFromTP(T,
+                                                           inv_T,
+                                                           ws.log_e_Tcurrent,
+                                                           pressure,
+                                                           log(pressure),
+                                                           &ws.plog_range_id[j],
+                                                           &dlnk_dlnT,
+                                                           &dlnk_dlnp);
+    dKdT[step_id] = (dlnk_dlnT+dlnk_dlnp)*inv_T;
+    if(Csum > 0.0) {
+      dKdCsum[step_id] = dlnk_dlnp/Csum;
+    }
+  }
+  // d(ln Krev)/dT = d(ln Kfwd)/dT - d(ln Keq)/dT where, for Keq in
+  // concentration units, d(ln Keq)/dT = (delta H/RT - delta n)/T
+  thermoPtr->getH_RT(T,&ws.Enthalpy_RT[0]);
+  for(j=0; j<nFromKeqStep; ++j) {
+    const int step_id = fromKeqStepList[j].stepIdx;
+    const int fwd_step_id = fromKeqStepList[j].fwdStepIdx;
+    dKdT[step_id] = dKdT[fwd_step_id]+
+      (fromKeqStepList[j].nDelta-
+       getThermoChangeOfKeqStep(j,&ws.Enthalpy_RT[0]))*inv_T;
+    dKdCsum[step_id] = dKdCsum[fwd_step_id];
+  }
+  // only the PLOG steps depend on Csum so far, and their rate constants are
+  // final
+  for(j=0; j<nStep; ++j) {
+    dKdCsum[j] *= Kwork[j];
+  }
+
+  // keep the rate constants before the corrections in dKdCsum, the third
+  // body and falloff steps are not PLOG steps
+  for(j=0; j<nThirdBodyRxn; ++j) {
+    dKdCsum[third_body_fwd_step_[j]] = Kwork[third_body_fwd_step_[j]];
+    if(third_body_rev_step_[j] >= 0) {
+      dKdCsum[third_body_rev_step_[j]] = Kwork[third_body_rev_step_[j]];
+    }
+  }
+  for(j=0; j<nFalloffRxn; ++j) {
+    dKdCsum[falloff_fwd_step_[j]] = Kwork[falloff_fwd_step_[j]];
+  }
+  updateThirdBodyRxn(&C[0],ws);
+  updateFalloffRxn(&C[0],ws);
+  memcpy(Kcopy,Kwork,cpySize);
+
+  // K = Kbase*Cmult
+  int term_id = 0;
+  for(j=0; j<nThirdBodyRxn; ++j) {
+    const int fwd_step_id = third_body_fwd_step_[j];
+    const int rev_step_id = third_body_rev_step_[j];
+    const double kbase_fwd = dKdCsum[fwd_step_id];
+    const double kbase_rev = ((rev_step_id >= 0) ? dKdCsum[rev_step_id] : 0.0);
+    dKdCsum[fwd_step_id] = third_body_csum_coef_[j]*kbase_fwd;
+    if(rev_step_id >= 0) {
+      dKdCsum[rev_step_id] = third_body_csum_coef_[j]*kbase_rev;
+    }
+    for(k=third_body_row_start_[j]; k<third_body_row_start_[j+1]; ++k) {
+      dKdC[term_id++] = third_body_eff_[k]*kbase_fwd;
+      if(rev_step_id >= 0) {
+        dKdC[term_id++] = third_body_eff_[k]*kbase_rev;
+      }
+    }
+  }
+
+  // K = Kinf*Pcorr with Pcorr = F*Pr/(1+Pr) and Pr = Klow*Cmult/Kinf
+  const int troe_start = falloff_type_start_[TROE_THREE_PARAMS];
+  const int sri_start = falloff_type_start_[SRI];
+  for(j=0; j<nFalloffRxn; ++j) {
+    const int fwd_step_id = falloff_fwd_step_[j];
+    const int rev_step_id = falloff_rev_step_[j];
+    const double kinf = dKdCsum[fwd_step_id];
+    const double Pr = ws.falloff_pr[j];
+    double dlnF_dlnPr = 0.0;
+    double dlnF_dT = 0.0; // at constant Pr
+
+    if(troe_start <= j && j < sri_start) {
+      // log10(F) = log10(Fcenter)/(1 + f**2), f = x/(n - 0.14*x) with
+      // x = log10(Pr) + c, where c and n depend on log10(Fcenter)
+      const int troe_id = j-troe_start;
+      const double log10_fcenter = ws.troe_log10_fcenter[troe_id];
+      const double x = log10(Pr)-ws.troe_c_term[troe_id];
+      const double n = ws.troe_n_term[troe_id];
+      const double denom = n-0.14*x;
+      const double f = x/denom;
+      const double inv_s = 1.0/(1.0+f*f);
+      const double dlog10F_df = -2.0*log10_fcenter*f*inv_s*inv_s;
+      const double df_dx = n/(denom*denom);
+      const double df_dn = -x/(denom*denom);
+      dlnF_dlnPr = dlog10F_df*df_dx;
+      dlnF_dT = log_e_10*(inv_s+dlog10F_df*(-0.67*df_dx-1.27*df_dn))*
+        getTroeLog10FcenterDerivative(troe_id,T,inv_T);
+    } else if(j >= sri_start) {
+      // ln(F) = ln(d) + ln(base)/(1 + log10(Pr)**2) + e*ln(T)
+      const int sri_id = j-sri_start;
+      const double log10_Pr = log10(Pr);
+      const double x_power = 1.0/(1.0+log10_Pr*log10_Pr);
+      const double base = ws.sri_base[sri_id];
+      double dbase_dT = sri_a_[sri_id]*sri_b_[sri_id]*inv_T*inv_T*
+        exp(-sri_b_[sri_id]*inv_T);
+      if(sri_inv_c_[sri_id] > 0) {
+        dbase_dT -= sri_inv_c_[sri_id]*exp(-T*sri_inv_c_[sri_id]);
+      }
+      dlnF_dlnPr = -2.0*log(base)*log10_Pr*x_power*x_power/log_e_10;
+      dlnF_dT = x_power*dbase_dT/base+sri_e_[sri_id]*inv_T;
+    }
+
+    const double dlnPcorr_dlnPr = dlnF_dlnPr+1.0/(1.0+Pr);
+    double dlnPr_dT = 0.0;
+    double dlnPr_dCmult = 0.0;
+    if(Pr > 1.0e-300 && kinf > 0.0) { // Pr is not clipped
+      dlnPr_dT = (falloff_tpow_low_[j]+falloff_tact_low_[j]*inv_T)*inv_T-
+                 dKdT[fwd_step_id];
+      dlnPr_dCmult = ws.falloff_klow[j]/(kinf*Pr);
+    }
+    const double dlnPcorr_dT = dlnF_dT+dlnPcorr_dlnPr*dlnPr_dT;
+    const double dlnPcorr_dCmult = dlnPcorr_dlnPr*dlnPr_dCmult;
+
+    const double dKfwd_dCmult = Kwork[fwd_step_id]*dlnPcorr_dCmult;
+    const double dKrev_dCmult =
+      ((rev_step_id >= 0) ? Kwork[rev_step_id]*dlnPcorr_dCmult : 0.0);
+    dKdT[fwd_step_id] += dlnPcorr_dT;
+    dKdCsum[fwd_step_id] = falloff_csum_coef_[j]*dKfwd_dCmult;
+    if(rev_step_id >= 0) {
+      dKdT[rev_step_id] += dlnPcorr_dT;
+      dKdCsum[rev_step_id] = falloff_csum_coef_[j]*dKrev_dCmult;
+    }
+    for(k=falloff_row_start_[j]; k<falloff_row_start_[j+1]; ++k) {
+      dKdC[term_id++] = falloff_eff_[k]*dKfwd_dCmult;
+      if(rev_step_id >= 0) {
+        dKdC[term_id++] = falloff_eff_[k]*dKrev_dCmult;
+      }
+    }
+  }
+
+  for(j=0; j<nStep; ++j) {
+    dKdT[j] *= Kwork[j];
+  }
+}
+
+// Compute the rate constants of all the steps in ws.Kwork at temperature T
+// and the mixture concentration ws.Csum
+void rate_const::computeK(const double T,
+                          const double C[],
+                          rate_const_workspace &ws) const
+{
+  computeBaseK(T,ws);
+  updateThirdBodyRxn(&C[0],ws);
+  updateFalloffRxn(&C[0],ws);
+}
+
+void rate_const::computeBaseK(const double T, rate_const_workspace &ws) const
 {
   int j;
   double pressure;
+  double *Kwork = &ws.Kwork[0];
   // initialize to aid in debugging
   for(j=0; j<nStep; j++)
     {Kwork[j]=0.0;}
 
-  updateTcurrent(T);
-  // Original from updateK takes the concetration sum from all the species
-  //Csum=0.0;
-  //for(j=0; j<nSpc;)
-  //  {Csum+=C[j]; ++j;}
-  //
-  // In updateK_CMT, the C_mix argument is used instead.
-  Csum = C_mix;
-  pressure = Csum*NIST_RU*T;
-
+  updateTcurrent(T,ws);
+  pressure = ws.Csum*NIST_RU*T;
 
   if(use_external_arrh)
   {
-     ex_func_calc_arrh(Tcurrent,arrWorkArray,Kwork,
+     ex_func_calc_arrh(ws.Tcurrent,ws.arrWorkArray,Kwork,
                        nDistinctArrhenius,
                        distinctArrheniusLogAfact,
                        distinctArrheniusTpow,
@@ -598,61 +777,127 @@ void rate_const::updateK_TCM(const double T,
   }
   else
   {
-     updateArrheniusStep();
+      updateArrheniusStep(ws);
   }
   // PLOG reactions must be updated before computing the reverse rates from
   // Keq
   updatePLogInterpolationStep(pressure,
-                              log(pressure));
+                              log(pressure),
+                              ws);
 
   if(use_external_keq)
   {
-     thermoPtr->getG_RT(Tcurrent,Gibbs_RT);
-     ex_func_calc_keq(nFromKeqStep,Gibbs_RT,keqWorkArray,Kwork,log_e_PatmInvRuT);
+     thermoPtr->getG_RT(ws.Tcurrent,&ws.Gibbs_RT[0]);
+     ex_func_calc_keq(nFromKeqStep,&ws.Gibbs_RT[0],ws.keqWorkArray,Kwork,
+                      ws.log_e_PatmInvRuT);
   }
   else
   {
-      updateFromKeqStep();
+      updateFromKeqStep(ws);
   }
-
-  updateThirdBodyRxn(&C[0]);
-  updateFalloffRxn(&C[0]);
 }
 
+static double * AllocateAlignedWorkArray(const int size)
+{
+  int allocSize = size;
+  allocSize = ((allocSize + 31)/32)*32; //round to next even multiple of 32
+  double *work = (double*)aligned_alloc(32, sizeof(double)*allocSize);
+  memset(work,0.0,sizeof(double)*allocSize);
+  return work;
+}
 
-void rate_const::updateK(const double T, const double C[], double Kcopy[])
+rate_const_workspace::rate_const_workspace()
+  :
+    Csum(0.0),
+    Tchanged(true),
+    Ttabulated(false),
+    Tcurrent(0.0),
+    log_e_Tcurrent(0.0),
+    invTcurrent(0.0),
+    log_e_PatmInvRuT(0.0),
+    parametersVersion(0),
+    arrWorkSize(0),
+    arrWorkArray(NULL),
+    keqWorkArray(NULL)
+{}
+
+rate_const_workspace::~rate_const_workspace()
 {
-  updateK(T,C);
-  memcpy(Kcopy,Kwork,cpySize);
+  if(arrWorkArray != NULL) {
+    _aligned_free(arrWorkArray);
+  }
+  if(keqWorkArray != NULL) {
+    _aligned_free(keqWorkArray);
+  }
 }
-void rate_const::updateK_TCM(const double T,
-                             const double C[],
-                             const double C_mix,
-                             double Kcopy[])
+
+std::unique_ptr<rate_const_workspace> rate_const::createWorkspace() const
 {
-  updateK_TCM(T,C,C_mix);
-  memcpy(Kcopy,Kwork,cpySize);
+  std::unique_ptr<rate_const_workspace> ws(new rate_const_workspace());
+  const int num_troe = falloff_type_start_[SRI]-
+                       falloff_type_start_[TROE_THREE_PARAMS];
+  const int num_sri = nFalloffRxn-falloff_type_start_[SRI];
+
+  ws->Kwork.assign(nStep,0.0);
+  ws->Gibbs_RT.assign(nSpc,0.0);
+  ws->Enthalpy_RT.assign(nSpc,0.0);
+  ws->parametersVersion = parameters_version_;
+  ws->arrWorkSize = nDistinctArrhenius;
+  ws->arrWorkArray = AllocateAlignedWorkArray(nDistinctArrhenius);
+  ws->keqWorkArray = AllocateAlignedWorkArray(nFromKeqStep);
+
+  ws->third_body_cmult.assign(nThirdBodyRxn,0.0);
+  ws->falloff_klow.assign(nFalloffRxn,0.0);
+  ws->troe_c_term.assign(num_troe,0.0);
+  ws->troe_n_term.assign(num_troe,0.0);
+  ws->troe_log10_fcenter.assign(num_troe,0.0);
+  ws->sri_base.assign(num_sri,0.0);
+  ws->sri_t_mult.assign(num_sri,1.0);
+  ws->falloff_cmult.assign(nFalloffRxn,0.0);
+  ws->falloff_pr.assign(nFalloffRxn,0.0);
+  ws->plog_range_id.assign(nPLogInterpolationStep,0);
+  return ws;
 }
-void rate_const::updateTcurrent(double const T)
+
+void rate_const::updateTcurrent(double const T, rate_const_workspace &ws) const
 {
-  Tchanged=false;
-  if(T!=Tcurrent) {
-    Tchanged = true;
-    Tcurrent=T;
-    log_e_Tcurrent=log(Tcurrent);
-    invTcurrent=1.0/Tcurrent;
-    log_e_PatmInvRuT=log(P_ATM/(NIST_RU*T));
+  if(ws.parametersVersion != parameters_version_) {
+    // the parameters or the temperature table changed since the last
+    // evaluation with this workspace
+    ws.parametersVersion = parameters_version_;
+    ws.Tcurrent = 0.0;
+    if(ws.arrWorkSize < nDistinctArrhenius) {
+      _aligned_free(ws.arrWorkArray);
+      ws.arrWorkArray = AllocateAlignedWorkArray(nDistinctArrhenius);
+      ws.arrWorkSize = nDistinctArrhenius;
+    }
+  }
+  ws.Tchanged=false;
+  if(T!=ws.Tcurrent) {
+    ws.Tchanged = true;
+    ws.Tcurrent=T;
+    ws.log_e_Tcurrent=log(T);
+    ws.invTcurrent=1.0/T;
+    ws.log_e_PatmInvRuT=log(P_ATM/(NIST_RU*T));
+
+    ws.Ttabulated = (temperature_table_ != NULL &&
+                     T >= temperature_table_->minTemperature &&
+                     T <= temperature_table_->maxTemperature);
+    if(ws.Ttabulated) {
+      updateFromTemperatureTable(ws);
+    }
   }
 }
 
 
-void rate_const::updateArrheniusStep()
+void rate_const::updateArrheniusStep(rate_const_workspace &ws) const
 {
   int j;
-  if(Tchanged) {
+  double *arrWorkArray = ws.arrWorkArray;
+  if(ws.Tchanged && !ws.Ttabulated) {
     //Need below def's for gcc to vectorize the loop
-    const double local_log_e_Tcurrent = log_e_Tcurrent;
-    const double local_invTcurrent = invTcurrent;
+    const double local_log_e_Tcurrent = ws.log_e_Tcurrent;
+    const double local_invTcurrent = ws.invTcurrent;
     for(j=0; j<nDistinctArrhenius; ++j) {
         arrWorkArray[j]=distinctArrheniusLogAfact[j]
                  	     +distinctArrheniusTpow[j]*local_log_e_Tcurrent
@@ -661,56 +906,486 @@ void rate_const::updateArrheniusStep()
     fast_vec_exp(arrWorkArray,nDistinctArrhenius+nDistinctArrhenius%4);
   }
   for(j=0; j<nArrheniusStep; ++j) {
-      Kwork[arrheniusStepList[j].stepIdx] =
+      ws.Kwork[arrheniusStepList[j].stepIdx] =
 	arrWorkArray[arrheniusStepList[j].arrheniusIdx];
     }
 }
 
 
-void rate_const::updateFromKeqStep()
+void rate_const::updateFromKeqStep(rate_const_workspace &ws) const
 {
-  int j,k;
-  if(Tchanged) {
-    double thermo_sum=0.0;
+  int j;
+  if(ws.Tchanged && !ws.Ttabulated) {
+    thermoPtr->getG_RT(ws.Tcurrent,&ws.Gibbs_RT[0]);
+    getLogKeq(ws.log_e_PatmInvRuT,&ws.Gibbs_RT[0],ws.keqWorkArray);
+    fast_vec_exp(ws.keqWorkArray,nFromKeqStep+nFromKeqStep%4);
+  }
+  for(j=0; j<nFromKeqStep; j++) {
 
-    thermoPtr->getG_RT(Tcurrent,Gibbs_RT);
+    ws.Kwork[fromKeqStepList[j].stepIdx]=
+      ws.keqWorkArray[j]*ws.Kwork[fromKeqStepList[j].fwdStepIdx];
+  }
+}
+
+// Natural log of the equilibrium constant of each step computed from Keq,
+// using the species Gibbs energies in Gibbs_RT.
+void rate_const::getLogKeq(const double log_e_PatmInvRuT_in,
+                           const double Gibbs_RT[],
+                           double log_keq[]) const
+{
+  for(int j=0; j<nFromKeqStep; ++j) {
+    log_keq[j] = getThermoChangeOfKeqStep(j,Gibbs_RT)-
+                 fromKeqStepList[j].nDelta*log_e_PatmInvRuT_in;
+  }
+}
 
-    for(j=0; j<nFromKeqStep; ++j) {
+double rate_const::getThermoChangeOfKeqStep(const int keq_id,
+                                            const double thermo[]) const
+{
+  int k;
+  double thermo_sum=0.0;
+  const int forward_step_id = fromKeqStepList[keq_id].fwdStepIdx;
+
+  if(non_integer_network_.HasStep(forward_step_id)) {
+    // products - reactants (defined relative to the forward direction)
+    thermo_sum =
+      non_integer_network_.GetThermoChangeOfStep(forward_step_id,
+                                                 thermo);
+
+  } else {
+    // the reactant and product counts are defined relative to the forward
+    // step direction
+    const int num_reactants = fromKeqStepList[keq_id].nReac;
+    const int num_products  = fromKeqStepList[keq_id].nProd;
+    for(k=0; k<num_products; ++k) {
+      thermo_sum += thermo[fromKeqStepList[keq_id].prodSpcIdx[k]];
+    }
+    for(k=0; k<num_reactants; ++k) {
+      thermo_sum -= thermo[fromKeqStepList[keq_id].reacSpcIdx[k]];
+    }
+  }
+  return thermo_sum;
+}
+
+// natural log of the ck SMALL constant
+static const double LOG_E_SMALL_TABLE_VALUE = -690.77552789821368;
+
+int rate_const::getNumTemperatureTableColumns() const
+{
+  const int num_troe = falloff_type_start_[SRI]-
+                       falloff_type_start_[TROE_THREE_PARAMS];
+  return nDistinctArrhenius+nFromKeqStep+nFalloffRxn+num_troe;
+}
+
+// Exact values of one row of the rateConstTable at temperature T
+void rate_const::getTemperatureTableRow(const double T, double row[]) const
+{
+  int j;
+  const double log_e_T = log(T);
+  const double inv_T = 1.0/T;
+  double *log_keq = &row[nDistinctArrhenius];
+  double *log_klow = &log_keq[nFromKeqStep];
+  double *log10_fcenter = &log_klow[nFalloffRxn];
+
+  for(j=0; j<nDistinctArrhenius; ++j) {
+    row[j] = distinctArrheniusLogAfact[j]+
+             distinctArrheniusTpow[j]*log_e_T-
+             distinctArrheniusTact[j]*inv_T;
+  }
+  std::vector<double> Gibbs_RT(nSpc);
+  thermoPtr->getG_RT(T,&Gibbs_RT[0]);
+  getLogKeq(log(P_ATM/(NIST_RU*T)),&Gibbs_RT[0],log_keq);
+  getFalloffLogKlow(log_e_T,inv_T,log_klow);
+  getTroeLog10Fcenter(T,inv_T,log10_fcenter);
+
+  // zero rate constants (log = -inf) can not be interpolated, they are
+  // stored at the ck SMALL constant instead
+  const int num_exp_columns = nDistinctArrhenius+nFromKeqStep+nFalloffRxn;
+  for(j=0; j<num_exp_columns; ++j) {
+    if(row[j] < LOG_E_SMALL_TABLE_VALUE) {
+      row[j] = LOG_E_SMALL_TABLE_VALUE;
+    }
+  }
+}
 
-      const int forward_step_id = fromKeqStepList[j].fwdStepIdx;
+// Four point Lagrange interpolation of the table columns
+// [start_column, start_column+num_columns) at temperature T
+void rate_const::interpolateTemperatureTable(const rateConstTable &table,
+                                             const double T,
+                                             const int start_column,
+                                             const int num_columns,
+                                             double values[]) const
+{
+  const double x = (T-table.minTemperature)*table.invDeltaTemperature;
+  int interval = (int)x;
+  if(interval >= table.numIntervals) {
+    interval = table.numIntervals-1;
+  }
+  const double s = x-(double)interval;
+  const double w0 = -s*(s-1.0)*(s-2.0)/6.0;
+  const double w1 = 0.5*(s+1.0)*(s-1.0)*(s-2.0);
+  const double w2 = -0.5*(s+1.0)*s*(s-2.0);
+  const double w3 = (s+1.0)*s*(s-1.0)/6.0;
+
+  // rows interval,...,interval+3 hold the grid points around T
+  const int stride = table.numColumns;
+  const double *row0 = &table.values[interval*stride+start_column];
+  const double *row1 = row0+stride;
+  const double *row2 = row1+stride;
+  const double *row3 = row2+stride;
+  for(int j=0; j<num_columns; ++j) {
+    values[j] = w0*row0[j]+w1*row1[j]+w2*row2[j]+w3*row3[j];
+  }
+}
 
-      if(non_integer_network_.HasStep(forward_step_id)) {
-        // products - reactants (defined relative to the forward direction)
-        thermo_sum =
-          non_integer_network_.GetThermoChangeOfStep(forward_step_id,
-                                                     Gibbs_RT);
+// Set the temperature dependent work arrays for Tcurrent from the table.
+// This replaces the exact evaluations in updateArrheniusStep,
+// updateFromKeqStep and updateFalloffTemperatureTerms.
+void rate_const::updateFromTemperatureTable(rate_const_workspace &ws) const
+{
+  const rateConstTable &table = *temperature_table_;
+  const double Tcurrent = ws.Tcurrent;
+  int column = 0;
+  interpolateTemperatureTable(table,Tcurrent,column,nDistinctArrhenius,
+                              ws.arrWorkArray);
+  fast_vec_exp(ws.arrWorkArray,nDistinctArrhenius+nDistinctArrhenius%4);
+  column += nDistinctArrhenius;
+
+  interpolateTemperatureTable(table,Tcurrent,column,nFromKeqStep,
+                              ws.keqWorkArray);
+  fast_vec_exp(ws.keqWorkArray,nFromKeqStep+nFromKeqStep%4);
+  column += nFromKeqStep;
+
+  if(nFalloffRxn > 0) {
+    interpolateTemperatureTable(table,Tcurrent,column,nFalloffRxn,
+                                &ws.falloff_klow[0]);
+    fast_vec_exp(&ws.falloff_klow[0],nFalloffRxn);
+    column += nFalloffRxn;
+    interpolateTemperatureTable(table,Tcurrent,column,
+                                (int)ws.troe_log10_fcenter.size(),
+                                ws.troe_log10_fcenter.data());
+  }
+}
 
-      } else {
-        // the reactant and product counts are defined relative to the forward
-        // step direction
-        const int num_reactants = fromKeqStepList[j].nReac;
-        const int num_products  = fromKeqStepList[j].nProd;
-        thermo_sum=0.0;
-        for(k=0; k<num_products; ++k) {
-          thermo_sum += Gibbs_RT[fromKeqStepList[j].prodSpcIdx[k]];
+std::shared_ptr<const rateConstTable>
+  rate_const::buildTemperatureTable(const double min_temperature,
+                                    const double max_temperature,
+                                    const double rtol,
+                                    const int max_points)
+{
+  assert(min_temperature > 0.0 && max_temperature > min_temperature);
+  const int num_columns = getNumTemperatureTableColumns();
+  const int num_exp_columns = nDistinctArrhenius+nFromKeqStep+nFalloffRxn;
+  std::vector<double> exact(num_columns);
+  std::vector<double> approx(num_columns);
+  std::shared_ptr<rateConstTable> table;
+  std::shared_ptr<rateConstTable> last_table;
+
+  int num_intervals = 32;
+  while(true) {
+    table = std::make_shared<rateConstTable>();
+    table->minTemperature = min_temperature;
+    table->maxTemperature = max_temperature;
+    table->numIntervals = num_intervals;
+    table->numPoints = num_intervals+3;
+    table->deltaTemperature = (max_temperature-min_temperature)/
+      (double)num_intervals;
+    table->invDeltaTemperature = 1.0/table->deltaTemperature;
+    table->numColumns = num_columns;
+    table->numExpColumns = num_exp_columns;
+    table->values.resize((size_t)table->numPoints*(size_t)num_columns);
+
+    // the first grid point must stay at a positive temperature
+    if(min_temperature-table->deltaTemperature > 0.0) {
+      for(int j=0; j<table->numPoints; ++j) {
+        getTemperatureTableRow(min_temperature+
+                                 (double)(j-1)*table->deltaTemperature,
+                               &table->values[(size_t)j*num_columns]);
+      }
+      // the interpolation error is largest near the interval midpoints
+      double max_error = 0.0;
+      for(int j=0; j<num_intervals; ++j) {
+        const double T = min_temperature+
+          ((double)j+0.5)*table->deltaTemperature;
+        getTemperatureTableRow(T,&exact[0]);
+        interpolateTemperatureTable(*table,T,0,num_columns,&approx[0]);
+        for(int k=0; k<num_columns; ++k) {
+          double error = approx[k]-exact[k];
+          if(k >= num_exp_columns) {
+            error *= log(10.0);
+          }
+          error = fabs(expm1(error));
+          if(error > max_error) {
+            max_error = error;
+          }
         }
-        for(k=0; k<num_reactants; ++k) {
-          thermo_sum -= Gibbs_RT[fromKeqStepList[j].reacSpcIdx[k]];
+      }
+      table->maxRelativeError = max_error;
+      if(max_error <= rtol) {
+        break;
+      }
+      // The thermodynamic fits are usually discontinuous at their common
+      // temperature, which sets a floor on the interpolation error of the
+      // equilibrium constants. Stop refining once the error is at that floor.
+      if(last_table != NULL &&
+         max_error > 0.5*last_table->maxRelativeError) {
+        if(last_table->maxRelativeError <= max_error) {
+          table = last_table;
         }
-
+        break;
       }
-      keqWorkArray[j] = thermo_sum-fromKeqStepList[j].nDelta*log_e_PatmInvRuT;
+    } else {
+      table->maxRelativeError = 1.0e300;
+    }
+    if(2*num_intervals+3 > max_points) {
+      break;
     }
-    fast_vec_exp(keqWorkArray,nFromKeqStep+nFromKeqStep%4);
+    last_table = table;
+    num_intervals *= 2;
   }
-  for(j=0; j<nFromKeqStep; j++) {
+  return table;
+}
+
+bool rate_const::setTemperatureTable(std::shared_ptr<const rateConstTable>
+                                     table)
+{
+  if(table == NULL ||
+     table->numColumns != getNumTemperatureTableColumns() ||
+     table->numExpColumns != nDistinctArrhenius+nFromKeqStep+nFalloffRxn) {
+    return false;
+  }
+  temperature_table_ = table;
+  ++parameters_version_; // force the temperature terms to be updated
+  return true;
+}
+
+void rate_const::unsetTemperatureTable()
+{
+  temperature_table_.reset();
+  ++parameters_version_; // force the temperature terms to be updated
+}
+
+// Force the temperature dependent terms to be recomputed after a change of
+// the kinetic parameters. A temperature table no longer matches them.
+void rate_const::parametersChanged()
+{
+  temperature_table_.reset();
+  ++parameters_version_;
+}
+
+// Append a distinct Arrhenius expression for a step that no longer shares
+// its parameters with the other steps
+void rate_const::addDistinctArrhenius()
+{
+  const int num_distinct = nDistinctArrhenius+1;
+  double *log_afact = new double[num_distinct];
+  double *tpow = new double[num_distinct];
+  double *tact = new double[num_distinct];
+  for(int j=0; j<nDistinctArrhenius; ++j) {
+    log_afact[j] = distinctArrheniusLogAfact[j];
+    tpow[j] = distinctArrheniusTpow[j];
+    tact[j] = distinctArrheniusTact[j];
+  }
+  log_afact[nDistinctArrhenius] = 0.0;
+  tpow[nDistinctArrhenius] = 0.0;
+  tact[nDistinctArrhenius] = 0.0;
+  delete [] distinctArrheniusLogAfact;
+  delete [] distinctArrheniusTpow;
+  delete [] distinctArrheniusTact;
+  distinctArrheniusLogAfact = log_afact;
+  distinctArrheniusTpow = tpow;
+  distinctArrheniusTact = tact;
+  nDistinctArrhenius = num_distinct;
+  // the work arrays of the workspaces are resized by updateTcurrent after
+  // parametersChanged
+}
 
-    Kwork[fromKeqStepList[j].stepIdx]=
-      keqWorkArray[j]*Kwork[fromKeqStepList[j].fwdStepIdx];
+bool rate_const::getArrheniusParameters(const int step_id,
+                                        double *A,
+                                        double *Tpow,
+                                        double *Eact) const
+{
+  if(step_id < 0 || step_id >= nStep || step_arrhenius_pos_[step_id] < 0) {
+    return false;
   }
+  const int pos = step_arrhenius_pos_[step_id];
+  const int idx = arrheniusStepList[pos].arrheniusIdx;
+  (*A) = exp(distinctArrheniusLogAfact[idx])/arrhenius_a_conversion_[pos];
+  (*Tpow) = distinctArrheniusTpow[idx];
+  (*Eact) = distinctArrheniusTact[idx]/convertE;
+  return true;
+}
+
+bool rate_const::setArrheniusParameters(const int step_id,
+                                        const double A,
+                                        const double Tpow,
+                                        const double Eact)
+{
+  if(step_id < 0 || step_id >= nStep || step_arrhenius_pos_[step_id] < 0 ||
+     !(A > 0.0)) {
+    return false;
+  }
+  const int pos = step_arrhenius_pos_[step_id];
+  int idx = arrheniusStepList[pos].arrheniusIdx;
+  // steps with the same parameters share one distinct expression, the
+  // changed step gets its own
+  for(int j=0; j<nArrheniusStep; ++j) {
+    if(j != pos && arrheniusStepList[j].arrheniusIdx == idx) {
+      addDistinctArrhenius();
+      idx = nDistinctArrhenius-1;
+      arrheniusStepList[pos].arrheniusIdx = idx;
+      break;
+    }
+  }
+  distinctArrheniusLogAfact[idx] = log(A*arrhenius_a_conversion_[pos]);
+  distinctArrheniusTpow[idx] = Tpow;
+  distinctArrheniusTact[idx] = Eact*convertE;
+  parametersChanged();
+  return true;
+}
+
+int rate_const::getFalloffRxnIdx(const int fwd_step_id) const
+{
+  for(int j=0; j<nFalloffRxn; ++j) {
+    if(falloffRxnList[j].fwdStepIdx == fwd_step_id) {
+      return j;
+    }
+  }
+  return -1;
+}
+
+bool rate_const::getFalloffLowParameters(const int fwd_step_id,
+                                         double *A,
+                                         double *Tpow,
+                                         double *Eact) const
+{
+  const int idx = getFalloffRxnIdx(fwd_step_id);
+  if(idx < 0) {
+    return false;
+  }
+  const falloffRxn &rxn = falloffRxnList[idx];
+  (*A) = exp(rxn.param[0])/falloff_a_low_conversion_[idx];
+  (*Tpow) = rxn.param[1];
+  (*Eact) = rxn.param[2]/convertE;
+  return true;
+}
+
+bool rate_const::setFalloffLowParameters(const int fwd_step_id,
+                                         const double A,
+                                         const double Tpow,
+                                         const double Eact)
+{
+  const int idx = getFalloffRxnIdx(fwd_step_id);
+  if(idx < 0 || !(A > 0.0)) {
+    return false;
+  }
+  falloffRxn &rxn = falloffRxnList[idx];
+  rxn.param[0] = log(A*falloff_a_low_conversion_[idx]);
+  rxn.param[1] = Tpow;
+  rxn.param[2] = Eact*convertE;
+  setPressureRxnArrays();
+  parametersChanged();
+  return true;
+}
+
+bool rate_const::getFalloffParameters(const int fwd_step_id,
+                                      std::vector<double> *params) const
+{
+  const int idx = getFalloffRxnIdx(fwd_step_id);
+  if(idx < 0) {
+    return false;
+  }
+  const falloffRxn &rxn = falloffRxnList[idx];
+  // param[0..2] are the low pressure Arrhenius parameters
+  params->assign(rxn.param.begin()+3,rxn.param.end());
+  if(rxn.falloffType == SRI) {
+    // stored as 1/c, or negative if c <= 0
+    (*params)[2] = ((rxn.param[5] > 0.0) ? 1.0/rxn.param[5] : 0.0);
+  }
+  return true;
+}
+
+bool rate_const::setFalloffParameters(const int fwd_step_id,
+                                      const std::vector<double> &params)
+{
+  const int idx = getFalloffRxnIdx(fwd_step_id);
+  if(idx < 0) {
+    return false;
+  }
+  falloffRxn &rxn = falloffRxnList[idx];
+  if(params.size()+3 != rxn.param.size()) {
+    return false;
+  }
+  for(size_t j=0; j<params.size(); ++j) {
+    rxn.param[3+j] = params[j];
+  }
+  if(rxn.falloffType == SRI) {
+    rxn.param[5] = ((params[2] > 0.0) ? 1.0/params[2] : -1.0);
+  }
+  setPressureRxnArrays();
+  parametersChanged();
+  return true;
+}
+
+int rate_const::getPLogIdx(const int step_id) const
+{
+  for(int j=0; j<nPLogInterpolationStep; ++j) {
+    if(plogInterpolationStepList[j].step_index() == step_id) {
+      return j;
+    }
+  }
+  return -1;
+}
+
+int rate_const::getNumPLogLines(const int step_id) const
+{
+  const int idx = getPLogIdx(step_id);
+  if(idx < 0) {
+    return -1;
+  }
+  return plogInterpolationStepList[idx].total_arrhenius_lines();
+}
+
+bool rate_const::getPLogParameters(const int step_id,
+                                   const int line_id,
+                                   double *pressure,
+                                   double *A,
+                                   double *Tpow,
+                                   double *Eact) const
+{
+  const int idx = getPLogIdx(step_id);
+  if(idx < 0 || line_id < 0 ||
+     line_id >= plogInterpolationStepList[idx].total_arrhenius_lines()) {
+    return false;
+  }
+  double Tact;
+  plogInterpolationStepList[idx].GetArrheniusLine(line_id,pressure,A,Tpow,
+                                                  &Tact);
+  (*pressure) /= P_ATM;
+  (*A) /= plog_a_conversion_[idx];
+  (*Eact) = Tact/convertE;
+  return true;
+}
+
+bool rate_const::setPLogParameters(const int step_id,
+                                   const int line_id,
+                                   const double A,
+                                   const double Tpow,
+                                   const double Eact)
+{
+  const int idx = getPLogIdx(step_id);
+  if(idx < 0 || line_id < 0 || A == 0.0 ||
+     line_id >= plogInterpolationStepList[idx].total_arrhenius_lines()) {
+    return false;
+  }
+  plogInterpolationStepList[idx].SetArrheniusLine(line_id,
+                                                  A*plog_a_conversion_[idx],
+                                                  Tpow,
+                                                  Eact*convertE);
+  parametersChanged();
+  return true;
 }
 
-//void rate_const::writeExplicitUpdates(const char *fileName, const char *funcName)
 void rate_const::write_funcs(FILE *fptr)
 {
   UnsupportedFeature(__FILE__,__LINE__);
@@ -839,155 +1514,369 @@ void rate_const::write_funcs(FILE *fptr)
 }
 
 
-void rate_const::updateThirdBodyRxn(const double C[])
+void rate_const::setPressureRxnArrays()
 {
   int j,k;
-  double Cmult;
-  for(j=0; j<nThirdBodyRxn; j++)
-    {
-      //printf("3rd body reaction %d of %d:\n",j,nThirdBodyRxn);
-      //printf("   nEnhanced    = %d\n", thirdBodyRxnList[j].nEnhanced);
-      //printf("   fwd step id  = %d\n", thirdBodyRxnList[j].fwdStepIdx);
-      //printf("   rev step id  = %d\n", thirdBodyRxnList[j].revStepIdx);
 
-      Cmult=Csum;
-      for(k=0; k<thirdBodyRxnList[j].nEnhanced; k++)
-	{
-	  //printf("      %d enhanced spc id = %d, eff = %g\n",
-	  //	 k,thirdBodyRxnList[j].etbSpcIdx[k],
-	  //	 thirdBodyRxnList[j].etbSpcEff[k]);
-	  //fflush(stdout);
-
-	  Cmult+=C[thirdBodyRxnList[j].etbSpcIdx[k]]*
-	    thirdBodyRxnList[j].etbSpcEff[k];
-	}
-      Kwork[thirdBodyRxnList[j].fwdStepIdx]*=Cmult;
-      if(likely(thirdBodyRxnList[j].revStepIdx >= 0))
-	{Kwork[thirdBodyRxnList[j].revStepIdx]*=Cmult;}
+  third_body_fwd_step_.resize(nThirdBodyRxn);
+  third_body_rev_step_.resize(nThirdBodyRxn);
+  third_body_row_start_.assign(nThirdBodyRxn+1,0);
+  third_body_csum_coef_.assign(nThirdBodyRxn,1.0);
+  third_body_spc_idx_.clear();
+  third_body_eff_.clear();
+  for(j=0; j<nThirdBodyRxn; ++j) {
+    third_body_fwd_step_[j] = thirdBodyRxnList[j].fwdStepIdx;
+    third_body_rev_step_[j] = thirdBodyRxnList[j].revStepIdx;
+    for(k=0; k<thirdBodyRxnList[j].nEnhanced; ++k) {
+      third_body_spc_idx_.push_back(thirdBodyRxnList[j].etbSpcIdx[k]);
+      third_body_eff_.push_back(thirdBodyRxnList[j].etbSpcEff[k]);
     }
-}
+    third_body_row_start_[j+1] = (int)third_body_spc_idx_.size();
+  }
 
-void rate_const::updateFalloffRxn(const double C[])
-{
-  int j,k;
-  double Cmult,Pr,log_10_Pr,Pcorr,Fcenter,fTerm,nTerm;
+  // order the falloff reactions by type, keeping the mechanism order
+  // within each type
+  std::vector<int> falloff_order;
+  for(int type=LINDEMANN; type<=SRI; ++type) {
+    falloff_type_start_[type] = (int)falloff_order.size();
+    for(j=0; j<nFalloffRxn; ++j) {
+      if(falloffRxnList[j].falloffType == type) {
+        falloff_order.push_back(j);
+      }
+    }
+  }
+  falloff_type_start_[SRI+1] = (int)falloff_order.size();
+  assert(falloff_type_start_[SRI+1] == nFalloffRxn);
+
+  falloff_fwd_step_.resize(nFalloffRxn);
+  falloff_rev_step_.resize(nFalloffRxn);
+  falloff_row_start_.assign(nFalloffRxn+1,0);
+  falloff_csum_coef_.assign(nFalloffRxn,1.0);
+  falloff_log_a_low_.resize(nFalloffRxn);
+  falloff_tpow_low_.resize(nFalloffRxn);
+  falloff_tact_low_.resize(nFalloffRxn);
+  falloff_spc_idx_.clear();
+  falloff_eff_.clear();
+  for(j=0; j<nFalloffRxn; ++j) {
+    const falloffRxn &rxn = falloffRxnList[falloff_order[j]];
+    falloff_fwd_step_[j] = rxn.fwdStepIdx;
+    falloff_rev_step_[j] = rxn.revStepIdx;
+    falloff_log_a_low_[j] = rxn.param[0];
+    falloff_tpow_low_[j] = rxn.param[1];
+    falloff_tact_low_[j] = rxn.param[2];
+    if(rxn.falloffSpcIdx >= 0) {
+      // single falloff species, enhanced third bodies are ignored
+      falloff_csum_coef_[j] = 0.0;
+      falloff_spc_idx_.push_back(rxn.falloffSpcIdx);
+      falloff_eff_.push_back(1.0);
+    } else {
+      for(k=0; k<rxn.nEnhanced; ++k) {
+        falloff_spc_idx_.push_back(rxn.etbSpcIdx[k]);
+        falloff_eff_.push_back(rxn.etbSpcEff[k]);
+      }
+    }
+    falloff_row_start_[j+1] = (int)falloff_spc_idx_.size();
+  }
 
-  double Klow[nFalloffRxn];
-  for(j=0; j<nFalloffRxn; j++) {
-    Klow[j] = falloffRxnList[j].param[0]+
-               falloffRxnList[j].param[1]*log_e_Tcurrent-
-	       falloffRxnList[j].param[2]*invTcurrent;
+  const int troe_start = falloff_type_start_[TROE_THREE_PARAMS];
+  const int num_troe = falloff_type_start_[SRI]-troe_start;
+  troe_alpha_.resize(num_troe);
+  troe_t3_.resize(num_troe);
+  troe_t1_.resize(num_troe);
+  troe_t2_.assign(num_troe,0.0);
+  for(j=0; j<num_troe; ++j) {
+    const falloffRxn &rxn = falloffRxnList[falloff_order[troe_start+j]];
+    troe_alpha_[j] = rxn.param[3];
+    troe_t3_[j] = rxn.param[4];
+    troe_t1_[j] = rxn.param[5];
+    if(rxn.falloffType == TROE_FOUR_PARAMS) {
+      troe_t2_[j] = rxn.param[6];
+    }
   }
-  fast_vec_exp(Klow, nFalloffRxn);
 
-  for(j=0; j<nFalloffRxn; j++) {
+  const int sri_start = falloff_type_start_[SRI];
+  const int num_sri = nFalloffRxn-sri_start;
+  sri_a_.resize(num_sri);
+  sri_b_.resize(num_sri);
+  sri_inv_c_.resize(num_sri);
+  sri_d_.assign(num_sri,1.0);
+  sri_e_.assign(num_sri,0.0);
+  for(j=0; j<num_sri; ++j) {
+    const falloffRxn &rxn = falloffRxnList[falloff_order[sri_start+j]];
+    sri_a_[j] = rxn.param[3];
+    sri_b_[j] = rxn.param[4];
+    sri_inv_c_[j] = rxn.param[5];
+    if(rxn.param.size() >= 7) {
+      sri_d_[j] = rxn.param[6];
+    }
+    if(rxn.param.size() == 8) {
+      sri_e_[j] = rxn.param[7];
+    }
+  }
 
-    if(falloffRxnList[j].falloffSpcIdx >= 0) {
-      // single falloff species
-      Cmult=C[falloffRxnList[j].falloffSpcIdx];
+  concentration_term_step_.clear();
+  concentration_term_species_.clear();
+  for(j=0; j<nThirdBodyRxn; ++j) {
+    for(k=third_body_row_start_[j]; k<third_body_row_start_[j+1]; ++k) {
+      concentration_term_step_.push_back(third_body_fwd_step_[j]);
+      concentration_term_species_.push_back(third_body_spc_idx_[k]);
+      if(third_body_rev_step_[j] >= 0) {
+        concentration_term_step_.push_back(third_body_rev_step_[j]);
+        concentration_term_species_.push_back(third_body_spc_idx_[k]);
+      }
     }
-    else {
-      // third-body species falloffRxnList[j].falloffSpcIdx == MIN_INT32
-      Cmult=Csum;
-      for(k=0; k<falloffRxnList[j].nEnhanced; k++) {
-	Cmult+=C[falloffRxnList[j].etbSpcIdx[k]]*
-               falloffRxnList[j].etbSpcEff[k];
+  }
+  for(j=0; j<nFalloffRxn; ++j) {
+    for(k=falloff_row_start_[j]; k<falloff_row_start_[j+1]; ++k) {
+      concentration_term_step_.push_back(falloff_fwd_step_[j]);
+      concentration_term_species_.push_back(falloff_spc_idx_[k]);
+      if(falloff_rev_step_[j] >= 0) {
+        concentration_term_step_.push_back(falloff_rev_step_[j]);
+        concentration_term_species_.push_back(falloff_spc_idx_[k]);
       }
     }
+  }
+}
 
-    Pr = Klow[j]*Cmult/Kwork[falloffRxnList[j].fwdStepIdx];
-    if(Pr < 1.0e-300) {
-      Pr = 1.0e-300; // ck SMALL constant
+void rate_const::getConcentrationTerms(int step_id[], int species_id[]) const
+{
+  for(size_t j=0; j<concentration_term_step_.size(); ++j) {
+    step_id[j]    = concentration_term_step_[j];
+    species_id[j] = concentration_term_species_[j];
+  }
+}
+
+// Cmult[j] = csum_coef[j]*Csum + sum of eff[k]*C[spc_idx[k]] over row j
+void rate_const::multiplyEnhancedSparse(const int num_rows,
+                                        const int row_start[],
+                                        const int spc_idx[],
+                                        const double eff[],
+                                        const double csum_coef[],
+                                        const double Csum,
+                                        const double C[],
+                                        double Cmult[]) const
+{
+  for(int j=0; j<num_rows; ++j) {
+    double sum = csum_coef[j]*Csum;
+    for(int k=row_start[j]; k<row_start[j+1]; ++k) {
+      sum += C[spc_idx[k]]*eff[k];
     }
-    log_10_Pr=log10(Pr);
+    Cmult[j] = sum;
+  }
+}
 
-    fTerm=1.0; // default is Lindemann
+void rate_const::updateThirdBodyRxn(const double C[],
+                                    rate_const_workspace &ws) const
+{
+  int j;
+  if(nThirdBodyRxn == 0) {
+    return;
+  }
+  double *Kwork = &ws.Kwork[0];
+  multiplyEnhancedSparse(nThirdBodyRxn,
+                         &third_body_row_start_[0],
+                         third_body_spc_idx_.data(),
+                         third_body_eff_.data(),
+                         &third_body_csum_coef_[0],
+                         ws.Csum,
+                         C,
+                         &ws.third_body_cmult[0]);
+  for(j=0; j<nThirdBodyRxn; ++j) {
+    const double Cmult = ws.third_body_cmult[j];
+    Kwork[third_body_fwd_step_[j]]*=Cmult;
+    if(likely(third_body_rev_step_[j] >= 0))
+      {Kwork[third_body_rev_step_[j]]*=Cmult;}
+  }
+}
 
-    if(falloffRxnList[j].falloffType == TROE_THREE_PARAMS ||
-       falloffRxnList[j].falloffType == TROE_FOUR_PARAMS) {
+// Update the falloff terms that depend only on temperature: the low pressure
+// rate constant, the Troe center broadening factor and the SRI temperature
+// terms. The first two are interpolated instead when Ttabulated is set.
+void rate_const::updateFalloffTemperatureTerms(rate_const_workspace &ws) const
+{
+  int j;
+  const double Tcurrent = ws.Tcurrent;
+  const double invTcurrent = ws.invTcurrent;
+  if(!ws.Ttabulated) {
+    getFalloffLogKlow(ws.log_e_Tcurrent,invTcurrent,&ws.falloff_klow[0]);
+    fast_vec_exp(&ws.falloff_klow[0], nFalloffRxn);
+    getTroeLog10Fcenter(Tcurrent,invTcurrent,ws.troe_log10_fcenter.data());
+  }
 
-      // Troe 3 and 4-parameter fits
-      Fcenter = 0.0;
-      if(falloffRxnList[j].param[4]!=0) {
-        Fcenter += (1.0-falloffRxnList[j].param[3])
-                   *exp(-Tcurrent/falloffRxnList[j].param[4]);
-      }
-      if(falloffRxnList[j].param[5]!=0) {
-        Fcenter+=falloffRxnList[j].param[3]
-                 *exp(-Tcurrent/falloffRxnList[j].param[5]);
-      }
+  const int num_troe = falloff_type_start_[SRI]-
+                       falloff_type_start_[TROE_THREE_PARAMS];
+  for(j=0; j<num_troe; ++j) {
+    ws.troe_n_term[j] = 0.75-1.27*ws.troe_log10_fcenter[j];
+    ws.troe_c_term[j] = 0.4+0.67*ws.troe_log10_fcenter[j];
+  }
 
-      // Below are the special TROE alterations that were present
-      // in JY Chen's version of chemkin II.  They are no longer used
-      // because in one case, when alpha is less than zero, is actually used
-      // in the full TROE form for the reaction C2H4+H(+M)<=>C2H5(+M)
-      // reported by Miller and Klippenstein, Phys Chem Chem Phys, vol 6,
-      // 1192-1202, 2004.
-      //
-      //if(falloffRxnList[j].param[4] < 0.0) {
-      //  // Fcenter = T***
-      //  Fcenter = -falloffRxnList[j].param[4];
-      //}
-      //
-      //if(falloffRxnList[j].param[3] < 0.0) {
-      //  // Fcenter = |alpha| + T*(T***)
-      //	Fcenter = fabs(falloffRxnList[j].param[3])
-      //            +falloffRxnList[j].param[4]*Tcurrent;
-      //}
-
-      if(falloffRxnList[j].falloffType ==  TROE_FOUR_PARAMS) {
-        // 4-parameter Troe
-        Fcenter += exp(-falloffRxnList[j].param[6]*invTcurrent);
-      }
+  // SRI fits
+  //   F = d*(a*exp(-b/T) + exp(-T/c))**X * T**e
+  // with d = 1 and e = 0 for the standard 3-term definition. Note that the
+  // 4-term SRI function is not supported by Cantera or Chemkin II.
+  const int num_sri = nFalloffRxn-falloff_type_start_[SRI];
+  for(j=0; j<num_sri; ++j) {
+    ws.sri_base[j] = sri_a_[j]*exp(-sri_b_[j]*invTcurrent);
+    if(sri_inv_c_[j] > 0) {
+      ws.sri_base[j] += exp(-Tcurrent*sri_inv_c_[j]);
+    }
+    ws.sri_t_mult[j] = 1.0;
+    if(sri_e_[j] != 0.0) {
+      ws.sri_t_mult[j] = pow(Tcurrent, sri_e_[j]);
+    }
+  }
+}
 
-      // use original formulation
-      if(Fcenter < 1.0e-300) {
-        Fcenter = 1.0e-300;
-      }
-      fTerm=log10(Fcenter);
-      nTerm=0.75-1.27*fTerm;
-      log_10_Pr-=(0.4+0.67*fTerm);                // log10(Pr) + c
-      log_10_Pr=log_10_Pr/(nTerm-0.14*log_10_Pr); // d = 0.14
-      log_10_Pr*=log_10_Pr;
-      fTerm/=(1.0+log_10_Pr);
-      fTerm=pow(10.0,fTerm);
-    // end if Troe 3 and 4 parameter falloff reactions
-    } else if(falloffRxnList[j].falloffType == SRI) {
-
-      // Note falloffRxnList[j].param[0-2] are the Klow/Khigh arrhenius
-      // parameters.
-      //
-      const double a = falloffRxnList[j].param[3];
-      const double b = falloffRxnList[j].param[4];
-      const double inv_c = falloffRxnList[j].param[5];
-      const double x_power = 1.0/(1.0+log_10_Pr*log_10_Pr);
-
-      // Standard 3-term SRI definition
-      //   F = (a*exp(-b/T) + exp(-T/c))**X
-      fTerm = a*exp(-b*invTcurrent);
-      if(inv_c > 0) {
-        fTerm += exp(-Tcurrent*inv_c);
-      }
-      fTerm = pow(fTerm, x_power);
-
-      // Auxillary 4 and 5-term SRI definitions
-      //   F = d*(a*exp(-b/T) + exp(-T/c))**X         (4-term)
-      //   F = d*(a*exp(-b/T) + exp(-T/c))**X * T**e  (5-term)
-      // Note that the 4-term SRI function is not supported by Cantera
-      // or Chemkin II.
-      if(falloffRxnList[j].param.size() >= 7) {
-        fTerm *= falloffRxnList[j].param[6];  // pre-multiplier 'd'
-      }
-      if(falloffRxnList[j].param.size() == 8) {
-        fTerm *= pow(Tcurrent, falloffRxnList[j].param[7]); // multiplier T**e
-      }
+void rate_const::getFalloffLogKlow(const double log_e_T,
+                                   const double inv_T,
+                                   double log_klow[]) const
+{
+  for(int j=0; j<nFalloffRxn; ++j) {
+    log_klow[j] = falloff_log_a_low_[j]+
+                  falloff_tpow_low_[j]*log_e_T-
+                  falloff_tact_low_[j]*inv_T;
+  }
+}
+
+// Troe 3 and 4-parameter fits, the 4-parameter fits are last in the group
+void rate_const::getTroeLog10Fcenter(const double T,
+                                     const double inv_T,
+                                     double log10_fcenter[]) const
+{
+  double Fcenter;
+  const int num_troe = falloff_type_start_[SRI]-
+                       falloff_type_start_[TROE_THREE_PARAMS];
+  const int troe_four_start = falloff_type_start_[TROE_FOUR_PARAMS]-
+                              falloff_type_start_[TROE_THREE_PARAMS];
+  for(int j=0; j<num_troe; ++j) {
+    Fcenter = 0.0;
+    if(troe_t3_[j]!=0) {
+      Fcenter += (1.0-troe_alpha_[j])*exp(-T/troe_t3_[j]);
+    }
+    if(troe_t1_[j]!=0) {
+      Fcenter += troe_alpha_[j]*exp(-T/troe_t1_[j]);
+    }
+    if(j >= troe_four_start) {
+      Fcenter += exp(-troe_t2_[j]*inv_T);
+    }
+    if(Fcenter < 1.0e-300) {
+      Fcenter = 1.0e-300;
+    }
+    log10_fcenter[j] = log10(Fcenter);
+  }
+}
+
+// d(log10(Fcenter))/dT of a Troe reaction, zero where Fcenter is clipped
+double rate_const::getTroeLog10FcenterDerivative(const int troe_id,
+                                                 const double T,
+                                                 const double inv_T) const
+{
+  const int troe_four_start = falloff_type_start_[TROE_FOUR_PARAMS]-
+                              falloff_type_start_[TROE_THREE_PARAMS];
+  double Fcenter = 0.0;
+  double dFcenter_dT = 0.0;
+  if(troe_t3_[troe_id]!=0) {
+    const double term = (1.0-troe_alpha_[troe_id])*exp(-T/troe_t3_[troe_id]);
+    Fcenter += term;
+    dFcenter_dT -= term/troe_t3_[troe_id];
+  }
+  if(troe_t1_[troe_id]!=0) {
+    const double term = troe_alpha_[troe_id]*exp(-T/troe_t1_[troe_id]);
+    Fcenter += term;
+    dFcenter_dT -= term/troe_t1_[troe_id];
+  }
+  if(troe_id >= troe_four_start) {
+    const double term = exp(-troe_t2_[troe_id]*inv_T);
+    Fcenter += term;
+    dFcenter_dT += term*troe_t2_[troe_id]*inv_T*inv_T;
+  }
+  if(Fcenter < 1.0e-300) {
+    return 0.0;
+  }
+  return dFcenter_dT/(Fcenter*log(10.0));
+}
+
+void rate_const::updateFalloffRxn(const double C[],
+                                  rate_const_workspace &ws) const
+{
+  int j;
+  double log_10_Pr,fTerm;
+  if(nFalloffRxn == 0) {
+    return;
+  }
+  if(ws.Tchanged) {
+    updateFalloffTemperatureTerms(ws);
+  }
+  double *Kwork = &ws.Kwork[0];
+
+  multiplyEnhancedSparse(nFalloffRxn,
+                         &falloff_row_start_[0],
+                         falloff_spc_idx_.data(),
+                         falloff_eff_.data(),
+                         &falloff_csum_coef_[0],
+                         ws.Csum,
+                         C,
+                         &ws.falloff_cmult[0]);
+
+  for(j=0; j<nFalloffRxn; ++j) {
+    double Pr = ws.falloff_klow[j]*ws.falloff_cmult[j]/Kwork[falloff_fwd_step_[j]];
+    if(Pr < 1.0e-300) {
+      Pr = 1.0e-300; // ck SMALL constant
     }
+    ws.falloff_pr[j] = Pr;
+  }
 
-    Pcorr = fTerm*Pr/(1.0+Pr);
+  // The falloff_cmult array is reused below to hold the correction
+  // Pcorr = F*Pr/(1+Pr), where F = 1 for Lindemann falloff.
+  for(j=falloff_type_start_[LINDEMANN];
+      j<falloff_type_start_[TROE_THREE_PARAMS]; ++j) {
+    ws.falloff_cmult[j] = ws.falloff_pr[j]/(1.0+ws.falloff_pr[j]);
+  }
 
-    Kwork[falloffRxnList[j].fwdStepIdx]*=Pcorr;
-    if(likely(falloffRxnList[j].revStepIdx >= 0))
-      {Kwork[falloffRxnList[j].revStepIdx]*=Pcorr;}
+  // Below are the special TROE alterations that were present
+  // in JY Chen's version of chemkin II.  They are no longer used
+  // because in one case, when alpha is less than zero, is actually used
+  // in the full TROE form for the reaction C2H4+H(+M)<=>C2H5(+M)
+  // reported by Miller and Klippenstein, Phys Chem Chem Phys, vol 6,
+  // 1192-1202, 2004.
+  //
+  //if(T*** < 0.0) {
+  //  // Fcenter = T***
+  //  Fcenter = -T***;
+  //}
+  //
+  //if(alpha < 0.0) {
+  //  // Fcenter = |alpha| + T*(T***)
+  //  Fcenter = fabs(alpha)+T***Tcurrent;
+  //}
+  const int troe_start = falloff_type_start_[TROE_THREE_PARAMS];
+  for(j=troe_start; j<falloff_type_start_[SRI]; ++j) {
+    const int troe_id = j-troe_start;
+    log_10_Pr=log10(ws.falloff_pr[j]);
+    log_10_Pr-=ws.troe_c_term[troe_id];                      // log10(Pr) + c
+    log_10_Pr=log_10_Pr/(ws.troe_n_term[troe_id]-0.14*log_10_Pr); // d = 0.14
+    log_10_Pr*=log_10_Pr;
+    fTerm=ws.troe_log10_fcenter[troe_id]/(1.0+log_10_Pr);
+    fTerm=pow(10.0,fTerm);
+    ws.falloff_cmult[j] = fTerm*ws.falloff_pr[j]/(1.0+ws.falloff_pr[j]);
+  }
+
+  const int sri_start = falloff_type_start_[SRI];
+  for(j=sri_start; j<nFalloffRxn; ++j) {
+    const int sri_id = j-sri_start;
+    log_10_Pr=log10(ws.falloff_pr[j]);
+    const double x_power = 1.0/(1.0+log_10_Pr*log_10_Pr);
+    fTerm = pow(ws.sri_base[sri_id], x_power);
+    fTerm *= sri_d_[sri_id];       // pre-multiplier 'd'
+    fTerm *= ws.sri_t_mult[sri_id];  // multiplier T**e
+    ws.falloff_cmult[j] = fTerm*ws.falloff_pr[j]/(1.0+ws.falloff_pr[j]);
+  }
+
+  for(j=0; j<nFalloffRxn; ++j) {
+    const double Pcorr = ws.falloff_cmult[j];
+    Kwork[falloff_fwd_step_[j]]*=Pcorr;
+    if(likely(falloff_rev_step_[j] >= 0))
+      {Kwork[falloff_rev_step_[j]]*=Pcorr;}
   }
 }
 
@@ -1001,9 +1890,9 @@ void rate_const::getKrxn(info_net &netobj, double Kfwd[],
   for(j=0; j<nStep; j++)
     {
       if(netobj.getRxnDirOfStep(j)==1)
-	{Kfwd[netobj.getRxnIdxOfStep(j)]=Kwork[j];}
+	{Kfwd[netobj.getRxnIdxOfStep(j)]=work_->Kwork[j];}
       else
-	{Krev[netobj.getRxnIdxOfStep(j)]=Kwork[j];}
+	{Krev[netobj.getRxnIdxOfStep(j)]=work_->Kwork[j];}
     }
 }
 
@@ -1044,14 +1933,13 @@ int rate_const::getThirdBodyEff(ckr::CKReader &ckrobj, int rxnId,
 
 int rate_const::spcIdxOfString(ckr::CKReader &ckrobj, string spcName)
 {
-  int j;
-
-  for(j=0; j<nSpc; j++)
-    {
-      if(ckrobj.species[j].name == spcName)
-	{return j;}
-    }
-  return MIN_INT32;
+  // the species index is stored with the species data by the mechanism,
+  // species that are not in the mechanism keep the default index of -1
+  ckr::speciesTable::const_iterator iter = ckrobj.speciesData.find(spcName);
+  if(iter == ckrobj.speciesData.end() || iter->second.index < 0 ||
+     iter->second.index >= nSpc)
+    {return MIN_INT32;}
+  return iter->second.index;
 }
 void rate_const::print()
 {
@@ -1161,21 +2049,25 @@ void rate_const::setPLogInterpolationStepList(ckr::CKReader &ckrobj,
                                                  false)); // use_extrapolate
 
       plogInterpolationStepList.push_back(current_reaction);
+      plog_a_conversion_.push_back(pow(convertC,
+        (1.0-netobj.getRealOrderOfStep(step_id))));
     }
   }
 }
 
 void rate_const::updatePLogInterpolationStep(const double pressure,
-                                             const double log_e_pressure)
+                                             const double log_e_pressure,
+                                             rate_const_workspace &ws) const
 {
   for(int j=0; j<nPLogInterpolationStep; ++j) {
 
-   Kwork[plogInterpolationStepList[j].step_index()] =
-     plogInterpolationStepList[j].GetRateCoefficientFromTP(Tcurrent,
-                                                           invTcurrent,
-                                                           log_e_Tcurrent,
+   ws.Kwork[plogInterpolationStepList[j].step_index()] =
+     plogInterpolationStepList[j].GetRateCoefficientFromTP(ws.Tcurrent,
+                                                           ws.invTcurrent,
+                                                           ws.log_e_Tcurrent,
                                                            pressure,
-                                                           log_e_pressure);
+                                                           log_e_pressure,
+                                                           &ws.plog_range_id[j]);
 
   }
 }
@@ -2,6 +2,7 @@
 #define ZERORK_RATE_CONST_H
 
 #include <string.h>
+#include <memory>
 #include <vector>
 #include "../CKconverter/CKReader.h"
 #include "info_net.h"
@@ -64,6 +65,76 @@ typedef struct
 } falloffRxn;
 
 
+// Table of the temperature dependent terms of the rate constants on a
+// uniform temperature grid. Each row holds, for one grid temperature, the
+// natural log of the distinct Arrhenius rate constants, of the equilibrium
+// constants of the steps computed from Keq and of the low pressure falloff
+// rate constants, followed by log10(Fcenter) of the Troe falloff reactions.
+// A table is not modified after it is built, so the same table can be used
+// by any number of rate_const objects for the same mechanism.
+typedef struct
+{
+  double minTemperature;      // interpolation range
+  double maxTemperature;
+  double deltaTemperature;    // grid spacing
+  double invDeltaTemperature;
+  int numIntervals;           // grid is minTemperature + (i-1)*deltaTemperature
+  int numPoints;              // for i = 0,...,numIntervals+2
+  int numColumns;
+  int numExpColumns;          // leading columns stored as natural logs
+  double maxRelativeError;    // largest measured error of an interpolated
+                              // term relative to its exact value
+  std::vector<double> values; // numPoints x numColumns, row major
+} rateConstTable;
+
+// Work arrays of one rate constant evaluation. The temperature dependent
+// terms are kept for the last temperature evaluated, Tcurrent, and are only
+// recomputed when the temperature changes. A rate_const object has its own
+// workspace for the updateK functions without a workspace argument;
+// threads that share a rate_const object each need a workspace from
+// rate_const::createWorkspace.
+class rate_const_workspace
+{
+ public:
+  rate_const_workspace();
+  ~rate_const_workspace();
+
+  std::vector<double> Kwork;    // length nStep
+  std::vector<double> Gibbs_RT; // length nSpc
+  std::vector<double> Enthalpy_RT; // length nSpc, for the derivatives
+
+  double Csum;
+  bool Tchanged;
+  bool Ttabulated; // temperature terms of Tcurrent are from the table
+  double Tcurrent;
+  double log_e_Tcurrent;
+  double invTcurrent;
+  double log_e_PatmInvRuT;
+  int parametersVersion; // of the rate_const when Tcurrent was evaluated
+
+  // 32 byte aligned for fast_vec_exp
+  int arrWorkSize;
+  double *arrWorkArray;
+  double *keqWorkArray;
+
+  std::vector<double> third_body_cmult;
+  // temperature only terms
+  std::vector<double> falloff_klow;
+  std::vector<double> troe_c_term;  // 0.4 + 0.67*log10(Fcenter)
+  std::vector<double> troe_n_term;  // 0.75 - 1.27*log10(Fcenter)
+  std::vector<double> troe_log10_fcenter;
+  std::vector<double> sri_base;     // a*exp(-b/T) + exp(-T/c)
+  std::vector<double> sri_t_mult;   // T**e
+  // concentration dependent work arrays
+  std::vector<double> falloff_cmult;
+  std::vector<double> falloff_pr;
+  // last bounded pressure range of each PLOG reaction
+  std::vector<int> plog_range_id;
+
+ private:
+  rate_const_workspace(const rate_const_workspace&);
+  rate_const_workspace& operator=(const rate_const_workspace&);
+};
 
 int isSameArrheniusTol(arrheniusSortElem x, arrheniusSortElem y);
 int compareArrhenius(const void *x, const void *y); 
@@ -81,7 +152,40 @@ class rate_const
   void updateK_TCM(const double T, const double C[], 
                    const double C_mix, double Kcopy[]);
   void updateKExplicit(const double T, const double C[], double Kcopy[]);
-  double * getKptr() const {return &Kwork[0];}
+  double * getKptr() const {return &work_->Kwork[0];}
+  // Same as updateK(T,C,Kcopy) using the work arrays in work instead of the
+  // ones of this object, so any number of threads with their own workspace
+  // can evaluate the rate constants at the same time. The rate constant
+  // parameters and the temperature table must not be changed meanwhile.
+  std::unique_ptr<rate_const_workspace> createWorkspace() const;
+  void updateK(const double T,
+               const double C[],
+               double Kcopy[],
+               rate_const_workspace *work) const;
+  // Rate constants of updateK(T,C,Kcopy,work) and their derivatives.
+  // dKdT[j] is the derivative of the rate constant of step j with respect
+  // to temperature at constant concentrations, which includes the change of
+  // the PLOG pressure p = Csum*Ru*T. The third body, falloff and PLOG steps
+  // also depend on the concentrations:
+  //
+  //   dK[j]/dC[k] = dKdCsum[j] + sum of dKdC[m] over the concentration
+  //                 terms m of step j and species k
+  //
+  // where dKdC has one value for each term of getConcentrationTerms, and
+  // dKdCsum is zero for the other steps. The derivatives are those of the
+  // exact rate constants, also when the temperature table is used.
+  void updateKDerivatives(const double T,
+                          const double C[],
+                          double Kcopy[],
+                          double dKdT[],
+                          double dKdCsum[],
+                          double dKdC[],
+                          rate_const_workspace *work) const;
+  // Step and species of each enhanced third body term of the third body and
+  // falloff steps, for the forward and reverse step of each reaction
+  int getNumConcentrationTerms() const
+  {return static_cast<int>(concentration_term_step_.size());}
+  void getConcentrationTerms(int step_id[], int species_id[]) const;
   void getKrxn(info_net &netobj, double Kfwd[], double Krev[]);
   int getNumSpecies() const {return nSpc;}
   void print();
@@ -95,24 +199,96 @@ class rate_const
   void setExArrhFunc(external_func_arrh_t fn_handle) { ex_func_calc_arrh = fn_handle; };
   void setExKeqFunc(external_func_keq_t fn_handle) { ex_func_calc_keq = fn_handle; };
 
+  // Build a rateConstTable over [min_temperature, max_temperature]. The grid
+  // is refined until the interpolated terms are within rtol of their exact
+  // values, measured at the midpoint of every interval, or until the table
+  // would exceed max_points rows.
+  std::shared_ptr<const rateConstTable>
+    buildTemperatureTable(const double min_temperature,
+                          const double max_temperature,
+                          const double rtol,
+                          const int max_points);
+  // Interpolate the temperature dependent terms from table when the
+  // temperature is inside its range. Returns false, and leaves the exact
+  // evaluation in place, if the table was built for a different mechanism.
+  bool setTemperatureTable(std::shared_ptr<const rateConstTable> table);
+  void unsetTemperatureTable();
+  std::shared_ptr<const rateConstTable> getTemperatureTable() const
+  {return temperature_table_;}
+
+  // Kinetic parameters of a step in the units of the mechanism file: the
+  // pre-exponential factor in mol, cm^3 and s and the activation energy in
+  // the energy units of the mechanism file. The falloff functions are
+  // identified by the forward step of the reaction. The setters change the
+  // rate constants of this object only, and unset the temperature table
+  // since its values no longer apply. Each returns false if the step does
+  // not have the parameters.
+  bool getArrheniusParameters(const int step_id,
+                              double *A,
+                              double *Tpow,
+                              double *Eact) const;
+  bool setArrheniusParameters(const int step_id,
+                              const double A,
+                              const double Tpow,
+                              const double Eact);
+  bool getFalloffLowParameters(const int fwd_step_id,
+                               double *A,
+                               double *Tpow,
+                               double *Eact) const;
+  bool setFalloffLowParameters(const int fwd_step_id,
+                               const double A,
+                               const double Tpow,
+                               const double Eact);
+  // Troe (alpha, T***, T*[, T**]) or SRI (a, b, c[, d, e]) parameters, the
+  // number of parameters of a reaction can not be changed
+  bool getFalloffParameters(const int fwd_step_id,
+                            std::vector<double> *params) const;
+  bool setFalloffParameters(const int fwd_step_id,
+                            const std::vector<double> &params);
+  // PLOG lines are ordered by pressure [atm]; returns -1 for a step that is
+  // not a PLOG reaction
+  int getNumPLogLines(const int step_id) const;
+  bool getPLogParameters(const int step_id,
+                         const int line_id,
+                         double *pressure,
+                         double *A,
+                         double *Tpow,
+                         double *Eact) const;
+  bool setPLogParameters(const int step_id,
+                         const int line_id,
+                         const double A,
+                         const double Tpow,
+                         const double Eact);
+
  protected:
  
   int nSpc;
   int nStep;
   int cpySize;
-  double *Kwork;    // length nStep
-  double *Gibbs_RT; // length nSpc 
 
   double convertE;
   double convertC;
 
-  double Csum;
-  bool Tchanged;
-  double Tcurrent;
-  double log_e_Tcurrent;
-  double invTcurrent;
-  double log_e_PatmInvRuT;
-  void updateTcurrent(double const T);
+  std::unique_ptr<rate_const_workspace> work_;
+  // incremented when the temperature dependent terms of the workspaces are
+  // no longer valid
+  int parameters_version_;
+  void computeK(const double T,
+                const double C[],
+                rate_const_workspace &ws) const;
+  // rate constants before the third body and falloff corrections
+  void computeBaseK(const double T, rate_const_workspace &ws) const;
+  void updateTcurrent(double const T, rate_const_workspace &ws) const;
+
+  std::shared_ptr<const rateConstTable> temperature_table_;
+  int getNumTemperatureTableColumns() const;
+  void getTemperatureTableRow(const double T, double row[]) const;
+  void interpolateTemperatureTable(const rateConstTable &table,
+                                   const double T,
+                                   const int start_column,
+                                   const int num_columns,
+                                   double values[]) const;
+  void updateFromTemperatureTable(rate_const_workspace &ws) const;
 
   // sizes of temperature based terms
   int nArrheniusStep;   
@@ -128,19 +304,97 @@ class rate_const
   void setRxnCount_Ptype(ckr::CKReader &ckrobj);
   thirdBodyRxn *thirdBodyRxnList;
   void setThirdBodyRxnList(ckr::CKReader &ckrobj, info_net &netobj);
-  void updateThirdBodyRxn(const double C[]);
+  void updateThirdBodyRxn(const double C[], rate_const_workspace &ws) const;
   int spcIdxOfString(ckr::CKReader &ckrobj, string spcName);
   int getThirdBodyEff(ckr::CKReader &ckrobj, int rxnId, vector <int> &spcId,
 		      vector <double> &spcEff);
   falloffRxn *falloffRxnList;
   void setFalloffRxnList(ckr::CKReader &ckrobj, info_net &netobj);
-  void updateFalloffRxn(const double C[]);
+  // pre-exponential factor of the low pressure limit in the internal units
+  // per unit in the mechanism file, for each reaction in falloffRxnList
+  std::vector<double> falloff_a_low_conversion_;
+  int getFalloffRxnIdx(const int fwd_step_id) const;
+  void parametersChanged();
+  void updateFalloffRxn(const double C[], rate_const_workspace &ws) const;
   int isNonStandardTroe(const int falloffId, const int rxnId) const;
 
+  // Contiguous (structure of arrays) copies of the third body and falloff
+  // reaction lists used by updateThirdBodyRxn and updateFalloffRxn. The
+  // effective third body concentration of each reaction is
+  //
+  //   Cmult = csum_coef*Csum + sum_k eff[k]*C[spc_idx[k]]
+  //
+  // stored as a CSR matrix with one row per reaction. A single falloff
+  // species (+X) is a row with a zero Csum coefficient and one entry. The
+  // falloff reactions are grouped by FalloffReactionType so each group is
+  // evaluated in its own branch-free loop, and the terms that depend only
+  // on temperature (Klow, the Troe center broadening, the SRI temperature
+  // terms) are only recomputed when Tchanged is set.
+  void setPressureRxnArrays();
+  void multiplyEnhancedSparse(const int num_rows,
+                              const int row_start[],
+                              const int spc_idx[],
+                              const double eff[],
+                              const double csum_coef[],
+                              const double Csum,
+                              const double C[],
+                              double Cmult[]) const;
+  void updateFalloffTemperatureTerms(rate_const_workspace &ws) const;
+  void getFalloffLogKlow(const double log_e_T,
+                         const double inv_T,
+                         double log_klow[]) const;
+  void getTroeLog10Fcenter(const double T,
+                           const double inv_T,
+                           double log10_fcenter[]) const;
+  double getTroeLog10FcenterDerivative(const int troe_id,
+                                       const double T,
+                                       const double inv_T) const;
+
+  std::vector<int> third_body_fwd_step_;
+  std::vector<int> third_body_rev_step_;
+  std::vector<int> third_body_row_start_;
+  std::vector<int> third_body_spc_idx_;
+  std::vector<double> third_body_eff_;
+  std::vector<double> third_body_csum_coef_;
+
+  // falloff arrays are ordered by type, group t is in
+  // [falloff_type_start_[t], falloff_type_start_[t+1])
+  int falloff_type_start_[SRI+2];
+  std::vector<int> falloff_fwd_step_;
+  std::vector<int> falloff_rev_step_;
+  std::vector<int> falloff_row_start_;
+  std::vector<int> falloff_spc_idx_;
+  std::vector<double> falloff_eff_;
+  std::vector<double> falloff_csum_coef_;
+  std::vector<double> falloff_log_a_low_;
+  std::vector<double> falloff_tpow_low_;
+  std::vector<double> falloff_tact_low_;
+  // Troe parameters alpha, T***, T*, T** (zero for three parameter Troe)
+  std::vector<double> troe_alpha_;
+  std::vector<double> troe_t3_;
+  std::vector<double> troe_t1_;
+  std::vector<double> troe_t2_;
+  // SRI parameters a, b, 1/c (negative if c <= 0), d and e (1 and 0 for the
+  // standard three parameter form)
+  std::vector<double> sri_a_;
+  std::vector<double> sri_b_;
+  std::vector<double> sri_inv_c_;
+  std::vector<double> sri_d_;
+  std::vector<double> sri_e_;
+
+  // enhanced third body terms of updateKDerivatives: the third body
+  // reactions followed by the falloff reactions, each entry of a row of the
+  // CSR arrays for the forward step then for the reverse step
+  std::vector<int> concentration_term_step_;
+  std::vector<int> concentration_term_species_;
+
   std::vector<PLogReaction> plogInterpolationStepList; 
+  std::vector<double> plog_a_conversion_;
+  int getPLogIdx(const int step_id) const;
   void setPLogInterpolationStepList(ckr::CKReader &ckrobj, info_net &netobj);
   void updatePLogInterpolationStep(const double pressure, 
-                                   const double log_e_pressure);
+                                   const double log_e_pressure,
+                                   rate_const_workspace &ws) const;
 
   // 
   int nDistinctArrhenius;
@@ -149,14 +403,24 @@ class rate_const
   double *distinctArrheniusTpow;
   double *distinctArrheniusTact;
   double *arrheniusCoeffs;
-  double *arrWorkArray;
-  double *keqWorkArray;
+  // arrheniusStepList position of each step (-1 for other steps) and the
+  // pre-exponential factor in the internal units per unit in the mechanism
+  // file, for each position
+  std::vector<int> step_arrhenius_pos_;
+  std::vector<double> arrhenius_a_conversion_;
+  void addDistinctArrhenius();
   void setArrheniusStepList(ckr::CKReader *ckrobj, info_net *netobj);
-  void updateArrheniusStep();
+  void updateArrheniusStep(rate_const_workspace &ws) const;
 
   fromKeqStep *fromKeqStepList;
   void setFromKeqStepList(ckr::CKReader &ckrobj, info_net &netobj);
-  void updateFromKeqStep();
+  void updateFromKeqStep(rate_const_workspace &ws) const;
+  void getLogKeq(const double log_e_PatmInvRuT_in,
+                 const double Gibbs_RT[],
+                 double log_keq[]) const;
+  // products - reactants of a species property of the step computed from Keq
+  double getThermoChangeOfKeqStep(const int keq_id,
+                                  const double thermo[]) const;
 
   nasa_poly_group *thermoPtr;
 
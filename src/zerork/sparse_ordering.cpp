@@ -0,0 +1,239 @@
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm> // std::sort, std::fill
+#include <set>
+#include <utility>   // std::pair
+
+#include "sparse_ordering.h"
+
+namespace zerork {
+
+static inline int PopCount(uint64_t word)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountll(word);
+#else
+  int count = 0;
+  for(; word != 0; word &= word-1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+static inline int TrailingZeros(const uint64_t word)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  int count = 0;
+  while(((word >> count) & 1) == 0) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+namespace {
+
+// Pattern of A + A^T without the diagonal, with one row of bits per node.
+// Eliminating a node sets its neighbors pairwise adjacent, which is a word
+// wise OR of rows, so building the elimination graph costs O(n^2/64) per
+// eliminated clique rather than the merge of the adjacency lists.
+class EliminationGraph
+{
+ public:
+  EliminationGraph(const int num_rows,
+                   const int column_sums[],
+                   const int row_indexes[])
+    :
+      num_words_((num_rows+63)/64),
+      bits_(static_cast<size_t>(num_rows)*((num_rows+63)/64), 0)
+  {
+    for(int j=0; j<num_rows; ++j) {
+      for(int m=column_sums[j]; m<column_sums[j+1]; ++m) {
+        const int i = row_indexes[m];
+        if(i != j && i >= 0 && i < num_rows) {
+          Set(i, j);
+          Set(j, i);
+        }
+      }
+    }
+  }
+
+  int Degree(const int v) const
+  {
+    const uint64_t *row = Row(v);
+    int degree = 0;
+    for(int k=0; k<num_words_; ++k) {
+      degree += PopCount(row[k]);
+    }
+    return degree;
+  }
+
+  void Neighbors(const int v, std::vector<int> *neighbors) const
+  {
+    const uint64_t *row = Row(v);
+    neighbors->clear();
+    for(int k=0; k<num_words_; ++k) {
+      uint64_t word = row[k];
+      while(word != 0) {
+        neighbors->push_back(64*k + TrailingZeros(word));
+        word &= word-1;
+      }
+    }
+  }
+
+  // Removes v from the graph without connecting its neighbors
+  void Remove(const int v)
+  {
+    std::vector<int> neighbors;
+    Neighbors(v, &neighbors);
+    for(size_t k=0; k<neighbors.size(); ++k) {
+      Clear(neighbors[k], v);
+    }
+    std::fill(Row(v), Row(v)+num_words_, 0);
+  }
+
+  // Removes v from the graph after connecting its neighbors pairwise,
+  // clique returns the neighbors of v
+  void Eliminate(const int v, std::vector<int> *clique)
+  {
+    Neighbors(v, clique);
+    const uint64_t *row_v = Row(v);
+    for(size_t k=0; k<clique->size(); ++k) {
+      const int u = (*clique)[k];
+      uint64_t *row_u = Row(u);
+      for(int m=0; m<num_words_; ++m) {
+        row_u[m] |= row_v[m];
+      }
+      Clear(u, u);
+      Clear(u, v);
+    }
+    std::fill(Row(v), Row(v)+num_words_, 0);
+  }
+
+ private:
+  uint64_t *Row(const int v)
+  {return &bits_[static_cast<size_t>(v)*num_words_];}
+  const uint64_t *Row(const int v) const
+  {return &bits_[static_cast<size_t>(v)*num_words_];}
+  void Set(const int v, const int u)
+  {Row(v)[u/64] |= (uint64_t(1) << (u%64));}
+  void Clear(const int v, const int u)
+  {Row(v)[u/64] &= ~(uint64_t(1) << (u%64));}
+
+  int num_words_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace
+
+void getMinimumDegreeOrdering(const int num_rows,
+                              const int column_sums[],
+                              const int row_indexes[],
+                              const int num_last,
+                              std::vector<int> *perm_c)
+{
+  perm_c->assign(num_rows > 0 ? num_rows : 0, 0);
+  if(num_rows <= 0) {
+    return;
+  }
+  const int num_free = num_rows - std::min(std::max(num_last, 0), num_rows);
+  const double dense_degree = std::max(16.0, 10.0*sqrt((double)num_rows));
+
+  EliminationGraph graph(num_rows, column_sums, row_indexes);
+
+  // remove the columns ordered last and the dense columns from the graph
+  std::vector<int> removed;
+  std::vector<std::pair<int, int> > dense_columns; // (degree, column)
+  for(int j=0; j<num_rows; ++j) {
+    const int degree = graph.Degree(j);
+    if(j >= num_free) {
+      removed.push_back(j);
+    } else if(degree > dense_degree) {
+      removed.push_back(j);
+      dense_columns.push_back(std::make_pair(degree, j));
+    }
+  }
+  std::vector<char> in_graph(num_rows, 1);
+  for(size_t k=0; k<removed.size(); ++k) {
+    graph.Remove(removed[k]);
+    in_graph[removed[k]] = 0;
+  }
+
+  // (degree, column) of the nodes left to eliminate, ties are broken by the
+  // original column index so the ordering is deterministic
+  std::set<std::pair<int, int> > queue;
+  std::vector<int> degree(num_rows, 0);
+  for(int j=0; j<num_rows; ++j) {
+    if(in_graph[j] != 0) {
+      degree[j] = graph.Degree(j);
+      queue.insert(std::make_pair(degree[j], j));
+    }
+  }
+
+  std::vector<int> order;
+  std::vector<int> clique;
+  order.reserve(num_rows);
+  while(!queue.empty()) {
+    if(queue.begin()->first + 1 == static_cast<int>(queue.size())) {
+      // the remaining nodes are a clique, any order has the same fill
+      for(std::set<std::pair<int, int> >::const_iterator iter=queue.begin();
+          iter != queue.end();
+          ++iter) {
+        order.push_back(iter->second);
+      }
+      break;
+    }
+    const int v = queue.begin()->second;
+    queue.erase(queue.begin());
+    order.push_back(v);
+    graph.Eliminate(v, &clique);
+    for(size_t k=0; k<clique.size(); ++k) {
+      const int u = clique[k];
+      queue.erase(std::make_pair(degree[u], u));
+      degree[u] = graph.Degree(u);
+      queue.insert(std::make_pair(degree[u], u));
+    }
+  }
+
+  std::sort(dense_columns.begin(), dense_columns.end());
+  for(size_t k=0; k<dense_columns.size(); ++k) {
+    order.push_back(dense_columns[k].second);
+  }
+  for(int j=num_free; j<num_rows; ++j) {
+    order.push_back(j);
+  }
+
+  for(int k=0; k<num_rows; ++k) {
+    (*perm_c)[order[k]] = k;
+  }
+}
+
+long long getSymbolicFactorNonzeros(const int num_rows,
+                                    const int column_sums[],
+                                    const int row_indexes[],
+                                    const int perm_c[])
+{
+  if(num_rows <= 0) {
+    return 0;
+  }
+  EliminationGraph graph(num_rows, column_sums, row_indexes);
+
+  std::vector<int> order(num_rows, 0);
+  for(int j=0; j<num_rows; ++j) {
+    order[perm_c[j]] = j;
+  }
+
+  std::vector<int> clique;
+  long long nonzeros = num_rows;
+  for(int k=0; k<num_rows; ++k) {
+    graph.Eliminate(order[k], &clique);
+    nonzeros += 2*static_cast<long long>(clique.size());
+  }
+  return nonzeros;
+}
+
+} // namespace zerork
@@ -0,0 +1,35 @@
+#ifndef ZERORK_SPARSE_ORDERING_H
+#define ZERORK_SPARSE_ORDERING_H
+
+#include <vector>
+
+namespace zerork {
+
+// Fill-reducing column ordering of a square matrix stored in compressed
+// column format (column_sums[num_rows+1], row_indexes[column_sums[num_rows]]).
+// The ordering is a minimum degree ordering of the pattern of A + A^T, and is
+// returned in the convention of SuperLU's perm_c: column j of A is column
+// perm_c[j] of A*Pc.
+//
+// Columns whose degree exceeds max(16, 10*sqrt(num_rows)) would couple
+// nearly every elimination clique, so they are removed from the graph and
+// ordered after the others by increasing degree. The last num_last columns
+// (e.g. temperature in a species + temperature state) are always ordered
+// last, in their original order.
+void getMinimumDegreeOrdering(const int num_rows,
+                              const int column_sums[],
+                              const int row_indexes[],
+                              const int num_last,
+                              std::vector<int> *perm_c);
+
+// Number of nonzeros in L+U (counting the diagonal once) of the symbolic
+// factorization of A + A^T with the columns and rows ordered by perm_c,
+// without pivoting.  Used to compare orderings.
+long long getSymbolicFactorNonzeros(const int num_rows,
+                                    const int column_sums[],
+                                    const int row_indexes[],
+                                    const int perm_c[]);
+
+} // namespace zerork
+
+#endif
@@ -0,0 +1,142 @@
+#include <vector>
+#include <cstdlib>
+#include <string>
+
+#include <zerork/mechanism.h>
+#include <zerork/sparse_ordering.h>
+
+#include <gtest/gtest.h>
+
+static const char MECH_FILENAME[]  = "mechanisms/ideal/non_integer_test.mech";
+static const char THERM_FILENAME[] = "mechanisms/ideal/const_specific_heat.therm";
+static const char PARSER_LOGNAME[] = "parser.log";
+
+static bool IsPermutation(const std::vector<int> &perm_c);
+
+// Compressed column pattern of an n x n arrow matrix: the diagonal plus a
+// full first row and first column
+static void ArrowPattern(const int n,
+                         std::vector<int> *column_sums,
+                         std::vector<int> *row_indexes);
+
+class JacobianOrderingTestFixture: public ::testing::Test
+{
+ public:
+  JacobianOrderingTestFixture() {
+    mechanism_ = NULL;
+    const char * ZERORK_DATA_DIR = std::getenv("ZERORK_DATA_DIR");
+    std::string load_mech(MECH_FILENAME);
+    std::string load_therm(THERM_FILENAME);
+    if(ZERORK_DATA_DIR == nullptr) {
+      load_mech = std::string("../../") + load_mech;
+      load_therm = std::string("../../") + load_therm;
+    } else {
+      load_mech = std::string(ZERORK_DATA_DIR) + "/" + load_mech;
+      load_therm = std::string(ZERORK_DATA_DIR) + "/" + load_therm;
+    }
+    mechanism_ = new zerork::mechanism(load_mech.c_str(),
+                                       load_therm.c_str(),
+                                       PARSER_LOGNAME);
+  }
+
+  ~JacobianOrderingTestFixture() {
+    if(mechanism_ != NULL) {
+      delete mechanism_;
+    }
+  }
+
+  zerork::mechanism *mechanism_;
+};
+
+TEST(SparseOrdering, ArrowMatrixHasNoFill)
+{
+  const int n = 40;
+  std::vector<int> column_sums, row_indexes, perm_c, natural(n);
+  ArrowPattern(n, &column_sums, &row_indexes);
+  for(int j=0; j<n; ++j) {
+    natural[j] = j;
+  }
+
+  zerork::getMinimumDegreeOrdering(n,
+                                   &column_sums[0],
+                                   &row_indexes[0],
+                                   0,
+                                   &perm_c);
+  ASSERT_TRUE(IsPermutation(perm_c));
+  // the hub of the arrow is eliminated with the last leaf
+  EXPECT_GE(perm_c[0], n-2);
+
+  const long long nnz = row_indexes.size();
+  EXPECT_EQ(nnz, zerork::getSymbolicFactorNonzeros(n,
+                                                   &column_sums[0],
+                                                   &row_indexes[0],
+                                                   &perm_c[0]));
+  // eliminating the dense column first fills the whole matrix
+  EXPECT_EQ((long long)n*n, zerork::getSymbolicFactorNonzeros(n,
+                                                              &column_sums[0],
+                                                              &row_indexes[0],
+                                                              &natural[0]));
+}
+
+TEST(SparseOrdering, LastColumnsKeepTheirPosition)
+{
+  const int n = 10;
+  std::vector<int> column_sums, row_indexes, perm_c;
+  ArrowPattern(n, &column_sums, &row_indexes);
+
+  zerork::getMinimumDegreeOrdering(n,
+                                   &column_sums[0],
+                                   &row_indexes[0],
+                                   2,
+                                   &perm_c);
+  ASSERT_TRUE(IsPermutation(perm_c));
+  EXPECT_EQ(n-2, perm_c[n-2]);
+  EXPECT_EQ(n-1, perm_c[n-1]);
+}
+
+TEST_F(JacobianOrderingTestFixture, TemperatureIsLast)
+{
+  ASSERT_TRUE(mechanism_ != NULL);
+  const int num_species = mechanism_->getNumSpecies();
+
+  std::vector<int> perm_c, perm_c_again;
+  mechanism_->getJacobianOrdering(&perm_c);
+  ASSERT_EQ(num_species+1, static_cast<int>(perm_c.size()));
+  EXPECT_TRUE(IsPermutation(perm_c));
+  EXPECT_EQ(num_species, perm_c[num_species]);
+
+  // stored with the mechanism
+  mechanism_->getJacobianOrdering(&perm_c_again);
+  EXPECT_EQ(perm_c, perm_c_again);
+}
+
+static bool IsPermutation(const std::vector<int> &perm_c)
+{
+  const int n = static_cast<int>(perm_c.size());
+  std::vector<int> count(n, 0);
+  for(int j=0; j<n; ++j) {
+    if(perm_c[j] < 0 || perm_c[j] >= n || count[perm_c[j]]++ != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void ArrowPattern(const int n,
+                         std::vector<int> *column_sums,
+                         std::vector<int> *row_indexes)
+{
+  column_sums->assign(1, 0);
+  row_indexes->clear();
+  for(int j=0; j<n; ++j) {
+    if(j == 0) {
+      for(int k=0; k<n; ++k) {
+        row_indexes->push_back(k);
+      }
+    } else {
+      row_indexes->push_back(0);
+      row_indexes->push_back(j);
+    }
+    column_sums->push_back(static_cast<int>(row_indexes->size()));
+  }
+}
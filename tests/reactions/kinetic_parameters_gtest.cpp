@@ -0,0 +1,358 @@
+#include <math.h>
+#include <vector>
+#include <cstdlib>
+#include <string>
+
+#include <zerork/mechanism.h>
+
+#include <gtest/gtest.h>
+
+// ---------------------------------------------------------------------------
+// test constants
+// ---------------------------------------------------------------------------
+static const double OK_DOUBLE = 1.0e-12; // acceptable relative tolerance
+
+// duplicate third body reactions with identical forward and reverse
+// parameters share their distinct Arrhenius expressions
+static const char SHARED_MECH_FILENAME[]  =
+  "mechanisms/ideal/hydrogen_no_falloff.mech";
+static const char H2_MECH_FILENAME[]  = "mechanisms/hydrogen/h2_v1b_mech.txt";
+static const char H2_THERM_FILENAME[] = "mechanisms/hydrogen/h2_v1a_therm.txt";
+static const char PLOG_MECH_FILENAME[]  = "mechanisms/ideal/plog_test.mech";
+static const char PLOG_THERM_FILENAME[] =
+  "mechanisms/ideal/const_specific_heat.therm";
+static const char PARSER_LOGNAME[] = "parser.log";
+
+// h+o2(+m) = ho2(+m) in h2_v1b_mech.txt
+static const int H2_FALLOFF_REACTION = 8;
+// PLOG reaction 3 in plog_test.mech has three lines at one atmosphere
+static const int PLOG_REACTION = 2;
+
+static const double TEST_TEMPERATURE = 1234.5;
+static const double TABLE_RTOL = 1.0e-6;
+
+static zerork::mechanism * LoadMechanism(const char mech_filename[],
+                                         const char therm_filename[]);
+static void GetRateConstants(zerork::mechanism *mech,
+                             const double temperature,
+                             const double pressure,
+                             std::vector<double> *k_forward,
+                             std::vector<double> *k_reverse);
+static double MaxRelativeDifference(const std::vector<double> &a,
+                                    const std::vector<double> &b);
+
+// ---------------------------------------------------------------------------
+// test fixture with an unchanged reference copy of each mechanism
+class KineticParametersTestFixture: public ::testing::Test
+{
+ public:
+  KineticParametersTestFixture( ) {
+    shared_reference_ = LoadMechanism(SHARED_MECH_FILENAME,
+                                      H2_THERM_FILENAME);
+    shared_mechanism_ = LoadMechanism(SHARED_MECH_FILENAME,
+                                      H2_THERM_FILENAME);
+    h2_reference_ = LoadMechanism(H2_MECH_FILENAME, H2_THERM_FILENAME);
+    h2_mechanism_ = LoadMechanism(H2_MECH_FILENAME, H2_THERM_FILENAME);
+    plog_reference_ = LoadMechanism(PLOG_MECH_FILENAME, PLOG_THERM_FILENAME);
+    plog_mechanism_ = LoadMechanism(PLOG_MECH_FILENAME, PLOG_THERM_FILENAME);
+  }
+
+  ~KineticParametersTestFixture( )  {
+    delete shared_reference_;
+    delete shared_mechanism_;
+    delete h2_reference_;
+    delete h2_mechanism_;
+    delete plog_reference_;
+    delete plog_mechanism_;
+  }
+
+  zerork::mechanism *shared_reference_;
+  zerork::mechanism *shared_mechanism_;
+  zerork::mechanism *h2_reference_;
+  zerork::mechanism *h2_mechanism_;
+  zerork::mechanism *plog_reference_;
+  zerork::mechanism *plog_mechanism_;
+};
+
+TEST_F (KineticParametersTestFixture, ArrheniusRoundTrip)
+{
+  const int num_reactions = h2_mechanism_->getNumReactions();
+  double A, Tpow, Eact;
+  // the first reaction h+o2 = o+oh has explicit reverse parameters
+  ASSERT_EQ(h2_mechanism_->getArrheniusParameters(0,1,&A,&Tpow,&Eact), 0);
+  EXPECT_NEAR(A, 1.915e14, 1.915e14*OK_DOUBLE);
+  EXPECT_EQ(Tpow, 0.0);
+  EXPECT_NEAR(Eact, 1.644e4, 1.644e4*OK_DOUBLE);
+  ASSERT_EQ(h2_mechanism_->getArrheniusParameters(0,-1,&A,&Tpow,&Eact), 0);
+  EXPECT_NEAR(A, 5.481e11, 5.481e11*OK_DOUBLE);
+  EXPECT_EQ(Tpow, 0.39);
+  EXPECT_NEAR(Eact, -2.930e2, 2.930e2*OK_DOUBLE);
+  // the reverse rate of the falloff reaction is computed from equilibrium
+  EXPECT_EQ(h2_mechanism_->getArrheniusParameters(H2_FALLOFF_REACTION,-1,
+                                                  &A,&Tpow,&Eact), -1);
+  EXPECT_EQ(h2_mechanism_->getArrheniusParameters(num_reactions,1,
+                                                  &A,&Tpow,&Eact), -1);
+
+  // setting the parameters read back leaves the rate constants unchanged
+  for(int j=0; j<num_reactions; ++j) {
+    for(int dir=1; dir>=-1; dir-=2) {
+      if(h2_mechanism_->getArrheniusParameters(j,dir,&A,&Tpow,&Eact) == 0) {
+        EXPECT_EQ(h2_mechanism_->setArrheniusParameters(j,dir,A,Tpow,Eact),
+                  0);
+      }
+    }
+  }
+  std::vector<double> kf_ref, kr_ref, kf, kr;
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  GetRateConstants(h2_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  EXPECT_LE(MaxRelativeDifference(kf_ref, kf), OK_DOUBLE);
+  EXPECT_LE(MaxRelativeDifference(kr_ref, kr), OK_DOUBLE);
+}
+
+TEST_F (KineticParametersTestFixture, SharedArrheniusSteps)
+{
+  const int num_reactions = shared_mechanism_->getNumReactions();
+  std::vector<double> kf_ref, kr_ref, kf, kr;
+  GetRateConstants(shared_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+
+  // doubling the pre-exponential factor of one step only changes that step,
+  // even when other steps have the same parameters
+  for(int j=0; j<num_reactions; ++j) {
+    for(int dir=1; dir>=-1; dir-=2) {
+      double A, Tpow, Eact;
+      if(shared_mechanism_->getArrheniusParameters(j,dir,&A,&Tpow,&Eact) != 0) {
+        continue;
+      }
+      ASSERT_EQ(shared_mechanism_->setArrheniusParameters(j,dir,2.0*A,Tpow,
+                                                          Eact), 0);
+      GetRateConstants(shared_mechanism_, TEST_TEMPERATURE, 1.01325e5,
+                       &kf, &kr);
+      const bool explicit_reverse =
+        (shared_mechanism_->getArrheniusParameters(j,-1,&A,&Tpow,&Eact) == 0);
+      for(int k=0; k<num_reactions; ++k) {
+        double kf_mult = 1.0;
+        double kr_mult = 1.0;
+        if(k == j && dir == 1) {
+          kf_mult = 2.0;
+          // the reverse rate from equilibrium follows the forward rate
+          kr_mult = (explicit_reverse ? 1.0 : 2.0);
+        } else if(k == j) {
+          kr_mult = 2.0;
+        }
+        EXPECT_NEAR(kf[k], kf_mult*kf_ref[k], kf_mult*kf_ref[k]*OK_DOUBLE)
+          << "forward rate constant of reaction " << k
+          << " after changing reaction " << j << " direction " << dir;
+        EXPECT_NEAR(kr[k], kr_mult*kr_ref[k], kr_mult*kr_ref[k]*OK_DOUBLE)
+          << "reverse rate constant of reaction " << k
+          << " after changing reaction " << j << " direction " << dir;
+      }
+      // restore the original parameters
+      ASSERT_EQ(shared_mechanism_->getArrheniusParameters(j,dir,&A,&Tpow,
+                                                          &Eact), 0);
+      ASSERT_EQ(shared_mechanism_->setArrheniusParameters(j,dir,0.5*A,Tpow,
+                                                          Eact), 0);
+    }
+  }
+  GetRateConstants(shared_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  EXPECT_LE(MaxRelativeDifference(kf_ref, kf), OK_DOUBLE);
+  EXPECT_LE(MaxRelativeDifference(kr_ref, kr), OK_DOUBLE);
+}
+
+TEST_F (KineticParametersTestFixture, ActivationEnergy)
+{
+  double A, Tpow, Eact;
+  ASSERT_EQ(h2_mechanism_->getArrheniusParameters(1,1,&A,&Tpow,&Eact), 0);
+  // the mechanism energy units are cal/mol
+  const double delta_Eact = 1000.0;
+  ASSERT_EQ(h2_mechanism_->setArrheniusParameters(1,1,A,Tpow+0.5,
+                                                  Eact+delta_Eact), 0);
+  std::vector<double> kf_ref, kr_ref, kf, kr;
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  GetRateConstants(h2_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  const double multiplier = sqrt(TEST_TEMPERATURE)*
+    exp(-delta_Eact*zerork::CAL_PER_MOL_TACT/TEST_TEMPERATURE);
+  EXPECT_NEAR(kf[1], multiplier*kf_ref[1], multiplier*kf_ref[1]*OK_DOUBLE);
+  EXPECT_NEAR(kr[1], kr_ref[1], kr_ref[1]*OK_DOUBLE);
+}
+
+TEST_F (KineticParametersTestFixture, Falloff)
+{
+  double A, Tpow, Eact;
+  ASSERT_EQ(h2_mechanism_->getFalloffLowParameters(H2_FALLOFF_REACTION,
+                                                   &A,&Tpow,&Eact), 0);
+  EXPECT_NEAR(A, 3.482e16, 3.482e16*OK_DOUBLE);
+  EXPECT_NEAR(Tpow, -0.411, 0.411*OK_DOUBLE);
+  EXPECT_NEAR(Eact, -1115.0, 1115.0*OK_DOUBLE);
+  EXPECT_EQ(h2_mechanism_->getFalloffLowParameters(0,&A,&Tpow,&Eact), -1);
+
+  std::vector<double> troe;
+  ASSERT_EQ(h2_mechanism_->getFalloffParameters(H2_FALLOFF_REACTION,&troe), 0);
+  ASSERT_EQ(troe.size(), 4);
+  EXPECT_EQ(troe[0], 0.5);
+  EXPECT_EQ(troe[1], 1.0e-30);
+  // the number of parameters can not change
+  EXPECT_EQ(h2_mechanism_->setFalloffParameters(H2_FALLOFF_REACTION,
+    std::vector<double>(troe.begin(),troe.begin()+3)), -1);
+
+  std::vector<double> kf_ref, kr_ref, kf, kr;
+  const double low_pressure = 1.0e-3;
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, low_pressure,
+                   &kf_ref, &kr_ref);
+  // in the low pressure limit the rate constant approaches Alow times a
+  // falloff function that depends only weakly on Alow
+  ASSERT_EQ(h2_mechanism_->setFalloffLowParameters(H2_FALLOFF_REACTION,
+                                                   2.0*A,Tpow,Eact), 0);
+  GetRateConstants(h2_mechanism_, TEST_TEMPERATURE, low_pressure, &kf, &kr);
+  EXPECT_NEAR(kf[H2_FALLOFF_REACTION]/kf_ref[H2_FALLOFF_REACTION], 2.0, 1.0e-2);
+  EXPECT_NEAR(kr[H2_FALLOFF_REACTION]/kr_ref[H2_FALLOFF_REACTION], 2.0, 1.0e-2);
+
+  troe[0] = 0.25;
+  ASSERT_EQ(h2_mechanism_->setFalloffParameters(H2_FALLOFF_REACTION,troe),
+            0);
+  GetRateConstants(h2_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  EXPECT_GT(MaxRelativeDifference(kf_ref, kf), 1.0e-3);
+
+  // restoring the parameters restores the rate constants at any pressure
+  troe[0] = 0.5;
+  ASSERT_EQ(h2_mechanism_->setFalloffLowParameters(H2_FALLOFF_REACTION,
+                                                   A,Tpow,Eact), 0);
+  ASSERT_EQ(h2_mechanism_->setFalloffParameters(H2_FALLOFF_REACTION,troe),
+            0);
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  GetRateConstants(h2_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  EXPECT_LE(MaxRelativeDifference(kf_ref, kf), OK_DOUBLE);
+  EXPECT_LE(MaxRelativeDifference(kr_ref, kr), OK_DOUBLE);
+}
+
+TEST_F (KineticParametersTestFixture, PLog)
+{
+  ASSERT_EQ(plog_mechanism_->getNumPLogLines(PLOG_REACTION), 3);
+  EXPECT_EQ(plog_mechanism_->getNumPLogLines(-1), -1);
+
+  double pressure, A, Tpow, Eact;
+  double A_sum = 0.0;
+  for(int j=0; j<3; ++j) {
+    ASSERT_EQ(plog_mechanism_->getPLogParameters(PLOG_REACTION,j,&pressure,
+                                                 &A,&Tpow,&Eact), 0);
+    EXPECT_EQ(pressure, 1.0);
+    A_sum += A;
+  }
+  EXPECT_NEAR(A_sum, 9.0e8, 9.0e8*OK_DOUBLE);
+  EXPECT_EQ(plog_mechanism_->getPLogParameters(PLOG_REACTION,3,&pressure,
+                                               &A,&Tpow,&Eact), -1);
+
+  // scaling every line scales the rate constant
+  for(int j=0; j<3; ++j) {
+    ASSERT_EQ(plog_mechanism_->getPLogParameters(PLOG_REACTION,j,&pressure,
+                                                 &A,&Tpow,&Eact), 0);
+    ASSERT_EQ(plog_mechanism_->setPLogParameters(PLOG_REACTION,j,3.0*A,
+                                                 Tpow,Eact), 0);
+  }
+  std::vector<double> kf_ref, kr_ref, kf, kr;
+  GetRateConstants(plog_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  GetRateConstants(plog_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  const int num_reactions = plog_mechanism_->getNumReactions();
+  for(int k=0; k<num_reactions; ++k) {
+    const double mult = ((k == PLOG_REACTION) ? 3.0 : 1.0);
+    EXPECT_NEAR(kf[k], mult*kf_ref[k], fabs(mult*kf_ref[k])*OK_DOUBLE) <<
+      "forward rate constant of reaction " << k;
+  }
+}
+
+TEST_F (KineticParametersTestFixture, RateConstTable)
+{
+  ASSERT_TRUE(h2_mechanism_->setRateConstTable(300.0, 3000.0,
+                                               TABLE_RTOL) >= 0.0);
+  ASSERT_TRUE(shared_mechanism_->setRateConstTable(300.0, 3000.0,
+                                                   TABLE_RTOL) >= 0.0);
+  double A, Tpow, Eact;
+  ASSERT_EQ(h2_mechanism_->getArrheniusParameters(1,1,&A,&Tpow,&Eact), 0);
+  ASSERT_EQ(h2_mechanism_->setArrheniusParameters(1,1,2.0*A,Tpow,Eact), 0);
+
+  // the table is rebuilt for the new parameters
+  std::vector<double> kf_ref, kr_ref, kf, kr;
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  GetRateConstants(h2_mechanism_, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  kf_ref[1] *= 2.0;
+  EXPECT_LE(MaxRelativeDifference(kf_ref, kf), 10.0*TABLE_RTOL);
+  EXPECT_LE(MaxRelativeDifference(kr_ref, kr), 10.0*TABLE_RTOL);
+
+  // a new table for the original files is not affected by the change
+  zerork::mechanism *mech = LoadMechanism(H2_MECH_FILENAME, H2_THERM_FILENAME);
+  ASSERT_TRUE(mech->setRateConstTable(300.0, 3000.0, TABLE_RTOL) >= 0.0);
+  GetRateConstants(h2_reference_, TEST_TEMPERATURE, 1.01325e5,
+                   &kf_ref, &kr_ref);
+  GetRateConstants(mech, TEST_TEMPERATURE, 1.01325e5, &kf, &kr);
+  EXPECT_LE(MaxRelativeDifference(kf_ref, kf), 10.0*TABLE_RTOL);
+  delete mech;
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+// ---------------------------------------------------------------------------
+static zerork::mechanism * LoadMechanism(const char mech_filename[],
+                                         const char therm_filename[])
+{
+  const char * ZERORK_DATA_DIR = std::getenv("ZERORK_DATA_DIR");
+  std::string load_mech(mech_filename);
+  std::string load_therm(therm_filename);
+  if(ZERORK_DATA_DIR == nullptr) {
+    load_mech = std::string("../../") + load_mech;
+    load_therm = std::string("../../") + load_therm;
+  } else {
+    load_mech = std::string(ZERORK_DATA_DIR) + "/" + load_mech;
+    load_therm = std::string(ZERORK_DATA_DIR) + "/" + load_therm;
+  }
+  return new zerork::mechanism(load_mech.c_str(),
+                               load_therm.c_str(),
+                               PARSER_LOGNAME);
+}
+
+// rate constants at the given pressure with a uniform composition
+static void GetRateConstants(zerork::mechanism *mech,
+                             const double temperature,
+                             const double pressure,
+                             std::vector<double> *k_forward,
+                             std::vector<double> *k_reverse)
+{
+  const int num_species = mech->getNumSpecies();
+  const int num_reactions = mech->getNumReactions();
+  const double concentration_sum =
+    pressure/(mech->getGasConstant()*temperature);
+  std::vector<double> concentrations(num_species,
+                                     concentration_sum/(double)num_species);
+
+  k_forward->assign(num_reactions, 0.0);
+  k_reverse->assign(num_reactions, 0.0);
+  mech->getKrxnFromTC(temperature,
+                      &concentrations[0],
+                      &(*k_forward)[0],
+                      &(*k_reverse)[0]);
+}
+
+static double MaxRelativeDifference(const std::vector<double> &a,
+                                    const std::vector<double> &b)
+{
+  double max_difference = 0.0;
+  for(size_t j=0; j<a.size(); ++j) {
+    double difference = fabs(a[j]-b[j]);
+    if(a[j] != 0.0) {
+      difference /= fabs(a[j]);
+    }
+    if(difference > max_difference) {
+      max_difference = difference;
+    }
+  }
+  return max_difference;
+}
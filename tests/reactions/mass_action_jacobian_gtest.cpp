@@ -0,0 +1,279 @@
+#include <math.h>
+#include <vector>
+#include <cstdlib>
+#include <string>
+#include <memory>
+
+#include <zerork/mechanism.h>
+
+#include <gtest/gtest.h>
+
+// ---------------------------------------------------------------------------
+// test constants
+// ---------------------------------------------------------------------------
+// the terms are the same products as the rate of progress divided by one
+// concentration, up to roundoff
+static const double TEST_RTOL = 1.0e-12;
+// central differences are exact for the mass action products up to second
+// order in each concentration, so only roundoff remains
+static const double PERTURB_RDELTA = 1.0e-4;
+static const double DIFFERENCE_RTOL = 1.0e-8;
+
+static const char H2_MECH_FILENAME[]  = "mechanisms/hydrogen/h2_v1b_mech.txt";
+static const char H2_THERM_FILENAME[] = "mechanisms/hydrogen/h2_v1a_therm.txt";
+static const char RECOMBINATION_MECH_FILENAME[] =
+  "mechanisms/ideal/hydrogen_recombination.mech";
+static const char NON_INTEGER_MECH_FILENAME[] =
+  "mechanisms/ideal/non_integer_test.mech";
+static const char IDEAL_THERM_FILENAME[] =
+  "mechanisms/ideal/const_specific_heat.therm";
+static const char PARSER_LOGNAME[] = "parser.log";
+
+static zerork::mechanism * LoadMechanism(const char mech_filename[],
+                                         const char therm_filename[]);
+// concentrations of a composition with unequal mole fractions, every third
+// species is set to zero when zero_species is true
+static void GetConcentrations(zerork::mechanism *mech,
+                              const bool zero_species,
+                              std::vector<double> *concentrations);
+// rate coefficients (limited K) and mass action terms at the given state
+static void GetTerms(zerork::mechanism *mech,
+                     const double temperature,
+                     const std::vector<double> &concentrations,
+                     std::vector<double> *step_rates,
+                     std::vector<double> *rate_coefficients,
+                     std::vector<double> *terms);
+// rate of progress of step_id from its rate coefficient and reactants
+static double GetMassActionRate(zerork::mechanism *mech,
+                                const int step_id,
+                                const double rate_coefficient,
+                                const std::vector<double> &concentrations);
+
+// ---------------------------------------------------------------------------
+class MassActionJacobianTestFixture: public ::testing::Test
+{
+ public:
+  MassActionJacobianTestFixture( ) {
+    h2_mechanism_ = LoadMechanism(H2_MECH_FILENAME, H2_THERM_FILENAME);
+    recombination_mechanism_ = LoadMechanism(RECOMBINATION_MECH_FILENAME,
+                                             IDEAL_THERM_FILENAME);
+    non_integer_mechanism_ = LoadMechanism(NON_INTEGER_MECH_FILENAME,
+                                           IDEAL_THERM_FILENAME);
+  }
+
+  ~MassActionJacobianTestFixture( )  {
+    delete h2_mechanism_;
+    delete recombination_mechanism_;
+    delete non_integer_mechanism_;
+  }
+
+  zerork::mechanism *h2_mechanism_;
+  zerork::mechanism *recombination_mechanism_;
+  zerork::mechanism *non_integer_mechanism_;
+};
+
+// one term per reactant of every integer order step, and getTermIdx is
+// consistent with getTermPattern
+TEST_F (MassActionJacobianTestFixture, TermPattern)
+{
+  zerork::mechanism *mechs[] = {h2_mechanism_,
+                                recombination_mechanism_,
+                                non_integer_mechanism_};
+  for(int n=0; n<3; ++n) {
+    const zerork::mass_action_jacobian *mass_action =
+      mechs[n]->getMassActionJacobian();
+    const int num_terms = mass_action->getNumTerms();
+    std::vector<int> term_step(num_terms+1), term_species(num_terms+1);
+    std::vector<int> count(num_terms, 0);
+    mass_action->getTermPattern(&term_step[0], &term_species[0]);
+
+    int num_reactants = 0;
+    for(int j=0; j<mechs[n]->getNumSteps(); ++j) {
+      for(int k=0; k<mechs[n]->getOrderOfStep(j); ++k) {
+        const int term_id = mass_action->getTermIdx(j,k);
+        ASSERT_GE(term_id, 0);
+        ASSERT_LT(term_id, num_terms);
+        EXPECT_EQ(j, term_step[term_id]);
+        EXPECT_EQ(mechs[n]->getSpecIdxOfStepReactant(j,k),
+                  term_species[term_id]);
+        ++count[term_id];
+        ++num_reactants;
+      }
+    }
+    EXPECT_EQ(num_terms, num_reactants);
+    for(int j=0; j<num_terms; ++j) {
+      EXPECT_EQ(1, count[j]) << "term " << j;
+    }
+  }
+  EXPECT_GT(h2_mechanism_->getMassActionJacobian()->getNumTerms(), 0);
+}
+
+// the terms match the current Jacobian method, step_rate/C, for nonzero
+// concentrations
+TEST_F (MassActionJacobianTestFixture, MatchesRateOverConcentration)
+{
+  zerork::mechanism *mechs[] = {h2_mechanism_, recombination_mechanism_};
+  const double temperatures[] = {600.0, 1500.0, 2500.0};
+  for(int n=0; n<2; ++n) {
+    const zerork::mass_action_jacobian *mass_action =
+      mechs[n]->getMassActionJacobian();
+    std::vector<double> concentrations, step_rates, rate_coefficients, terms;
+    GetConcentrations(mechs[n], false, &concentrations);
+    for(int m=0; m<3; ++m) {
+      GetTerms(mechs[n], temperatures[m], concentrations,
+               &step_rates, &rate_coefficients, &terms);
+      for(int j=0; j<mechs[n]->getNumSteps(); ++j) {
+        for(int k=0; k<mechs[n]->getOrderOfStep(j); ++k) {
+          const int species_id = mechs[n]->getSpecIdxOfStepReactant(j,k);
+          const double reference =
+            step_rates[j]/concentrations[species_id];
+          const double term = terms[mass_action->getTermIdx(j,k)];
+          EXPECT_NEAR(reference, term, TEST_RTOL*fabs(reference))
+            << "step " << j << ", reactant " << k
+            << ", T = " << temperatures[m];
+        }
+      }
+    }
+  }
+}
+
+// with zero concentrations the terms are the exact derivatives of the
+// mass action rates of progress, where step_rate/C is undefined
+TEST_F (MassActionJacobianTestFixture, ZeroConcentrations)
+{
+  zerork::mechanism *mechs[] = {h2_mechanism_, recombination_mechanism_};
+  int num_nonzero_at_zero = 0;
+  for(int n=0; n<2; ++n) {
+    const zerork::mass_action_jacobian *mass_action =
+      mechs[n]->getMassActionJacobian();
+    const int num_species = mechs[n]->getNumSpecies();
+    std::vector<double> concentrations, perturbed;
+    std::vector<double> step_rates, rate_coefficients, terms;
+    GetConcentrations(mechs[n], true, &concentrations);
+    GetTerms(mechs[n], 1500.0, concentrations,
+             &step_rates, &rate_coefficients, &terms);
+
+    double max_concentration = 0.0;
+    for(int k=0; k<num_species; ++k) {
+      max_concentration = fmax(max_concentration, concentrations[k]);
+    }
+    for(int j=0; j<mechs[n]->getNumSteps(); ++j) {
+      const int order = mechs[n]->getOrderOfStep(j);
+      for(int k=0; k<num_species; ++k) {
+        double derivative = 0.0;
+        bool is_reactant = false;
+        for(int m=0; m<order; ++m) {
+          if(mechs[n]->getSpecIdxOfStepReactant(j,m) == k) {
+            derivative += terms[mass_action->getTermIdx(j,m)];
+            is_reactant = true;
+          }
+        }
+        if(!is_reactant) {
+          continue;
+        }
+        const double delta = PERTURB_RDELTA*max_concentration;
+        perturbed = concentrations;
+        perturbed[k] += delta;
+        const double plus_rate =
+          GetMassActionRate(mechs[n], j, rate_coefficients[j], perturbed);
+        perturbed[k] -= 2.0*delta;
+        const double minus_rate =
+          GetMassActionRate(mechs[n], j, rate_coefficients[j], perturbed);
+        const double difference = (plus_rate-minus_rate)/(2.0*delta);
+        EXPECT_NEAR(difference, derivative,
+                    DIFFERENCE_RTOL*(fabs(difference)+
+                                     fabs(rate_coefficients[j])*
+                                     pow(max_concentration, order-1)))
+          << "step " << j << ", species " << k;
+        if(concentrations[k] == 0.0 && derivative != 0.0) {
+          ++num_nonzero_at_zero;
+        }
+      }
+    }
+  }
+  EXPECT_GT(num_nonzero_at_zero, 0);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+// ---------------------------------------------------------------------------
+static zerork::mechanism * LoadMechanism(const char mech_filename[],
+                                         const char therm_filename[])
+{
+  const char * ZERORK_DATA_DIR = std::getenv("ZERORK_DATA_DIR");
+  std::string load_mech(mech_filename);
+  std::string load_therm(therm_filename);
+  if(ZERORK_DATA_DIR == nullptr) {
+    load_mech = std::string("../../") + load_mech;
+    load_therm = std::string("../../") + load_therm;
+  } else {
+    load_mech = std::string(ZERORK_DATA_DIR) + "/" + load_mech;
+    load_therm = std::string(ZERORK_DATA_DIR) + "/" + load_therm;
+  }
+  return new zerork::mechanism(load_mech.c_str(),
+                               load_therm.c_str(),
+                               PARSER_LOGNAME);
+}
+
+static void GetConcentrations(zerork::mechanism *mech,
+                              const bool zero_species,
+                              std::vector<double> *concentrations)
+{
+  const int num_species = mech->getNumSpecies();
+  concentrations->assign(num_species, 0.0);
+  for(int j=0; j<num_species; ++j) {
+    if(zero_species && j%3 == 0) {
+      continue;
+    }
+    (*concentrations)[j] = 1.0e-3*(1.0+0.5*(j%4));
+  }
+}
+
+static void GetTerms(zerork::mechanism *mech,
+                     const double temperature,
+                     const std::vector<double> &concentrations,
+                     std::vector<double> *step_rates,
+                     std::vector<double> *rate_coefficients,
+                     std::vector<double> *terms)
+{
+  const int num_species = mech->getNumSpecies();
+  const int num_steps = mech->getNumSteps();
+  const zerork::mass_action_jacobian *mass_action =
+    mech->getMassActionJacobian();
+  std::vector<double> net(num_species), create(num_species);
+  std::vector<double> destroy(num_species);
+  std::vector<double> step_limiter(num_steps, 1.0e+300);
+  std::unique_ptr<zerork::rate_const_workspace> work =
+    mech->createRateConstWorkspace();
+
+  step_rates->assign(num_steps, 0.0);
+  rate_coefficients->assign(num_steps, 0.0);
+  terms->assign(mass_action->getNumTerms()+1, 0.0);
+  mech->getReactionRatesLimiter(temperature,
+                                &concentrations[0],
+                                &step_limiter[0],
+                                &net[0],
+                                &create[0],
+                                &destroy[0],
+                                &(*step_rates)[0],
+                                &(*rate_coefficients)[0],
+                                work.get());
+  mass_action->getTermValues(&(*rate_coefficients)[0],
+                             &concentrations[0],
+                             &(*terms)[0]);
+}
+
+static double GetMassActionRate(zerork::mechanism *mech,
+                                const int step_id,
+                                const double rate_coefficient,
+                                const std::vector<double> &concentrations)
+{
+  double rate = rate_coefficient;
+  for(int m=0; m<mech->getOrderOfStep(step_id); ++m) {
+    rate *= concentrations[mech->getSpecIdxOfStepReactant(step_id,m)];
+  }
+  return rate;
+}
@@ -0,0 +1,249 @@
+#include <math.h>
+#include <vector>
+#include <cstdlib>
+#include <string>
+#include <memory>
+
+#include <zerork/mechanism.h>
+
+#include <gtest/gtest.h>
+
+// ---------------------------------------------------------------------------
+// test constants
+// ---------------------------------------------------------------------------
+static const char MECH_FILENAME[]  = "mechanisms/hydrogen/h2_v1b_mech.txt";
+static const char THERM_FILENAME[] = "mechanisms/hydrogen/h2_v1a_therm.txt";
+static const char PARSER_LOGNAME[] = "parser.log";
+
+static const double TABLE_MIN_TEMPERATURE = 300.0;
+static const double TABLE_MAX_TEMPERATURE = 3000.0;
+static const double TABLE_RTOL = 1.0e-6;
+// The reverse rate constants combine the errors of the forward rate
+// constant and the equilibrium constant, and the error is only measured at
+// the interval midpoints when the table is built.
+static const double ERROR_MULTIPLIER = 4.0;
+
+static void GetRateConstants(zerork::mechanism *mech,
+                             const double temperature,
+                             std::vector<double> *k_forward,
+                             std::vector<double> *k_reverse);
+static void GetRatesOfProgress(zerork::mechanism *mech,
+                               zerork::rate_const_workspace *work,
+                               const double temperature,
+                               std::vector<double> *rates_of_progress);
+static double MaxRelativeDifference(const std::vector<double> &a,
+                                    const std::vector<double> &b);
+
+// ---------------------------------------------------------------------------
+// test fixture with two copies of the same mechanism, the second one will
+// use the rate constant table
+class RateConstTableTestFixture: public ::testing::Test
+{
+ public:
+  RateConstTableTestFixture( ) {
+    exact_mechanism_ = NULL;
+    table_mechanism_ = NULL;
+    const char * ZERORK_DATA_DIR = std::getenv("ZERORK_DATA_DIR");
+    std::string load_mech(MECH_FILENAME);
+    std::string load_therm(THERM_FILENAME);
+    if(ZERORK_DATA_DIR == nullptr) {
+      load_mech = std::string("../../") + load_mech;
+      load_therm = std::string("../../") + load_therm;
+    } else {
+      load_mech = std::string(ZERORK_DATA_DIR) + "/" + load_mech;
+      load_therm = std::string(ZERORK_DATA_DIR) + "/" + load_therm;
+    }
+    exact_mechanism_ = new zerork::mechanism(load_mech.c_str(),
+                                             load_therm.c_str(),
+                                             PARSER_LOGNAME);
+    table_mechanism_ = new zerork::mechanism(load_mech.c_str(),
+                                             load_therm.c_str(),
+                                             PARSER_LOGNAME);
+  }
+
+  ~RateConstTableTestFixture( )  {
+    if(exact_mechanism_ != NULL) {
+      delete exact_mechanism_;
+    }
+    if(table_mechanism_ != NULL) {
+      delete table_mechanism_;
+    }
+  }
+
+  zerork::mechanism *exact_mechanism_;
+  zerork::mechanism *table_mechanism_;
+};
+
+TEST_F (RateConstTableTestFixture, TableError)
+{
+  ASSERT_TRUE(table_mechanism_ != NULL) <<
+    "table_mechanism_ = new zerork::mechanism";
+
+  const double table_error =
+    table_mechanism_->setRateConstTable(TABLE_MIN_TEMPERATURE,
+                                        TABLE_MAX_TEMPERATURE,
+                                        TABLE_RTOL);
+  // the error floor set by the discontinuity of the thermodynamic fits
+  // at 1000 K is slightly above the requested tolerance
+  ASSERT_TRUE(table_error >= 0.0 && table_error < 10.0*TABLE_RTOL) <<
+    "setRateConstTable(...) returned max relative error = " << table_error;
+
+  std::vector<double> kf_exact, kr_exact, kf_table, kr_table;
+  const int num_temperatures = 997;
+  for(int j=0; j<num_temperatures; ++j) {
+    const double temperature = TABLE_MIN_TEMPERATURE +
+      (TABLE_MAX_TEMPERATURE-TABLE_MIN_TEMPERATURE)*
+      (double)j/(double)(num_temperatures-1);
+    GetRateConstants(exact_mechanism_, temperature, &kf_exact, &kr_exact);
+    GetRateConstants(table_mechanism_, temperature, &kf_table, &kr_table);
+
+    EXPECT_LE(MaxRelativeDifference(kf_exact, kf_table),
+              ERROR_MULTIPLIER*table_error) <<
+      "forward rate constants at T = " << temperature;
+    EXPECT_LE(MaxRelativeDifference(kr_exact, kr_table),
+              ERROR_MULTIPLIER*table_error) <<
+      "reverse rate constants at T = " << temperature;
+  }
+}
+
+TEST_F (RateConstTableTestFixture, OutsideTableRange)
+{
+  ASSERT_TRUE(table_mechanism_ != NULL) <<
+    "table_mechanism_ = new zerork::mechanism";
+
+  ASSERT_TRUE(table_mechanism_->setRateConstTable(TABLE_MIN_TEMPERATURE,
+                                                  TABLE_MAX_TEMPERATURE,
+                                                  TABLE_RTOL) >= 0.0);
+
+  // temperatures outside the table range use the exact evaluation
+  std::vector<double> kf_exact, kr_exact, kf_table, kr_table;
+  const double temperatures[] = {250.0, 3200.0};
+  for(int j=0; j<2; ++j) {
+    GetRateConstants(exact_mechanism_,temperatures[j],&kf_exact,&kr_exact);
+    GetRateConstants(table_mechanism_,temperatures[j],&kf_table,&kr_table);
+    EXPECT_EQ(MaxRelativeDifference(kf_exact, kf_table), 0.0) <<
+      "forward rate constants at T = " << temperatures[j];
+    EXPECT_EQ(MaxRelativeDifference(kr_exact, kr_table), 0.0) <<
+      "reverse rate constants at T = " << temperatures[j];
+  }
+}
+
+TEST_F (RateConstTableTestFixture, UnsetTable)
+{
+  ASSERT_TRUE(table_mechanism_ != NULL) <<
+    "table_mechanism_ = new zerork::mechanism";
+
+  ASSERT_TRUE(table_mechanism_->setRateConstTable(TABLE_MIN_TEMPERATURE,
+                                                  TABLE_MAX_TEMPERATURE,
+                                                  TABLE_RTOL) >= 0.0);
+  std::vector<double> kf_exact, kr_exact, kf_table, kr_table;
+  const double temperature = 1234.5;
+  GetRateConstants(table_mechanism_, temperature, &kf_table, &kr_table);
+  table_mechanism_->unsetRateConstTable();
+
+  // the same temperature must be evaluated exactly after the table is unset
+  GetRateConstants(exact_mechanism_, temperature, &kf_exact, &kr_exact);
+  GetRateConstants(table_mechanism_, temperature, &kf_table, &kr_table);
+  EXPECT_EQ(MaxRelativeDifference(kf_exact, kf_table), 0.0);
+  EXPECT_EQ(MaxRelativeDifference(kr_exact, kr_table), 0.0);
+}
+
+TEST_F (RateConstTableTestFixture, Workspace)
+{
+  ASSERT_TRUE(table_mechanism_ != NULL) <<
+    "table_mechanism_ = new zerork::mechanism";
+
+  ASSERT_TRUE(table_mechanism_->setRateConstTable(TABLE_MIN_TEMPERATURE,
+                                                  TABLE_MAX_TEMPERATURE,
+                                                  TABLE_RTOL) >= 0.0);
+  std::unique_ptr<zerork::rate_const_workspace> work =
+    table_mechanism_->createRateConstWorkspace();
+
+  // a separate workspace gives the same rates as the mechanism's own, also
+  // after the table is unset between two evaluations at one temperature
+  std::vector<double> rop_mechanism, rop_workspace;
+  const double temperatures[] = {250.0, 1234.5, 1234.5, 3200.0};
+  for(int j=0; j<4; ++j) {
+    if(j == 2) {
+      table_mechanism_->unsetRateConstTable();
+    }
+    GetRatesOfProgress(table_mechanism_,NULL,temperatures[j],&rop_mechanism);
+    GetRatesOfProgress(table_mechanism_,work.get(),temperatures[j],
+                       &rop_workspace);
+    EXPECT_EQ(MaxRelativeDifference(rop_mechanism, rop_workspace), 0.0) <<
+      "rates of progress at T = " << temperatures[j] << ", j = " << j;
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+// ---------------------------------------------------------------------------
+// rate constants at one atmosphere with a uniform composition
+static void GetRateConstants(zerork::mechanism *mech,
+                             const double temperature,
+                             std::vector<double> *k_forward,
+                             std::vector<double> *k_reverse)
+{
+  const int num_species = mech->getNumSpecies();
+  const int num_reactions = mech->getNumReactions();
+  const double concentration_sum =
+    1.01325e5/(mech->getGasConstant()*temperature);
+  std::vector<double> concentrations(num_species,
+                                     concentration_sum/(double)num_species);
+
+  k_forward->assign(num_reactions, 0.0);
+  k_reverse->assign(num_reactions, 0.0);
+  mech->getKrxnFromTC(temperature,
+                      &concentrations[0],
+                      &(*k_forward)[0],
+                      &(*k_reverse)[0]);
+}
+
+// rates of progress at one atmosphere with a uniform composition, using
+// the workspace work if it is not NULL
+static void GetRatesOfProgress(zerork::mechanism *mech,
+                               zerork::rate_const_workspace *work,
+                               const double temperature,
+                               std::vector<double> *rates_of_progress)
+{
+  const int num_species = mech->getNumSpecies();
+  const int num_steps = mech->getNumSteps();
+  const double concentration_sum =
+    1.01325e5/(mech->getGasConstant()*temperature);
+  std::vector<double> concentrations(num_species,
+                                     concentration_sum/(double)num_species);
+  std::vector<double> step_limiter(num_steps, 1.0e300);
+  std::vector<double> net(num_species), create(num_species);
+  std::vector<double> destroy(num_species);
+
+  rates_of_progress->assign(num_steps, 0.0);
+  if(work == NULL) {
+    mech->getReactionRatesLimiter(temperature, &concentrations[0],
+                                  &step_limiter[0], &net[0], &create[0],
+                                  &destroy[0], &(*rates_of_progress)[0]);
+  } else {
+    mech->getReactionRatesLimiter(temperature, &concentrations[0],
+                                  &step_limiter[0], &net[0], &create[0],
+                                  &destroy[0], &(*rates_of_progress)[0],
+                                  work);
+  }
+}
+
+static double MaxRelativeDifference(const std::vector<double> &a,
+                                    const std::vector<double> &b)
+{
+  double max_difference = 0.0;
+  for(size_t j=0; j<a.size(); ++j) {
+    double difference = fabs(a[j]-b[j]);
+    if(a[j] != 0.0) {
+      difference /= fabs(a[j]);
+    }
+    if(difference > max_difference) {
+      max_difference = difference;
+    }
+  }
+  return max_difference;
+}
@@ -0,0 +1,294 @@
+#include <math.h>
+#include <vector>
+#include <cstdlib>
+#include <string>
+#include <memory>
+
+#include <zerork/mechanism.h>
+
+#include <gtest/gtest.h>
+
+// ---------------------------------------------------------------------------
+// test constants
+// ---------------------------------------------------------------------------
+// central differences with a relative perturbation of 1.0e-5 are accurate
+// to about 1.0e-9
+static const double PERTURB_RDELTA = 1.0e-5;
+static const double TEST_RTOL = 1.0e-6;
+static const double TEST_ATOL = 1.0e-8; // relative to the scale of the term
+
+static const char H2_MECH_FILENAME[]  = "mechanisms/hydrogen/h2_v1b_mech.txt";
+static const char H2_THERM_FILENAME[] = "mechanisms/hydrogen/h2_v1a_therm.txt";
+static const char TROE_MECH_FILENAME[] = "mechanisms/ideal/troe_test.mech";
+static const char SRI_MECH_FILENAME[]  = "mechanisms/ideal/sri_reaction.mech";
+static const char PLOG_MECH_FILENAME[] = "mechanisms/ideal/plog_test.mech";
+static const char IDEAL_THERM_FILENAME[] =
+  "mechanisms/ideal/const_specific_heat.therm";
+static const char PARSER_LOGNAME[] = "parser.log";
+
+static zerork::mechanism * LoadMechanism(const char mech_filename[],
+                                         const char therm_filename[]);
+// concentrations of a composition with unequal mole fractions at the given
+// temperature and pressure
+static void GetConcentrations(zerork::mechanism *mech,
+                              const double temperature,
+                              const double pressure,
+                              std::vector<double> *concentrations);
+static void GetStepRates(zerork::mechanism *mech,
+                         const double temperature,
+                         const std::vector<double> &concentrations,
+                         const std::vector<double> &step_limiter,
+                         std::vector<double> *step_rates);
+// Compares the analytic derivatives of the step rates of progress with
+// respect to temperature and to each concentration against central
+// differences, returns the number of mismatched terms
+static int CountMismatchedDerivatives(zerork::mechanism *mech,
+                                      const double temperature,
+                                      const double pressure,
+                                      const double step_limit);
+
+// ---------------------------------------------------------------------------
+class RateDerivativesTestFixture: public ::testing::Test
+{
+ public:
+  RateDerivativesTestFixture( ) {
+    h2_mechanism_ = LoadMechanism(H2_MECH_FILENAME, H2_THERM_FILENAME);
+    troe_mechanism_ = LoadMechanism(TROE_MECH_FILENAME, IDEAL_THERM_FILENAME);
+    sri_mechanism_ = LoadMechanism(SRI_MECH_FILENAME, IDEAL_THERM_FILENAME);
+    plog_mechanism_ = LoadMechanism(PLOG_MECH_FILENAME, IDEAL_THERM_FILENAME);
+  }
+
+  ~RateDerivativesTestFixture( )  {
+    delete h2_mechanism_;
+    delete troe_mechanism_;
+    delete sri_mechanism_;
+    delete plog_mechanism_;
+  }
+
+  zerork::mechanism *h2_mechanism_;
+  zerork::mechanism *troe_mechanism_;
+  zerork::mechanism *sri_mechanism_;
+  zerork::mechanism *plog_mechanism_;
+};
+
+// Arrhenius, reverse rates from Keq, third body and Troe falloff reactions
+TEST_F (RateDerivativesTestFixture, Hydrogen)
+{
+  const double temperatures[] = {600.0, 1234.5, 2500.0};
+  const double pressures[] = {1.0e4, 1.01325e5, 5.0e6};
+  for(int j=0; j<3; ++j) {
+    for(int k=0; k<3; ++k) {
+      EXPECT_EQ(0, CountMismatchedDerivatives(h2_mechanism_,
+                                              temperatures[j],
+                                              pressures[k],
+                                              1.0e+300))
+        << "T = " << temperatures[j] << " [K], p = " << pressures[k]
+        << " [Pa]";
+    }
+  }
+  EXPECT_GT(h2_mechanism_->getNumRateConstConcentrationTerms(), 0);
+}
+
+TEST_F (RateDerivativesTestFixture, StepLimiter)
+{
+  EXPECT_EQ(0, CountMismatchedDerivatives(h2_mechanism_,
+                                          1234.5,
+                                          1.01325e5,
+                                          1.0e+6));
+}
+
+TEST_F (RateDerivativesTestFixture, Troe)
+{
+  const double pressures[] = {1.0e2, 1.01325e5, 1.0e8};
+  for(int k=0; k<3; ++k) {
+    EXPECT_EQ(0, CountMismatchedDerivatives(troe_mechanism_,
+                                            1500.0,
+                                            pressures[k],
+                                            1.0e+300))
+      << "p = " << pressures[k] << " [Pa]";
+  }
+}
+
+TEST_F (RateDerivativesTestFixture, SRI)
+{
+  const double pressures[] = {1.0e2, 1.01325e5, 1.0e8};
+  for(int k=0; k<3; ++k) {
+    EXPECT_EQ(0, CountMismatchedDerivatives(sri_mechanism_,
+                                            1500.0,
+                                            pressures[k],
+                                            1.0e+300))
+      << "p = " << pressures[k] << " [Pa]";
+  }
+}
+
+// pressures inside and outside of the PLOG pressure ranges
+TEST_F (RateDerivativesTestFixture, PLog)
+{
+  const double pressures[] = {1.0e2, 3.0e4, 2.5e5, 5.0e6, 3.0e7};
+  for(int k=0; k<5; ++k) {
+    EXPECT_EQ(0, CountMismatchedDerivatives(plog_mechanism_,
+                                            1100.0,
+                                            pressures[k],
+                                            1.0e+300))
+      << "p = " << pressures[k] << " [Pa]";
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+// ---------------------------------------------------------------------------
+static zerork::mechanism * LoadMechanism(const char mech_filename[],
+                                         const char therm_filename[])
+{
+  const char * ZERORK_DATA_DIR = std::getenv("ZERORK_DATA_DIR");
+  std::string load_mech(mech_filename);
+  std::string load_therm(therm_filename);
+  if(ZERORK_DATA_DIR == nullptr) {
+    load_mech = std::string("../../") + load_mech;
+    load_therm = std::string("../../") + load_therm;
+  } else {
+    load_mech = std::string(ZERORK_DATA_DIR) + "/" + load_mech;
+    load_therm = std::string(ZERORK_DATA_DIR) + "/" + load_therm;
+  }
+  return new zerork::mechanism(load_mech.c_str(),
+                               load_therm.c_str(),
+                               PARSER_LOGNAME);
+}
+
+static void GetConcentrations(zerork::mechanism *mech,
+                              const double temperature,
+                              const double pressure,
+                              std::vector<double> *concentrations)
+{
+  const int num_species = mech->getNumSpecies();
+  const double concentration_sum =
+    pressure/(mech->getGasConstant()*temperature);
+  double weight_sum = 0.0;
+  concentrations->assign(num_species, 0.0);
+  for(int j=0; j<num_species; ++j) {
+    (*concentrations)[j] = 1.0+0.5*(j%3);
+    weight_sum += (*concentrations)[j];
+  }
+  for(int j=0; j<num_species; ++j) {
+    (*concentrations)[j] *= concentration_sum/weight_sum;
+  }
+}
+
+static void GetStepRates(zerork::mechanism *mech,
+                         const double temperature,
+                         const std::vector<double> &concentrations,
+                         const std::vector<double> &step_limiter,
+                         std::vector<double> *step_rates)
+{
+  const int num_species = mech->getNumSpecies();
+  std::vector<double> net(num_species), create(num_species);
+  std::vector<double> destroy(num_species);
+  step_rates->assign(mech->getNumSteps(), 0.0);
+  mech->getReactionRatesLimiter(temperature,
+                                &concentrations[0],
+                                &step_limiter[0],
+                                &net[0],
+                                &create[0],
+                                &destroy[0],
+                                &(*step_rates)[0]);
+}
+
+static int CountMismatchedDerivatives(zerork::mechanism *mech,
+                                      const double temperature,
+                                      const double pressure,
+                                      const double step_limit)
+{
+  const int num_species = mech->getNumSpecies();
+  const int num_steps = mech->getNumSteps();
+  const int num_terms = mech->getNumRateConstConcentrationTerms();
+  std::vector<double> step_limiter(num_steps, step_limit);
+  std::vector<double> concentrations, perturbed;
+  std::vector<double> net(num_species), create(num_species);
+  std::vector<double> destroy(num_species);
+  std::vector<double> step_rates(num_steps), plus_rates, minus_rates;
+  std::vector<double> rate_coefficients(num_steps);
+  const zerork::mass_action_jacobian *mass_action =
+    mech->getMassActionJacobian();
+  std::vector<double> mass_action_terms(mass_action->getNumTerms()+1);
+  std::vector<double> dstep_dT(num_steps), dstep_dCsum(num_steps);
+  std::vector<double> dstep_dC(num_terms+1);
+  std::vector<int> term_step(num_terms+1), term_species(num_terms+1);
+  std::unique_ptr<zerork::rate_const_workspace> work =
+    mech->createRateConstWorkspace();
+  int num_mismatched = 0;
+
+  GetConcentrations(mech, temperature, pressure, &concentrations);
+  mech->getReactionRateDerivativesLimiter(temperature,
+                                          &concentrations[0],
+                                          &step_limiter[0],
+                                          &net[0],
+                                          &create[0],
+                                          &destroy[0],
+                                          &step_rates[0],
+                                          &rate_coefficients[0],
+                                          &dstep_dT[0],
+                                          &dstep_dCsum[0],
+                                          &dstep_dC[0],
+                                          work.get());
+  mech->getRateConstConcentrationTerms(&term_step[0], &term_species[0]);
+  mass_action->getTermValues(&rate_coefficients[0],
+                             &concentrations[0],
+                             &mass_action_terms[0]);
+
+  // temperature derivatives at constant concentration
+  const double delta_temperature = PERTURB_RDELTA*temperature;
+  GetStepRates(mech, temperature+delta_temperature, concentrations,
+               step_limiter, &plus_rates);
+  GetStepRates(mech, temperature-delta_temperature, concentrations,
+               step_limiter, &minus_rates);
+  for(int j=0; j<num_steps; ++j) {
+    const double difference =
+      (plus_rates[j]-minus_rates[j])/(2.0*delta_temperature);
+    const double scale = fabs(step_rates[j])/temperature;
+    if(fabs(difference-dstep_dT[j]) >
+       TEST_RTOL*fabs(difference)+TEST_ATOL*scale) {
+      ++num_mismatched;
+      ADD_FAILURE() << "d(step " << j << ")/dT = " << dstep_dT[j]
+                    << ", difference = " << difference;
+    }
+  }
+
+  // concentration derivatives
+  for(int k=0; k<num_species; ++k) {
+    const double delta_concentration = PERTURB_RDELTA*concentrations[k];
+    perturbed = concentrations;
+    perturbed[k] += delta_concentration;
+    GetStepRates(mech, temperature, perturbed, step_limiter, &plus_rates);
+    perturbed[k] -= 2.0*delta_concentration;
+    GetStepRates(mech, temperature, perturbed, step_limiter, &minus_rates);
+
+    for(int j=0; j<num_steps; ++j) {
+      // mass action
+      double derivative = 0.0;
+      for(int m=0; m<mech->getOrderOfStep(j); ++m) {
+        if(mech->getSpecIdxOfStepReactant(j,m) == k) {
+          derivative += mass_action_terms[mass_action->getTermIdx(j,m)];
+        }
+      }
+      derivative += dstep_dCsum[j];
+      for(int m=0; m<num_terms; ++m) {
+        if(term_step[m] == j && term_species[m] == k) {
+          derivative += dstep_dC[m];
+        }
+      }
+      const double difference =
+        (plus_rates[j]-minus_rates[j])/(2.0*delta_concentration);
+      const double scale = fabs(step_rates[j])/concentrations[k];
+      if(fabs(difference-derivative) >
+         TEST_RTOL*fabs(difference)+TEST_ATOL*scale) {
+        ++num_mismatched;
+        ADD_FAILURE() << "d(step " << j << ")/dC[" << k << "] = "
+                      << derivative << ", difference = " << difference;
+      }
+    }
+  }
+  return num_mismatched;
+}
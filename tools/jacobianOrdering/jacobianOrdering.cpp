@@ -0,0 +1,64 @@
+// Computes the fill-reducing column ordering of the species + temperature
+// Jacobian of a mechanism (zerork::mechanism::getJacobianOrdering) and
+// writes it in the perm_c.txt format read by the applications using
+// permutationType = 3, one column position per line. The nonzeros of the
+// symbolic L+U factors with the natural ordering and with the computed
+// ordering are printed for comparison.
+//
+// usage: jacobianOrdering.x <mechanism file> <thermo file>
+//                           [<perm_c file> (default perm_c.txt)]
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "zerork/mechanism.h"
+#include "zerork/sparse_ordering.h"
+
+int main(int argc, char *argv[])
+{
+  if(argc != 3 && argc != 4) {
+    printf("ERROR: incorrect command line usage\n");
+    printf("       use instead %s <mechanism file> <thermo file>\n",
+           argv[0]);
+    printf("                   [<perm_c file> (default perm_c.txt)]\n");
+    exit(-1);
+  }
+  const char *perm_c_filename = ((argc == 4) ? argv[3] : "perm_c.txt");
+
+  zerork::mechanism mech(argv[1], argv[2], "");
+  const int num_states = mech.getNumSpecies()+1;
+
+  std::vector<int> column_sums, row_indexes, perm_c, natural(num_states);
+  mech.getJacobianPattern(&column_sums, &row_indexes);
+  mech.getJacobianOrdering(&perm_c);
+  for(int j=0; j<num_states; ++j) {
+    natural[j] = j;
+  }
+
+  printf("# number of species + temperature : %d\n", num_states);
+  printf("# Jacobian nonzeros               : %d\n", column_sums[num_states]);
+  printf("# L+U nonzeros, natural ordering  : %lld\n",
+         zerork::getSymbolicFactorNonzeros(num_states,
+                                           &column_sums[0],
+                                           &row_indexes[0],
+                                           &natural[0]));
+  printf("# L+U nonzeros, mechanism ordering: %lld\n",
+         zerork::getSymbolicFactorNonzeros(num_states,
+                                           &column_sums[0],
+                                           &row_indexes[0],
+                                           &perm_c[0]));
+
+  FILE *perm_c_file = fopen(perm_c_filename, "w");
+  if(perm_c_file == NULL) {
+    printf("ERROR: could not open file %s to write the ordering\n",
+           perm_c_filename);
+    exit(-1);
+  }
+  for(int j=0; j<num_states; ++j) {
+    fprintf(perm_c_file, "%d\n", perm_c[j]);
+  }
+  fclose(perm_c_file);
+  printf("# ordering written to %s\n", perm_c_filename);
+  return 0;
+}
@@ -0,0 +1,275 @@
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "utilities/math_utilities.h"
+
+#include "synthetic_mechanism.h"
+
+static const int NUM_ELEMENTS = 3;
+static const char *ELEMENT_NAMES[NUM_ELEMENTS] = {"C", "H", "O"};
+// maximum number of random draws for the products of a reaction
+static const int MAX_PRODUCT_TRIES = 100;
+
+typedef struct
+{
+  int atoms[NUM_ELEMENTS];
+} Composition;
+
+static int TotalAtoms(const Composition &comp);
+static std::string CompositionName(const Composition &comp);
+static int RandomInt(const int max_value);
+static std::string ReactionKey(const std::vector<int> &reactants,
+                               const std::vector<int> &products);
+static void WriteThermoRecord(FILE *fptr,
+                              const std::string &name,
+                              const Composition &comp);
+
+int WriteSyntheticMechanism(const int num_species,
+                            const int num_reactions,
+                            const int num_thermo_records,
+                            const std::string &mech_file,
+                            const std::string &therm_file)
+{
+  // The species are all compositions in the order of their total number of
+  // atoms, so every composition with fewer atoms than a species is also a
+  // species, and a species can always be split into two smaller ones.
+  std::vector<Composition> species;
+  std::map<std::string, int> species_id;
+  for(int total = 1; (int)species.size() < num_species; ++total) {
+    for(int c = total; c >= 0 && (int)species.size() < num_species; --c) {
+      for(int o = 0; o <= total-c && (int)species.size() < num_species; ++o) {
+        Composition comp;
+        comp.atoms[0] = c;
+        comp.atoms[1] = total-c-o;
+        comp.atoms[2] = o;
+        species_id[CompositionName(comp)] = species.size();
+        species.push_back(comp);
+      }
+    }
+  }
+
+  FILE *mech_fptr = fopen(mech_file.c_str(), "w");
+  if(mech_fptr == NULL) {
+    printf("ERROR: could not open synthetic mechanism file %s for write\n",
+           mech_file.c_str());
+    return -1;
+  }
+  fprintf(mech_fptr, "! synthetic mechanism: %d species, %d reactions\n",
+          num_species, num_reactions);
+  fprintf(mech_fptr, "ELEMENTS\n");
+  for(int k=0; k<NUM_ELEMENTS; ++k) {
+    fprintf(mech_fptr, "%s ", ELEMENT_NAMES[k]);
+  }
+  fprintf(mech_fptr, "\nEND\nSPECIES\n");
+  for(int j=0; j<num_species; ++j) {
+    fprintf(mech_fptr, "%-12s%s", CompositionName(species[j]).c_str(),
+            (j%8 == 7 || j == num_species-1) ? "\n" : " ");
+  }
+  fprintf(mech_fptr, "END\nREACTIONS\n");
+
+  std::set<std::string> reaction_keys;
+  int num_written = 0;
+  int num_failed = 0;
+  while(num_written < num_reactions) {
+    if(num_failed > 100*num_reactions) {
+      printf("ERROR: could not generate %d synthetic reactions\n",
+             num_reactions);
+      fclose(mech_fptr);
+      return -1;
+    }
+    const bool third_body = (zerork::utilities::random01() < 0.2);
+    std::vector<int> reactants(1, RandomInt(num_species-1));
+    if(!third_body) {
+      reactants.push_back(RandomInt(num_species-1));
+    }
+    Composition total;
+    for(int k=0; k<NUM_ELEMENTS; ++k) {
+      total.atoms[k] = 0;
+      for(size_t j=0; j<reactants.size(); ++j) {
+        total.atoms[k] += species[reactants[j]].atoms[k];
+      }
+    }
+    if(TotalAtoms(total) < 2) {
+      ++num_failed;
+      continue;
+    }
+
+    // split the reactant atoms into two product species
+    std::vector<int> products;
+    for(int t=0; t<MAX_PRODUCT_TRIES && products.size() == 0; ++t) {
+      Composition first, second;
+      for(int k=0; k<NUM_ELEMENTS; ++k) {
+        first.atoms[k] = RandomInt(total.atoms[k]);
+        second.atoms[k] = total.atoms[k] - first.atoms[k];
+      }
+      if(TotalAtoms(first) == 0 || TotalAtoms(second) == 0) {
+        continue;
+      }
+      std::map<std::string, int>::iterator first_it =
+        species_id.find(CompositionName(first));
+      std::map<std::string, int>::iterator second_it =
+        species_id.find(CompositionName(second));
+      if(first_it == species_id.end() || second_it == species_id.end()) {
+        continue;
+      }
+      products.push_back(first_it->second);
+      products.push_back(second_it->second);
+    }
+    if(products.size() == 0) {
+      ++num_failed;
+      continue;
+    }
+    std::sort(reactants.begin(), reactants.end());
+    std::sort(products.begin(), products.end());
+    if(reactants == products) {
+      ++num_failed;
+      continue;
+    }
+    // a reversible reaction is the same in both directions
+    std::string key = ReactionKey(reactants, products);
+    const std::string reverse_key = ReactionKey(products, reactants);
+    if(reverse_key < key) {
+      key = reverse_key;
+    }
+    if(third_body) {
+      key = "M" + key;
+    }
+    if(!reaction_keys.insert(key).second) {
+      ++num_failed;
+      continue;
+    }
+
+    std::string equation = CompositionName(species[reactants[0]]);
+    for(size_t j=1; j<reactants.size(); ++j) {
+      equation += "+" + CompositionName(species[reactants[j]]);
+    }
+    equation += third_body ? "+M=" : "=";
+    equation += CompositionName(species[products[0]]) + "+" +
+                CompositionName(species[products[1]]);
+    if(third_body) {
+      equation += "+M";
+    }
+    fprintf(mech_fptr, "%-40s %12.4e %6.2f %12.4e\n",
+            equation.c_str(),
+            1.0e12*(1.0 + 99.0*zerork::utilities::random01()),
+            2.0*zerork::utilities::random01() - 1.0,
+            4.0e4*zerork::utilities::random01());
+    if(third_body) {
+      std::set<int> efficiency_species;
+      while((int)efficiency_species.size() < std::min(3, num_species)) {
+        efficiency_species.insert(RandomInt(num_species-1));
+      }
+      for(std::set<int>::iterator it = efficiency_species.begin();
+          it != efficiency_species.end(); ++it) {
+        fprintf(mech_fptr, "%s/%.2f/ ",
+                CompositionName(species[*it]).c_str(),
+                0.5 + 4.5*zerork::utilities::random01());
+      }
+      fprintf(mech_fptr, "\n");
+    }
+    ++num_written;
+  }
+  fprintf(mech_fptr, "END\n");
+  fclose(mech_fptr);
+
+  FILE *therm_fptr = fopen(therm_file.c_str(), "w");
+  if(therm_fptr == NULL) {
+    printf("ERROR: could not open synthetic thermo file %s for write\n",
+           therm_file.c_str());
+    return -1;
+  }
+  fprintf(therm_fptr, "THERMO\n   300.000  1000.000  5000.000\n");
+  for(int j=0; j<num_species; ++j) {
+    WriteThermoRecord(therm_fptr, CompositionName(species[j]), species[j]);
+  }
+  // records of species that are not used by the mechanism
+  for(int j=num_species; j<num_thermo_records; ++j) {
+    char name[32];
+    snprintf(name, sizeof(name), "X%d", j);
+    Composition comp;
+    for(int k=0; k<NUM_ELEMENTS; ++k) {
+      comp.atoms[k] = 1 + RandomInt(8);
+    }
+    WriteThermoRecord(therm_fptr, name, comp);
+  }
+  fprintf(therm_fptr, "END\n");
+  fclose(therm_fptr);
+  return 0;
+}
+
+static int TotalAtoms(const Composition &comp)
+{
+  int total = 0;
+  for(int k=0; k<NUM_ELEMENTS; ++k) {
+    total += comp.atoms[k];
+  }
+  return total;
+}
+
+static std::string CompositionName(const Composition &comp)
+{
+  std::string name;
+  for(int k=0; k<NUM_ELEMENTS; ++k) {
+    name += std::string(ELEMENT_NAMES[k]) + std::to_string(comp.atoms[k]);
+  }
+  return name;
+}
+
+// uniform integer in [0, max_value]
+static int RandomInt(const int max_value)
+{
+  const int value = (int)((max_value+1)*zerork::utilities::random01());
+  return std::min(value, max_value);
+}
+
+static std::string ReactionKey(const std::vector<int> &reactants,
+                               const std::vector<int> &products)
+{
+  std::string key;
+  for(size_t j=0; j<reactants.size(); ++j) {
+    key += std::to_string(reactants[j]) + " ";
+  }
+  key += "=";
+  for(size_t j=0; j<products.size(); ++j) {
+    key += " " + std::to_string(products[j]);
+  }
+  return key;
+}
+
+// NASA 7 coefficient record with a constant heat capacity, so the low and
+// high temperature polynomials are identical and continuous at 1000 K
+static void WriteThermoRecord(FILE *fptr,
+                              const std::string &name,
+                              const Composition &comp)
+{
+  const int total = TotalAtoms(comp);
+  double coef[7] = {2.0 + 0.5*total, 0.0, 0.0, 0.0, 0.0,
+                    1.0e3*total, 5.0 + 0.1*total};
+  char elements[4][6];
+  int num_elements = 0;
+  for(int k=0; k<4; ++k) {
+    snprintf(elements[k], sizeof(elements[k]), "     ");
+  }
+  for(int k=0; k<NUM_ELEMENTS; ++k) {
+    if(comp.atoms[k] > 0) {
+      snprintf(elements[num_elements], sizeof(elements[num_elements]),
+               "%-2s%3d", ELEMENT_NAMES[k], comp.atoms[k]);
+      ++num_elements;
+    }
+  }
+  fprintf(fptr, "%-16s%-8s%s%s%s%sG%10.3f%10.3f%8.2f%6s1\n",
+          name.c_str(), "BENCH",
+          elements[0], elements[1], elements[2], elements[3],
+          300.0, 5000.0, 1000.0, "");
+  fprintf(fptr, "%15.8E%15.8E%15.8E%15.8E%15.8E    2\n",
+          coef[0], coef[1], coef[2], coef[3], coef[4]);
+  fprintf(fptr, "%15.8E%15.8E%15.8E%15.8E%15.8E    3\n",
+          coef[5], coef[6], coef[0], coef[1], coef[2]);
+  fprintf(fptr, "%15.8E%15.8E%15.8E%15.8E                   4\n",
+          coef[3], coef[4], coef[5], coef[6]);
+}
@@ -0,0 +1,26 @@
+#ifndef SYNTHETIC_MECHANISM_H_
+#define SYNTHETIC_MECHANISM_H_
+
+#include <string>
+
+// Writes a synthetic C/H/O mechanism and thermodynamics file for timing the
+// mechanism parser on mechanisms larger than those shipped in data/.
+//
+// The species are named after their composition (e.g. C2H5O1). The
+// reactions are element balanced: about 80% are bimolecular exchange
+// reactions A+B=C+D and the rest are third body dissociations A+M=C+D+M
+// with three collision efficiencies. The thermodynamics file contains a
+// record for every species followed by records of species that are not in
+// the mechanism, as in a large thermo database. The files only depend on
+// num_species, num_reactions, num_thermo_records and the seed of
+// zerork::utilities::random01seed.
+//
+// Returns 0 on success and -1 if a file could not be written or the
+// reactions could not be generated.
+int WriteSyntheticMechanism(const int num_species,
+                            const int num_reactions,
+                            const int num_thermo_records,
+                            const std::string &mech_file,
+                            const std::string &therm_file);
+
+#endif
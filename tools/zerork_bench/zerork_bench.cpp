@@ -0,0 +1,883 @@
+// Micro-benchmarks of the hot kernels of Zero-RK over the mechanisms shipped
+// in data/mechanisms. Each kernel is timed over a set of randomly sampled
+// temperatures, pressures and compositions, and the results are written as
+// JSON (ns/call, calls/s and bytes/call). The mechanism parser is timed on
+// synthetic mechanisms (synthetic_<num species>) written to the current
+// directory. With --compare the results are checked against a stored
+// baseline, and the program returns a non-zero exit code if any kernel is
+// slower than the baseline by more than the threshold.
+//
+// usage: zerork_bench.x [--data-dir <dir>] [--output <json file>]
+//                       [--compare <baseline json file>] [--threshold <frac>]
+//                       [--num-states <n>] [--min-time <seconds>]
+//                       [--seed <int>] [--mechanism <name>]...
+//                       [--parse-species <n>]...
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zerork/mechanism.h"
+#include "zerork/utilities.h"
+#include "utilities/file_utilities.h"
+#include "utilities/math_utilities.h"
+#include "transport/mass_transport_factory.h"
+
+#include "reactor_constant_pressure_cpu.h"
+#include "solver_seulex.h"
+#include "nvector/nvector_serial.h"
+
+#include "synthetic_mechanism.h"
+
+static const int MAX_LINE_LEN = 4096;
+
+// default sampling of the thermodynamic states
+static const double MIN_TEMPERATURE = 600.0;       // [K]
+static const double MAX_TEMPERATURE = 2500.0;      // [K]
+static const double MIN_PRESSURE = 1.01325e5;      // [Pa]
+static const double MAX_PRESSURE = 1.01325e7;      // [Pa]
+static const double MIN_LOG10_MOLE_FRACTION = -12.0;
+// gamma of the preconditioner I - gamma*J formed by JacobianFactor
+static const double PRECONDITIONER_GAMMA = 1.0e-6;
+
+// size of the synthetic mechanisms per species, and the number of parses of
+// which the fastest is reported
+static const int PARSE_REACTIONS_PER_SPECIES = 5;
+static const double PARSE_THERMO_RECORDS_PER_SPECIES = 3.5;
+static const int PARSE_REPEATS = 3;
+static const int DEFAULT_PARSE_SPECIES[] = {2000, 10000};
+
+typedef struct
+{
+  const char *name;
+  const char *mech_file;
+  const char *therm_file;
+  const char *trans_file; // NULL when the mechanism has no transport data
+} BenchMechanism;
+
+static const BenchMechanism BENCH_MECHANISMS[] = {
+  {"hydrogen",
+   "mechanisms/hydrogen/h2_v1b_mech.txt",
+   "mechanisms/hydrogen/h2_v1a_therm.txt",
+   "mechanisms/hydrogen/h2_v1a_tran.txt"},
+  {"dme",
+   "mechanisms/dme/dme_24_mech.txt",
+   "mechanisms/dme/dme_24_therm.txt",
+   NULL},
+  {"n-heptane_reduced",
+   "mechanisms/n-heptane_reduced/heptanesymp159_mec.txt",
+   "mechanisms/n-heptane_reduced/heptanesymp_therm.txt",
+   NULL},
+  {"iso-octane",
+   "mechanisms/iso-octane/species874/ic8_ver3_mech.txt",
+   "mechanisms/iso-octane/species874/prf_v3_therm_dat.txt",
+   NULL},
+  {"n-dodecane",
+   "mechanisms/n-dodecane/NC12H26_Hybrid_mech.txt",
+   "mechanisms/n-dodecane/NC12H26_Hybrid_therm.txt",
+   "mechanisms/n-dodecane/NC12H26_Hybrid_transport.txt"},
+  {"plog",
+   "mechanisms/plog/plog_test.mech",
+   "mechanisms/plog/plog_test.therm",
+   NULL}
+};
+static const int NUM_BENCH_MECHANISMS =
+  sizeof(BENCH_MECHANISMS)/sizeof(BENCH_MECHANISMS[0]);
+
+typedef struct
+{
+  std::string data_dir;
+  std::string output_file;
+  std::string compare_file;
+  double threshold;
+  int num_states;
+  double min_time;
+  int seed;
+  std::vector<std::string> mechanisms;
+  std::vector<int> parse_species;
+} BenchOptions;
+
+typedef struct
+{
+  std::string mechanism;
+  std::string kernel;
+  long num_calls;
+  double ns_per_call;
+  double calls_per_s;
+  double bytes_per_call;
+} BenchResult;
+
+typedef struct
+{
+  double temperature;
+  double pressure;
+  std::vector<double> mass_fraction;
+  std::vector<double> concentration;
+} BenchState;
+
+static int ParseCommandLine(int argc, char *argv[], BenchOptions *options);
+static void SampleStates(zerork::mechanism *mech,
+                         const int num_states,
+                         std::vector<BenchState> *states);
+static double TimePass(const int num_states,
+                       const int num_repeats,
+                       const std::function<void(int)> &setup,
+                       const std::function<void(int)> &kernel);
+static double TimeKernel(const int num_states,
+                         const double min_time,
+                         const std::function<void(int)> &setup,
+                         const std::function<void(int)> &kernel,
+                         long *num_calls);
+static void AddResult(const std::string &mechanism,
+                      const std::string &kernel,
+                      const long num_calls,
+                      const double elapsed_time,
+                      const double bytes_per_call,
+                      std::vector<BenchResult> *results);
+static void BenchMechanismKernels(const BenchMechanism &bench_mech,
+                                  const BenchOptions &options,
+                                  std::vector<BenchResult> *results);
+static void BenchMechanismParse(const int num_species,
+                                const BenchOptions &options,
+                                std::vector<BenchResult> *results);
+static int WriteResults(const BenchOptions &options,
+                        const std::vector<BenchResult> &results);
+static int ReadResults(const std::string &file_name,
+                       std::vector<BenchResult> *results);
+static int CompareResults(const BenchOptions &options,
+                          const std::vector<BenchResult> &results);
+
+int main(int argc, char *argv[])
+{
+  BenchOptions options;
+  if(ParseCommandLine(argc, argv, &options) != 0) {
+    exit(-1);
+  }
+
+  std::vector<BenchResult> results;
+  for(int j=0; j<NUM_BENCH_MECHANISMS; ++j) {
+    if(options.mechanisms.size() > 0 &&
+       std::find(options.mechanisms.begin(),
+                 options.mechanisms.end(),
+                 BENCH_MECHANISMS[j].name) == options.mechanisms.end()) {
+      continue;
+    }
+    BenchMechanismKernels(BENCH_MECHANISMS[j], options, &results);
+  }
+  for(size_t j=0; j<options.parse_species.size(); ++j) {
+    BenchMechanismParse(options.parse_species[j], options, &results);
+  }
+
+  printf("# %-18s  %-36s  %12s  %14s  %12s\n",
+         "mechanism", "kernel", "ns/call", "calls/s", "bytes/call");
+  for(size_t j=0; j<results.size(); ++j) {
+    printf("  %-18s  %-36s  %12.1f  %14.1f  %12.0f\n",
+           results[j].mechanism.c_str(),
+           results[j].kernel.c_str(),
+           results[j].ns_per_call,
+           results[j].calls_per_s,
+           results[j].bytes_per_call);
+  }
+  fflush(stdout);
+
+  if(WriteResults(options, results) != 0) {
+    exit(-1);
+  }
+  if(options.compare_file.size() > 0 &&
+     CompareResults(options, results) != 0) {
+    return 1;
+  }
+  return 0;
+}
+
+static int ParseCommandLine(int argc, char *argv[], BenchOptions *options)
+{
+  const char *data_dir = getenv("ZERORK_DATA_DIR");
+#ifdef ZERORK_BENCH_DATA_DIR
+  if(data_dir == NULL) {
+    data_dir = ZERORK_BENCH_DATA_DIR;
+  }
+#endif
+  options->data_dir = (data_dir == NULL) ? std::string(".") :
+                                           std::string(data_dir);
+  options->output_file = "zerork_bench.json";
+  options->compare_file = "";
+  options->threshold = 0.1;
+  options->num_states = 32;
+  options->min_time = 0.2;
+  options->seed = 1;
+  options->mechanisms.clear();
+  options->parse_species.assign(DEFAULT_PARSE_SPECIES,
+                                DEFAULT_PARSE_SPECIES+
+                                sizeof(DEFAULT_PARSE_SPECIES)/sizeof(int));
+
+  bool default_parse_species = true;
+  for(int j=1; j<argc; ++j) {
+    std::string arg(argv[j]);
+    if(j+1 >= argc) {
+      printf("ERROR: command line option %s has no value\n", argv[j]);
+      return -1;
+    }
+    std::string value(argv[++j]);
+    if(arg == "--data-dir") {
+      options->data_dir = value;
+    } else if(arg == "--output") {
+      options->output_file = value;
+    } else if(arg == "--compare") {
+      options->compare_file = value;
+    } else if(arg == "--threshold") {
+      options->threshold = atof(value.c_str());
+    } else if(arg == "--num-states") {
+      options->num_states = std::max(1, atoi(value.c_str()));
+    } else if(arg == "--min-time") {
+      options->min_time = atof(value.c_str());
+    } else if(arg == "--seed") {
+      options->seed = atoi(value.c_str());
+    } else if(arg == "--mechanism") {
+      options->mechanisms.push_back(value);
+    } else if(arg == "--parse-species") {
+      // the first value replaces the default sizes, 0 skips the parser
+      if(default_parse_species) {
+        options->parse_species.clear();
+        default_parse_species = false;
+      }
+      if(atoi(value.c_str()) > 0) {
+        options->parse_species.push_back(atoi(value.c_str()));
+      }
+    } else {
+      printf("ERROR: unknown command line option %s\n", argv[j-1]);
+      printf("       use instead %s [--data-dir <dir>] [--output <json file>]\n",
+             argv[0]);
+      printf("                  [--compare <baseline json file>] [--threshold <frac>]\n");
+      printf("                  [--num-states <n>] [--min-time <seconds>]\n");
+      printf("                  [--seed <int>] [--mechanism <name>]...\n");
+      printf("                  [--parse-species <n>]...\n");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+// Uniform temperatures, log-uniform pressures and mole fractions spread
+// log-uniformly over MIN_LOG10_MOLE_FRACTION decades so that every species,
+// and therefore every reaction and Jacobian term, is active.
+static void SampleStates(zerork::mechanism *mech,
+                         const int num_states,
+                         std::vector<BenchState> *states)
+{
+  const int num_species = mech->getNumSpecies();
+  std::vector<double> mole_fraction(num_species);
+  states->assign(num_states, BenchState());
+  for(int j=0; j<num_states; ++j) {
+    BenchState &state = (*states)[j];
+    state.temperature = MIN_TEMPERATURE +
+      (MAX_TEMPERATURE-MIN_TEMPERATURE)*zerork::utilities::random01();
+    state.pressure = MIN_PRESSURE*
+      pow(MAX_PRESSURE/MIN_PRESSURE, zerork::utilities::random01());
+
+    double mole_fraction_sum = 0.0;
+    for(int k=0; k<num_species; ++k) {
+      mole_fraction[k] = pow(10.0, MIN_LOG10_MOLE_FRACTION*
+                                   zerork::utilities::random01());
+      mole_fraction_sum += mole_fraction[k];
+    }
+    for(int k=0; k<num_species; ++k) {
+      mole_fraction[k] /= mole_fraction_sum;
+    }
+    state.mass_fraction.assign(num_species, 0.0);
+    state.concentration.assign(num_species, 0.0);
+    mech->getYfromX(&mole_fraction[0], &state.mass_fraction[0]);
+    const double density = mech->getDensityFromTPY(state.temperature,
+                                                   state.pressure,
+                                                   &state.mass_fraction[0]);
+    mech->getCfromVY(1.0/density,
+                     &state.mass_fraction[0],
+                     &state.concentration[0]);
+  }
+}
+
+// Calls kernel(state_id) num_repeats times for every sampled state and
+// returns the total time of the kernel calls. The optional setup(state_id)
+// is called before the calls on each state and is not timed.
+static double TimePass(const int num_states,
+                       const int num_repeats,
+                       const std::function<void(int)> &setup,
+                       const std::function<void(int)> &kernel)
+{
+  double elapsed_time = 0.0;
+  for(int j=0; j<num_states; ++j) {
+    if(setup) {
+      setup(j);
+    }
+    const double start_time = zerork::getHighResolutionTime();
+    for(int k=0; k<num_repeats; ++k) {
+      kernel(j);
+    }
+    elapsed_time += zerork::getHighResolutionTime() - start_time;
+  }
+  return elapsed_time;
+}
+
+// Repeats the kernel calls on each state until the total kernel time is at
+// least min_time. The number of repeats is calibrated with passes that are
+// long enough to be above the timer resolution.
+static double TimeKernel(const int num_states,
+                         const double min_time,
+                         const std::function<void(int)> &setup,
+                         const std::function<void(int)> &kernel,
+                         long *num_calls)
+{
+  int num_repeats = 1;
+  double elapsed_time = TimePass(num_states, num_repeats, setup, kernel);
+  while(elapsed_time < 0.1*min_time && num_repeats < 1000000) {
+    num_repeats *= 10;
+    elapsed_time = TimePass(num_states, num_repeats, setup, kernel);
+  }
+  if(elapsed_time < min_time) {
+    num_repeats = (int)ceil(num_repeats*min_time/
+                            std::max(elapsed_time, 1.0e-9));
+    elapsed_time = TimePass(num_states, num_repeats, setup, kernel);
+  }
+  *num_calls = (long)num_repeats*(long)num_states;
+  return elapsed_time;
+}
+
+static void AddResult(const std::string &mechanism,
+                      const std::string &kernel,
+                      const long num_calls,
+                      const double elapsed_time,
+                      const double bytes_per_call,
+                      std::vector<BenchResult> *results)
+{
+  BenchResult result;
+  result.mechanism = mechanism;
+  result.kernel = kernel;
+  result.num_calls = num_calls;
+  result.ns_per_call = 1.0e9*elapsed_time/(double)num_calls;
+  result.calls_per_s = (double)num_calls/elapsed_time;
+  result.bytes_per_call = bytes_per_call;
+  results->push_back(result);
+}
+
+// The bytes/call are the sizes of the arrays read and written by each call,
+// not including the internal work arrays of the mechanism.
+static void BenchMechanismKernels(const BenchMechanism &bench_mech,
+                                  const BenchOptions &options,
+                                  std::vector<BenchResult> *results)
+{
+  const std::string mech_file = options.data_dir + "/" + bench_mech.mech_file;
+  const std::string therm_file = options.data_dir + "/" +
+    bench_mech.therm_file;
+  if(!zerork::utilities::FileIsReadable(mech_file) ||
+     !zerork::utilities::FileIsReadable(therm_file)) {
+    printf("WARNING: skipping mechanism %s, could not read files:\n"
+           "         %s\n"
+           "         %s\n",
+           bench_mech.name, mech_file.c_str(), therm_file.c_str());
+    return;
+  }
+  std::shared_ptr<zerork::mechanism> mech =
+    std::make_shared<zerork::mechanism>(mech_file.c_str(),
+                                        therm_file.c_str(),
+                                        zerork::utilities::null_filename);
+  const std::string name(bench_mech.name);
+  const int num_species = mech->getNumSpecies();
+  const int num_reactions = mech->getNumReactions();
+  const int num_steps = mech->getNumSteps();
+  const double dsize = (double)sizeof(double);
+  const double isize = (double)sizeof(int);
+
+  zerork::utilities::random01seed(options.seed);
+  std::vector<BenchState> states;
+  SampleStates(mech.get(), options.num_states, &states);
+
+  std::vector<double> net_rates(num_species);
+  std::vector<double> creation_rates(num_species);
+  std::vector<double> destruction_rates(num_species);
+  std::vector<double> step_rates(num_steps);
+  std::vector<double> k_forward(num_reactions);
+  std::vector<double> k_reverse(num_reactions);
+  std::vector<double> cp_species(num_species);
+  std::vector<double> h_species(num_species);
+  long num_calls;
+  double elapsed_time;
+
+  // chemical source terms
+  elapsed_time = TimeKernel(options.num_states, options.min_time, nullptr,
+    [&](int id) {
+      mech->getReactionRates(states[id].temperature,
+                             &states[id].concentration[0],
+                             &net_rates[0],
+                             &creation_rates[0],
+                             &destruction_rates[0],
+                             &step_rates[0]);
+    }, &num_calls);
+  AddResult(name, "mechanism::getReactionRates", num_calls, elapsed_time,
+            dsize*(4*num_species + num_steps), results);
+
+  // rate constants, getKrxnFromTC is the public entry to rate_const::updateK
+  elapsed_time = TimeKernel(options.num_states, options.min_time, nullptr,
+    [&](int id) {
+      mech->getKrxnFromTC(states[id].temperature,
+                          &states[id].concentration[0],
+                          &k_forward[0],
+                          &k_reverse[0]);
+    }, &num_calls);
+  AddResult(name, "rate_const::updateK", num_calls, elapsed_time,
+            dsize*(num_species + 2*num_reactions), results);
+
+  // thermodynamics
+  elapsed_time = TimeKernel(options.num_states, options.min_time, nullptr,
+    [&](int id) {
+      mech->getCp_R_Enthalpy_RT(states[id].temperature,
+                                &cp_species[0],
+                                &h_species[0]);
+    }, &num_calls);
+  AddResult(name, "mechanism::getCp_R_Enthalpy_RT", num_calls, elapsed_time,
+            dsize*2*num_species, results);
+
+  elapsed_time = TimeKernel(options.num_states, options.min_time, nullptr,
+    [&](int id) {
+      mech->getMassCpFromTY(states[id].temperature,
+                            &states[id].mass_fraction[0],
+                            &cp_species[0]);
+    }, &num_calls);
+  AddResult(name, "mechanism::getMassCpFromTY", num_calls, elapsed_time,
+            dsize*2*num_species, results);
+
+  std::vector<double> enthalpy(options.num_states);
+  for(int j=0; j<options.num_states; ++j) {
+    enthalpy[j] = mech->getMassEnthalpyFromTY(states[j].temperature,
+                                              &states[j].mass_fraction[0]);
+  }
+  elapsed_time = TimeKernel(options.num_states, options.min_time, nullptr,
+    [&](int id) {
+      mech->getTemperatureFromHY(enthalpy[id],
+                                 &states[id].mass_fraction[0],
+                                 0.5*(MIN_TEMPERATURE+MAX_TEMPERATURE));
+    }, &num_calls);
+  AddResult(name, "mechanism::getTemperatureFromHY", num_calls, elapsed_time,
+            dsize*num_species, results);
+
+  // elementary mass action Jacobian terms d(ROP_j)/dC[k], compared to the
+  // division by the clipped concentrations that the terms replace
+  const zerork::mass_action_jacobian *mass_action =
+    mech->getMassActionJacobian();
+  const int num_terms = mass_action->getNumTerms();
+  std::vector<int> term_step(num_terms+1), term_species(num_terms+1);
+  std::vector<double> rate_coefficients(num_steps);
+  std::vector<double> no_step_limiter(num_steps, 1.0e+300);
+  std::vector<double> inv_concentrations(num_species);
+  std::vector<double> terms(num_terms+1);
+  std::unique_ptr<zerork::rate_const_workspace> rate_const_work =
+    mech->createRateConstWorkspace();
+  mass_action->getTermPattern(&term_step[0], &term_species[0]);
+  auto rates_setup = [&](int id) {
+    mech->getReactionRatesLimiter(states[id].temperature,
+                                  &states[id].concentration[0],
+                                  &no_step_limiter[0],
+                                  &net_rates[0],
+                                  &creation_rates[0],
+                                  &destruction_rates[0],
+                                  &step_rates[0],
+                                  &rate_coefficients[0],
+                                  rate_const_work.get());
+  };
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    rates_setup,
+    [&](int id) {
+      mass_action->getTermValues(&rate_coefficients[0],
+                                 &states[id].concentration[0],
+                                 &terms[0]);
+    }, &num_calls);
+  AddResult(name, "mass_action_jacobian::getTermValues", num_calls,
+            elapsed_time, dsize*(num_steps + num_species + num_terms) +
+            isize*num_terms, results);
+
+  const double min_concentration = 1.0/mech->getAvogadroNumber();
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    rates_setup,
+    [&](int id) {
+      const double *concentration = &states[id].concentration[0];
+      for(int k=0; k<num_species; ++k) {
+        double c = concentration[k];
+        if(fabs(c) < min_concentration) {
+          c = (c < 0.0) ? -min_concentration : min_concentration;
+        }
+        inv_concentrations[k] = 1.0/c;
+      }
+      for(int k=0; k<num_terms; ++k) {
+        terms[k] = step_rates[term_step[k]]*inv_concentrations[term_species[k]];
+      }
+    }, &num_calls);
+  AddResult(name, "mass_action_jacobian::ClippedDivision", num_calls,
+            elapsed_time, dsize*(num_steps + 2*num_species + num_terms) +
+            2*isize*num_terms, results);
+
+  // sparse Jacobian and preconditioner of the cfd_plugin reactor
+  ReactorConstantPressureCPU reactor(mech);
+  OptionableBase::IntOptions int_options;
+  OptionableBase::DoubleOptions double_options;
+  int_options["dense"] = 0;
+  int_options["analytic"] = 1;
+  int_options["iterative"] = 1;
+  int_options["abstol_dens"] = 0;
+  int_options["adaptive_chemistry"] = 0;
+  double_options["reference_temperature"] = 1.0;
+  double_options["min_mass_fraction"] = 1.0e-30;
+  double_options["preconditioner_threshold"] = 1.0e-3;
+  double_options["delta_temperature_ignition"] = 0.0;
+  reactor.SetIntOptions(int_options);
+  reactor.SetDoubleOptions(double_options);
+  reactor.SetSolveTemperature(true);
+  reactor.SetStepLimiter(1.0e22);
+
+  const int num_variables = reactor.GetNumStateVariables();
+  N_Vector derivative = N_VNew_Serial(num_variables);
+  N_Vector solution = N_VNew_Serial(num_variables);
+  const double zero = 0.0;
+  std::function<void(int)> initialize_state = [&](int id) {
+    reactor.InitializeState(0.0, 1,
+                            &states[id].temperature,
+                            &states[id].pressure,
+                            &states[id].mass_fraction[0],
+                            &zero, &zero, nullptr);
+    reactor.GetTimeDerivative(0.0, reactor.GetStateNVectorRef(), derivative);
+  };
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    initialize_state,
+    [&](int id) {
+      reactor.JacobianSetup(0.0, reactor.GetStateNVectorRef(), derivative);
+    }, &num_calls);
+
+  const std::vector<int> *column_sums;
+  const std::vector<int> *row_indexes;
+  const std::vector<double> *values;
+  initialize_state(0);
+  reactor.JacobianSetup(0.0, reactor.GetStateNVectorRef(), derivative);
+  reactor.GetSparsePreconditioner(PRECONDITIONER_GAMMA,
+                                  &column_sums, &row_indexes, &values);
+  const double preconditioner_bytes =
+    isize*(column_sums->size() + row_indexes->size()) + dsize*values->size();
+  AddResult(name, "ReactorNVectorSerial::JacobianSetup", num_calls,
+            elapsed_time, dsize*2*num_variables + preconditioner_bytes,
+            results);
+
+  std::function<void(int)> setup_jacobian = [&](int id) {
+    initialize_state(id);
+    reactor.JacobianSetup(0.0, reactor.GetStateNVectorRef(), derivative);
+  };
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    setup_jacobian,
+    [&](int id) {
+      reactor.JacobianFactor(PRECONDITIONER_GAMMA);
+    }, &num_calls);
+  AddResult(name, "ReactorNVectorSerial::JacobianFactor", num_calls,
+            elapsed_time, preconditioner_bytes, results);
+
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    [&](int id) {
+      setup_jacobian(id);
+      reactor.JacobianFactor(PRECONDITIONER_GAMMA);
+    },
+    [&](int id) {
+      reactor.JacobianSolve(0.0, reactor.GetStateNVectorRef(), derivative,
+                            derivative, solution);
+    }, &num_calls);
+  AddResult(name, "ReactorNVectorSerial::JacobianSolve", num_calls,
+            elapsed_time, dsize*2*num_variables, results);
+
+  // Krylov product of the exponential integrator, with the full Jacobian
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    setup_jacobian,
+    [&](int id) {
+      reactor.JacobianVectorProduct(derivative, solution);
+    }, &num_calls);
+  AddResult(name, "ReactorNVectorSerial::JacobianVectorProduct", num_calls,
+            elapsed_time, dsize*2*num_variables + preconditioner_bytes,
+            results);
+
+  // per integration overhead of SEULEX over an interval short enough for a
+  // few steps, with a new workspace per integration and with a reused one
+  const double short_time = 1.0e-9;
+  OptionableBase::IntOptions solver_int_options;
+  OptionableBase::DoubleOptions solver_double_options;
+  solver_int_options["max_steps"] = 5000;
+  solver_int_options["seulex_warm_start"] = 0;
+  solver_double_options["abs_tol"] = 1.0e-20;
+  solver_double_options["rel_tol"] = 1.0e-8;
+  solver_double_options["max_dt"] = short_time;
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    initialize_state,
+    [&](int id) {
+      SeulexSolver solver(reactor);
+      solver.SetIntOptions(solver_int_options);
+      solver.SetDoubleOptions(solver_double_options);
+      solver.Integrate(short_time);
+    }, &num_calls);
+  AddResult(name, "SeulexSolver::Integrate", num_calls, elapsed_time,
+            dsize*num_variables, results);
+
+  SeulexContext seulex_context;
+  elapsed_time = TimeKernel(options.num_states, options.min_time,
+    initialize_state,
+    [&](int id) {
+      SeulexSolver solver(reactor);
+      solver.SetContext(&seulex_context);
+      solver.SetIntOptions(solver_int_options);
+      solver.SetDoubleOptions(solver_double_options);
+      solver.Integrate(short_time);
+    }, &num_calls);
+  AddResult(name, "SeulexSolver::Integrate(SeulexContext)", num_calls,
+            elapsed_time, dsize*num_variables, results);
+  N_VDestroy(derivative);
+  N_VDestroy(solution);
+
+  // mixture averaged transport fluxes in one dimension
+  if(bench_mech.trans_file != NULL) {
+    const std::string trans_file = options.data_dir + "/" +
+      bench_mech.trans_file;
+    std::unique_ptr<transport::MassTransportInterface> trans(
+      transport::InterfaceFactory::CreateMassBased("MixAvg"));
+    std::vector<std::string> transport_files(1, trans_file);
+    int flag = trans->Initialize(mech.get(), transport_files,
+                                 zerork::utilities::null_filename);
+    if(flag != transport::NO_ERROR) {
+      printf("WARNING: skipping transport of mechanism %s,\n"
+             "         MassTransportInterface::Initialize returned %d\n",
+             bench_mech.name, flag);
+      return;
+    }
+    std::vector<double> grad_mass_fraction(num_species);
+    std::vector<double> mass_flux(num_species);
+    std::vector<double> lewis_numbers(num_species);
+    double grad_temperature = 1.0e5;
+    double grad_pressure = 0.0;
+    double conductivity, specific_heat;
+    for(int k=0; k<num_species; ++k) {
+      grad_mass_fraction[k] = 2.0*zerork::utilities::random01() - 1.0;
+    }
+    transport::MassTransportInput input;
+    input.num_dimensions_ = 1;
+    input.ld_grad_temperature_ = 1;
+    input.ld_grad_pressure_ = 1;
+    input.ld_grad_mass_fraction_ = num_species;
+    input.grad_temperature_ = &grad_temperature;
+    input.grad_pressure_ = &grad_pressure;
+    input.grad_mass_fraction_ = &grad_mass_fraction[0];
+    elapsed_time = TimeKernel(options.num_states, options.min_time, nullptr,
+      [&](int id) {
+        input.temperature_ = states[id].temperature;
+        input.pressure_ = states[id].pressure;
+        input.mass_fraction_ = &states[id].mass_fraction[0];
+        trans->GetSpeciesMassFlux(input, num_species, &conductivity,
+                                  &specific_heat, &mass_flux[0],
+                                  &lewis_numbers[0]);
+      }, &num_calls);
+    AddResult(name, "transport::GetSpeciesMassFlux", num_calls, elapsed_time,
+              dsize*4*num_species, results);
+  }
+}
+
+// Times the construction of a mechanism from the synthetic files, which is
+// dominated by the parser. The bytes/call are the sizes of the two files.
+static void BenchMechanismParse(const int num_species,
+                                const BenchOptions &options,
+                                std::vector<BenchResult> *results)
+{
+  const std::string name = "synthetic_" + std::to_string(num_species);
+  if(options.mechanisms.size() > 0 &&
+     std::find(options.mechanisms.begin(),
+               options.mechanisms.end(),
+               name) == options.mechanisms.end()) {
+    return;
+  }
+  const std::string mech_file = "zerork_bench_" + name + "_mech.txt";
+  const std::string therm_file = "zerork_bench_" + name + "_therm.txt";
+  zerork::utilities::random01seed(options.seed);
+  if(WriteSyntheticMechanism(num_species,
+                             PARSE_REACTIONS_PER_SPECIES*num_species,
+                             (int)(PARSE_THERMO_RECORDS_PER_SPECIES*
+                                   num_species),
+                             mech_file,
+                             therm_file) != 0) {
+    printf("WARNING: skipping mechanism %s\n", name.c_str());
+    return;
+  }
+  double bytes_per_call = 0.0;
+  const std::string files[] = {mech_file, therm_file};
+  for(int j=0; j<2; ++j) {
+    FILE *fptr = fopen(files[j].c_str(), "r");
+    if(fptr != NULL) {
+      fseek(fptr, 0, SEEK_END);
+      bytes_per_call += (double)ftell(fptr);
+      fclose(fptr);
+    }
+  }
+
+  double min_time = 1.0e300;
+  for(int j=0; j<PARSE_REPEATS; ++j) {
+    const double start_time = zerork::getHighResolutionTime();
+    zerork::mechanism mech(mech_file.c_str(),
+                           therm_file.c_str(),
+                           zerork::utilities::null_filename);
+    min_time = std::min(min_time,
+                        zerork::getHighResolutionTime() - start_time);
+  }
+  AddResult(name, "mechanism::mechanism", 1, min_time, bytes_per_call,
+            results);
+  remove(mech_file.c_str());
+  remove(therm_file.c_str());
+}
+
+// One result per line so that the baseline can be read back by ReadResults
+// without a JSON library.
+static int WriteResults(const BenchOptions &options,
+                        const std::vector<BenchResult> &results)
+{
+  FILE *output_fptr = fopen(options.output_file.c_str(), "w");
+  if(output_fptr == NULL) {
+    printf("ERROR: could not open output file %s for write\n",
+           options.output_file.c_str());
+    return -1;
+  }
+  fprintf(output_fptr, "{\n");
+  fprintf(output_fptr, "  \"num_states\": %d,\n", options.num_states);
+  fprintf(output_fptr, "  \"min_time\": %.6g,\n", options.min_time);
+  fprintf(output_fptr, "  \"seed\": %d,\n", options.seed);
+  fprintf(output_fptr, "  \"results\": [\n");
+  for(size_t j=0; j<results.size(); ++j) {
+    fprintf(output_fptr,
+            "    {\"mechanism\": \"%s\", \"kernel\": \"%s\", "
+            "\"num_calls\": %ld, \"ns_per_call\": %.6g, "
+            "\"calls_per_s\": %.6g, \"bytes_per_call\": %.6g}%s\n",
+            results[j].mechanism.c_str(),
+            results[j].kernel.c_str(),
+            results[j].num_calls,
+            results[j].ns_per_call,
+            results[j].calls_per_s,
+            results[j].bytes_per_call,
+            (j+1 < results.size()) ? "," : "");
+  }
+  fprintf(output_fptr, "  ]\n");
+  fprintf(output_fptr, "}\n");
+  fclose(output_fptr);
+  return 0;
+}
+
+static bool GetStringValue(const char *line, const char *key,
+                           std::string *value)
+{
+  std::string search = std::string("\"") + key + "\": \"";
+  const char *start = strstr(line, search.c_str());
+  if(start == NULL) {
+    return false;
+  }
+  start += search.size();
+  const char *end = strchr(start, '"');
+  if(end == NULL) {
+    return false;
+  }
+  value->assign(start, end-start);
+  return true;
+}
+
+static bool GetNumberValue(const char *line, const char *key, double *value)
+{
+  std::string search = std::string("\"") + key + "\": ";
+  const char *start = strstr(line, search.c_str());
+  if(start == NULL) {
+    return false;
+  }
+  *value = atof(start + search.size());
+  return true;
+}
+
+static int ReadResults(const std::string &file_name,
+                       std::vector<BenchResult> *results)
+{
+  FILE *input_fptr = fopen(file_name.c_str(), "r");
+  if(input_fptr == NULL) {
+    printf("ERROR: could not open baseline file %s for read\n",
+           file_name.c_str());
+    return -1;
+  }
+  char line[MAX_LINE_LEN];
+  results->clear();
+  while(fgets(line, MAX_LINE_LEN, input_fptr) != NULL) {
+    BenchResult result;
+    double num_calls;
+    if(GetStringValue(line, "mechanism", &result.mechanism) &&
+       GetStringValue(line, "kernel", &result.kernel) &&
+       GetNumberValue(line, "num_calls", &num_calls) &&
+       GetNumberValue(line, "ns_per_call", &result.ns_per_call) &&
+       GetNumberValue(line, "calls_per_s", &result.calls_per_s) &&
+       GetNumberValue(line, "bytes_per_call", &result.bytes_per_call)) {
+      result.num_calls = (long)num_calls;
+      results->push_back(result);
+    }
+  }
+  fclose(input_fptr);
+  return 0;
+}
+
+// Returns the number of kernels that are slower than the baseline by more
+// than options.threshold (relative change of ns/call). Kernels missing from
+// either set of results are reported but not counted as regressions.
+static int CompareResults(const BenchOptions &options,
+                          const std::vector<BenchResult> &results)
+{
+  std::vector<BenchResult> baseline;
+  if(ReadResults(options.compare_file, &baseline) != 0) {
+    return -1;
+  }
+  std::map<std::string, const BenchResult *> baseline_map;
+  for(size_t j=0; j<baseline.size(); ++j) {
+    baseline_map[baseline[j].mechanism + "/" + baseline[j].kernel] =
+      &baseline[j];
+  }
+
+  int num_regressions = 0;
+  printf("# comparison to baseline %s (threshold %.1f%%)\n",
+         options.compare_file.c_str(), 100.0*options.threshold);
+  printf("# %-18s  %-36s  %12s  %12s  %8s\n",
+         "mechanism", "kernel", "base ns/call", "ns/call", "change");
+  for(size_t j=0; j<results.size(); ++j) {
+    const std::string key = results[j].mechanism + "/" + results[j].kernel;
+    std::map<std::string, const BenchResult *>::iterator it =
+      baseline_map.find(key);
+    if(it == baseline_map.end()) {
+      printf("  %-18s  %-36s  %12s  %12.1f  %8s\n",
+             results[j].mechanism.c_str(), results[j].kernel.c_str(),
+             "-", results[j].ns_per_call, "new");
+      continue;
+    }
+    const double change =
+      results[j].ns_per_call/it->second->ns_per_call - 1.0;
+    const bool regression = (change > options.threshold);
+    if(regression) {
+      ++num_regressions;
+    }
+    printf("  %-18s  %-36s  %12.1f  %12.1f  %+7.1f%%%s\n",
+           results[j].mechanism.c_str(), results[j].kernel.c_str(),
+           it->second->ns_per_call, results[j].ns_per_call, 100.0*change,
+           regression ? "  REGRESSION" : "");
+    baseline_map.erase(it);
+  }
+  for(std::map<std::string, const BenchResult *>::iterator it =
+        baseline_map.begin(); it != baseline_map.end(); ++it) {
+    printf("  %-18s  %-36s  %12.1f  %12s  %8s\n",
+           it->second->mechanism.c_str(), it->second->kernel.c_str(),
+           it->second->ns_per_call, "-", "missing");
+  }
+  printf("# %d kernel(s) slower than the baseline by more than %.1f%%\n",
+         num_regressions, 100.0*options.threshold);
+  return num_regressions;
+}